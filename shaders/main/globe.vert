@@ -0,0 +1,42 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+// compact vertices: see 'scene.vert'
+layout (location = 0) in vec4 mPosition;
+layout (location = 1) in vec2 vTexCoord;
+layout (location = 3) in vec3 mNormal;
+layout (location = 4) in vec3 mTangent;
+layout (location = 5) in vec3 mBitangent;
+
+// object space, transformed in globe.tese
+layout (location = 0) out vec3 cPosition;
+layout (location = 1) out vec3 cNormal;
+layout (location = 2) out vec3 cTangent;
+layout (location = 3) out vec3 cBitangent;
+layout (location = 4) out vec2 cTexCoord;
+layout (location = 5) flat out uint cDrawId; // gl_DrawID is available only in the vertex shader
+
+
+
+void main() {
+	cDrawId = drawIdOffset + uint(gl_DrawID);
+
+	if (COMPACT_VERTICES) {
+		DRAW draw = draws[cDrawId];
+
+		cPosition = draw.positionOffset.xyz + draw.positionScale.xyz * mPosition.xyz;
+		cNormal = decodeOctahedral(mNormal.xy);
+		cTangent = decodeOctahedral(mTangent.xy);
+		cBitangent = (mPosition.w > 0.5f ? 1.0f : -1.0f) * cross(cNormal, cTangent);
+		cTexCoord = draw.texCoordRange.xy + draw.texCoordRange.zw * vTexCoord;
+	}
+	else {
+		cPosition = mPosition.xyz;
+		cNormal = mNormal;
+		cTangent = mTangent;
+		cBitangent = mBitangent;
+		cTexCoord = vTexCoord;
+	}
+}
@@ -0,0 +1,81 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+const uint GRID_SIZE = 32u; // quads per node side, defined also in Planet.cpp
+const float PI = 3.14159265f;
+
+// per-node data, defined also in Planet.h
+struct NODE {
+  vec2 origin; // cube face coordinates, [-1, 1]
+  float size;
+  uint face;
+  vec2 morphRange; // object space distances
+};
+
+layout (std430, binding = 2) readonly buffer NodeBuffer {
+  vec4 eyePosition; // object space
+  vec4 sphere; // center, radius (object space)
+  NODE nodes[];
+};
+
+// cube faces: the point (s, t) of a face is normalize(n + s * u + t * v), with u x v = n
+const vec3 FACE_U[6] = vec3[6](vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 0.0f, 1.0f), vec3(1.0f, 0.0f, 0.0f),
+                               vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f));
+const vec3 FACE_V[6] = vec3[6](vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 0.0f, -1.0f),
+                               vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+const vec3 FACE_N[6] = vec3[6](vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f),
+                               vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f));
+
+layout (location = 0) in vec2 mGridPosition; // [0, 1]
+
+layout (location = 0) smooth out vec3 ePosition;
+layout (location = 1) smooth out vec3 eNormal;
+layout (location = 2) smooth out vec2 fTexCoord;
+layout (location = 3) smooth out vec2 fInvTexCoord;
+layout (location = 4) flat out uint fMaterialId;
+
+layout (location = 5) smooth out vec3 eTangent;
+layout (location = 6) smooth out vec3 eBitangent;
+layout (location = 7) smooth out vec3 fDirection; // object space, the texture coordinates are computed per fragment
+
+
+
+vec3 getDirection(NODE node, vec2 gridPosition) {
+	vec2 facePosition = node.origin + gridPosition * node.size;
+	return normalize(FACE_N[node.face] + facePosition.x * FACE_U[node.face] + facePosition.y * FACE_V[node.face]);
+}
+
+
+
+void main() {
+	DRAW draw = draws[drawIdOffset + uint(gl_DrawID)];
+	NODE node = nodes[gl_InstanceID];
+	fMaterialId = draw.materialId;
+
+	// CDLOD morph: the odd grid vertices slide onto the grid of the parent node
+	float distance = length(sphere.xyz + sphere.w * getDirection(node, mGridPosition) - eyePosition.xyz);
+	float morph = clamp((distance - node.morphRange.x) / (node.morphRange.y - node.morphRange.x), 0.0f, 1.0f);
+
+	vec2 gridPosition = mGridPosition * float(GRID_SIZE);
+	gridPosition = (gridPosition - fract(gridPosition * 0.5f) * 2.0f * morph) / float(GRID_SIZE);
+
+	vec3 direction = getDirection(node, gridPosition);
+	vec3 position = sphere.xyz + sphere.w * direction;
+	fDirection = direction;
+
+	gl_Position = draw.modelViewProjectionMatrix * vec4(position, 1.0f);
+	ePosition = (draw.modelViewMatrix * vec4(position, 1.0f)).rgb;
+	eNormal = (draw.normalMatrix * vec4(direction, 0.0f)).rgb;
+
+	// same mapping as the sphere model: u along the longitude (from +z towards +x), v along the latitude
+	vec2 texCoord = vec2(fract(atan(direction.x, direction.z) / (2.0f * PI) + 0.25f),
+		                 asin(clamp(direction.y, -1.0f, 1.0f)) / PI + 0.5f);
+	fTexCoord = texCoord;
+	fInvTexCoord = vec2(texCoord.x, 1.0f - texCoord.y);
+
+	vec3 tangent = length(direction.xz) > 0.0001f ? normalize(vec3(direction.z, 0.0f, -direction.x)) : vec3(1.0f, 0.0f, 0.0f);
+	eTangent = (draw.normalMatrix * vec4(tangent, 0.0f)).rgb;
+	eBitangent = (draw.normalMatrix * vec4(cross(direction, tangent), 0.0f)).rgb;
+}
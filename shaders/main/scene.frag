@@ -1,36 +1,73 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 30, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 float GAMMA = 1.0f / 2.2f;
 
-smooth in vec3 ePosition, eNormal;
-smooth in vec2 fTexCoord, fInvTexCoord;
+layout (location = 0) smooth in vec3 ePosition;
+layout (location = 1) smooth in vec3 eNormal;
+layout (location = 2) smooth in vec2 fTexCoord;
+layout (location = 3) smooth in vec2 fInvTexCoord;
+layout (location = 4) flat in uint fMaterialId;
 
 #ifdef NORMAL_MAPPING_MODE
-smooth in vec3 eTangent, eBitangent;
+layout (location = 5) smooth in vec3 eTangent;
+layout (location = 6) smooth in vec3 eBitangent;
 #endif
 
-out vec4 outputColor;
+#ifdef PLANET_MODE
+layout (location = 7) smooth in vec3 fDirection;
+
+// texture coordinates of the sphere model; of the two longitude ranges, the one without the seam
+// discontinuity in this fragment (smaller derivative) is used, so the mip level is not wrong along the seam
+vec2 getPlanetTexCoord(vec3 direction) {
+	float PI = 3.14159265f;
+	float longitude = atan(direction.x, direction.z) / (2.0f * PI);
+
+	float u1 = fract(longitude + 0.25f);
+	float u2 = fract(longitude + 0.75f) - 0.5f;
+
+	return vec2(fwidth(u1) <= fwidth(u2) ? u1 : u2, asin(clamp(direction.y, -1.0f, 1.0f)) / PI + 0.5f);
+}
+#endif
+
+layout (location = 0) out vec4 outputColor;
 
 
 
 void main() {
+	material = materials[fMaterialId];
+
+	vec2 texCoord = fTexCoord, invTexCoord = fInvTexCoord;
+
+	#ifdef PLANET_MODE
+	texCoord = getPlanetTexCoord(normalize(fDirection));
+	invTexCoord = vec2(texCoord.x, 1.0f - texCoord.y);
+	#endif
+
+	// feedback pass of the virtual textures, see 'Scene.updateVirtualTextures_': texture coordinates, -log2 of their
+	// largest derivatives (1/16 steps, u + 1024 v) and material id + 1 (0 -> cleared)
+	if (VIRTUAL_TEXTURE_FEEDBACK) {
+		vec2 footprint = max(abs(dFdx(texCoord)), abs(dFdy(texCoord)));
+		vec2 footprintLog2 = floor(clamp(-log2(max(footprint, vec2(1e-20f))), 0.0f, 63.0f) * 16.0f);
+
+		outputColor = vec4(fract(texCoord), footprintLog2.x + footprintLog2.y * 1024.0f, float(fMaterialId + 1u));
+		return;
+	}
+
 	vec4 color = vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	vec3 specularColor = vec3(0.0f), emissiveColor = vec3(0.0f);
 	vec3 normal = normalize (eNormal);
-	
-	#ifdef NO_SHADING_MODE
-	material.shadingModel;
-	#endif
+
+	if (TWO_SIDED && !gl_FrontFacing) normal = -normal; // back faces are not culled
 	
 	#ifdef NORMAL_MAPPING_MODE
 	vec3 tangent = normalize (eTangent);
 	vec3 bitangent = normalize (eBitangent);
 
-	if (hasNormalMapTexture) {
-		vec3 tNormal = getNormalInTangentSpace(fTexCoord, fInvTexCoord, GAMMA);
+	if (HAS_NORMAL_MAP_TEXTURE) {
+		vec3 tNormal = getNormalInTangentSpace(texCoord, invTexCoord, GAMMA);
 		computeShadingTangent(ePosition, normal, tangent, bitangent, tNormal, color, specularColor, emissiveColor);
 	}
 	else computeShadingTangent(ePosition, normal, vec3(0.0f), vec3(0.0f), vec3(0.0f), color, specularColor, emissiveColor);
@@ -38,7 +75,7 @@ void main() {
 	computeShadingNormal(ePosition, normal, color, specularColor, emissiveColor);
 	#endif
 
-	textureMapping (fTexCoord, fInvTexCoord, GAMMA, color, specularColor, emissiveColor);
+	textureMapping (texCoord, invTexCoord, GAMMA, color, specularColor, emissiveColor);
 
 	float opacity = color.a;
 	outputColor = vec4(color.rgb + specularColor + emissiveColor, opacity);	
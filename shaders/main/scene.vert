@@ -1,38 +1,67 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 28, 2025
+ * Last modified: Oct 17, 2026
  **/
  
-in vec3 mPosition, mNormal;
-in vec2 vTexCoord;
+// attribute locations defined also in BaseProgram.cpp; compact vertices (see 'MeshBatch'): unorm positions (w: sign of
+// the bitangent) and texture coordinates, octahedral normals and tangents (xy)
+layout (location = 0) in vec4 mPosition;
+layout (location = 1) in vec2 vTexCoord;
+layout (location = 3) in vec3 mNormal;
 
-smooth out vec3 ePosition, eNormal;
-smooth out vec2 fTexCoord, fInvTexCoord;
+layout (location = 0) smooth out vec3 ePosition;
+layout (location = 1) smooth out vec3 eNormal;
+layout (location = 2) smooth out vec2 fTexCoord;
+layout (location = 3) smooth out vec2 fInvTexCoord;
+layout (location = 4) flat out uint fMaterialId;
 
 #ifdef NORMAL_MAPPING_MODE
-in vec3 mTangent, mBitangent;
-smooth out vec3 eTangent, eBitangent;
+layout (location = 4) in vec3 mTangent;
+layout (location = 5) in vec3 mBitangent;
+layout (location = 5) smooth out vec3 eTangent;
+layout (location = 6) smooth out vec3 eBitangent;
 #endif
 
-uniform mat4 modelViewMatrix;
-uniform mat4 modelViewProjectionMatrix;
-uniform mat4 normalMatrix;
+// instanced meshes, see 'MeshInstances.h': the per-draw matrices are those of the scene space
+layout (std430, binding = 3) readonly buffer InstanceBuffer { mat4 transforms[]; };
+layout (std430, binding = 4) readonly buffer VisibleInstanceBuffer {
+  mat4 meshModelMatrix;
+  uint visibleInstances[];
+};
+
+layout (location = 1) uniform bool instanced;
 
 
 
 void main() {
-	gl_Position = modelViewProjectionMatrix * vec4(mPosition, 1.0f);	
-	ePosition = (modelViewMatrix * vec4(mPosition, 1.0f)).rgb;
-	eNormal = (normalMatrix * vec4(mNormal, 1.0f)).rgb;
+	DRAW draw = draws[drawIdOffset + uint(gl_DrawID)];
+	material = materials[draw.materialId];
+	fMaterialId = draw.materialId;
+
+	// the instance and mesh transformations are rotations, translations and uniform scales, so they also transform
+	// the normals (normalized later)
+	mat4 instanceMatrix = instanced ? transforms[visibleInstances[gl_InstanceID]] * meshModelMatrix : mat4(1.0f);
+	mat4 normalMatrix = draw.normalMatrix * instanceMatrix;
+
+	vec3 position = COMPACT_VERTICES ? draw.positionOffset.xyz + draw.positionScale.xyz * mPosition.xyz : mPosition.xyz;
+	vec3 normal = COMPACT_VERTICES ? decodeOctahedral(mNormal.xy) : mNormal;
+	vec2 texCoord = COMPACT_VERTICES ? draw.texCoordRange.xy + draw.texCoordRange.zw * vTexCoord : vTexCoord;
 
-	fTexCoord = vTexCoord;
-	fInvTexCoord = vec2(vTexCoord.x, 1.0f - vTexCoord.y);
+	gl_Position = draw.modelViewProjectionMatrix * instanceMatrix * vec4(position, 1.0f);	
+	ePosition = (draw.modelViewMatrix * instanceMatrix * vec4(position, 1.0f)).rgb;
+	eNormal = (normalMatrix * vec4(normal, 0.0f)).rgb;
+
+	fTexCoord = texCoord;
+	fInvTexCoord = vec2(texCoord.x, 1.0f - texCoord.y);
 
 	#ifdef PHONG_SHADING_MODE
 	
 	#elif defined (NORMAL_MAPPING_MODE)
-	eTangent = (normalMatrix * vec4(mTangent, 1.0f)).rgb;
-	eBitangent = (normalMatrix * vec4(mBitangent, 1.0f)).rgb;
+	vec3 tangent = COMPACT_VERTICES ? decodeOctahedral(mTangent.xy) : mTangent;
+	vec3 bitangent = COMPACT_VERTICES ? (mPosition.w > 0.5f ? 1.0f : -1.0f) * cross(normal, tangent) : mBitangent;
+
+	eTangent = (normalMatrix * vec4(tangent, 0.0f)).rgb;
+	eBitangent = (normalMatrix * vec4(bitangent, 0.0f)).rgb;
 	#else
 	computeShading(ePosition, eNormal);
 	#endif
@@ -1,27 +1,41 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 30, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifdef NO_SHADING_MODE
-flat in vec4 diffColor;
+layout (location = 8) flat in vec4 diffColor;
 #elif defined (FLAT_SHADING_MODE)
-flat in vec4 diffColor;
-flat in vec3 specColor, emissColor;
+layout (location = 8) flat in vec4 diffColor;
+layout (location = 9) flat in vec3 specColor;
+layout (location = 10) flat in vec3 emissColor;
 #elif defined (GOURAUD_SHADING_MODE)
-smooth in vec4 diffColor;
-smooth in vec3 specColor, emissColor;
+layout (location = 8) smooth in vec4 diffColor;
+layout (location = 9) smooth in vec3 specColor;
+layout (location = 10) smooth in vec3 emissColor;
 #endif
 
-uniform bool hasDiffuseTexture, hasSpecularTexture, hasEmissiveTexture;
-uniform bool diffuseCompressed, specularCompressed, emissiveCompressed;
-uniform sampler2D diffuseTexSampler, specularTexSampler, emissiveTexSampler;
+// texture units defined also in MainShaderManager.cpp
+layout (location = 6, binding = 0) uniform sampler2D diffuseTexSampler;
+layout (location = 7, binding = 1) uniform sampler2D specularTexSampler;
+layout (location = 8, binding = 2) uniform sampler2D emissiveTexSampler;
 
 #ifdef NORMAL_MAPPING_MODE
-const float EPSILON = 0.01f;
+const float NORMAL_EPSILON = 0.01f;
 
-uniform bool hasNormalMapTexture, normalMapCompressed;
-uniform sampler2D normalMapTexSampler;
+layout (location = 9, binding = 3) uniform sampler2D normalMapTexSampler;
+#endif
+
+// virtual textures (see 'VirtualTexture'): the texture sampler reads the atlas of resident pages, the page table has
+// one texel per page and level (atlas slot x, y, level of the resident page: the page or its nearest resident ancestor)
+const float VT_TILE_SIZE = 128.0f, VT_TILE_BORDER = 4.0f; // defined also in PageFile.cpp
+
+layout (location = 10, binding = 4) uniform usampler2D diffusePageTableSampler;
+layout (location = 11, binding = 5) uniform usampler2D specularPageTableSampler;
+layout (location = 12, binding = 6) uniform usampler2D emissivePageTableSampler;
+
+#ifdef NORMAL_MAPPING_MODE
+layout (location = 13, binding = 7) uniform usampler2D normalMapPageTableSampler;
 #endif
 
 void computeShading(vec3 position, vec3 normal, vec3 tangent, vec3 bitangent, vec3 tNormal,
@@ -62,17 +76,50 @@ void computeShadingTangent(vec3 position, vec3 normal, vec3 tangent, vec3 bitang
 
 
 
+// uv in [0, 1); bilinear inside the page (its border covers the filter)
+vec4 sampleVirtualLevel(sampler2D atlas, usampler2D pageTable, vec2 uv, int level) {
+	ivec2 nPages = textureSize(pageTable, level);
+	uvec4 entry = texelFetch(pageTable, min(ivec2(uv * vec2(nPages)), nPages - 1), level);
+	int residentLevel = int(entry.z);
+
+	vec2 texel = uv * vec2(textureSize(pageTable, 0)) * VT_TILE_SIZE * exp2(-float(residentLevel));
+	vec2 page = min(floor(texel / VT_TILE_SIZE), vec2(textureSize(pageTable, residentLevel) - 1));
+
+	vec2 atlasTexel = vec2(entry.xy) * (VT_TILE_SIZE + 2.0f * VT_TILE_BORDER) + VT_TILE_BORDER + texel - page * VT_TILE_SIZE;
+	return textureLod(atlas, atlasTexel / vec2(textureSize(atlas, 0)), 0.0f);
+}
+
+
+
+// trilinear: the two levels around the mip level of the fragment (the page table has the levels of the texture);
+// virtual textures repeat
+vec4 sampleVirtualTexture(sampler2D atlas, usampler2D pageTable, vec2 texCoord) {
+	vec2 size = vec2(textureSize(pageTable, 0)) * VT_TILE_SIZE;
+	float lod = log2(max(max(length(dFdx(texCoord) * size), length(dFdy(texCoord) * size)), 1.0f));
+	lod = min(lod, float(textureQueryLevels(pageTable) - 1));
+
+	int level = int(lod);
+	vec2 uv = fract(texCoord);
+
+	return mix(sampleVirtualLevel(atlas, pageTable, uv, level),
+		       sampleVirtualLevel(atlas, pageTable, uv, min(level + 1, textureQueryLevels(pageTable) - 1)), fract(lod));
+}
+
+
+
 #ifdef NORMAL_MAPPING_MODE
 vec3 getNormalInTangentSpace(vec2 texCoord, vec2 invTexCoord, float gamma) {
-	vec3 normal;
-	if(normalMapCompressed)
-		normal = texture(normalMapTexSampler, invTexCoord).rgb;
-	else {
-		normal = texture(normalMapTexSampler, texCoord).rgb;
-		normal = pow(normal, vec3(gamma));
+	// DDS textures are stored top-down, see 'ColorTexture'
+	vec3 normal = NORMAL_MAP_VIRTUAL ? sampleVirtualTexture(normalMapTexSampler, normalMapPageTableSampler, texCoord).rgb
+		                             : texture(normalMapTexSampler, NORMAL_MAP_COMPRESSED ? invTexCoord : texCoord).rgb;
+	if (!NORMAL_MAP_COMPRESSED) normal = pow(normal, vec3(gamma));
+	// two channel normal maps (BC5, see 'TextureCooker') store x and y only, blue reads 0
+	else if (normal.b == 0.0f) {
+		vec2 xy = 2.0f * normal.rg - 1.0f;
+		normal.b = 0.5f + 0.5f * sqrt(max(1.0f - dot(xy, xy), 0.0f));
 	}
 
-	if (length (normal) > EPSILON)
+	if (length (normal) > NORMAL_EPSILON)
 		return normalize (2.0f * normal - 1.0f);
 	else return vec3(0.0f, 0.0f, 0.0f);
 }
@@ -82,37 +129,25 @@ vec3 getNormalInTangentSpace(vec2 texCoord, vec2 invTexCoord, float gamma) {
 
 void textureMapping (vec2 texCoord, vec2 invTexCoord, float gamma, 
 	                 inout vec4 color, inout vec3 specularColor, inout vec3 emissiveColor) {
-	if (hasDiffuseTexture) {
-		vec4 tex;
-		if(diffuseCompressed)
-			tex = texture(diffuseTexSampler, invTexCoord);
-		else {
-			tex = texture(diffuseTexSampler, texCoord);
-			tex.rgb = pow(tex.rgb, vec3(gamma));
-		}
+	// DDS textures are stored top-down, see 'ColorTexture'
+	if (HAS_DIFFUSE_TEXTURE) {
+		vec4 tex = DIFFUSE_VIRTUAL ? sampleVirtualTexture(diffuseTexSampler, diffusePageTableSampler, texCoord)
+		                           : texture(diffuseTexSampler, DIFFUSE_COMPRESSED ? invTexCoord : texCoord);
+		if (!DIFFUSE_COMPRESSED) tex.rgb = pow(tex.rgb, vec3(gamma));
 		color *= tex;
 	}
 
-	if (hasSpecularTexture) {
-		vec3 tex;
-		if(specularCompressed)
-			tex = texture(specularTexSampler, invTexCoord).rgb;
-		else {
-			tex = texture(specularTexSampler, texCoord).rgb;
-			tex = pow(tex, vec3(gamma));
-		}
+	if (HAS_SPECULAR_TEXTURE) {
+		vec3 tex = SPECULAR_VIRTUAL ? sampleVirtualTexture(specularTexSampler, specularPageTableSampler, texCoord).rgb
+		                            : texture(specularTexSampler, SPECULAR_COMPRESSED ? invTexCoord : texCoord).rgb;
+		if (!SPECULAR_COMPRESSED) tex = pow(tex, vec3(gamma));
 		specularColor *= tex;
 	}
 
-	if (hasEmissiveTexture) {
-		vec3 tex;
-		if (emissiveCompressed) 
-			tex = texture(emissiveTexSampler, invTexCoord).rgb;
-		else {
-			tex = texture(emissiveTexSampler, texCoord).rgb;
-			tex = pow(tex, vec3(gamma));
-		}
-
+	if (HAS_EMISSIVE_TEXTURE) {
+		vec3 tex = EMISSIVE_VIRTUAL ? sampleVirtualTexture(emissiveTexSampler, emissivePageTableSampler, texCoord).rgb
+		                            : texture(emissiveTexSampler, EMISSIVE_COMPRESSED ? invTexCoord : texCoord).rgb;
+		if (!EMISSIVE_COMPRESSED) tex = pow(tex, vec3(gamma));
 		emissiveColor *= tex;
-	}	
+	}
 }
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 // constants defined also in Material.h
@@ -83,14 +83,14 @@ void computeShading(vec3 position, vec3 normal, vec3 tangent, vec3 bitangent, ve
 	vec3 diffuse = light.diffuseColor * NdotL;
 	vec3 specular = light.specularColor * powNdotH;	
 
-	if (scene.ambientLightOn) color.rgb += ambient * material.ambientColor;
-	if (scene.diffuseLightOn) color.rgb += diffuse * material.diffuseColor;
+	if (AMBIENT_LIGHT_ON) color.rgb += ambient * material.ambientColor;
+	if (DIFFUSE_LIGHT_ON) color.rgb += diffuse * material.diffuseColor;
 	color.rgb = min(color.rgb, 1.0f);
 
-	if (material.shadingModel == PHONG && scene.specularLightOn)
+	if (material.shadingModel == PHONG && SPECULAR_LIGHT_ON)
 		specularColor = specular * material.specularColor;
 
-	if (scene.emissiveLightOn) emissiveColor = material.emissiveColor;	
+	if (EMISSIVE_LIGHT_ON) emissiveColor = material.emissiveColor;
 	
 	// transition between day and night
 	NdotL = 0.0f, powNdotH = 0.0f;
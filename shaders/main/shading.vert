@@ -1,16 +1,18 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 30, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifdef NO_SHADING_MODE
-flat out vec4 diffColor;
+layout (location = 8) flat out vec4 diffColor;
 #elif defined (FLAT_SHADING_MODE)
-flat out vec4 diffColor;
-flat out vec3 specColor, emissColor;
+layout (location = 8) flat out vec4 diffColor;
+layout (location = 9) flat out vec3 specColor;
+layout (location = 10) flat out vec3 emissColor;
 #elif defined (GOURAUD_SHADING_MODE)
-smooth out vec4 diffColor;
-smooth out vec3 specColor, emissColor;
+layout (location = 8) smooth out vec4 diffColor;
+layout (location = 9) smooth out vec3 specColor;
+layout (location = 10) smooth out vec3 emissColor;
 #endif
 
 void computeShading(vec3 position, vec3 normal, vec3 tangent, vec3 bitangent, vec3 tNormal,
@@ -1,8 +1,33 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
+// features of the program permutation, in the bit order of 'MainProgram::Feature': constants of the header of the
+// GLSL source (see 'MainProgram.getFeatureHeader'), specialization constants of the SPIR-V modules
+// (see 'shaders/spirv/build.bat'); the branches on them are removed by the compiler
+#ifdef GL_SPIRV
+layout (constant_id = 0) const bool HAS_DIFFUSE_TEXTURE = false;
+layout (constant_id = 1) const bool HAS_SPECULAR_TEXTURE = false;
+layout (constant_id = 2) const bool HAS_EMISSIVE_TEXTURE = false;
+layout (constant_id = 3) const bool HAS_NORMAL_MAP_TEXTURE = false;
+layout (constant_id = 4) const bool DIFFUSE_COMPRESSED = false;
+layout (constant_id = 5) const bool SPECULAR_COMPRESSED = false;
+layout (constant_id = 6) const bool EMISSIVE_COMPRESSED = false;
+layout (constant_id = 7) const bool NORMAL_MAP_COMPRESSED = false;
+layout (constant_id = 8) const bool TWO_SIDED = false;
+layout (constant_id = 9) const bool AMBIENT_LIGHT_ON = false;
+layout (constant_id = 10) const bool DIFFUSE_LIGHT_ON = false;
+layout (constant_id = 11) const bool SPECULAR_LIGHT_ON = false;
+layout (constant_id = 12) const bool EMISSIVE_LIGHT_ON = false;
+layout (constant_id = 13) const bool DIFFUSE_VIRTUAL = false;
+layout (constant_id = 14) const bool SPECULAR_VIRTUAL = false;
+layout (constant_id = 15) const bool EMISSIVE_VIRTUAL = false;
+layout (constant_id = 16) const bool NORMAL_MAP_VIRTUAL = false;
+layout (constant_id = 17) const bool VIRTUAL_TEXTURE_FEEDBACK = false;
+layout (constant_id = 18) const bool COMPACT_VERTICES = false;
+#endif
+
 struct LIGHT {
   vec3 eDirection;
   vec3 ambientColor, diffuseColor, specularColor;
@@ -13,12 +38,38 @@ struct MATERIAL {
   vec3 ambientColor, diffuseColor, specularColor, emissiveColor;
   float shininess;
   float opacity;
+  bool hasDiffuseTexture, hasSpecularTexture, hasEmissiveTexture, hasNormalMapTexture;
+  bool diffuseCompressed, specularCompressed, emissiveCompressed, normalMapCompressed;
+};
+
+// per-draw data, defined also in MeshBatch.h
+struct DRAW {
+  mat4 modelViewMatrix, modelViewProjectionMatrix, normalMatrix;
+  vec4 positionOffset, positionScale; // compact vertices: position = offset + scale * unorm position (xyz)
+  vec4 texCoordRange; // compact vertices: texture coordinates = xy + zw * unorm coordinates
+  uint materialId;
 };
 
-struct SCENE {
-  bool ambientLightOn, diffuseLightOn, specularLightOn, emissiveLightOn;	
+// per-frame data, defined also in MainShaderManager.h
+layout (std140, binding = 0) uniform FrameBlock {
+  LIGHT light;
 };
 
-uniform LIGHT light;
-uniform MATERIAL material;
-uniform SCENE scene;
+layout (std430, binding = 0) readonly buffer DrawBuffer { DRAW draws[]; };
+layout (std430, binding = 1) readonly buffer MaterialBuffer { MATERIAL materials[]; };
+
+// explicit uniform locations and bindings (the SPIR-V modules have no names), see 'MainProgram'
+layout (location = 0) uniform uint drawIdOffset;
+
+MATERIAL material; // set in main()
+
+
+
+// compact vertices (see 'MeshBatch'): the normals and tangents are folded on the octahedron |x| + |y| + |z| = 1
+vec3 decodeOctahedral(vec2 octahedral) {
+	vec3 vector = vec3(octahedral, 1.0f - abs(octahedral.x) - abs(octahedral.y));
+	float fold = max(-vector.z, 0.0f);
+	vector.xy += vec2(vector.x >= 0.0f ? -fold : fold, vector.y >= 0.0f ? -fold : fold);
+
+	return normalize(vector);
+}
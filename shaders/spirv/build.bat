@@ -0,0 +1,66 @@
+@echo off
+rem Author: Oldrin Barbulescu
+rem Last modified: Oct 17, 2026
+rem
+rem SPIR-V modules of 'shaders/main', one per program mode and stage (pre-build step of BlueMarble.vcxproj).
+rem The files of a stage are concatenated in the order of 'main.cpp' and compiled with the '#define' of the mode;
+rem the features of a permutation are specialization constants (see 'structures.glsl'), set at load time.
+rem Without glslangValidator (Vulkan SDK) nothing is built and the program compiles the source code.
+
+setlocal enabledelayedexpansion
+
+set "OUT=%~dp0"
+set "SRC=%~dp0..\main"
+
+set "GLSLANG=glslangValidator"
+if defined VULKAN_SDK set "GLSLANG=%VULKAN_SDK%\Bin\glslangValidator.exe"
+where "%GLSLANG%" >nul 2>nul || if not exist "%GLSLANG%" (
+	echo SPIR-V modules: glslangValidator not found, skipped.
+	exit /b 0
+)
+
+rem name, mode defines, vertex files, fragment files (tessellation files: 'globe' only)
+call :module noShading     "NO_SHADING_MODE"                 "shading.vert scene.vert"              "shading.frag scene.frag" || exit /b 1
+call :module flat          "FLAT_SHADING_MODE"               "shading.glsl shading.vert scene.vert" "shading.frag scene.frag" || exit /b 1
+call :module gouraud       "GOURAUD_SHADING_MODE"            "shading.glsl shading.vert scene.vert" "shading.frag scene.frag" || exit /b 1
+call :module phong         "PHONG_SHADING_MODE"              "scene.vert"                           "shading.glsl shading.frag scene.frag" || exit /b 1
+call :module normalMapping "NORMAL_MAPPING_MODE"             "scene.vert"                           "shading.glsl shading.frag scene.frag" || exit /b 1
+call :module planet        "NORMAL_MAPPING_MODE PLANET_MODE" "planet.vert"                          "shading.glsl shading.frag scene.frag" || exit /b 1
+call :module globe         "NORMAL_MAPPING_MODE"             "globe.vert"                           "shading.glsl shading.frag scene.frag" || exit /b 1
+call :stage globe tesc "NORMAL_MAPPING_MODE" "globe.tesc" || exit /b 1
+call :stage globe tese "NORMAL_MAPPING_MODE" "globe.tese" || exit /b 1
+
+echo SPIR-V modules: built.
+exit /b 0
+
+
+
+:module
+call :stage %1 vert %2 %3 || exit /b 1
+call :stage %1 frag %2 %4 || exit /b 1
+exit /b 0
+
+
+
+rem %1 name, %2 stage, %3 mode defines, %4 files (after 'structures.glsl')
+:stage
+set "UNIT=%TEMP%\BlueMarble_%1.%2"
+set "DEFINES="
+for %%d in (%~3) do set "DEFINES=!DEFINES! -D%%d"
+
+> "%UNIT%" echo #version 460 core
+type "%SRC%\structures.glsl" >> "%UNIT%"
+for %%f in (%~4) do (
+	echo.>> "%UNIT%"
+	type "%SRC%\%%f" >> "%UNIT%"
+)
+
+"%GLSLANG%" -G -S %2 !DEFINES! -o "%OUT%%1.%2.spv" "%UNIT%" >nul || (
+	echo SPIR-V modules: %1.%2 failed.
+	"%GLSLANG%" -G -S %2 !DEFINES! "%UNIT%"
+	del "%UNIT%"
+	exit /b 1
+)
+
+del "%UNIT%"
+exit /b 0
@@ -0,0 +1,90 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+// Texture cooker: TextureCooker.exe <directory> <image>[:bc1|bc3|bc4|bc5|bc7] ...
+// each image is cooked into '<image>.dds' (see 'TextureCooker'), the format chosen from the image when not given;
+// without images, the textures of the Earth material are cooked.
+
+#include <GL/gl3w.h>
+
+#include "texture/cooker/TextureCooker.h"
+
+#include <IL/il.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::exception;
+using std::runtime_error;
+using std::size_t;
+using std::string;
+using std::vector;
+
+using Clock = std::chrono::steady_clock;
+
+
+
+const string kDefaultDirectory("model/earth");
+const vector<string> kDefaultImages({ "land_ocean_ice_8192.png", "specular_map_8192.png:bc4",
+	                                  "land_ocean_ice_lights_8192.tif", "normal_map_4096.jpg:bc5",
+	                                  "cloud_combined_8192.png" });
+
+
+
+TextureCooker::Format getFormat(const string& kName);
+
+
+
+int main(int argc, char** argv) {
+	int exitStatus = EXIT_SUCCESS;
+
+	string directory = (argc > 1) ? string(argv[1]) : ::kDefaultDirectory;
+	vector<string> images;
+	for (int i = 2; i < argc; i++) images.push_back(string(argv[i]));
+	if (images.empty()) images = ::kDefaultImages;
+
+	ilInit();
+
+	Clock::time_point start = Clock::now();
+
+	for (const string& kImage : images) {
+		size_t pos = kImage.rfind(':');
+		string fileName = (pos == string::npos) ? kImage : kImage.substr(0u, pos);
+
+		try {
+			TextureCooker::Format format = (pos == string::npos) ? TextureCooker::Format::AUTO
+				                                                 : getFormat(kImage.substr(pos + 1u));
+			TextureCooker::cook(directory, fileName, format);
+		}
+		catch (const exception& kException) {
+			cerr << "main > " << kException.what() << endl;
+			exitStatus = EXIT_FAILURE;
+		}
+	}
+
+	cout << "Time: " << std::chrono::duration<float>(Clock::now() - start).count() << " s." << endl;
+
+	ilShutDown();
+	return exitStatus;
+}
+
+
+
+TextureCooker::Format getFormat(const string& kName) {
+	if (kName == "bc1") return TextureCooker::Format::BC1;
+	else if (kName == "bc3") return TextureCooker::Format::BC3;
+	else if (kName == "bc4") return TextureCooker::Format::BC4;
+	else if (kName == "bc5") return TextureCooker::Format::BC5;
+	else if (kName == "bc7") return TextureCooker::Format::BC7;
+	else throw runtime_error("main::getFormat|Unknown format '" + kName + "'.");
+}
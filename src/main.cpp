@@ -1,13 +1,15 @@
 ﻿/**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 5, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include <GL/gl3w.h>
 #include <GLFW/glfw3.h>
 
+#include "scene/info/GlDebug.h"
 #include "scene/shader/shaderProgram/MainProgram.h"
 #include "scene/shader/shaderProgram/Text2dProgram.h"
+#include "scene/state/GlState.h"
 #include "scene/Scene.h"
 
 #include <assimp/postprocess.h>
@@ -15,15 +17,23 @@
 
 #include <IL/il.h>
 
+#include <glm/mat4x4.hpp>
+#include <glm/trigonometric.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include <glm/ext/matrix_transform.hpp>
+
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <random>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
+using glm::mat4;
 using glm::uvec2;
 using glm::vec3;
 
@@ -31,12 +41,15 @@ using std::cerr;
 using std::cout;
 using std::endl;
 using std::exception;
+using std::exception_ptr;
 using std::exit;
 using std::runtime_error;
 using std::size_t;
 using std::string;
 using std::system;
+using std::thread;
 using std::to_string;
+using std::vector;
 
 
 
@@ -46,8 +59,14 @@ const float kDeltaTranslation(0.02f), kDeltaRotation(2.0f), kDeltaFieldOfView(5.
 const float kKeyRepeatSpeed(3.0f);
 const float kMouseCursorSpeed(0.25f);
 const float kDefaultFieldOfView = 45.0f;
+#ifdef _DEBUG
+const unsigned int kBenchmarkFrames(100u);
+#endif
+const bool kShowSmallBodies(false); // instanced belt of small bodies around the planet (instanced draw demo)
+const unsigned int kNumSmallBodies(100000u);
 
 Scene* pScene = nullptr;
+GLFWwindow* pCompileWindow = nullptr; // hidden, its context shares the objects of the main one
 int windowsIsIconified = GLFW_FALSE;
 bool mouseButtonIsPressed = false;
 string glfwError = "";
@@ -57,6 +76,7 @@ string glfwError = "";
 // SCENE ###################################################################################
 // http://earthobservatory.nasa.gov/Features/BlueMarble/BlueMarble_2002.php
 const string kSceneFilePath = "earth"; const string kSceneFileNames[] = { "spheres.obj" };
+const string kSmallBodyFileName = "asteroid.obj";
 //###########################################################################################
 
 
@@ -64,6 +84,8 @@ const string kSceneFilePath = "earth"; const string kSceneFileNames[] = { "spher
 void render();
 void clean();
 
+vector<mat4> createSmallBodyTransforms(unsigned int nBodies);
+
 void resizeCallback(GLFWwindow*, int, int);
 void iconifyCallback(GLFWwindow*, int);
 void keyboardCallback(GLFWwindow*, int, int, int, int);
@@ -91,7 +113,7 @@ void init() {
 
 		// initialize shaders
 		//###########################################################################################		
-		const string kVersion = "#version 330 core\n";
+		const string kVersion = "#version 460 core\n";
 
 		string path = "shaders/main";
 		
@@ -124,13 +146,44 @@ void init() {
 		::pScene->addShaderSourceCode(programMode, path, { "structures.glsl", "scene.vert" }, kVersion + directive,
 														 { "structures.glsl", "shading.frag", "scene.frag" }, kVersion + directive);
 
+		programMode = MainProgram::ProgramMode::PLANET;
+		directive = "#define NORMAL_MAPPING_MODE\n#define PLANET_MODE\n";
+		::pScene->addFragmentShaderSourceCode(programMode, path, { "structures.glsl", "shading.glsl" }, kVersion + directive);
+		::pScene->addShaderSourceCode(programMode, path, { "structures.glsl", "planet.vert" }, kVersion + directive,
+														 { "structures.glsl", "shading.frag", "scene.frag" }, kVersion + directive);
+
+		programMode = MainProgram::ProgramMode::GLOBE;
+		directive = "#define NORMAL_MAPPING_MODE\n";
+		::pScene->addFragmentShaderSourceCode(programMode, path, { "structures.glsl", "shading.glsl" }, kVersion + directive);
+		::pScene->addShaderSourceCode(programMode, path, { "structures.glsl", "globe.vert" }, kVersion + directive,
+														 { "structures.glsl", "shading.frag", "scene.frag" }, kVersion + directive);
+		::pScene->addTessellationShaderSourceCode(programMode, path, { "structures.glsl", "globe.tesc" }, kVersion + directive,
+																	 { "structures.glsl", "globe.tese" }, kVersion + directive);
+
+		// SPIR-V modules of the same shaders (pre-build step 'shaders/spirv/build.bat'), used instead of the source code
+		// if the driver supports them
+		path = "shaders/spirv";
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::NO_SHADING, path, "noShading");
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::FLAT, path, "flat");
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::GOURAUD, path, "gouraud");
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::PHONG, path, "phong");
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::NORMAL_MAPPING, path, "normalMapping");
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::PLANET, path, "planet");
+		::pScene->addShaderBinaries(MainProgram::ProgramMode::GLOBE, path, "globe");
+
 		path = "shaders/text2D";
 		Text2dProgram::ProgramMode text2dProgramMode = Text2dProgram::ProgramMode::TEXT_2D;
 		::pScene->addShaderSourceCode(text2dProgramMode, path, { "text2D.vert" }, kVersion, { "text2D.frag" }, kVersion);
 
-		::pScene->compileShaders();
-		
-	
+		// the 8192 x 4096 earth textures are streamed, see 'VirtualTexture'
+		::pScene->setVirtualTexturing(4096);
+
+		// the first frame is drawn before the textures are decoded, see 'Scene.setAsyncTextureLoading'
+		::pScene->setAsyncTextureLoading(true);
+
+		// quantized vertices and 16-bit indices, see 'Scene.setCompactVertices'
+		::pScene->setCompactVertices(true);
+
 		// initialize model
 		//###########################################################################################
 		unsigned int postProcessSteps =
@@ -156,7 +209,8 @@ void init() {
 		unsigned int nModels = sizeof(kSceneFileNames) / sizeof(kSceneFileNames[0u]);
 		for (unsigned int i = 0u; i < nModels; i++)
 			::pScene->import3DModel("model/" + ::kSceneFilePath, ::kSceneFileNames[i], postProcessSteps);
-		::pScene->loadBufferData();
+		if (::kShowSmallBodies)
+			::pScene->import3DModel("model/" + ::kSceneFilePath, ::kSmallBodyFileName, postProcessSteps);
 
 		::pScene->setRotationSpeed(20.0f);
 
@@ -167,8 +221,44 @@ void init() {
 		::pScene->setMeshRotationSpeed(0, 1, 1.0f);
 		::pScene->rotateMesh(-1, -1, -90.0f, vec3(0.0f, 1.0f, 0.0f));
 		::pScene->scaleMesh(0, 1, vec3(1.008f));		
+		::pScene->setHorizonOccluder(0, 0);
+		::pScene->setPlanet(0, 0);
+		::pScene->setGlobe(0, 1);
+		if (::kShowSmallBodies) ::pScene->addInstances(static_cast<int>(nModels), 0, createSmallBodyTransforms(::kNumSmallBodies));
 
 		::pScene->initializeSceneParameters();
+
+
+		// the program permutations of the first frame (requested by 'initializeSceneParameters') are compiled by the
+		// driver threads with parallel shader compile, otherwise by a worker thread, while the vertex data is loaded
+		// and the textures decoded; each program is finished when first drawn
+		//###########################################################################################
+		thread compileThread;
+		exception_ptr pCompileException = nullptr;
+		if (::pCompileWindow)
+			compileThread = thread([&pCompileException]() {
+				glfwMakeContextCurrent(::pCompileWindow);
+				try {
+					::pScene->compileShaders();
+				}
+				catch (...) {
+					pCompileException = std::current_exception();
+				}
+				glFinish(); // complete before the main context uses the objects
+				glfwMakeContextCurrent(NULL);
+			});
+		else ::pScene->compileShaders();
+
+		try {
+			::pScene->loadBufferData();
+		}
+		catch (...) {
+			if (compileThread.joinable()) compileThread.join();
+			throw;
+		}
+
+		if (compileThread.joinable()) compileThread.join();
+		if (pCompileException) std::rethrow_exception(pCompileException);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("main::init > " + string(kException.what()));
@@ -225,11 +315,18 @@ int main(int, char**) {
 		cout << "DevIL version: " << ilGetInteger(IL_VERSION_NUM) << endl;
 		cout << "Assimp version: " << aiGetVersionMajor() << "." << aiGetVersionMinor() << endl;
 		cout << "GLM version: " << GLM_VERSION << endl;
+		cout << "Parallel shader compile: " << (GlState::hasParallelShaderCompile() ? "yes" : "no (worker thread)") << endl;
 		cout << endl;
 
+		if (!GlState::hasParallelShaderCompile()) {
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+			::pCompileWindow = glfwCreateWindow(1, 1, "", NULL, pWindow);
+			if (!::pCompileWindow) throw runtime_error("GLFW|Cannot create GLFW compile window.");
+		}
+
 		glEnable(GL_MULTISAMPLE);
-		glEnable(GL_DEPTH_TEST);
-		glDepthFunc(GL_LESS);
+		GlState::setDepthTest(true);
+		GlState::setDepthFunc(GL_LESS);
 
 		GLint dimensions[2u];
 		glGetIntegerv(GL_MAX_VIEWPORT_DIMS, dimensions);
@@ -242,7 +339,7 @@ int main(int, char**) {
 		while (!glfwWindowShouldClose(pWindow)) {
 			if (::windowsIsIconified == GLFW_FALSE) {
 				render();
-				glfwSwapBuffers(pWindow);				
+				glfwSwapBuffers(pWindow);
 			}
 			glfwPollEvents();
 		}
@@ -256,6 +353,7 @@ int main(int, char**) {
 	clean();
 
 	if (glfw == GLFW_TRUE) {
+		if (::pCompileWindow) glfwDestroyWindow(::pCompileWindow);
 		if (pWindow) glfwDestroyWindow(pWindow);
 		glfwTerminate();
 	}
@@ -307,6 +405,28 @@ void clean() {
 
 
 
+// a belt of small bodies around the earth (scene space: the earth radius is about 0.5), fixed seed
+vector<mat4> createSmallBodyTransforms(unsigned int nBodies) {
+	std::mt19937 generator(1u);
+	std::uniform_real_distribution<float> angle(0.0f, 360.0f), distance(0.6f, 0.8f), height(-0.03f, 0.03f),
+	                                      scale(0.3f, 1.0f);
+
+	vector<mat4> transforms;
+	transforms.reserve(nBodies);
+
+	for (unsigned int i = 0u; i < nBodies; i++) {
+		mat4 transform = glm::rotate(mat4(1.0f), glm::radians(angle(generator)), vec3(0.0f, 1.0f, 0.0f));
+		transform = glm::translate(transform, vec3(distance(generator), height(generator), 0.0f));
+		transform = glm::rotate(transform, glm::radians(angle(generator)), glm::normalize(vec3(1.0f, 1.0f, 0.0f)));
+
+		transforms.push_back(glm::scale(transform, vec3(scale(generator))));
+	}
+
+	return transforms;
+}
+
+
+
 void resizeCallback(GLFWwindow* pWindow, int width, int height) {
 	if (::windowsIsIconified == GLFW_FALSE) {
 		if (width > 0 && height > 0) {
@@ -423,10 +543,22 @@ void defaultKeyboardCallback(GLFWwindow* pWindow, int key, int action) {
 				break;
 			case GLFW_KEY_A: ::pScene->toggleAmbientLight();
 				break;
+#ifdef _DEBUG
+			case GLFW_KEY_B: ::pScene->benchmarkGlobeTessellation(::kBenchmarkFrames);
+				break;
+#endif
+			case GLFW_KEY_C: ::pScene->toggleInstanceCulling();
+				break;
 			case GLFW_KEY_D: ::pScene->toggleDiffuseLight();
 				break;
 			case GLFW_KEY_F: ::pScene->toggleEmissiveLight();
 				break;
+			case GLFW_KEY_G: cout << GlDebug::toString() << endl << ::pScene->getPlanetInfo() << endl
+				                  << ::pScene->getInstanceInfo() << endl << ::pScene->getVirtualTextureInfo() << endl
+				                  << "Textures loading: " << ::pScene->getNumLoadingTextures() << endl
+				                  << "Programs linking: " << ::pScene->getNumLinkingPrograms() << " ("
+				                  << ProgramCache::toString() << ")" << endl;
+				break;
 			case GLFW_KEY_I: ::pScene->toggleDisplayInfo();
 				break;
 			case GLFW_KEY_N: ::pScene->toggleNormalMapping();
@@ -435,6 +567,10 @@ void defaultKeyboardCallback(GLFWwindow* pWindow, int key, int action) {
 				break;
 			case GLFW_KEY_S: ::pScene->toggleSpecularLight();
 				break;
+			case GLFW_KEY_T: ::pScene->toggleGlobeTessellation();
+				break;
+			case GLFW_KEY_V: GlDebug::toggleValidation();
+				break;
 			case GLFW_KEY_W: ::pScene->toggleWireframe();
 				break;
 			case GLFW_KEY_ESCAPE: glfwSetWindowShouldClose(pWindow, GL_TRUE);
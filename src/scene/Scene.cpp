@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 5, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Scene.h"
@@ -23,11 +23,22 @@ float Scene::getMaxVerticalRotationAngle_() {
 
 
 
+// a material whose textures are still loading is drawn with its colors (as if it had no textures)
+const ColorTexture* Scene::getResidentTexture_(const ColorTexture* pkTexture) {
+	return (pkTexture && pkTexture->isResident()) ? pkTexture : nullptr;
+}
+
+
+
 Scene::Scene(const uvec2& kWindowSize):
 	         perspectiveCameras_(), cameras_(), pActiveCamera_(nullptr),
 	         directionalLights_(), lights_(), materials_(), meshes_(),
 	         diffuseTextures_(), specularTextures_(), emissiveTextures_(), normalMapTextures_(),
-	         pMainShaderManager_(nullptr), pInfo_(nullptr),
+	         frustum_(), pkOccluder_(nullptr), occluderRadius_(0.0f), visibleDraws_(), pkPlanetMesh_(nullptr), pPlanet_(nullptr),
+	         pkGlobeMesh_(nullptr), isGlobeTessellation_(false), tessellationEdgeLength_(8.0f), fixedTessellationLevel_(0.0f),
+	         meshInstances_(), isInstanceCulling_(true),
+	         virtualTextures_(), pFeedbackBuffer_(nullptr), feedbackPixels_(), nFeedbackFrames_(0u),
+	         pMainShaderManager_(nullptr), pMeshBatch_(nullptr), pInfo_(nullptr),
 	         rotationMatrix_(mat4(1.0f)), cursorRotationMatrix_(mat4(1.0f)), rotationAngle_(0.0f), rotationSpeed_(0.0f),
 	         cursorRotationAngleX_(0.0f), cursorRotationAngleY_(0.0f), isRotating_(false),	         
 	         lastStartTime_(0.0), lastStopTime_(0.0), lastResetTime_(0.0),
@@ -36,18 +47,22 @@ Scene::Scene(const uvec2& kWindowSize):
 	         hasAmbientColor_(false), hasDiffuseColor_(false), hasSpecularColor_(false), hasEmissiveColor_(false),
 	         ambientOn_(false), diffuseOn_(false), specularOn_(false), emissiveOn_(false),
 	         hasNormalMapping_(false), isNormalMapping_(false),
-	         windowSize_(kWindowSize), aspectRatio_(1.0f) {
+	         sceneRadius_(0.5f), windowSize_(kWindowSize), aspectRatio_(1.0f) {
 
 	if (kWindowSize.x == 0u || kWindowSize.y == 0u)
 		throw runtime_error("Scene|Invalid window size value.");
 	aspectRatio_ = static_cast<float>(kWindowSize.x) / static_cast<float>(kWindowSize.y);
 
+	VirtualTexture::setScreenSize(kWindowSize);
+
 	try {
 		pMainShaderManager_ = new MainShaderManager(kWindowSize);
+		pMeshBatch_ = new MeshBatch();
 		pInfo_ = new Info(kWindowSize);
 	}
 	catch (const exception& kException) {
 		if (pMainShaderManager_) delete pMainShaderManager_;
+		if (pMeshBatch_) delete pMeshBatch_;
 		if (pInfo_) delete pInfo_;
 
 		throw runtime_error("Scene > " + string(kException.what()));
@@ -60,7 +75,12 @@ Scene::Scene(const uvec2& kWindowSize):
 
 Scene::~Scene() {
 	delete pMainShaderManager_;
+	delete pMeshBatch_;
 	delete pInfo_;
+	if (pPlanet_) delete pPlanet_;
+	for (MeshInstances* iMeshInstances : meshInstances_)
+		if (iMeshInstances) delete iMeshInstances;
+	if (pFeedbackBuffer_) delete pFeedbackBuffer_;
 
 	cout << "Scene deleted." << endl;
 }
@@ -105,6 +125,35 @@ void Scene::addFragmentShaderSourceCode(MainProgram::ProgramMode programMode, co
 
 
 
+void Scene::addTessellationShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
+	                                        const list<string>& kTessControlShaderFileList,
+	                                        const string& kTessControlShaderHeader,
+	                                        const list<string>& kTessEvaluationShaderFileList,
+	                                        const string& kTessEvaluationShaderHeader) const {
+	try {
+		pMainShaderManager_->addTessellationShaderSourceCode(programMode, kPath, kTessControlShaderFileList,
+			                                                 kTessControlShaderHeader, kTessEvaluationShaderFileList,
+			                                                 kTessEvaluationShaderHeader);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.addTessellationShaderSourceCode > " + string(kException.what()));
+	}
+}
+
+
+
+void Scene::addShaderBinaries(MainProgram::ProgramMode programMode, const string& kPath,
+	                          const string& kModuleName) const {
+	try {
+		pMainShaderManager_->addShaderBinaries(programMode, kPath, kModuleName);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.addShaderBinaries > " + string(kException.what()));
+	}
+}
+
+
+
 void Scene::addShaderSourceCode(Text2dProgram::ProgramMode programMode, const string& kPath,
 	                            const list<string>& kVertexShaderFileList, const string& kVertexShaderHeader,
 	                            const list<string>& kFragmentShaderFileList, const string& kFragmentShaderHeader) const {
@@ -144,16 +193,13 @@ void Scene::addFragmentShaderSourceCode(Text2dProgram::ProgramMode programMode,
 
 
 void  Scene::compileShaders() const {
+	// programs found in the program cache skip compiling and linking: the first start is cold, the next ones are warm;
+	// the other programs are compiled and linked by the driver threads when it supports parallel shader compile.
+	// The main programs are permutations of the materials: those of the first frame are requested by
+	// 'initializeSceneParameters' (see 'requestPrograms_'), the other ones are compiled when first drawn
 	try {
-		pMainShaderManager_->compileShaders();
-
 		pInfo_->compileShaders();
-
-		pMainShaderManager_->linkProgram(MainProgram::ProgramMode::NO_SHADING);
-		pMainShaderManager_->linkProgram(MainProgram::ProgramMode::FLAT);
-		pMainShaderManager_->linkProgram(MainProgram::ProgramMode::GOURAUD);
-		pMainShaderManager_->linkProgram(MainProgram::ProgramMode::PHONG);
-		pMainShaderManager_->linkProgram(MainProgram::ProgramMode::NORMAL_MAPPING);		
+		pMainShaderManager_->compileShaders();
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Scene.compileShaders > " + string(kException.what()));
@@ -162,6 +208,12 @@ void  Scene::compileShaders() const {
 
 
 
+unsigned int Scene::getNumLinkingPrograms() const {
+	return pMainShaderManager_->getNumLinkingPrograms() + pInfo_->getNumLinkingPrograms();
+}
+
+
+
 void Scene::setText2DTexture(const string& kFilePath, const string& kFileName) const {
 	try {
 		pInfo_->setText2DTexture(kFilePath, kFileName);
@@ -173,13 +225,48 @@ void Scene::setText2DTexture(const string& kFilePath, const string& kFileName) c
 
 
 
+void Scene::setVirtualTexturing(GLsizei minSize) {
+	try {
+		VirtualTexture::setMinSize(minSize);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.setVirtualTexturing > " + string(kException.what()));
+	}
+}
+
+
+
+void Scene::setAsyncTextureLoading(bool on) {
+	ColorTexture::setAsyncLoading(on);
+}
+
+
+
+void Scene::setImportThreads(unsigned int nThreads) {
+	Model3D::setNumThreads(nThreads);
+}
+
+
+
+void Scene::setCompactVertices(bool on) {
+	try {
+		pMeshBatch_->setCompactVertices(on);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.setCompactVertices > " + string(kException.what()));
+	}
+}
+
+
+
+// the vertices are written straight into the buffers of the mesh batch, see 'loadBufferData'
 void Scene::import3DModel(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps) {
 	try {
 		Model3D model3D(kFilePath, kFileName, postProcessSteps, 0, false, false);
 
 		model3D.loadMaterials(materials_);
 		model3D.loadTextures(diffuseTextures_, specularTextures_, emissiveTextures_, normalMapTextures_);
-		model3D.loadMeshes(meshes_);
+		model3D.loadMeshes(meshes_, pMeshBatch_);
 		model3D.loadTransformations();
 	}
 	catch (const exception& kException) {
@@ -194,10 +281,14 @@ void Scene::import3DModel(const string& kFilePath, const string& kFileName, unsi
 
 void Scene::loadBufferData() {
 	try {
-		for (Mesh& iMesh : meshes_) {
-			iMesh.updateVertexBuffer();
-			pMainShaderManager_->setAttribPointers(&iMesh);
-		}
+		for (const Material& ikMaterial : materials_)
+			pMeshBatch_->addMaterial(&ikMaterial);
+
+		for (const Mesh& ikMesh : meshes_)
+			pMeshBatch_->addMesh(&ikMesh);
+
+		pMeshBatch_->updateVertexBuffer();
+		pMainShaderManager_->setAttribPointers(pMeshBatch_);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Scene.loadBufferData > " + string(kException.what()));
@@ -354,6 +445,86 @@ void Scene::setRotationSpeed(float value) {
 
 
 
+void Scene::setHorizonOccluder(int modelId, int meshId) {
+	const Mesh* pkMesh = getMesh_(static_cast<unsigned int>(modelId), static_cast<unsigned int>(meshId));
+	if (!pkMesh) throw runtime_error("Scene.setHorizonOccluder|Invalid model or mesh id value.");
+
+	// the smallest distance from the center to a face plane keeps the occluder inside the mesh
+	const vec3& kCenter = *(pkMesh->getBoundingSphereCenter());
+	float radius = pkMesh->getBoundingSphereRadius();
+
+	try {
+		for (unsigned int i = 0u; i < pkMesh->getNumFaces(); i++) {
+			const uvec3* pkFace = pkMesh->getFace(i);
+			vec3 vertex0 = *(pkMesh->getVertex(pkFace->x));
+			vec3 normal = glm::cross(*(pkMesh->getVertex(pkFace->y)) - vertex0, *(pkMesh->getVertex(pkFace->z)) - vertex0);
+
+			if (glm::length(normal) > 0.0f)
+				radius = std::min(radius, glm::abs(glm::dot(glm::normalize(normal), vertex0 - kCenter)));
+		}
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.setHorizonOccluder > " + string(kException.what()));
+	}
+
+	pkOccluder_ = pkMesh;
+	occluderRadius_ = radius;
+}
+
+
+
+void Scene::setPlanet(int modelId, int meshId) {
+	Mesh* pMesh = getMesh_(static_cast<unsigned int>(modelId), static_cast<unsigned int>(meshId));
+	if (!pMesh) throw runtime_error("Scene.setPlanet|Invalid model or mesh id value.");
+
+	try {
+		if (!pPlanet_) pPlanet_ = new Planet();
+		pMainShaderManager_->setAttribPointers(pPlanet_);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.setPlanet > " + string(kException.what()));
+	}
+
+	pkPlanetMesh_ = pMesh;
+}
+
+
+
+void Scene::setGlobe(int modelId, int meshId) {
+	const Mesh* pkMesh = getMesh_(static_cast<unsigned int>(modelId), static_cast<unsigned int>(meshId));
+	if (!pkMesh) throw runtime_error("Scene.setGlobe|Invalid model or mesh id value.");
+
+	pkGlobeMesh_ = pkMesh;
+}
+
+
+
+void Scene::addInstances(int modelId, int meshId, const vector<mat4>& kTransforms) {
+	const Mesh* pkMesh = getMesh_(static_cast<unsigned int>(modelId), static_cast<unsigned int>(meshId));
+	if (!pkMesh) throw runtime_error("Scene.addInstances|Invalid model or mesh id value.");
+	if (pkMesh == pkPlanetMesh_ || pkMesh == pkGlobeMesh_)
+		throw runtime_error("Scene.addInstances|The planet and globe meshes cannot have instances.");
+
+	// the draw ids follow the order of the meshes, see 'loadBufferData'
+	unsigned int drawId = 0u;
+	for (const Mesh& ikMesh : meshes_) {
+		if (&ikMesh == pkMesh) break;
+		drawId++;
+	}
+
+	if (meshInstances_.empty()) meshInstances_.assign(meshes_.size(), nullptr);
+
+	try {
+		if (!meshInstances_.at(drawId)) meshInstances_.at(drawId) = new MeshInstances();
+		meshInstances_.at(drawId)->addInstances(kTransforms);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.addInstances > " + string(kException.what()));
+	}
+}
+
+
+
 void Scene::initializeSceneParameters() {
 	if (pActiveCamera_) throw runtime_error("Scene.initializeSceneParameters|Scene parameters already initialized.");
 	if (cameras_.size() > 0u) pActiveCamera_ = getCamera_(0u);
@@ -388,6 +559,10 @@ void Scene::setWindowSize(const uvec2& kSize) {
 
 		pInfo_->setWindowSize(kSize);
 		updateDisplayInfo_();
+
+		// the atlases keep their size, only new virtual textures follow the window
+		VirtualTexture::setScreenSize(kSize);
+		if (pFeedbackBuffer_) pFeedbackBuffer_->setWindowSize(kSize);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Scene.setWindowSize > " + string(kException.what()));
@@ -540,6 +715,73 @@ void Scene::toggleNormalMapping() {
 
 
 
+void Scene::toggleGlobeTessellation() {
+	if (pkGlobeMesh_) {
+		isGlobeTessellation_ = !isGlobeTessellation_;
+		cout << "Globe tessellation " << (isGlobeTessellation_ ? "on" : "off") << "." << endl;
+	}
+}
+
+
+
+#ifdef _DEBUG
+// the scene is drawn 'nFrames' times per level (without the info text), waiting for the GPU after each frame
+void Scene::benchmarkGlobeTessellation(unsigned int nFrames) {
+	if (!pkGlobeMesh_) throw runtime_error("Scene.benchmarkGlobeTessellation|No globe mesh.");
+	if (!pActiveCamera_) throw runtime_error("Scene.benchmarkGlobeTessellation|Scene parameters not initialized yet.");
+	if (nFrames == 0u) throw runtime_error("Scene.benchmarkGlobeTessellation|Invalid number of frames value.");
+
+	bool isGlobeTessellation = isGlobeTessellation_;
+	isGlobeTessellation_ = true;
+
+	cout << "Globe tessellation benchmark (" << glGetString(GL_RENDERER) << ", " << nFrames << " frames per level):" << endl;
+
+	try {
+		// level 0: levels from the projected edge length
+		for (float level : { 0.0f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f }) {
+			fixedTessellationLevel_ = level;
+
+			std::chrono::steady_clock::time_point startTime;
+
+			for (unsigned int i = 0u; i <= nFrames; i++) {
+				if (i == 1u) startTime = std::chrono::steady_clock::now(); // first frame: warm-up
+
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				GlState::setBlend(true);
+				GlState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				renderScene_();
+				glFinish();
+			}
+
+			std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - startTime;
+			cout << "  level " << (level == 0.0f ? string("adaptive") : std::to_string(static_cast<int>(level))) << ": "
+				 << time.count() / static_cast<double>(nFrames) << " ms per frame" << endl;
+		}
+	}
+	catch (const exception& kException) {
+		fixedTessellationLevel_ = 0.0f;
+		isGlobeTessellation_ = isGlobeTessellation;
+
+		throw runtime_error("Scene.benchmarkGlobeTessellation > " + string(kException.what()));
+	}
+
+	fixedTessellationLevel_ = 0.0f;
+	isGlobeTessellation_ = isGlobeTessellation;
+	cout << endl;
+}
+#endif
+
+
+
+void Scene::toggleInstanceCulling() {
+	if (!meshInstances_.empty()) {
+		isInstanceCulling_ = !isInstanceCulling_;
+		cout << "Instance culling " << (isInstanceCulling_ ? "on" : "off") << "." << endl;
+	}
+}
+
+
+
 void Scene::setActiveCamera(unsigned int id) {
 	if (!pActiveCamera_) throw runtime_error("Scene.setActiveCamera|Scene parameters not initialized yet.");
 
@@ -769,6 +1011,8 @@ void Scene::updateRotation(float deltaTime) {
 void Scene::render(double currentTime, unsigned int fps) {
 	if (!pActiveCamera_) throw runtime_error("Scene.render|Scene parameters not initialized yet.");
 
+	GlDebug::startFrame();
+
 	try {
 		renderToScreen_(currentTime, fps);
 	}
@@ -779,6 +1023,40 @@ void Scene::render(double currentTime, unsigned int fps) {
 
 
 
+string Scene::getPlanetInfo() const {
+	return pPlanet_ ? pPlanet_->toString() : "";
+}
+
+
+
+string Scene::getInstanceInfo() const {
+	string info = "";
+
+	for (const MeshInstances* ikMeshInstances : meshInstances_)
+		if (ikMeshInstances) info += (info.empty() ? "" : "\n") + ikMeshInstances->toString();
+
+	return info;
+}
+
+
+
+string Scene::getVirtualTextureInfo() const {
+	string info = "";
+
+	for (const VirtualTexture* ikVirtualTexture : virtualTextures_)
+		info += (info.empty() ? "" : "\n") + ikVirtualTexture->toString();
+
+	return info;
+}
+
+
+
+unsigned int Scene::getNumLoadingTextures() const {
+	return ColorTexture::getNumLoading();
+}
+
+
+
 void Scene::addPerspectiveCamera_(const vec3& kPosition, const vec3& kLookAt, float fieldOfView) {
 	unsigned int id = static_cast<unsigned int>(cameras_.size());
 	if (id >= BaseCamera::MAX_NUMBER_OF_CAMERAS)
@@ -835,10 +1113,48 @@ void Scene::initializeSceneParameters_() {
 
 	try {
 		computeBoundingBox_();
+
+		// the instances are not part of the bounding box, the camera planes must still enclose them
+		unsigned int drawId = 0u;
+		for (const Mesh& ikMesh : meshes_) {
+			const MeshInstances* pkMeshInstances = getMeshInstances_(drawId++);
+			if (pkMeshInstances)
+				sceneRadius_ = std::max(sceneRadius_, pkMeshInstances->getMaxDistance(*(ikMesh.getBoundingSphereCenter()),
+					                                                                  ikMesh.getBoundingSphereRadius(),
+					                                                                  *(ikMesh.getModelMatrix())));
+		}
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Scene.initializeSceneParameters_ > " + string(kException.what()));
 	}	
+
+	try {
+		initializeVirtualTextures_();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.initializeSceneParameters_ > " + string(kException.what()));
+	}
+}
+
+
+
+// again each time textures become resident (see 'updateTextures_')
+void Scene::initializeVirtualTextures_() {
+	virtualTextures_.clear();
+
+	for (const list<ColorTexture>* pkTextures : { &diffuseTextures_, &specularTextures_, &emissiveTextures_,
+		                                          &normalMapTextures_ })
+		for (const ColorTexture& ikTexture : *pkTextures)
+			if (ikTexture.isVirtual()) virtualTextures_.push_back(ikTexture.getVirtualTexture());
+
+	if (!virtualTextures_.empty() && !pFeedbackBuffer_) {
+		try {
+			pFeedbackBuffer_ = new FeedbackBuffer(windowSize_);
+		}
+		catch (const exception& kException) {
+			throw runtime_error("Scene.initializeVirtualTextures_ > " + string(kException.what()));
+		}
+	}
 }
 
 
@@ -884,7 +1200,7 @@ void Scene::initializeShadingParameters_() {
 		if (isNormalMapping_) setNormalMapping_(isNormalMapping_);
 		else setShadingModel_(shadingModel_);
 
-		pMainShaderManager_->setShadingParameters(ambientOn_, diffuseOn_, specularOn_, emissiveOn_);
+		requestPrograms_();
 
 		initializeLightParameters_();
 		updateLightInEyeSpace_();
@@ -991,8 +1307,8 @@ void Scene::computeCameraFrustrum_(BaseCamera* pCamera) const {
 		distToSceneCentre *= glm::dot(cameraToScene, cameraLookAt);
 	}
 
-	float nearPlane = std::max(0.0f, distToSceneCentre - 0.5f);		
-	float farPlane = nearPlane + 1.0f;
+	float nearPlane = std::max(0.0f, distToSceneCentre - sceneRadius_);		
+	float farPlane = nearPlane + 2.0f * sceneRadius_;
 
 	try {
 		pCamera->setNearAndFarPlanes(nearPlane, farPlane);
@@ -1046,8 +1362,8 @@ void Scene::toggleLightComponent_(BaseLight::LightComponent component) {
 		default: return;
 		}
 
+		// the permutations of the new light switches are compiled when first drawn
 		try {
-			pMainShaderManager_->setShadingParameters(ambientOn_, diffuseOn_, specularOn_, emissiveOn_);
 			updateDisplayInfo_();
 		}
 		catch (const exception& kException) {
@@ -1193,17 +1509,22 @@ void Scene::updateCameraText_() const {
 void Scene::renderToScreen_(double currentTime, unsigned int fps) {
 	const unsigned int kColorTexture = 1u;
 
-	glViewport(0, 0, static_cast<GLsizei>(windowSize_.x), static_cast<GLsizei>(windowSize_.y));
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
 	try {
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		updateTextures_();
+		updateVirtualTextures_();
+
+		glViewport(0, 0, static_cast<GLsizei>(windowSize_.x), static_cast<GLsizei>(windowSize_.y));
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		GlDebug::countCalls(2u);
+
+		GlState::setBlend(true);
+		GlState::setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		renderScene_();
 
-		glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
+		GlState::setBlendFunc(GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA);
 		renderInfo_(currentTime, fps);
 
+		if (pFeedbackBuffer_) renderFeedback_();
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Scene.renderToScreen_ > " + string(kException.what()));
@@ -1213,31 +1534,224 @@ void Scene::renderToScreen_(double currentTime, unsigned int fps) {
 
 
 void Scene::renderScene_() {
-	MainProgram::ProgramMode programMode;
+	try {
+		unsigned int drawId = 0u, nCulledDraws = 0u;
 
-	switch (shadingModel_) {
-	case Scene::ShadingModel::NO_SHADING:
-		programMode = MainProgram::ProgramMode::NO_SHADING;
-		break;
-	case Scene::ShadingModel::FLAT:
-		programMode = MainProgram::ProgramMode::FLAT;
-		break;
-	case Scene::ShadingModel::GOURAUD:
-		programMode = MainProgram::ProgramMode::GOURAUD;
-		break;
-	case Scene::ShadingModel::PHONG:
-		programMode = isNormalMapping_ ? MainProgram::ProgramMode::NORMAL_MAPPING : MainProgram::ProgramMode::PHONG;
-		break;
-	default:
-		return;
+		frustum_.update(*(pActiveCamera_->getViewProjectionMatrix()));
+		visibleDraws_.assign(meshes_.size(), true);
+
+		vec3 occluderCenter = vec3(0.0f);
+		float occluderRadius = 0.0f;
+
+		if (pkOccluder_) {
+			mat4 modelMatrix = cursorRotationMatrix_ * rotationMatrix_ * (*(pkOccluder_->getModelMatrix()));
+			float minScale = std::min({ glm::length(vec3(modelMatrix[0u])), glm::length(vec3(modelMatrix[1u])),
+				                        glm::length(vec3(modelMatrix[2u])) });
+
+			occluderCenter = vec3(modelMatrix * vec4(*(pkOccluder_->getBoundingSphereCenter()), 1.0f));
+			occluderRadius = occluderRadius_ * minScale;
+		}
+
+		mat4 sceneMatrix = cursorRotationMatrix_ * rotationMatrix_;
+
+		for (const Mesh& ikMesh : meshes_) {
+			MeshInstances* pMeshInstances = getMeshInstances_(drawId);
+			mat4 modelMatrix = sceneMatrix * (*(ikMesh.getModelMatrix()));
+			bool visible = false;
+
+			if (pMeshInstances) {
+				pMeshInstances->selectInstances(*(ikMesh.getBoundingSphereCenter()), ikMesh.getBoundingSphereRadius(),
+					                            *(ikMesh.getModelMatrix()),
+					                            (*(pActiveCamera_->getViewProjectionMatrix())) * sceneMatrix,
+					                            isInstanceCulling_);
+
+				visible = pMeshInstances->getNumVisibleInstances() > 0u;
+				modelMatrix = sceneMatrix; // the mesh and instance transformations are applied in 'scene.vert'
+			}
+			else {
+				float maxScale = std::max({ glm::length(vec3(modelMatrix[0u])), glm::length(vec3(modelMatrix[1u])),
+					                        glm::length(vec3(modelMatrix[2u])) });
+
+				vec3 center = vec3(modelMatrix * vec4(*(ikMesh.getBoundingSphereCenter()), 1.0f));
+				float radius = ikMesh.getBoundingSphereRadius() * maxScale;
+
+				// sphere first (cheap), then the tighter box
+				visible = frustum_.intersectsSphere(center, radius) &&
+					      frustum_.intersectsBox(*(ikMesh.getBoundingBoxMin()), *(ikMesh.getBoundingBoxMax()), modelMatrix);
+
+				if (visible && pkOccluder_ && &ikMesh != pkOccluder_)
+					visible = !Frustum::isBehindHorizon(center, radius, occluderCenter, occluderRadius,
+						                                *(pActiveCamera_->getPosition()));
+			}
+
+			if (visible) {
+				mat4 modelViewMatrix = (*(pActiveCamera_->getViewMatrix())) * modelMatrix;
+				mat4 modelViewProjMatrix = (*(pActiveCamera_->getViewProjectionMatrix())) * modelMatrix;
+				mat4 normalMatrix = glm::transpose(glm::inverse(modelViewMatrix));
+
+				pMeshBatch_->setDrawData(drawId, modelViewMatrix, modelViewProjMatrix, normalMatrix);
+				if (!pMeshInstances) pMeshBatch_->sortFaces(drawId, modelViewMatrix);
+
+				if (&ikMesh == pkPlanetMesh_)
+					pPlanet_->selectNodes(*(ikMesh.getBoundingSphereCenter()), ikMesh.getBoundingSphereRadius(), modelMatrix,
+						                  *(pActiveCamera_->getViewMatrix()), *(pActiveCamera_->getProjectionMatrix()),
+						                  *(pActiveCamera_->getPosition()), windowSize_.y);
+			}
+			else {
+				visibleDraws_.at(drawId) = false;
+				nCulledDraws++;
+			}
+
+			drawId++;
+		}
+
+		GlDebug::countCulledDraws(nCulledDraws);
+
+		pMeshBatch_->updateDrawData();
+		renderDraws_(false);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.renderScene_ > " + string(kException.what()));
 	}
+}
+
+
 
+// feedback: every mesh writes its texture coordinates, so the meshes without virtual textures still hide the ones
+// behind them; the transparent meshes are left out every other feedback frame, so the meshes they cover are seen too
+void Scene::renderDraws_(bool feedback) {
 	try {
-		for (const Mesh& ikMesh : meshes_)
-			renderMesh_(&ikMesh, programMode);		
+		MainProgram::ProgramMode programMode = getProgramMode_();
+		unsigned int feedbackFeature =
+			feedback ? static_cast<unsigned int>(MainProgram::Feature::VIRTUAL_TEXTURE_FEEDBACK) : 0u;
+
+		vector<bool> draws = visibleDraws_;
+		unsigned int drawId = 0u;
+
+		if (feedback && nFeedbackFrames_ % 2u == 1u)
+			for (list<Mesh>::const_iterator it = meshes_.cbegin(); it != meshes_.cend(); it++, drawId++)
+				if (it->getMaterial() && it->getMaterial()->isTransparent()) draws.at(drawId) = false;
+
+		pMeshBatch_->bindBuffers();
+
+		GlState::setCullFaceMode(GL_BACK);
+
+		// consecutive visible meshes sharing textures, sidedness and polygon mode are drawn with one indirect call, each
+		// batch with the program permutation of its material (meshes with transparency sorting are drawn alone, their indices are in back-to-front order;
+		// the planet mesh is replaced by the planet nodes, the globe mesh is drawn as patches, meshes with instances are
+		// drawn with one instanced call)
+		unsigned int firstDrawId = 0u;
+		drawId = 0u;
+
+		for (list<Mesh>::const_iterator it = meshes_.cbegin(); it != meshes_.cend(); it++, drawId++) {
+			list<Mesh>::const_iterator next = std::next(it);
+			bool wireframe = (isWireframe_ && !isSolid_) || it->isWireframe();
+
+			if (!draws.at(drawId) || isDrawnAlone_(&(*it), drawId)) {
+				if (draws.at(drawId)) {
+					GlState::setCullFace(!it->isTwoSided());
+
+					if (&(*it) == pkPlanetMesh_)
+						renderPlanet_(drawId, it->getMaterial(), wireframe,
+							          getProgramFeatures_(&(*it), MainProgram::ProgramMode::PLANET) | feedbackFeature);
+					else if (getMeshInstances_(drawId))
+						renderInstances_(drawId, it->getMaterial(), wireframe, programMode,
+							             getProgramFeatures_(&(*it), programMode) | feedbackFeature);
+					else renderGlobe_(drawId, it->getMaterial(), wireframe,
+						              getProgramFeatures_(&(*it), MainProgram::ProgramMode::GLOBE) | feedbackFeature);
+				}
+
+				firstDrawId = drawId + 1u;
+				continue;
+			}
+
+			if (next == meshes_.cend() || !draws.at(drawId + 1u) || isDrawnAlone_(&(*next), drawId + 1u) ||
+				it->hasTransparencySorting() || !canBatch_(&(*it), &(*next))) {
+				GlState::setCullFace(!it->isTwoSided());
+				renderMeshes_(firstDrawId, drawId + 1u - firstDrawId, it->getMaterial(), wireframe, programMode,
+					          getProgramFeatures_(&(*it), programMode) | feedbackFeature);
+				firstDrawId = drawId + 1u;
+			}
+		}
+
+		pMainShaderManager_->stopProgram();
 	}
 	catch (const exception& kException) {
-		throw runtime_error("Scene.renderScene_ > " + string(kException.what()));
+		throw runtime_error("Scene.renderDraws_ > " + string(kException.what()));
+	}
+}
+
+
+
+// the new textures replace the colors of their materials: the program permutations with the textures are requested
+// now, so the driver compiles them while the next frames are drawn
+void Scene::updateTextures_() {
+	if (ColorTexture::getNumLoading() == 0u) return;
+
+	try {
+		if (ColorTexture::updateLoading() == 0u) return;
+
+		initializeVirtualTextures_();
+		requestPrograms_();
+		pMainShaderManager_->compileShaders();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.updateTextures_ > " + string(kException.what()));
+	}
+}
+
+
+
+// requests the pages seen by the last finished feedback readback (the footprint of a feedback pixel is 'getScale'
+// window pixels on each side), then uploads the pages loaded since the last frame
+void Scene::updateVirtualTextures_() {
+	if (!pFeedbackBuffer_) return;
+
+	try {
+		if (pFeedbackBuffer_->getPixels(feedbackPixels_)) {
+			float scaleLog2 = std::log2(static_cast<float>(FeedbackBuffer::getScale()));
+
+			for (const vec4& ikPixel : feedbackPixels_) {
+				if (ikPixel.w < 0.5f) continue; // cleared
+
+				const Material* pkMaterial = pMeshBatch_->getMaterial(static_cast<unsigned int>(ikPixel.w - 0.5f));
+				if (!pkMaterial) continue;
+
+				// see 'shaders/main/scene.frag'
+				unsigned int footprint = static_cast<unsigned int>(ikPixel.z);
+				float uFootprintLog2 = -static_cast<float>(footprint % 1024u) / 16.0f - scaleLog2;
+				float vFootprintLog2 = -static_cast<float>(footprint / 1024u) / 16.0f - scaleLog2;
+
+				for (const ColorTexture* pkTexture : { pkMaterial->getDiffuseTexture(), pkMaterial->getSpecularTexture(),
+					                                   pkMaterial->getEmissiveTexture(), pkMaterial->getNormalMapTexture() })
+					if (pkTexture && pkTexture->isVirtual())
+						pkTexture->getVirtualTexture()->requestPages(ikPixel.x, ikPixel.y, uFootprintLog2, vFootprintLog2);
+			}
+		}
+
+		for (VirtualTexture* iVirtualTexture : virtualTextures_)
+			iVirtualTexture->update();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.updateVirtualTextures_ > " + string(kException.what()));
+	}
+}
+
+
+
+// after the frame: read back one or two frames later, see 'FeedbackBuffer'
+void Scene::renderFeedback_() {
+	try {
+		GlState::setBlend(false); // the alpha channel is the material id
+
+		pFeedbackBuffer_->start();
+		renderDraws_(true);
+		pFeedbackBuffer_->stop();
+
+		nFeedbackFrames_++;
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.renderFeedback_ > " + string(kException.what()));
 	}
 }
 
@@ -1252,9 +1766,9 @@ void Scene::renderInfo_(double currentTime, unsigned int fps) const {
 		if (isRotating_) time += currentTime - lastStartTime_;
 	}
 
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
+	GlState::setPolygonMode(GL_FILL);
+	GlState::setCullFace(true);
+	GlState::setCullFaceMode(GL_BACK);
 
 	try {
 		pInfo_->displayMainInfo();
@@ -1272,84 +1786,240 @@ void Scene::renderInfo_(double currentTime, unsigned int fps) const {
 
 
 
-void Scene::renderMesh_(const Face* pkMesh, MainProgram::ProgramMode programMode) const {
+void Scene::renderMeshes_(unsigned int firstDrawId, unsigned int nDraws, const Material* pkMaterial, bool wireframe,
+	                      MainProgram::ProgramMode programMode, unsigned int features) const {
 	try {
-		pMainShaderManager_->startProgram(programMode);
+		GlState::setPolygonMode(wireframe ? GL_LINE : GL_FILL);
 
-		mat4 modelMatrix = cursorRotationMatrix_ * rotationMatrix_ * (*(pkMesh->getModelMatrix()));
-		mat4 modelViewMatrix = (*(pActiveCamera_->getViewMatrix())) * modelMatrix;
-		mat4 modelViewProjMatrix = (*(pActiveCamera_->getViewProjectionMatrix())) * modelMatrix;
-		mat4 normalMatrix = glm::transpose(glm::inverse(modelViewMatrix));
+		pMainShaderManager_->startProgram(programMode, features);
 
-		pMainShaderManager_->setModelViewMatrix(modelViewMatrix);
-		pMainShaderManager_->setModelViewProjectionMatrix(modelViewProjMatrix);
-		pMainShaderManager_->setNormalMatrix(normalMatrix);
+		startReadingMaterial_(pkMaterial);
+		pMainShaderManager_->render(pMeshBatch_, firstDrawId, nDraws);
+		stopReadingMaterial_(pkMaterial);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.renderMeshes_ > " + string(kException.what()));
+	}
+}
 
-		if ((isWireframe_ && !isSolid_) || pkMesh->isWireframe())
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		else glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
-		
-		const Material* pkMaterial = pkMesh->getMaterial();
-		if (pkMaterial) 
-			renderMaterial_(pkMesh, pkMaterial, modelMatrix, false);
 
-		pMainShaderManager_->stopProgram();
+// the planet is always drawn with normal mapping, see 'shaders/main/planet.vert'
+void Scene::renderPlanet_(unsigned int drawId, const Material* pkMaterial, bool wireframe, unsigned int features) const {
+	try {
+		GlState::setPolygonMode(wireframe ? GL_LINE : GL_FILL);
+
+		pMainShaderManager_->startProgram(MainProgram::ProgramMode::PLANET, features);
+
+		startReadingMaterial_(pkMaterial);
+		pMainShaderManager_->render(pPlanet_, drawId);
+		stopReadingMaterial_(pkMaterial);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.renderPlanet_ > " + string(kException.what()));
+	}
+}
+
+
+
+// the globe is always drawn with normal mapping, see 'shaders/main/globe.tese'
+void Scene::renderGlobe_(unsigned int drawId, const Material* pkMaterial, bool wireframe, unsigned int features) const {
+	try {
+		GlState::setPolygonMode(wireframe ? GL_LINE : GL_FILL);
+
+		pMainShaderManager_->startProgram(MainProgram::ProgramMode::GLOBE, features);
+		pMainShaderManager_->setTessellation(vec4(*(pkGlobeMesh_->getBoundingSphereCenter()),
+			                                      pkGlobeMesh_->getBoundingSphereRadius()),
+			                                 vec2(windowSize_), tessellationEdgeLength_, fixedTessellationLevel_);
+
+		startReadingMaterial_(pkMaterial);
+		pMainShaderManager_->render(pMeshBatch_, drawId, 1u);
+		stopReadingMaterial_(pkMaterial);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("Scene.renderMesh_ > " + string(kException.what()));
+		throw runtime_error("Scene.renderGlobe_ > " + string(kException.what()));
 	}
 }
 
 
 
-void Scene::renderMaterial_(const Face* pkMesh, const Material* pkMaterial, const mat4& kModelMatrix, bool twoSided) const {
+void Scene::renderInstances_(unsigned int drawId, const Material* pkMaterial, bool wireframe,
+	                         MainProgram::ProgramMode programMode, unsigned int features) const {
 	try {
-		pMainShaderManager_->setMaterialParameters(pkMaterial->getShadingModel());
-		pMainShaderManager_->setMaterialParameters(*(pkMaterial->getAmbientColor()), *(pkMaterial->getDiffuseColor()),
-			                                       *(pkMaterial->getSpecularColor()), *(pkMaterial->getEmissiveColor()));
-		pMainShaderManager_->setMaterialParameters(pkMaterial->getShininess(), pkMaterial->getOpacity());
-		
-		const ColorTexture* pkDiffuseTexture = pkMaterial->getDiffuseTexture();
-		const ColorTexture* pkSpecularTexture = pkMaterial->getSpecularTexture();
-		const ColorTexture* pkEmissiveTexture = pkMaterial->getEmissiveTexture();
-		const ColorTexture* pkNormalMapTexture = pkMaterial->getNormalMapTexture();
+		GlState::setPolygonMode(wireframe ? GL_LINE : GL_FILL);
 
+		pMainShaderManager_->startProgram(programMode, features);
+
+		startReadingMaterial_(pkMaterial);
+		pMainShaderManager_->render(pMeshBatch_, drawId, getMeshInstances_(drawId));
+		stopReadingMaterial_(pkMaterial);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.renderInstances_ > " + string(kException.what()));
+	}
+}
+
+
+
+void Scene::startReadingMaterial_(const Material* pkMaterial) const {
+	try {
+		const ColorTexture* pkDiffuseTexture = Scene::getResidentTexture_(pkMaterial->getDiffuseTexture());
+		const ColorTexture* pkSpecularTexture = Scene::getResidentTexture_(pkMaterial->getSpecularTexture());
+		const ColorTexture* pkEmissiveTexture = Scene::getResidentTexture_(pkMaterial->getEmissiveTexture());
+		const ColorTexture* pkNormalMapTexture = Scene::getResidentTexture_(pkMaterial->getNormalMapTexture());
+
+		// texture flags are part of the material data, see 'MeshBatch'; a virtual texture binds its atlas to the unit of
+		// the texture and its page table to the page table unit
 		if (pkDiffuseTexture) {
-			pkDiffuseTexture->startReading(MainShaderManager::getDiffuseTextureUnit());
-			pMainShaderManager_->setDiffuseTexParameters(true, pkDiffuseTexture->isDDS());
+			if (pkDiffuseTexture->isVirtual())
+				pkDiffuseTexture->getVirtualTexture()->startReading(MainShaderManager::getDiffuseTextureUnit(),
+					                                                MainShaderManager::getDiffusePageTableUnit());
+			else pkDiffuseTexture->startReading(MainShaderManager::getDiffuseTextureUnit());
 		}
-		else pMainShaderManager_->setDiffuseTexParameters(false, false);
-
 		if (pkSpecularTexture) {
-			pkSpecularTexture->startReading(MainShaderManager::getSpecularTextureUnit());
-			pMainShaderManager_->setSpecularTexParameters(true, pkSpecularTexture->isDDS());
+			if (pkSpecularTexture->isVirtual())
+				pkSpecularTexture->getVirtualTexture()->startReading(MainShaderManager::getSpecularTextureUnit(),
+					                                                 MainShaderManager::getSpecularPageTableUnit());
+			else pkSpecularTexture->startReading(MainShaderManager::getSpecularTextureUnit());
 		}
-		else pMainShaderManager_->setSpecularTexParameters(false, false);
-
 		if (pkEmissiveTexture) {
-			pkEmissiveTexture->startReading(MainShaderManager::getEmissiveTextureUnit());
-			pMainShaderManager_->setEmissiveTexParameters(true, pkEmissiveTexture->isDDS());
+			if (pkEmissiveTexture->isVirtual())
+				pkEmissiveTexture->getVirtualTexture()->startReading(MainShaderManager::getEmissiveTextureUnit(),
+					                                                 MainShaderManager::getEmissivePageTableUnit());
+			else pkEmissiveTexture->startReading(MainShaderManager::getEmissiveTextureUnit());
 		}
-		else pMainShaderManager_->setEmissiveTexParameters(false, false);
-
 		if (pkNormalMapTexture) {
-			pkNormalMapTexture->startReading(MainShaderManager::getNormalMapTextureUnit());
-			pMainShaderManager_->setNormalTexParameters(true, pkNormalMapTexture->isDDS());
+			if (pkNormalMapTexture->isVirtual())
+				pkNormalMapTexture->getVirtualTexture()->startReading(MainShaderManager::getNormalMapTextureUnit(),
+					                                                  MainShaderManager::getNormalMapPageTableUnit());
+			else pkNormalMapTexture->startReading(MainShaderManager::getNormalMapTextureUnit());
 		}
-		else pMainShaderManager_->setNormalTexParameters(false, false);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Scene.startReadingMaterial_ > " + string(kException.what()));
+	}
+}
+
+
+
+void Scene::stopReadingMaterial_(const Material* pkMaterial) const {
+	if (pkMaterial->getDiffuseTexture()) pkMaterial->getDiffuseTexture()->stopReading();
+	if (pkMaterial->getSpecularTexture()) pkMaterial->getSpecularTexture()->stopReading();
+	if (pkMaterial->getEmissiveTexture()) pkMaterial->getEmissiveTexture()->stopReading();
+	if (pkMaterial->getNormalMapTexture()) pkMaterial->getNormalMapTexture()->stopReading();
+}
 
-		pMainShaderManager_->render(pkMesh);
 
-		if (pkDiffuseTexture) pkDiffuseTexture->stopReading();
-		if (pkSpecularTexture) pkSpecularTexture->stopReading();
-		if (pkEmissiveTexture) pkEmissiveTexture->stopReading();
-		if (pkNormalMapTexture) pkNormalMapTexture->stopReading();
+
+bool Scene::canBatch_(const Mesh* pkMesh, const Mesh* pkNextMesh) const {
+	const Material* pkMaterial = pkMesh->getMaterial();
+	const Material* pkNextMaterial = pkNextMesh->getMaterial();
+
+	return !pkNextMesh->hasTransparencySorting() && (pkMesh->isWireframe() == pkNextMesh->isWireframe()) &&
+		   (pkMesh->isTwoSided() == pkNextMesh->isTwoSided()) &&
+		   (pkMaterial->getDiffuseTexture() == pkNextMaterial->getDiffuseTexture()) &&
+		   (pkMaterial->getSpecularTexture() == pkNextMaterial->getSpecularTexture()) &&
+		   (pkMaterial->getEmissiveTexture() == pkNextMaterial->getEmissiveTexture()) &&
+		   (pkMaterial->getNormalMapTexture() == pkNextMaterial->getNormalMapTexture());
+}
+
+
+
+bool Scene::isDrawnAlone_(const Mesh* pkMesh, unsigned int drawId) const {
+	return pkMesh == pkPlanetMesh_ || (isGlobeTessellation_ && pkMesh == pkGlobeMesh_) || getMeshInstances_(drawId);
+}
+
+
+
+MainProgram::ProgramMode Scene::getProgramMode_() const {
+	switch (shadingModel_) {
+	case Scene::ShadingModel::NO_SHADING:
+		return MainProgram::ProgramMode::NO_SHADING;
+	case Scene::ShadingModel::FLAT:
+		return MainProgram::ProgramMode::FLAT;
+	case Scene::ShadingModel::GOURAUD:
+		return MainProgram::ProgramMode::GOURAUD;
+	case Scene::ShadingModel::PHONG:
+		return isNormalMapping_ ? MainProgram::ProgramMode::NORMAL_MAPPING : MainProgram::ProgramMode::PHONG;
+	default:
+		throw runtime_error("Scene.getProgramMode_|Invalid shading model value.");
+	}
+}
+
+
+
+// bits that make no difference in 'programMode' are left out, so fewer permutations are compiled
+unsigned int Scene::getProgramFeatures_(const Mesh* pkMesh, MainProgram::ProgramMode programMode) const {
+	unsigned int features = 0u;
+	const Material* pkMaterial = pkMesh->getMaterial();
+
+	const ColorTexture* pkDiffuseTexture = pkMaterial ? Scene::getResidentTexture_(pkMaterial->getDiffuseTexture()) : nullptr;
+	const ColorTexture* pkSpecularTexture = pkMaterial ? Scene::getResidentTexture_(pkMaterial->getSpecularTexture()) : nullptr;
+	const ColorTexture* pkEmissiveTexture = pkMaterial ? Scene::getResidentTexture_(pkMaterial->getEmissiveTexture()) : nullptr;
+	const ColorTexture* pkNormalMapTexture = pkMaterial ? Scene::getResidentTexture_(pkMaterial->getNormalMapTexture()) : nullptr;
+
+	if (pkDiffuseTexture) {
+		features |= static_cast<unsigned int>(MainProgram::Feature::DIFFUSE_TEXTURE);
+		if (pkDiffuseTexture->isDDS()) features |= static_cast<unsigned int>(MainProgram::Feature::DIFFUSE_COMPRESSED);
+		if (pkDiffuseTexture->isVirtual()) features |= static_cast<unsigned int>(MainProgram::Feature::DIFFUSE_VIRTUAL);
+	}
+	if (pkSpecularTexture) {
+		features |= static_cast<unsigned int>(MainProgram::Feature::SPECULAR_TEXTURE);
+		if (pkSpecularTexture->isDDS()) features |= static_cast<unsigned int>(MainProgram::Feature::SPECULAR_COMPRESSED);
+		if (pkSpecularTexture->isVirtual()) features |= static_cast<unsigned int>(MainProgram::Feature::SPECULAR_VIRTUAL);
+	}
+	if (pkEmissiveTexture) {
+		features |= static_cast<unsigned int>(MainProgram::Feature::EMISSIVE_TEXTURE);
+		if (pkEmissiveTexture->isDDS()) features |= static_cast<unsigned int>(MainProgram::Feature::EMISSIVE_COMPRESSED);
+		if (pkEmissiveTexture->isVirtual()) features |= static_cast<unsigned int>(MainProgram::Feature::EMISSIVE_VIRTUAL);
+	}
+	if (pkNormalMapTexture && (programMode == MainProgram::ProgramMode::NORMAL_MAPPING ||
+		                       programMode == MainProgram::ProgramMode::PLANET || programMode == MainProgram::ProgramMode::GLOBE)) {
+		features |= static_cast<unsigned int>(MainProgram::Feature::NORMAL_MAP_TEXTURE);
+		if (pkNormalMapTexture->isDDS())
+			features |= static_cast<unsigned int>(MainProgram::Feature::NORMAL_MAP_COMPRESSED);
+		if (pkNormalMapTexture->isVirtual())
+			features |= static_cast<unsigned int>(MainProgram::Feature::NORMAL_MAP_VIRTUAL);
+	}
+
+	if (pkMesh->isTwoSided()) features |= static_cast<unsigned int>(MainProgram::Feature::TWO_SIDED);
+
+	// the planet computes its vertices
+	if (pMeshBatch_->hasCompactVertices() && programMode != MainProgram::ProgramMode::PLANET)
+		features |= static_cast<unsigned int>(MainProgram::Feature::COMPACT_VERTICES);
+
+	if (programMode != MainProgram::ProgramMode::NO_SHADING) {
+		if (ambientOn_) features |= static_cast<unsigned int>(MainProgram::Feature::AMBIENT_LIGHT);
+		if (diffuseOn_) features |= static_cast<unsigned int>(MainProgram::Feature::DIFFUSE_LIGHT);
+		if (specularOn_) features |= static_cast<unsigned int>(MainProgram::Feature::SPECULAR_LIGHT);
+		if (emissiveOn_) features |= static_cast<unsigned int>(MainProgram::Feature::EMISSIVE_LIGHT);
+	}
+
+	return features;
+}
+
+
+
+// the permutations of the first frame are compiled by the next 'compileShaders', the other ones when first drawn
+void Scene::requestPrograms_() const {
+	try {
+		MainProgram::ProgramMode programMode = getProgramMode_();
+
+		unsigned int drawId = 0u;
+		for (list<Mesh>::const_iterator it = meshes_.cbegin(); it != meshes_.cend(); it++, drawId++) {
+			MainProgram::ProgramMode meshProgramMode = programMode;
+			if (&(*it) == pkPlanetMesh_) meshProgramMode = MainProgram::ProgramMode::PLANET;
+			else if (isGlobeTessellation_ && &(*it) == pkGlobeMesh_ && !getMeshInstances_(drawId))
+				meshProgramMode = MainProgram::ProgramMode::GLOBE;
+
+			pMainShaderManager_->requestProgram(meshProgramMode, getProgramFeatures_(&(*it), meshProgramMode));
+			if (!virtualTextures_.empty())
+				pMainShaderManager_->requestProgram(meshProgramMode, getProgramFeatures_(&(*it), meshProgramMode) |
+					                                static_cast<unsigned int>(MainProgram::Feature::VIRTUAL_TEXTURE_FEEDBACK));
+		}
 	}
 	catch (const exception& kException) {
-		throw runtime_error("Scene.renderMaterial_ > " + string(kException.what()));
+		throw runtime_error("Scene.requestPrograms_ > " + string(kException.what()));
 	}
 }
 
@@ -1379,3 +2049,9 @@ Mesh* Scene::getMesh_(unsigned int modelId, unsigned int meshId) const {
 			return const_cast<Mesh*> (&ikMesh);
 	return nullptr;
 }
+
+
+
+MeshInstances* Scene::getMeshInstances_(unsigned int drawId) const {
+	return meshInstances_.empty() ? nullptr : meshInstances_.at(drawId);
+}
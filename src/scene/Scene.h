@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 5, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef SCENE_H
@@ -9,19 +9,28 @@
 #include <GL/gl3w.h>
 
 #include "camera/BaseCamera.h"
+#include "camera/Frustum.h"
 #include "camera/PerspectiveCamera.h"
+#include "info/GlDebug.h"
 #include "info/Info.h"
 #include "light/light/BaseLight.h"
 #include "light/light/DirectionalLight.h"
 #include "material/Material.h"
+#include "mesh/batch/MeshBatch.h"
+#include "mesh/instance/MeshInstances.h"
 #include "mesh/mesh/Face.h"
 #include "mesh/mesh/Mesh.h"
+#include "mesh/planet/Planet.h"
 #include "mesh/triangle/TriangleList2D.h"
 #include "model/Model3D.h"
+#include "shader/program/ProgramCache.h"
 #include "shader/shaderManager/MainShaderManager.h"
 #include "shader/shaderProgram/MainProgram.h"
 #include "shader/shaderProgram/Text2dProgram.h"
+#include "state/GlState.h"
 #include "texture/texture/ColorTexture.h"
+#include "texture/virtual/FeedbackBuffer.h"
+#include "texture/virtual/VirtualTexture.h"
 
 #include <glm/geometric.hpp>
 #include <glm/mat3x3.hpp>
@@ -35,9 +44,11 @@
 #include <glm/ext/matrix_transform.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <exception>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <stdexcept>
@@ -70,11 +81,15 @@ public:
 	~Scene();
 
 	
-	// init: 1) add(...)ShaderSourceCode (for each 'programMode' in 'Main/Text2dProgram')
+	// init: 1) add(...)ShaderSourceCode (for each 'programMode' in 'Main/Text2dProgram'), [addTessellationShaderSourceCode],
+	//          [addShaderBinaries]
+	//          [setVirtualTexturing], [setAsyncTextureLoading], [setImportThreads], [setCompactVertices],
 	//          import3DModel (for each model), setText2DTexture
-	//       2) compileShaders, loadBufferData, addCamera, [setLight], [translate/scale/rotateMesh], [setMeshWireframe],
-	//          [setMeshRotationSpeed], [setRotationSpeed]
+	//       2) addCamera, [setLight], [translate/scale/rotateMesh], [setMeshWireframe],
+	//          [setMeshRotationSpeed], [setRotationSpeed], [setHorizonOccluder], [setPlanet],
+	//          [setGlobe], [addInstances]
 	//       3) initializeSceneParameters
+	//       4) compileShaders, loadBufferData
 	//############################################################################
 	void addShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
 		                     const list<string>& kVertexShaderFileList, const string& kVertexShaderHeader,
@@ -83,6 +98,12 @@ public:
 		                           const list<string>& kFileList, const string& kHeader) const;
 	void addFragmentShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
 		                             const list<string>& kFileList, const string& kHeader) const;
+	void addTessellationShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
+		                                 const list<string>& kTessControlShaderFileList, const string& kTessControlShaderHeader,
+		                                 const list<string>& kTessEvaluationShaderFileList,
+		                                 const string& kTessEvaluationShaderHeader) const;
+	// SPIR-V modules (instead of the source code) of 'programMode', see 'MainShaderManager'
+	void addShaderBinaries(MainProgram::ProgramMode programMode, const string& kPath, const string& kModuleName) const;
 	
 	void addShaderSourceCode(Text2dProgram::ProgramMode programMode, const string& kPath,
 		                     const list<string>& kVertexShaderFileList, const string& kVertexShaderHeader,
@@ -92,10 +113,30 @@ public:
 	void addFragmentShaderSourceCode(Text2dProgram::ProgramMode programMode, const string& kPath,
 		                             const list<string>& kFileList, const string& kHeader) const;
 	
+	// starts compiling and linking, the programs are finished when first drawn; makes no GL state change, so it may
+	// run on a worker thread with a shared context while 'loadBufferData' runs (only the 'getNumLinkingPrograms'
+	// polling must wait for it); the main program permutations of the first frame are those requested by
+	// 'initializeSceneParameters', the other ones are compiled when first drawn
 	void compileShaders() const;
+	unsigned int getNumLinkingPrograms() const; // see 'GlState.hasParallelShaderCompile'
 	
 	void setText2DTexture(const string& kFilePath, const string& kFileName) const;
 	
+	// images (not DDS) with a side of at least 'minSize' texels are streamed as virtual textures (0 -> off, the default):
+	// only the pages seen by a low-resolution feedback pass are resident, see 'VirtualTexture'
+	void setVirtualTexturing(GLsizei minSize);
+
+	// the textures of the next models are decoded by worker threads and uploaded while the scene is rendered (off by
+	// default); their materials are drawn with their colors until then, see 'ColorTexture.setAsyncLoading'
+	void setAsyncTextureLoading(bool on);
+
+	// the meshes of a model are converted by 'nThreads' worker threads (0 -> one per core, default), see 'Model3D'
+	void setImportThreads(unsigned int nThreads);
+
+	// quantized vertices (20 bytes instead of 56) and 16-bit indices for the meshes with up to 65536 vertices (off by
+	// default), set before the first import; see 'MeshBatch.setCompactVertices'
+	void setCompactVertices(bool on);
+
 	void import3DModel(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps);
 	void loadBufferData();
 	
@@ -114,6 +155,20 @@ public:
 		                     const vec3& kSpecularColor);
 
 	void setRotationSpeed(float value);
+
+	// meshes behind the horizon of this (closed, convex) mesh are not drawn
+	void setHorizonOccluder(int modelId, int meshId);
+
+	// this (spherical) mesh is drawn as a CDLOD planet; the mesh supplies the material and the transformations
+	void setPlanet(int modelId, int meshId);
+
+	// in globe tessellation mode, this (spherical, low-poly) mesh is tessellated on the GPU and projected on its
+	// bounding sphere; the tessellation levels follow the projected edge length
+	void setGlobe(int modelId, int meshId);
+
+	// this mesh is drawn once per transformation (scene space, applied after the mesh transformations) with one
+	// instanced call; the instances outside the frustum are culled on the CPU
+	void addInstances(int modelId, int meshId, const vector<mat4>& kTransforms);
 	
 	void initializeSceneParameters();
 	
@@ -139,6 +194,13 @@ public:
 
 	void toggleNormalMapping();
 
+	void toggleGlobeTessellation();
+#ifdef _DEBUG
+	void benchmarkGlobeTessellation(unsigned int nFrames); // frame time for each fixed tessellation level (debug build)
+#endif
+
+	void toggleInstanceCulling();
+
 	void setActiveCamera(unsigned int id);
 	
 	void translateCameraRight(float distance) const;
@@ -164,11 +226,20 @@ public:
 	void updateRotation(float deltaTime);
 	void render(double currentTime, unsigned int fps);
 
+
+	// get
+	//############################################################################
+	string getPlanetInfo() const; // last frame, empty without planet
+	string getInstanceInfo() const; // last frame, empty without instances
+	string getVirtualTextureInfo() const; // empty without virtual textures
+	unsigned int getNumLoadingTextures() const; // not resident yet
+
 private:
 	static const float kLengthEpsilon_;
 
 	static float getMaxSceneRadius_();
 	static float getMaxVerticalRotationAngle_();
+	static const ColorTexture* getResidentTexture_(const ColorTexture* pkTexture); // nullptr while loading
 
 	Scene(const Scene&);
 	const Scene& operator=(const Scene&) {}
@@ -178,6 +249,7 @@ private:
 		           const vec3& kAmbientColor, const vec3& kDiffuseColor, const vec3& kSpecularColor);
 	
 	void initializeSceneParameters_();
+	void initializeVirtualTextures_();
 	void initializeShadingParameters_();
 	void initializeLightParameters_();
 	void initializeCameraParameters_();
@@ -204,14 +276,34 @@ private:
 
 	void renderToScreen_(double currentTime, unsigned int fps);		
 	void renderScene_();
+	void renderDraws_(bool feedback); // visible meshes of the last 'renderScene_'
+
+	void updateTextures_();
+	void updateVirtualTextures_();
+	void renderFeedback_();
 
 	void renderInfo_(double currentTime, unsigned int fps) const;	
-	void renderMesh_(const Face* pkMesh, MainProgram::ProgramMode programMode) const;	
-	void renderMaterial_(const Face* pkMesh, const Material* pkMaterial, const mat4& kModelMatrix, bool twoSided) const;
+	void renderMeshes_(unsigned int firstDrawId, unsigned int nDraws, const Material* pkMaterial, bool wireframe,
+		               MainProgram::ProgramMode programMode, unsigned int features) const;
+	void renderPlanet_(unsigned int drawId, const Material* pkMaterial, bool wireframe, unsigned int features) const;
+	void renderGlobe_(unsigned int drawId, const Material* pkMaterial, bool wireframe, unsigned int features) const;
+	void renderInstances_(unsigned int drawId, const Material* pkMaterial, bool wireframe,
+		                  MainProgram::ProgramMode programMode, unsigned int features) const;
+
+	bool isDrawnAlone_(const Mesh* pkMesh, unsigned int drawId) const; // planet / tessellated globe / instances
+	void startReadingMaterial_(const Material* pkMaterial) const;
+	void stopReadingMaterial_(const Material* pkMaterial) const;
+
+	bool canBatch_(const Mesh* pkMesh, const Mesh* pkNextMesh) const;
+
+	MainProgram::ProgramMode getProgramMode_() const; // shading model of the scene
+	unsigned int getProgramFeatures_(const Mesh* pkMesh, MainProgram::ProgramMode programMode) const; // 'MainProgram::Feature'
+	void requestPrograms_() const;
 		
 	BaseCamera* getCamera_(unsigned int id) const;
 	BaseLight* getLight_(unsigned int id) const;
 	Mesh* getMesh_(unsigned int modelId, unsigned int meshId) const;
+	MeshInstances* getMeshInstances_(unsigned int drawId) const;
 
 	list<PerspectiveCamera> perspectiveCameras_;	
 	list<BaseCamera*> cameras_;
@@ -224,7 +316,28 @@ private:
 	list<Mesh> meshes_;
 	list<ColorTexture> diffuseTextures_, specularTextures_, emissiveTextures_, normalMapTextures_;
 	
+	Frustum frustum_;
+	const Mesh* pkOccluder_;
+	float occluderRadius_; // object space, inscribed sphere
+	vector<bool> visibleDraws_;
+
+	const Mesh* pkPlanetMesh_;
+	Planet* pPlanet_;
+
+	const Mesh* pkGlobeMesh_;
+	bool isGlobeTessellation_;
+	float tessellationEdgeLength_, fixedTessellationLevel_; // pixels; 0 -> from the edge length
+
+	vector<MeshInstances*> meshInstances_; // per 'drawId', nullptr for meshes without instances
+	bool isInstanceCulling_;
+
+	vector<VirtualTexture*> virtualTextures_;
+	FeedbackBuffer* pFeedbackBuffer_; // nullptr without virtual textures
+	vector<vec4> feedbackPixels_;
+	unsigned int nFeedbackFrames_;
+
 	MainShaderManager* pMainShaderManager_;
+	MeshBatch* pMeshBatch_;
 	Info* pInfo_;
 	
 	mat4 rotationMatrix_, cursorRotationMatrix_;
@@ -240,6 +353,8 @@ private:
 	bool ambientOn_, diffuseOn_, specularOn_, emissiveOn_;
 	bool hasNormalMapping_, isNormalMapping_;
 
+	float sceneRadius_; // 0.5 after 'computeBoundingBox_', more if instances are outside
+
 	uvec2 windowSize_;
 	float aspectRatio_;
 };
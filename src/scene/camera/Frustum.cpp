@@ -0,0 +1,81 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "Frustum.h"
+
+
+
+// the sphere is hidden if it is beyond the plane of the horizon circle and inside the cone tangent to the occluder
+bool Frustum::isBehindHorizon(const vec3& kCenter, float radius, const vec3& kOccluderCenter, float occluderRadius,
+	                          const vec3& kEyePosition) {
+	vec3 occluderToEye = kEyePosition - kOccluderCenter;
+	float eyeDistance = glm::length(occluderToEye);
+
+	if (eyeDistance <= occluderRadius) return false;
+	vec3 eyeDirection = occluderToEye / eyeDistance;
+
+	float horizonDistance = occluderRadius * occluderRadius / eyeDistance;
+	if (glm::dot(kCenter - kOccluderCenter, eyeDirection) + radius >= horizonDistance) return false;
+
+	vec3 eyeToCenter = kCenter - kEyePosition;
+	float centerDistance = glm::length(eyeToCenter);
+
+	if (centerDistance <= radius) return false;
+
+	float coneAngle = std::asin(occluderRadius / eyeDistance);
+	float angle = std::acos(glm::clamp(glm::dot(eyeToCenter / centerDistance, -eyeDirection), -1.0f, 1.0f));
+
+	return angle + std::asin(radius / centerDistance) < coneAngle;
+}
+
+
+
+Frustum::Frustum() : planes_() {}
+
+
+
+Frustum::~Frustum() {}
+
+
+
+// Gribb-Hartmann: the planes are sums and differences of the rows of the view-projection matrix
+void Frustum::update(const mat4& kViewProjectionMatrix) {
+	mat4 transposed = glm::transpose(kViewProjectionMatrix);
+
+	planes_[0u] = transposed[3u] + transposed[0u];
+	planes_[1u] = transposed[3u] - transposed[0u];
+	planes_[2u] = transposed[3u] + transposed[1u];
+	planes_[3u] = transposed[3u] - transposed[1u];
+	planes_[4u] = transposed[3u] + transposed[2u];
+	planes_[5u] = transposed[3u] - transposed[2u];
+
+	for (vec4& rPlane : planes_)
+		rPlane /= glm::length(vec3(rPlane));
+}
+
+
+
+bool Frustum::intersectsSphere(const vec3& kCenter, float radius) const {
+	for (const vec4& kPlane : planes_)
+		if (glm::dot(vec3(kPlane), kCenter) + kPlane.w < -radius) return false;
+
+	return true;
+}
+
+
+
+bool Frustum::intersectsBox(const vec3& kMin, const vec3& kMax, const mat4& kModelMatrix) const {
+	// world-space box around the transformed box: center and half extents
+	vec3 center = vec3(kModelMatrix * vec4(0.5f * (kMin + kMax), 1.0f));
+	mat3 absMatrix = mat3(glm::abs(vec3(kModelMatrix[0u])), glm::abs(vec3(kModelMatrix[1u])), glm::abs(vec3(kModelMatrix[2u])));
+	vec3 extents = absMatrix * (0.5f * (kMax - kMin));
+
+	for (const vec4& kPlane : planes_) {
+		vec3 normal = vec3(kPlane);
+		if (glm::dot(normal, center) + kPlane.w < -glm::dot(glm::abs(normal), extents)) return false;
+	}
+
+	return true;
+}
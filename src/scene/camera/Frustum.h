@@ -0,0 +1,56 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using glm::mat3;
+using glm::mat4;
+using glm::vec3;
+using glm::vec4;
+
+
+
+// World-space clip planes of a camera, for culling bounding volumes before they are drawn.
+class Frustum {
+public:
+	// true if the sphere is entirely hidden by the occluder sphere, seen from 'kEyePosition'
+	static bool isBehindHorizon(const vec3& kCenter, float radius, const vec3& kOccluderCenter, float occluderRadius,
+		                        const vec3& kEyePosition);
+
+
+	Frustum();
+	~Frustum();
+
+
+	// set
+	//############################################################################
+	void update(const mat4& kViewProjectionMatrix);
+
+
+	// get (false only if the volume is entirely outside)
+	//############################################################################
+	bool intersectsSphere(const vec3& kCenter, float radius) const; // world space
+	bool intersectsBox(const vec3& kMin, const vec3& kMax, const mat4& kModelMatrix) const; // object space box
+
+private:
+	Frustum(const Frustum&);
+	const Frustum& operator=(const Frustum&) {}
+
+	vec4 planes_[6u]; // left, right, bottom, top, near, far; normals point inside
+};
+
+#endif
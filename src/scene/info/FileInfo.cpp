@@ -0,0 +1,17 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "FileInfo.h"
+
+
+
+bool FileInfo::get(const string& kFilePath, long long& rSize, long long& rTime) {
+	struct _stat64 info;
+	if (_stat64(kFilePath.c_str(), &info) != 0) return false;
+
+	rSize = static_cast<long long>(info.st_size);
+	rTime = static_cast<long long>(info.st_mtime);
+	return true;
+}
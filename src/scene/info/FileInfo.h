@@ -0,0 +1,28 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef FILE_INFO_H
+#define FILE_INFO_H
+
+#include <string>
+#include <sys/stat.h>
+
+using std::string;
+
+
+
+// Size and last modification time of a source file (model, image), stored in the files derived from it (see
+// 'MeshCache', 'PageFile', 'TextureCooker') so that they are rebuilt once it changes.
+class FileInfo {
+public:
+	static bool get(const string& kFilePath, long long& rSize, long long& rTime); // false -> not found
+
+private:
+	FileInfo();
+	FileInfo(const FileInfo&);
+	const FileInfo& operator=(const FileInfo&) {}
+};
+
+#endif
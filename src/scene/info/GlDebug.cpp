@@ -0,0 +1,107 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "GlDebug.h"
+
+
+
+#ifdef _DEBUG
+bool GlDebug::validation_ = true;
+#else
+bool GlDebug::validation_ = false;
+#endif
+
+unsigned int GlDebug::nCalls_ = 0u, GlDebug::nSkippedCalls_ = 0u, GlDebug::nQueries_ = 0u, GlDebug::nCulledDraws_ = 0u;
+unsigned int GlDebug::nFrameCalls_ = 0u, GlDebug::nFrameSkippedCalls_ = 0u, GlDebug::nFrameQueries_ = 0u,
+             GlDebug::nFrameCulledDraws_ = 0u;
+
+
+
+void GlDebug::setValidation(bool validation) {
+	GlDebug::validation_ = validation;
+}
+
+
+
+void GlDebug::toggleValidation() {
+	GlDebug::validation_ = !GlDebug::validation_;
+}
+
+
+
+void GlDebug::startFrame() {
+	GlDebug::nCalls_ = GlDebug::nFrameCalls_;
+	GlDebug::nSkippedCalls_ = GlDebug::nFrameSkippedCalls_;
+	GlDebug::nQueries_ = GlDebug::nFrameQueries_;
+	GlDebug::nCulledDraws_ = GlDebug::nFrameCulledDraws_;
+
+	GlDebug::nFrameCalls_ = 0u;
+	GlDebug::nFrameSkippedCalls_ = 0u;
+	GlDebug::nFrameQueries_ = 0u;
+	GlDebug::nFrameCulledDraws_ = 0u;
+}
+
+
+
+void GlDebug::countCalls(unsigned int nCalls) {
+	GlDebug::nFrameCalls_ += nCalls;
+}
+
+
+
+void GlDebug::countSkippedCalls(unsigned int nCalls) {
+	GlDebug::nFrameSkippedCalls_ += nCalls;
+}
+
+
+
+void GlDebug::countQueries(unsigned int nQueries) {
+	GlDebug::nFrameCalls_ += nQueries;
+	GlDebug::nFrameQueries_ += nQueries;
+}
+
+
+
+void GlDebug::countCulledDraws(unsigned int nDraws) {
+	GlDebug::nFrameCulledDraws_ += nDraws;
+}
+
+
+
+bool GlDebug::isValidating() {
+	return GlDebug::validation_;
+}
+
+
+
+unsigned int GlDebug::getNumCalls() {
+	return GlDebug::nCalls_;
+}
+
+
+
+unsigned int GlDebug::getNumSkippedCalls() {
+	return GlDebug::nSkippedCalls_;
+}
+
+
+
+unsigned int GlDebug::getNumQueries() {
+	return GlDebug::nQueries_;
+}
+
+
+
+unsigned int GlDebug::getNumCulledDraws() {
+	return GlDebug::nCulledDraws_;
+}
+
+
+
+string GlDebug::toString() {
+	return "GL calls per frame: " + to_string(GlDebug::nCalls_) + " issued, " + to_string(GlDebug::nSkippedCalls_) +
+		   " skipped (object queries: " + to_string(GlDebug::nQueries_) + ", validation " +
+		   (GlDebug::validation_ ? "on" : "off") + "), culled draws: " + to_string(GlDebug::nCulledDraws_);
+}
@@ -0,0 +1,63 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef GL_DEBUG_H
+#define GL_DEBUG_H
+
+#include <GL/gl3w.h>
+
+#include <iostream>
+#include <string>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::to_string;
+
+
+
+// Validation mode (GL object queries before each draw) and GL call counters of the render path.
+class GlDebug {
+public:
+	// set
+	//############################################################################
+	static void setValidation(bool validation);
+	static void toggleValidation();
+
+
+	// render: 1) startFrame
+	//         2) countCalls/countSkippedCalls/countQueries (for each GL call), [countCulledDraws]
+	//############################################################################
+	static void startFrame();
+
+	static void countCalls(unsigned int nCalls);
+	static void countSkippedCalls(unsigned int nCalls); // redundant state changes, see 'GlState'
+	static void countQueries(unsigned int nQueries);
+	static void countCulledDraws(unsigned int nDraws); // meshes outside the frustum or behind the horizon
+
+
+	// get
+	//############################################################################
+	static bool isValidating();
+
+	static unsigned int getNumCalls(); // last frame
+	static unsigned int getNumSkippedCalls(); // last frame
+	static unsigned int getNumQueries(); // last frame
+	static unsigned int getNumCulledDraws(); // last frame
+
+	static string toString();
+
+private:
+	GlDebug();
+	GlDebug(const GlDebug&);
+	const GlDebug& operator=(const GlDebug&) {}
+
+	static bool validation_;
+
+	static unsigned int nCalls_, nSkippedCalls_, nQueries_, nCulledDraws_;
+	static unsigned int nFrameCalls_, nFrameSkippedCalls_, nFrameQueries_, nFrameCulledDraws_;
+};
+
+#endif
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 30, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Info.h"
@@ -152,6 +152,12 @@ void Info::compileShaders() const {
 
 
 
+unsigned int Info::getNumLinkingPrograms() const {
+	return pText2dShaderManager_->getNumLinkingPrograms();
+}
+
+
+
 void Info::setText2DTexture(const string& kFilePath, const string& kFileName) {
 	if (pkTexture_) throw runtime_error("Info.setText2DTexture|Texture text 2D already loaded.");
 
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 30, 2025
+ * Last modified: Oct 17, 2026
  **/
  
 #ifndef INFO_H
@@ -46,7 +46,8 @@ public:
 
 
 	// init: 1) addShaderSourceCode/addVertexShaderSourceCode/addFragmentShaderSourceCode (programMode = 'TEXT_2D')
-	//       2) compileShaders
+	//       2) compileShaders (the program is finished when first drawn)
+	//       3) [getNumLinkingPrograms]
 	//############################################################################
 	void addShaderSourceCode(Text2dProgram::ProgramMode programMode, const string& kPath,
 		                     const list<string>& kVertexShaderFileList, const string& kVertexShaderHeader,
@@ -57,6 +58,7 @@ public:
 		                             const string& kPath, const list<string>& kFileList, const string& kHeader) const;
 
 	void compileShaders() const;
+	unsigned int getNumLinkingPrograms() const;
 
 
 	// init
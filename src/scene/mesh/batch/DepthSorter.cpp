@@ -0,0 +1,247 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "DepthSorter.h"
+
+
+
+const float DepthSorter::kDirectionEpsilon_ = 0.0001f; // 1 - cos(angle), about 0.8 degrees
+const unsigned int DepthSorter::kMinFacesPerThread_ = 16384u;
+const unsigned int DepthSorter::kRadixBits_ = 8u;
+
+vector<thread> DepthSorter::workers_;
+mutex DepthSorter::mutex_;
+condition_variable DepthSorter::condition_;
+const function<void(unsigned int)>* DepthSorter::pkJob_ = nullptr;
+unsigned int DepthSorter::nJobChunks_ = 0u;
+unsigned int DepthSorter::nextChunk_ = 0u;
+unsigned int DepthSorter::nDoneChunks_ = 0u;
+exception_ptr DepthSorter::pJobException_ = nullptr;
+unsigned int DepthSorter::nSorters_ = 0u;
+bool DepthSorter::stopping_ = false;
+
+
+
+// order preserving map of a float to an unsigned key
+uint32_t DepthSorter::getKey_(float depth) {
+	uint32_t bits;
+	std::memcpy(&bits, &depth, sizeof(bits));
+
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+
+
+void DepthSorter::work_() {
+	unique_lock<mutex> lock(DepthSorter::mutex_);
+
+	while (true) {
+		DepthSorter::condition_.wait(lock, [] {
+			return DepthSorter::stopping_ || (DepthSorter::pkJob_ && DepthSorter::nextChunk_ < DepthSorter::nJobChunks_);
+		});
+		if (DepthSorter::stopping_) return;
+
+		DepthSorter::runChunk_(lock);
+	}
+}
+
+
+
+void DepthSorter::runChunk_(unique_lock<mutex>& rLock) {
+	const function<void(unsigned int)>& kJob = *DepthSorter::pkJob_;
+	unsigned int chunk = DepthSorter::nextChunk_++;
+	rLock.unlock();
+
+	exception_ptr pException = nullptr;
+	try {
+		kJob(chunk);
+	}
+	catch (...) {
+		pException = std::current_exception();
+	}
+
+	rLock.lock();
+	if (pException && !DepthSorter::pJobException_) DepthSorter::pJobException_ = pException;
+	if (++DepthSorter::nDoneChunks_ == DepthSorter::nJobChunks_) DepthSorter::condition_.notify_all();
+}
+
+
+
+DepthSorter::DepthSorter(const uvec3* pkFaces, const vec3* pkVertices, unsigned int nFaces) : kNumFaces_(nFaces),
+	                     nThreads_(1u), faces_(), centroids_(), keys_(), sortedKeys_(), order_(), sortedOrder_(),
+	                     indices_(), direction_(vec3(0.0f)), isSorted_(false) {
+	if (nFaces == 0u) throw runtime_error("DepthSorter|Invalid number of faces value.");
+
+	faces_.assign(pkFaces, pkFaces + nFaces);
+	centroids_.resize(nFaces);
+
+	for (unsigned int i = 0u; i < nFaces; i++) {
+		const uvec3& kFace = faces_.at(i);
+		centroids_.at(i) = (pkVertices[kFace.x] + pkVertices[kFace.y] + pkVertices[kFace.z]) / 3.0f;
+	}
+
+	keys_.resize(nFaces);
+	sortedKeys_.resize(nFaces);
+	order_.resize(nFaces);
+	sortedOrder_.resize(nFaces);
+	indices_.resize(static_cast<size_t>(nFaces) * 3u);
+
+	for (unsigned int i = 0u; i < nFaces; i++) {
+		indices_.at(3u * i) = faces_.at(i).x;
+		indices_.at(3u * i + 1u) = faces_.at(i).y;
+		indices_.at(3u * i + 2u) = faces_.at(i).z;
+	}
+
+	nThreads_ = std::max(1u, std::min(thread::hardware_concurrency(), nFaces / DepthSorter::kMinFacesPerThread_));
+	if (nThreads_ > 1u) {
+		unique_lock<mutex> lock(DepthSorter::mutex_);
+		if (DepthSorter::workers_.empty())
+			for (unsigned int i = 1u; i < thread::hardware_concurrency(); i++)
+				DepthSorter::workers_.emplace_back(&DepthSorter::work_);
+		DepthSorter::nSorters_++;
+	}
+}
+
+
+
+DepthSorter::~DepthSorter() {
+	if (nThreads_ == 1u) return;
+
+	unique_lock<mutex> lock(DepthSorter::mutex_);
+	DepthSorter::nSorters_--;
+	if (DepthSorter::nSorters_ > 0u) return;
+
+	DepthSorter::stopping_ = true;
+	lock.unlock();
+	DepthSorter::condition_.notify_all();
+
+	for (thread& rWorker : DepthSorter::workers_) rWorker.join();
+	DepthSorter::workers_.clear();
+	DepthSorter::stopping_ = false;
+}
+
+
+
+bool DepthSorter::sort(const mat4& kModelViewMatrix) {
+	// eye-space depth of 'p' is dot(row2, p) + constant, the constant does not change the order
+	vec3 row2 = vec3(kModelViewMatrix[0u][2u], kModelViewMatrix[1u][2u], kModelViewMatrix[2u][2u]);
+	float length = glm::length(row2);
+
+	if (length == 0.0f) return false;
+	vec3 direction = row2 / length;
+
+	if (isSorted_ && glm::dot(direction, direction_) > 1.0f - DepthSorter::kDirectionEpsilon_) return false;
+
+	for (unsigned int i = 0u; i < kNumFaces_; i++) {
+		keys_.at(i) = DepthSorter::getKey_(glm::dot(direction, centroids_.at(i)));
+		order_.at(i) = static_cast<GLuint>(i);
+	}
+
+	try {
+		radixSort_();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("DepthSorter.sort > " + string(kException.what()));
+	}
+
+	// ascending eye-space depth: the farthest faces (most negative z) first
+	for (unsigned int i = 0u; i < kNumFaces_; i++) {
+		const uvec3& kFace = faces_.at(order_.at(i));
+		indices_.at(3u * i) = kFace.x;
+		indices_.at(3u * i + 1u) = kFace.y;
+		indices_.at(3u * i + 2u) = kFace.z;
+	}
+
+	direction_ = direction;
+	isSorted_ = true;
+
+	return true;
+}
+
+
+
+const GLuint* DepthSorter::getIndices() const {
+	return indices_.data();
+}
+
+
+
+unsigned int DepthSorter::getNumFaces() const {
+	return kNumFaces_;
+}
+
+
+
+// each pass: 1) histogram of the digit per chunk
+//            2) exclusive prefix sum over (digit, chunk) gives the stable scatter offsets
+//            3) scatter of each chunk
+void DepthSorter::radixSort_() {
+	const unsigned int kRadix = 1u << DepthSorter::kRadixBits_;
+
+	unsigned int chunkSize = (kNumFaces_ + nThreads_ - 1u) / nThreads_;
+
+	vector<vector<unsigned int>> offsets(nThreads_, vector<unsigned int>(kRadix, 0u));
+
+	for (unsigned int shift = 0u; shift < 32u; shift += DepthSorter::kRadixBits_) {
+		runChunks_([&](unsigned int t) {
+			vector<unsigned int>& rCount = offsets.at(t);
+			std::fill(rCount.begin(), rCount.end(), 0u);
+
+			unsigned int end = std::min(kNumFaces_, (t + 1u) * chunkSize);
+			for (unsigned int i = t * chunkSize; i < end; i++)
+				rCount.at((keys_[i] >> shift) & (kRadix - 1u))++;
+		});
+
+		unsigned int offset = 0u;
+		for (unsigned int digit = 0u; digit < kRadix; digit++)
+			for (unsigned int t = 0u; t < nThreads_; t++) {
+				unsigned int count = offsets.at(t).at(digit);
+				offsets.at(t).at(digit) = offset;
+				offset += count;
+			}
+
+		runChunks_([&](unsigned int t) {
+			vector<unsigned int>& rOffset = offsets.at(t);
+
+			unsigned int end = std::min(kNumFaces_, (t + 1u) * chunkSize);
+			for (unsigned int i = t * chunkSize; i < end; i++) {
+				unsigned int position = rOffset[(keys_[i] >> shift) & (kRadix - 1u)]++;
+				sortedKeys_[position] = keys_[i];
+				sortedOrder_[position] = order_[i];
+			}
+		});
+
+		keys_.swap(sortedKeys_);
+		order_.swap(sortedOrder_);
+	}
+}
+
+
+
+void DepthSorter::runChunks_(const function<void(unsigned int)>& kJob) const {
+	if (nThreads_ == 1u) {
+		kJob(0u);
+		return;
+	}
+
+	unique_lock<mutex> lock(DepthSorter::mutex_);
+	DepthSorter::pkJob_ = &kJob;
+	DepthSorter::nJobChunks_ = nThreads_;
+	DepthSorter::nextChunk_ = 0u;
+	DepthSorter::nDoneChunks_ = 0u;
+	DepthSorter::pJobException_ = nullptr;
+	DepthSorter::condition_.notify_all();
+
+	while (DepthSorter::nextChunk_ < DepthSorter::nJobChunks_)
+		DepthSorter::runChunk_(lock);
+	DepthSorter::condition_.wait(lock, [] { return DepthSorter::nDoneChunks_ == DepthSorter::nJobChunks_; });
+
+	DepthSorter::pkJob_ = nullptr;
+	exception_ptr pException = DepthSorter::pJobException_;
+	DepthSorter::pJobException_ = nullptr;
+	lock.unlock();
+
+	if (pException) std::rethrow_exception(pException);
+}
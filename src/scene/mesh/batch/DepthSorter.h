@@ -0,0 +1,104 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef DEPTH_SORTER_H
+#define DEPTH_SORTER_H
+
+#include <GL/gl3w.h>
+
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using glm::mat4;
+using glm::uvec3;
+using glm::vec3;
+
+using std::condition_variable;
+using std::exception;
+using std::exception_ptr;
+using std::function;
+using std::mutex;
+using std::runtime_error;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+
+
+// Back-to-front face order of a transparent mesh, by the eye-space depth of the face centroids.
+// The order depends only on the view direction in object space, so it is sorted again (parallel LSD
+// radix sort of the depth keys) only when that direction changes by more than 'kDirectionEpsilon_'. The chunks of a
+// pass are run by the calling thread and a pool of worker threads shared by the sorters of large meshes.
+class DepthSorter {
+public:
+	DepthSorter(const uvec3* pkFaces, const vec3* pkVertices, unsigned int nFaces);
+	~DepthSorter();
+
+
+	// render: 1) sort (returns true if the order changed)
+	//         2) [getIndices]
+	//############################################################################
+	bool sort(const mat4& kModelViewMatrix);
+
+
+	// get
+	//############################################################################
+	const GLuint* getIndices() const; // 3 * numFaces, relative to the first vertex of the mesh
+	unsigned int getNumFaces() const;
+
+private:
+	static const float kDirectionEpsilon_;
+	static const unsigned int kMinFacesPerThread_;
+	static const unsigned int kRadixBits_;
+
+	static vector<thread> workers_;
+	static mutex mutex_;
+	static condition_variable condition_;
+	static const function<void(unsigned int)>* pkJob_; // nullptr -> none
+	static unsigned int nJobChunks_, nextChunk_, nDoneChunks_;
+	static exception_ptr pJobException_; // the first one of the job
+	static unsigned int nSorters_; // using the workers
+	static bool stopping_;
+
+	static uint32_t getKey_(float depth);
+
+	static void work_();
+	static void runChunk_(unique_lock<mutex>& rLock); // the next chunk of the job, 'rLock' released meanwhile
+
+	DepthSorter(const DepthSorter&);
+	const DepthSorter& operator=(const DepthSorter&) {}
+
+	void radixSort_();
+	// 'kJob' for each chunk, by this thread and the workers; the first exception is rethrown once all are done
+	void runChunks_(const function<void(unsigned int)>& kJob) const;
+
+	const unsigned int kNumFaces_;
+	unsigned int nThreads_; // chunks per pass, > 1 -> the workers are used
+
+	vector<uvec3> faces_;
+	vector<vec3> centroids_;
+	vector<uint32_t> keys_, sortedKeys_;
+	vector<GLuint> order_, sortedOrder_;
+	vector<GLuint> indices_;
+
+	vec3 direction_;
+	bool isSorted_;
+};
+
+#endif
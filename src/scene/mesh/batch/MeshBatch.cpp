@@ -0,0 +1,786 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "MeshBatch.h"
+
+
+
+const GLuint MeshBatch::kMaxShortIndexVertices_ = 65536u;
+
+
+
+GLuint MeshBatch::getDrawDataBinding() {
+	return 0u;
+}
+
+
+
+GLuint MeshBatch::getMaterialDataBinding() {
+	return 1u;
+}
+
+
+
+MeshBatch::MeshBatch() : materials_(), meshes_(), drawData_(), materialData_(), drawCommands_(), indexTypes_(),
+	                     depthSorters_(), vertexData_(), mappedMeshes_(), nVertices_(0u), nIndices_(0u), indicesSize_(0),
+	                     compactVertices_(false), shortIndices_(), vao_(0u), verticesVbo_(0u), indicesVbo_(0u),
+	                     drawDataSsbo_(0u), materialDataSsbo_(0u), drawCommandsBuffer_(0u) {
+	glGenVertexArrays(1, &vao_);
+
+	glGenBuffers(1, &verticesVbo_);
+	glGenBuffers(1, &indicesVbo_);
+	glGenBuffers(1, &drawDataSsbo_);
+	glGenBuffers(1, &materialDataSsbo_);
+	glGenBuffers(1, &drawCommandsBuffer_);
+
+	//cout << "MeshBatch created." << endl;
+}
+
+
+
+MeshBatch::~MeshBatch() {
+	for (DepthSorter* pDepthSorter : depthSorters_)
+		if (pDepthSorter) delete pDepthSorter;
+
+	for (const VERTEX_DATA& ikVertexData : vertexData_) { // unmapped
+		glDeleteBuffers(1, &ikVertexData.verticesVbo);
+		glDeleteBuffers(1, &ikVertexData.indicesVbo);
+	}
+
+	glDeleteBuffers(1, &verticesVbo_);
+	glDeleteBuffers(1, &indicesVbo_);
+	glDeleteBuffers(1, &drawDataSsbo_);
+	glDeleteBuffers(1, &materialDataSsbo_);
+	glDeleteBuffers(1, &drawCommandsBuffer_);
+
+	GlState::deleteVertexArray(vao_);
+
+	//cout << "MeshBatch deleted." << endl;
+}
+
+
+
+void MeshBatch::setCompactVertices(bool on) {
+	if (!vertexData_.empty() || !meshes_.empty())
+		throw runtime_error("MeshBatch.setCompactVertices|Vertex format set after the first mesh.");
+
+	compactVertices_ = on;
+}
+
+
+
+// sized for 32-bit indices: enough for the 16-bit ones, padded to 4 bytes
+void MeshBatch::mapVertexData(unsigned int nVertices, unsigned int nIndices) {
+	const GLbitfield kMapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+
+	if (!vertexData_.empty() && vertexData_.back().pVertices)
+		throw runtime_error("MeshBatch.mapVertexData|Vertex data already mapped.");
+	if (nVertices == 0u || nIndices == 0u) throw runtime_error("MeshBatch.mapVertexData|Invalid size value.");
+
+	VERTEX_DATA vertexData = {};
+	vertexData.nVertices = nVertices;
+	vertexData.indicesSize = static_cast<GLsizeiptr>(sizeof(GLuint) * nIndices);
+
+	GLsizeiptr verticesSize = getVertexSize_() * nVertices;
+	GLsizeiptr indicesSize = vertexData.indicesSize;
+
+	// immutable: the driver keeps no copy, the mapping is the buffer (the indices are updated by 'sortFaces')
+	glGenBuffers(1, &vertexData.verticesVbo);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, vertexData.verticesVbo);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, verticesSize, nullptr, GL_MAP_WRITE_BIT);
+	vertexData.pVertices = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, verticesSize, kMapFlags));
+
+	glGenBuffers(1, &vertexData.indicesVbo);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, vertexData.indicesVbo);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, indicesSize, nullptr, GL_MAP_WRITE_BIT | GL_DYNAMIC_STORAGE_BIT);
+	vertexData.pIndices = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, indicesSize, kMapFlags));
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+	if (!vertexData.pVertices || !vertexData.pIndices) {
+		glDeleteBuffers(1, &vertexData.verticesVbo); // unmapped
+		glDeleteBuffers(1, &vertexData.indicesVbo);
+		throw runtime_error("MeshBatch.mapVertexData|Cannot map the vertex data.");
+	}
+
+	vertexData_.push_back(vertexData);
+}
+
+
+
+unsigned int MeshBatch::mapMesh(const Mesh* pkMesh) {
+	if (vertexData_.empty() || !vertexData_.back().pVertices)
+		throw runtime_error("MeshBatch.mapMesh|Vertex data not mapped yet.");
+	if (getMappedMesh_(pkMesh)) throw runtime_error("MeshBatch.mapMesh|Mesh " + pkMesh->toString() + " already mapped.");
+
+	VERTEX_DATA& rVertexData = vertexData_.back();
+	GLuint nVertices = pkMesh->getNumVertices();
+	GLenum indexType = getIndexType_(pkMesh);
+	GLintptr indexOffset = (rVertexData.indexOffset + 3) / 4 * 4;
+	GLsizeiptr indicesSize = MeshBatch::getIndexSize_(indexType) * 3 * pkMesh->getNumFaces();
+
+	if (rVertexData.vertex + nVertices > rVertexData.nVertices || indexOffset + indicesSize > rVertexData.indicesSize)
+		throw runtime_error("MeshBatch.mapMesh|Vertex data too small for mesh " + pkMesh->toString() + ".");
+
+	mappedMeshes_.push_back({ pkMesh, static_cast<unsigned int>(vertexData_.size() - 1u), rVertexData.vertex,
+		                      indexOffset, indexType, vec4(0.0f, 0.0f, 1.0f, 1.0f) });
+
+	rVertexData.vertex += nVertices;
+	rVertexData.indexOffset = indexOffset + indicesSize;
+
+	return static_cast<unsigned int>(mappedMeshes_.size() - 1u);
+}
+
+
+
+// the mapped meshes are not added or removed while they are written
+void MeshBatch::writeMesh(unsigned int mappedMeshId, const uvec3* pkFaces, const vec3* pkVertices,
+	                      const vec2* pkTexCoords, const vec3* pkNormals, const vec3* pkTangents,
+	                      const vec3* pkBitangents) {
+	if (mappedMeshId >= mappedMeshes_.size()) throw runtime_error("MeshBatch.writeMesh|Invalid mapped mesh id value.");
+
+	MAPPED_MESH& rMappedMesh = mappedMeshes_.at(mappedMeshId);
+	const VERTEX_DATA& kVertexData = vertexData_.at(rMappedMesh.vertexDataId);
+	if (!kVertexData.pVertices) throw runtime_error("MeshBatch.writeMesh|Vertex data not mapped.");
+
+	writeVertices_(rMappedMesh.pkMesh, pkVertices, pkTexCoords, pkNormals, pkTangents, pkBitangents,
+		           kVertexData.pVertices + getVertexSize_() * rMappedMesh.firstVertex, rMappedMesh.texCoordRange);
+	writeIndices_(pkFaces, rMappedMesh.pkMesh->getNumFaces(), rMappedMesh.indexType,
+		          kVertexData.pIndices + rMappedMesh.indexOffset);
+}
+
+
+
+bool MeshBatch::unmapVertexData() {
+	if (vertexData_.empty() || !vertexData_.back().pVertices) return true;
+
+	VERTEX_DATA& rVertexData = vertexData_.back();
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, rVertexData.verticesVbo);
+	bool unmapped = glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE;
+	glBindBuffer(GL_COPY_WRITE_BUFFER, rVertexData.indicesVbo);
+	unmapped = (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE) && unmapped;
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+	rVertexData.pVertices = nullptr;
+	rVertexData.pIndices = nullptr;
+
+	return unmapped;
+}
+
+
+
+unsigned int MeshBatch::addMaterial(const Material* pkMaterial) {
+	if (!pkMaterial) throw runtime_error("MeshBatch.addMaterial|Invalid material.");
+
+	MATERIAL_DATA material = {};
+	material.shadingModel = static_cast<GLuint>(pkMaterial->getShadingModel());
+	material.ambientColor = *(pkMaterial->getAmbientColor());
+	material.diffuseColor = *(pkMaterial->getDiffuseColor());
+	material.specularColor = *(pkMaterial->getSpecularColor());
+	material.emissiveColor = *(pkMaterial->getEmissiveColor());
+	material.shininess = pkMaterial->getShininess();
+	material.opacity = pkMaterial->getOpacity();
+
+	const ColorTexture* pkDiffuseTexture = pkMaterial->getDiffuseTexture();
+	const ColorTexture* pkSpecularTexture = pkMaterial->getSpecularTexture();
+	const ColorTexture* pkEmissiveTexture = pkMaterial->getEmissiveTexture();
+	const ColorTexture* pkNormalMapTexture = pkMaterial->getNormalMapTexture();
+
+	material.hasDiffuseTexture = static_cast<GLuint>(pkDiffuseTexture != nullptr);
+	material.hasSpecularTexture = static_cast<GLuint>(pkSpecularTexture != nullptr);
+	material.hasEmissiveTexture = static_cast<GLuint>(pkEmissiveTexture != nullptr);
+	material.hasNormalMapTexture = static_cast<GLuint>(pkNormalMapTexture != nullptr);
+
+	material.diffuseCompressed = static_cast<GLuint>(pkDiffuseTexture && pkDiffuseTexture->isDDS());
+	material.specularCompressed = static_cast<GLuint>(pkSpecularTexture && pkSpecularTexture->isDDS());
+	material.emissiveCompressed = static_cast<GLuint>(pkEmissiveTexture && pkEmissiveTexture->isDDS());
+	material.normalMapCompressed = static_cast<GLuint>(pkNormalMapTexture && pkNormalMapTexture->isDDS());
+
+	materials_.push_back(pkMaterial);
+	materialData_.push_back(material);
+
+	return static_cast<unsigned int>(materials_.size() - 1u);
+}
+
+
+
+unsigned int MeshBatch::addMesh(const Mesh* pkMesh) {
+	if (!pkMesh->hasFaces() || !pkMesh->hasVertices() || !pkMesh->hasNormals())
+		throw runtime_error("MeshBatch.addMesh|Mesh " + pkMesh->toString() + " not loaded yet.");
+
+	DRAW_DATA draw = {};
+	DRAW_COMMAND command = {};
+	GLenum indexType = getIndexType_(pkMesh);
+	GLsizeiptr indexSize = MeshBatch::getIndexSize_(indexType);
+
+	DepthSorter* pDepthSorter = nullptr;
+
+	try {
+		draw.materialId = getMaterialId_(pkMesh->getMaterial());
+
+		if (pkMesh->hasTransparencySorting())
+			pDepthSorter = new DepthSorter(pkMesh->getFace(0u), pkMesh->getVertex(0u), pkMesh->getNumFaces());
+	}
+	catch (const exception& kException) {
+		throw runtime_error("MeshBatch.addMesh > " + string(kException.what()));
+	}
+
+	// texture coordinate range: written with the vertices
+	draw.positionOffset = compactVertices_ ? vec4(*pkMesh->getBoundingBoxMin(), 0.0f) : vec4(0.0f);
+	draw.positionScale = compactVertices_ ? vec4(*pkMesh->getBoundingBoxMax() - *pkMesh->getBoundingBoxMin(), 0.0f) :
+		                                    vec4(1.0f);
+	draw.texCoordRange = vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+	indicesSize_ = (indicesSize_ + 3) / 4 * 4;
+
+	command.count = 3u * pkMesh->getNumFaces();
+	command.instanceCount = 1u;
+	command.firstIndex = static_cast<GLuint>(indicesSize_ / indexSize);
+	command.baseVertex = static_cast<GLint>(nVertices_);
+	command.baseInstance = 0u;
+
+	nVertices_ += pkMesh->getNumVertices();
+	nIndices_ += command.count;
+	indicesSize_ += indexSize * command.count;
+
+	meshes_.push_back(pkMesh);
+	drawData_.push_back(draw);
+	drawCommands_.push_back(command);
+	indexTypes_.push_back(indexType);
+	depthSorters_.push_back(pDepthSorter);
+
+	return static_cast<unsigned int>(meshes_.size() - 1u);
+}
+
+
+
+void MeshBatch::updateVertexBuffer() {
+	const GLbitfield kMapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+
+	if (meshes_.size() == 0u) throw runtime_error("MeshBatch.updateVertexBuffer|No meshes added yet.");
+	if (!vertexData_.empty() && vertexData_.back().pVertices)
+		throw runtime_error("MeshBatch.updateVertexBuffer|Vertex data still mapped.");
+
+	bool hasDepthSorters = std::any_of(depthSorters_.cbegin(), depthSorters_.cend(),
+		                               [](const DepthSorter* pkDepthSorter) { return pkDepthSorter != nullptr; });
+
+	// a single imported model, in the order of its meshes: its buffer pair is the arena
+	if (isVertexDataArena_()) {
+		glDeleteBuffers(1, &verticesVbo_);
+		glDeleteBuffers(1, &indicesVbo_);
+
+		verticesVbo_ = vertexData_.front().verticesVbo;
+		indicesVbo_ = vertexData_.front().indicesVbo;
+		vertexData_.clear();
+	}
+	else {
+		GLsizeiptr vertexSize = getVertexSize_();
+		GLsizeiptr verticesSize = vertexSize * nVertices_;
+
+		// copy write target: the element array buffer binding would change the vao state
+		glBindBuffer(GL_COPY_WRITE_BUFFER, verticesVbo_);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, verticesSize, nullptr, GL_MAP_WRITE_BIT);
+		GLubyte* pGlVertices = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, verticesSize, kMapFlags));
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, indicesVbo_);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, indicesSize_, nullptr,
+			            hasDepthSorters ? GL_MAP_WRITE_BIT | GL_DYNAMIC_STORAGE_BIT : GL_MAP_WRITE_BIT);
+		GLubyte* pGlIndices = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, indicesSize_, kMapFlags));
+
+		try {
+			if (!pGlVertices || !pGlIndices) throw runtime_error("Cannot map the vertex buffer.");
+
+			// the meshes loaded with their vertices are written straight into the arena
+			for (size_t i = 0u; i < meshes_.size(); i++) {
+				const Mesh* pkMesh = meshes_.at(i);
+				if (getMappedMesh_(pkMesh)) continue;
+
+				const DRAW_COMMAND& kCommand = drawCommands_.at(i);
+				GLenum indexType = indexTypes_.at(i);
+
+				writeVertices_(pkMesh, pkMesh->getVertex(0u), pkMesh->hasTexCoords() ? pkMesh->getTexCoord(0u) : nullptr,
+					           pkMesh->getNormal(0u), pkMesh->hasTangentsAndBitangents() ? pkMesh->getTangent(0u) : nullptr,
+					           pkMesh->hasTangentsAndBitangents() ? pkMesh->getBitangent(0u) : nullptr,
+					           pGlVertices + vertexSize * kCommand.baseVertex, drawData_.at(i).texCoordRange);
+				writeIndices_(pkMesh->getFace(0u), pkMesh->getNumFaces(), indexType,
+					          pGlIndices + MeshBatch::getIndexSize_(indexType) * kCommand.firstIndex);
+			}
+		}
+		catch (const exception& kException) {
+			if (pGlVertices) {
+				glBindBuffer(GL_COPY_WRITE_BUFFER, verticesVbo_);
+				glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			}
+			if (pGlIndices) {
+				glBindBuffer(GL_COPY_WRITE_BUFFER, indicesVbo_);
+				glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			}
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+			throw runtime_error("MeshBatch.updateVertexBuffer > " + string(kException.what()));
+		}
+
+		bool unmapped = glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE; // indices, bound last
+		glBindBuffer(GL_COPY_WRITE_BUFFER, verticesVbo_);
+		unmapped = (glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_TRUE) && unmapped;
+
+		// the mapped meshes are copied on the GPU
+		for (size_t i = 0u; i < meshes_.size(); i++) {
+			const MAPPED_MESH* pkMappedMesh = getMappedMesh_(meshes_.at(i));
+			if (!pkMappedMesh) continue;
+
+			const VERTEX_DATA& kVertexData = vertexData_.at(pkMappedMesh->vertexDataId);
+			const DRAW_COMMAND& kCommand = drawCommands_.at(i);
+			GLsizeiptr indexSize = MeshBatch::getIndexSize_(indexTypes_.at(i));
+
+			glBindBuffer(GL_COPY_READ_BUFFER, kVertexData.verticesVbo);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, verticesVbo_);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, vertexSize * pkMappedMesh->firstVertex,
+				                vertexSize * kCommand.baseVertex, vertexSize * meshes_.at(i)->getNumVertices());
+
+			glBindBuffer(GL_COPY_READ_BUFFER, kVertexData.indicesVbo);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, indicesVbo_);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, pkMappedMesh->indexOffset,
+				                indexSize * kCommand.firstIndex, indexSize * kCommand.count);
+		}
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0u);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+		for (const VERTEX_DATA& ikVertexData : vertexData_) {
+			glDeleteBuffers(1, &ikVertexData.verticesVbo);
+			glDeleteBuffers(1, &ikVertexData.indicesVbo);
+		}
+		vertexData_.clear();
+
+		// the contents are undefined after a display mode change
+		if (!unmapped) throw runtime_error("MeshBatch.updateVertexBuffer|Vertex buffer lost.");
+	}
+
+	for (size_t i = 0u; i < meshes_.size(); i++) {
+		const MAPPED_MESH* pkMappedMesh = getMappedMesh_(meshes_.at(i));
+		if (pkMappedMesh) drawData_.at(i).texCoordRange = pkMappedMesh->texCoordRange;
+	}
+
+	mappedMeshes_.clear();
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandsBuffer_);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(sizeof(DRAW_COMMAND) * drawCommands_.size()),
+		         drawCommands_.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0u);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataSsbo_);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(sizeof(DRAW_DATA) * drawData_.size()),
+		         drawData_.data(), GL_DYNAMIC_DRAW);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialDataSsbo_);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(sizeof(MATERIAL_DATA) * materialData_.size()),
+		         materialData_.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+}
+
+
+
+// compact vertices: the bitangent is rebuilt from the normal, the tangent and the sign in the position (w)
+void MeshBatch::setAttribPointers(GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex,
+	                              GLuint tangentIndex, GLuint bitangentIndex) {
+	const GLsizei kStride = static_cast<GLsizei>(getVertexSize_());
+
+	GlState::bindVertexArray(vao_);
+	glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
+
+	if (compactVertices_) {
+		glVertexAttribPointer(positionIndex, 4, GL_UNSIGNED_SHORT, GL_TRUE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::COMPACT_VERTEX_3D, position)));
+		glEnableVertexAttribArray(positionIndex);
+
+		glVertexAttribPointer(texCoordIndex, 2, GL_UNSIGNED_SHORT, GL_TRUE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::COMPACT_VERTEX_3D, texCoord)));
+		glEnableVertexAttribArray(texCoordIndex);
+
+		glVertexAttribPointer(normalIndex, 2, GL_SHORT, GL_TRUE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::COMPACT_VERTEX_3D, normal)));
+		glEnableVertexAttribArray(normalIndex);
+
+		glVertexAttribPointer(tangentIndex, 2, GL_SHORT, GL_TRUE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::COMPACT_VERTEX_3D, tangent)));
+		glEnableVertexAttribArray(tangentIndex);
+
+		glDisableVertexAttribArray(bitangentIndex);
+	}
+	else {
+		glVertexAttribPointer(positionIndex, 3, GL_FLOAT, GL_FALSE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::VERTEX_3D, position)));
+		glEnableVertexAttribArray(positionIndex);
+
+		glVertexAttribPointer(texCoordIndex, 2, GL_FLOAT, GL_FALSE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::VERTEX_3D, texCoord)));
+		glEnableVertexAttribArray(texCoordIndex);
+
+		glVertexAttribPointer(normalIndex, 3, GL_FLOAT, GL_FALSE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::VERTEX_3D, normal)));
+		glEnableVertexAttribArray(normalIndex);
+
+		glVertexAttribPointer(tangentIndex, 3, GL_FLOAT, GL_FALSE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::VERTEX_3D, tangent)));
+		glEnableVertexAttribArray(tangentIndex);
+
+		glVertexAttribPointer(bitangentIndex, 3, GL_FLOAT, GL_FALSE, kStride,
+			                  reinterpret_cast<const void*>(offsetof(Triangle::VERTEX_3D, bitangent)));
+		glEnableVertexAttribArray(bitangentIndex);
+	}
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVbo_);
+
+	GlState::bindVertexArray(0u);
+	glBindBuffer(GL_ARRAY_BUFFER, 0u);
+}
+
+
+
+void MeshBatch::setDrawData(unsigned int drawId, const mat4& kModelViewMatrix, const mat4& kModelViewProjectionMatrix,
+	                                             const mat4& kNormalMatrix) {
+	if (drawId >= drawData_.size()) throw runtime_error("MeshBatch.setDrawData|Invalid draw id value.");
+
+	DRAW_DATA& rDraw = drawData_.at(drawId);
+	rDraw.modelViewMatrix = kModelViewMatrix;
+	rDraw.modelViewProjectionMatrix = kModelViewProjectionMatrix;
+	rDraw.normalMatrix = kNormalMatrix;
+}
+
+
+
+void MeshBatch::sortFaces(unsigned int drawId, const mat4& kModelViewMatrix) {
+	if (drawId >= depthSorters_.size()) throw runtime_error("MeshBatch.sortFaces|Invalid draw id value.");
+
+	DepthSorter* pDepthSorter = depthSorters_.at(drawId);
+	if (!pDepthSorter) return;
+
+	try {
+		if (!pDepthSorter->sort(kModelViewMatrix)) return;
+	}
+	catch (const exception& kException) {
+		throw runtime_error("MeshBatch.sortFaces > " + string(kException.what()));
+	}
+
+	// copy write target: the element array buffer binding would change the vao state
+	const DRAW_COMMAND& kCommand = drawCommands_.at(drawId);
+	const GLvoid* pkIndices = pDepthSorter->getIndices();
+	GLsizeiptr indexSize = MeshBatch::getIndexSize_(indexTypes_.at(drawId));
+
+	if (indexTypes_.at(drawId) == GL_UNSIGNED_SHORT) {
+		shortIndices_.resize(kCommand.count);
+		for (GLuint i = 0u; i < kCommand.count; i++)
+			shortIndices_[i] = static_cast<GLushort>(pDepthSorter->getIndices()[i]);
+		pkIndices = shortIndices_.data();
+	}
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, indicesVbo_);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, indexSize * kCommand.firstIndex, indexSize * kCommand.count, pkIndices);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0u);
+
+	GlDebug::countCalls(3u);
+}
+
+
+
+void MeshBatch::updateDrawData() const {
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataSsbo_);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(DRAW_DATA) * drawData_.size()),
+		            drawData_.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+
+	GlDebug::countCalls(3u);
+}
+
+
+
+void MeshBatch::bindBuffers() const {
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshBatch::getDrawDataBinding(), drawDataSsbo_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshBatch::getMaterialDataBinding(), materialDataSsbo_);
+
+	GlDebug::countCalls(2u);
+}
+
+
+
+void MeshBatch::render(unsigned int firstDrawId, unsigned int nDraws, GLenum mode) const {
+	if (nDraws == 0u) return;
+	if (firstDrawId + nDraws > drawCommands_.size()) throw runtime_error("MeshBatch.render|Invalid draw id value.");
+	if (getNumRenderedDraws(firstDrawId, nDraws) != nDraws)
+		throw runtime_error("MeshBatch.render|Draws with different index types.");
+
+	if (mode == GL_PATCHES) GlState::setPatchVertices(3);
+	else if (mode != GL_TRIANGLES) throw runtime_error("MeshBatch.render|Invalid primitive mode value.");
+
+	GlState::bindVertexArray(vao_); // left bound, see GlState
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandsBuffer_);
+
+	glMultiDrawElementsIndirect(mode, indexTypes_.at(firstDrawId),
+		                        reinterpret_cast<const void*>(sizeof(DRAW_COMMAND) * firstDrawId),
+		                        static_cast<GLsizei>(nDraws), 0);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0u);
+
+	GlDebug::countCalls(3u);
+}
+
+
+
+// gl_DrawID is 0 outside multi-draw calls, the shaders read the per-draw data of 'drawIdOffset' = 'drawId'
+void MeshBatch::renderInstanced(unsigned int drawId, unsigned int nInstances, GLenum mode) const {
+	if (nInstances == 0u) return;
+	if (drawId >= drawCommands_.size()) throw runtime_error("MeshBatch.renderInstanced|Invalid draw id value.");
+
+	if (mode == GL_PATCHES) GlState::setPatchVertices(3);
+	else if (mode != GL_TRIANGLES) throw runtime_error("MeshBatch.renderInstanced|Invalid primitive mode value.");
+
+	const DRAW_COMMAND& kCommand = drawCommands_.at(drawId);
+
+	GlState::bindVertexArray(vao_); // left bound, see GlState
+
+	GLenum indexType = indexTypes_.at(drawId);
+
+	glDrawElementsInstancedBaseVertex(mode, static_cast<GLsizei>(kCommand.count), indexType,
+		                              reinterpret_cast<const void*>(MeshBatch::getIndexSize_(indexType) *
+		                                                            kCommand.firstIndex),
+		                              static_cast<GLsizei>(nInstances), kCommand.baseVertex);
+
+	GlDebug::countCalls(1u);
+}
+
+
+
+unsigned int MeshBatch::getNumDraws() const {
+	return static_cast<unsigned int>(drawCommands_.size());
+}
+
+
+
+// a range of draws with the same index type
+unsigned int MeshBatch::getNumRenderedDraws(unsigned int firstDrawId, unsigned int nDraws) const {
+	unsigned int nRenderedDraws = 0u;
+	while (nRenderedDraws < nDraws && firstDrawId + nRenderedDraws < indexTypes_.size() &&
+		   indexTypes_.at(firstDrawId + nRenderedDraws) == indexTypes_.at(firstDrawId))
+		nRenderedDraws++;
+
+	return nRenderedDraws;
+}
+
+
+
+unsigned int MeshBatch::getNumVertices() const {
+	return nVertices_;
+}
+
+
+
+unsigned int MeshBatch::getNumIndices() const {
+	return nIndices_;
+}
+
+
+
+GLsizeiptr MeshBatch::getVertexDataSize() const {
+	return getVertexSize_() * nVertices_ + indicesSize_;
+}
+
+
+
+bool MeshBatch::hasCompactVertices() const {
+	return compactVertices_;
+}
+
+
+
+const Material* MeshBatch::getMaterial(unsigned int materialId) const {
+	return materialId < materials_.size() ? materials_.at(materialId) : nullptr;
+}
+
+
+
+unsigned int MeshBatch::getNumMaterials() const {
+	return static_cast<unsigned int>(materials_.size());
+}
+
+
+
+GLsizeiptr MeshBatch::getIndexSize_(GLenum indexType) {
+	return indexType == GL_UNSIGNED_SHORT ? static_cast<GLsizeiptr>(sizeof(GLushort)) :
+		                                    static_cast<GLsizeiptr>(sizeof(GLuint));
+}
+
+
+
+GLushort MeshBatch::getUnorm_(float value) {
+	return static_cast<GLushort>(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f);
+}
+
+
+
+// the unit vector projected on the octahedron |x| + |y| + |z| = 1, the lower half folded over the upper one
+void MeshBatch::getOctahedral_(const vec3& kVector, GLshort* pOctahedral) {
+	float length = std::abs(kVector.x) + std::abs(kVector.y) + std::abs(kVector.z);
+	vec2 octahedral = length > 0.0f ? vec2(kVector.x, kVector.y) / length : vec2(0.0f);
+
+	if (kVector.z < 0.0f)
+		octahedral = vec2((1.0f - std::abs(octahedral.y)) * (octahedral.x >= 0.0f ? 1.0f : -1.0f),
+			              (1.0f - std::abs(octahedral.x)) * (octahedral.y >= 0.0f ? 1.0f : -1.0f));
+
+	pOctahedral[0u] = static_cast<GLshort>(std::lround(std::min(std::max(octahedral.x, -1.0f), 1.0f) * 32767.0f));
+	pOctahedral[1u] = static_cast<GLshort>(std::lround(std::min(std::max(octahedral.y, -1.0f), 1.0f) * 32767.0f));
+}
+
+
+
+unsigned int MeshBatch::getMaterialId_(const Material* pkMaterial) const {
+	for (size_t i = 0u; i < materials_.size(); i++)
+		if (materials_.at(i) == pkMaterial)
+			return static_cast<unsigned int>(i);
+
+	throw runtime_error("MeshBatch.getMaterialId_|Material not added yet.");
+}
+
+
+
+const MeshBatch::MAPPED_MESH* MeshBatch::getMappedMesh_(const Mesh* pkMesh) const {
+	for (const MAPPED_MESH& ikMappedMesh : mappedMeshes_)
+		if (ikMappedMesh.pkMesh == pkMesh)
+			return &ikMappedMesh;
+
+	return nullptr;
+}
+
+
+
+bool MeshBatch::isVertexDataArena_() const {
+	if (vertexData_.size() != 1u || mappedMeshes_.size() != meshes_.size()) return false;
+
+	const VERTEX_DATA& kVertexData = vertexData_.front();
+	if (kVertexData.vertex != nVertices_ || kVertexData.indexOffset != indicesSize_) return false;
+
+	for (size_t i = 0u; i < meshes_.size(); i++) {
+		const MAPPED_MESH* pkMappedMesh = getMappedMesh_(meshes_.at(i));
+		const DRAW_COMMAND& kCommand = drawCommands_.at(i);
+
+		if (!pkMappedMesh || pkMappedMesh->firstVertex != static_cast<GLuint>(kCommand.baseVertex) ||
+			pkMappedMesh->indexOffset != MeshBatch::getIndexSize_(indexTypes_.at(i)) * kCommand.firstIndex)
+			return false;
+	}
+
+	return true;
+}
+
+
+
+GLsizeiptr MeshBatch::getVertexSize_() const {
+	return compactVertices_ ? static_cast<GLsizeiptr>(sizeof(Triangle::COMPACT_VERTEX_3D)) :
+		                      static_cast<GLsizeiptr>(sizeof(Triangle::VERTEX_3D));
+}
+
+
+
+GLenum MeshBatch::getIndexType_(const Mesh* pkMesh) const {
+	return compactVertices_ && pkMesh->getNumVertices() <= MeshBatch::kMaxShortIndexVertices_ ? GL_UNSIGNED_SHORT :
+		                                                                                       GL_UNSIGNED_INT;
+}
+
+
+
+// the buffer may be write-combined memory: each vertex is written whole
+void MeshBatch::writeVertices_(const Mesh* pkMesh, const vec3* pkVertices, const vec2* pkTexCoords,
+	                           const vec3* pkNormals, const vec3* pkTangents, const vec3* pkBitangents,
+	                           GLubyte* pVertices, vec4& rTexCoordRange) const {
+	unsigned int nVertices = pkMesh->getNumVertices();
+	rTexCoordRange = vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+	if (!compactVertices_) {
+		Triangle::VERTEX_3D* pGlVertices = reinterpret_cast<Triangle::VERTEX_3D*>(pVertices);
+
+		for (unsigned int i = 0u; i < nVertices; i++) {
+			Triangle::VERTEX_3D vertex = {};
+			vertex.position = pkVertices[i];
+
+			if (pkTexCoords) vertex.texCoord = pkTexCoords[i];
+			if (pkNormals) vertex.normal = pkNormals[i];
+			if (pkTangents && pkBitangents) {
+				vertex.tangent = pkTangents[i];
+				vertex.bitangent = pkBitangents[i];
+			}
+
+			pGlVertices[i] = vertex;
+		}
+		return;
+	}
+
+	// the positions in the bounding box of the mesh (see 'addMesh'), the texture coordinates in their range
+	vec3 positionOffset = *pkMesh->getBoundingBoxMin();
+	vec3 positionScale = *pkMesh->getBoundingBoxMax() - positionOffset;
+
+	vec2 texCoordMin(0.0f), texCoordMax(0.0f);
+	if (pkTexCoords && nVertices > 0u) {
+		texCoordMin = texCoordMax = pkTexCoords[0u];
+		for (unsigned int i = 1u; i < nVertices; i++) {
+			texCoordMin = glm::min(texCoordMin, pkTexCoords[i]);
+			texCoordMax = glm::max(texCoordMax, pkTexCoords[i]);
+		}
+	}
+	rTexCoordRange = vec4(texCoordMin, texCoordMax - texCoordMin);
+
+	vec3 positionFactor(positionScale.x > 0.0f ? 1.0f / positionScale.x : 0.0f,
+		                positionScale.y > 0.0f ? 1.0f / positionScale.y : 0.0f,
+		                positionScale.z > 0.0f ? 1.0f / positionScale.z : 0.0f);
+	vec2 texCoordFactor(rTexCoordRange.z > 0.0f ? 1.0f / rTexCoordRange.z : 0.0f,
+		                rTexCoordRange.w > 0.0f ? 1.0f / rTexCoordRange.w : 0.0f);
+
+	Triangle::COMPACT_VERTEX_3D* pGlVertices = reinterpret_cast<Triangle::COMPACT_VERTEX_3D*>(pVertices);
+
+	for (unsigned int i = 0u; i < nVertices; i++) {
+		Triangle::COMPACT_VERTEX_3D vertex = {};
+
+		vec3 position = (pkVertices[i] - positionOffset) * positionFactor;
+		vertex.position[0u] = MeshBatch::getUnorm_(position.x);
+		vertex.position[1u] = MeshBatch::getUnorm_(position.y);
+		vertex.position[2u] = MeshBatch::getUnorm_(position.z);
+		vertex.position[3u] = 65535u;
+
+		if (pkTexCoords) {
+			vec2 texCoord = (pkTexCoords[i] - texCoordMin) * texCoordFactor;
+			vertex.texCoord[0u] = MeshBatch::getUnorm_(texCoord.x);
+			vertex.texCoord[1u] = MeshBatch::getUnorm_(texCoord.y);
+		}
+
+		if (pkNormals) MeshBatch::getOctahedral_(pkNormals[i], vertex.normal);
+		if (pkNormals && pkTangents && pkBitangents) {
+			MeshBatch::getOctahedral_(pkTangents[i], vertex.tangent);
+			if (glm::dot(glm::cross(pkNormals[i], pkTangents[i]), pkBitangents[i]) < 0.0f) vertex.position[3u] = 0u;
+		}
+
+		pGlVertices[i] = vertex;
+	}
+}
+
+
+
+void MeshBatch::writeIndices_(const uvec3* pkFaces, unsigned int nFaces, GLenum indexType, GLubyte* pIndices) const {
+	if (indexType == GL_UNSIGNED_SHORT) {
+		GLushort* pGlIndices = reinterpret_cast<GLushort*>(pIndices);
+
+		for (unsigned int i = 0u; i < nFaces; i++) {
+			pGlIndices[3u * i] = static_cast<GLushort>(pkFaces[i].x);
+			pGlIndices[3u * i + 1u] = static_cast<GLushort>(pkFaces[i].y);
+			pGlIndices[3u * i + 2u] = static_cast<GLushort>(pkFaces[i].z);
+		}
+		return;
+	}
+
+	GLuint* pGlIndices = reinterpret_cast<GLuint*>(pIndices);
+
+	for (unsigned int i = 0u; i < nFaces; i++) {
+		pGlIndices[3u * i] = pkFaces[i].x;
+		pGlIndices[3u * i + 1u] = pkFaces[i].y;
+		pGlIndices[3u * i + 2u] = pkFaces[i].z;
+	}
+}
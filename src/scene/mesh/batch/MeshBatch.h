@@ -0,0 +1,216 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef MESH_BATCH_H
+#define MESH_BATCH_H
+
+#include <GL/gl3w.h>
+
+#include "DepthSorter.h"
+#include "info/GlDebug.h"
+#include "material/Material.h"
+#include "mesh/mesh/Mesh.h"
+#include "state/GlState.h"
+#include "texture/texture/ColorTexture.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using glm::mat4;
+using glm::uvec3;
+using glm::vec2;
+using glm::vec3;
+using glm::vec4;
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+
+
+// All meshes share one vertex/index arena; per-draw data is read in the shaders from a storage buffer
+// indexed by 'drawIdOffset + gl_DrawID', so a range of consecutive draws is a single glMultiDrawElementsIndirect.
+// The vertices of an imported model are written once, straight into a mapped buffer pair sized for the whole model
+// ('mapVertexData'); the arena is then that pair (a single model), or is copied from the pairs on the GPU.
+// With compact vertices the arena holds 'Triangle::COMPACT_VERTEX_3D' vertices, quantized in the ranges of their mesh
+// (kept in the per-draw data), and the indices of the meshes with up to 65536 vertices are 16-bit.
+class MeshBatch {
+public:
+	static GLuint getDrawDataBinding();
+	static GLuint getMaterialDataBinding();
+
+
+	MeshBatch();
+	~MeshBatch();
+
+
+	// off by default, set before the first import: the programs decode them (see 'MainProgram::Feature::COMPACT_VERTICES')
+	void setCompactVertices(bool on);
+
+
+	// import (see 'Model3D.loadMeshes'): 1) mapVertexData (for each model, sized for all its meshes)
+	//                                    2) mapMesh (for each mesh, returns 'mappedMeshId')
+	//                                    3) writeMesh (for each mapped mesh, any thread: one per mesh)
+	//                                    4) unmapVertexData
+	//############################################################################
+	void mapVertexData(unsigned int nVertices, unsigned int nIndices);
+	unsigned int mapMesh(const Mesh* pkMesh);
+	// the faces and vertices of the mesh (its bounding box loaded); nullptr -> none
+	void writeMesh(unsigned int mappedMeshId, const uvec3* pkFaces, const vec3* pkVertices, const vec2* pkTexCoords,
+		           const vec3* pkNormals, const vec3* pkTangents, const vec3* pkBitangents);
+	bool unmapVertexData(); // also after an error; false -> vertex data lost (display mode change), import again
+
+
+	// init: 1) addMaterial (for each material)
+	//       2) addMesh (for each mesh)
+	//       3) updateVertexBuffer
+	//       4) setAttribPointers
+	//############################################################################
+	unsigned int addMaterial(const Material* pkMaterial); // returns 'materialId'
+	unsigned int addMesh(const Mesh* pkMesh); // returns 'drawId'; mapped meshes: their vertices are not read
+
+	void updateVertexBuffer();
+	void setAttribPointers(GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex,
+		                   GLuint tangentIndex, GLuint bitangentIndex);
+
+
+	// render: 1) setDrawData, [sortFaces] (for each 'drawId')
+	//         2) updateDrawData
+	//         3) render (for each range of draws) / renderInstanced (for each instanced mesh)
+	//############################################################################
+	void setDrawData(unsigned int drawId, const mat4& kModelViewMatrix, const mat4& kModelViewProjectionMatrix,
+		                                  const mat4& kNormalMatrix);
+	void sortFaces(unsigned int drawId, const mat4& kModelViewMatrix); // meshes with transparency sorting
+	void updateDrawData() const;
+
+	void bindBuffers() const;
+	// GL_TRIANGLES / GL_PATCHES (3 vertices); the draws of a call have the same index type, see 'getNumRenderedDraws'
+	void render(unsigned int firstDrawId, unsigned int nDraws, GLenum mode) const;
+	void renderInstanced(unsigned int drawId, unsigned int nInstances, GLenum mode) const; // see 'MeshInstances'
+
+
+	// get
+	//############################################################################
+	unsigned int getNumDraws() const;
+	unsigned int getNumRenderedDraws(unsigned int firstDrawId, unsigned int nDraws) const; // by the first 'render' call
+	unsigned int getNumVertices() const;
+	unsigned int getNumIndices() const;
+	GLsizeiptr getVertexDataSize() const; // bytes of the vertices and indices
+	bool hasCompactVertices() const;
+	const Material* getMaterial(unsigned int materialId) const; // nullptr -> no such material
+	unsigned int getNumMaterials() const;
+
+private:
+	static const GLuint kMaxShortIndexVertices_;
+
+	static GLsizeiptr getIndexSize_(GLenum indexType);
+	static GLushort getUnorm_(float value);
+	static void getOctahedral_(const vec3& kVector, GLshort* pOctahedral); // 2 components
+
+	MeshBatch(const MeshBatch&);
+	const MeshBatch& operator=(const MeshBatch&) {}
+
+	unsigned int getMaterialId_(const Material* pkMaterial) const;
+
+	// the mapped vertex data of a mesh, nullptr -> its vertices are read from the mesh
+	struct MAPPED_MESH {
+		const Mesh* pkMesh;
+		unsigned int vertexDataId;
+		GLuint firstVertex;
+		GLintptr indexOffset; // bytes
+		GLenum indexType;
+		vec4 texCoordRange; // see 'DRAW_DATA', set by 'writeMesh'
+	};
+
+	const MAPPED_MESH* getMappedMesh_(const Mesh* pkMesh) const;
+	bool isVertexDataArena_() const;
+
+	GLsizeiptr getVertexSize_() const;
+	GLenum getIndexType_(const Mesh* pkMesh) const;
+
+	// interleaved, quantized with compact vertices ('rTexCoordRange')
+	void writeVertices_(const Mesh* pkMesh, const vec3* pkVertices, const vec2* pkTexCoords, const vec3* pkNormals,
+		                const vec3* pkTangents, const vec3* pkBitangents, GLubyte* pVertices, vec4& rTexCoordRange) const;
+	void writeIndices_(const uvec3* pkFaces, unsigned int nFaces, GLenum indexType, GLubyte* pIndices) const;
+
+	// std430 layouts, see 'shaders/main/structures.glsl'
+	struct DRAW_DATA {
+		mat4 modelViewMatrix, modelViewProjectionMatrix, normalMatrix;
+		vec4 positionOffset, positionScale; // compact vertices: position = offset + scale * unorm position (xyz)
+		vec4 texCoordRange; // compact vertices: texture coordinates = xy + zw * unorm coordinates
+		GLuint materialId;
+		GLuint padding[3u];
+	};
+
+	struct MATERIAL_DATA {
+		GLuint shadingModel;
+		GLuint padding0[3u];
+		vec3 ambientColor;
+		GLfloat padding1;
+		vec3 diffuseColor;
+		GLfloat padding2;
+		vec3 specularColor;
+		GLfloat padding3;
+		vec3 emissiveColor;
+		GLfloat shininess;
+		GLfloat opacity;
+		GLuint hasDiffuseTexture, hasSpecularTexture, hasEmissiveTexture, hasNormalMapTexture;
+		GLuint diffuseCompressed, specularCompressed, emissiveCompressed, normalMapCompressed;
+		GLuint padding4[3u];
+	};
+
+	struct DRAW_COMMAND {
+		GLuint count, instanceCount, firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	vector<const Material*> materials_;
+	vector<const Mesh*> meshes_;
+
+	vector<DRAW_DATA> drawData_;
+	vector<MATERIAL_DATA> materialData_;
+	vector<DRAW_COMMAND> drawCommands_; // 'firstIndex' in units of the index type of the draw
+	vector<GLenum> indexTypes_;
+	vector<DepthSorter*> depthSorters_; // nullptr for meshes without transparency sorting
+
+	// one buffer pair for each imported model
+	struct VERTEX_DATA {
+		GLuint verticesVbo, indicesVbo;
+		GLubyte* pVertices; // nullptr -> unmapped
+		GLubyte* pIndices;
+		GLuint nVertices; // size
+		GLsizeiptr indicesSize; // bytes
+		GLuint vertex; // used
+		GLintptr indexOffset; // used, bytes
+	};
+
+	vector<VERTEX_DATA> vertexData_; // deleted (or used as the arena) once the arena is loaded
+	vector<MAPPED_MESH> mappedMeshes_;
+
+	GLuint nVertices_, nIndices_;
+	GLsizeiptr indicesSize_; // bytes, each mesh aligned to 4 bytes
+	bool compactVertices_;
+	vector<GLushort> shortIndices_; // 'sortFaces'
+
+	GLuint vao_;
+	GLuint verticesVbo_, indicesVbo_, drawDataSsbo_, materialDataSsbo_, drawCommandsBuffer_;
+};
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "MeshInstances.h"
+
+
+
+GLuint MeshInstances::getInstanceDataBinding() {
+	return 3u;
+}
+
+
+
+GLuint MeshInstances::getVisibleInstanceDataBinding() {
+	return 4u;
+}
+
+
+
+MeshInstances::MeshInstances() : transforms_(), scales_(), visibleInstances_(), frustum_(), meshModelMatrix_(mat4(1.0f)),
+                                 instanceDataSsbo_(0u), visibleInstanceDataSsbo_(0u) {
+	glGenBuffers(1, &instanceDataSsbo_);
+	glGenBuffers(1, &visibleInstanceDataSsbo_);
+
+	//cout << "MeshInstances created." << endl;
+}
+
+
+
+MeshInstances::~MeshInstances() {
+	glDeleteBuffers(1, &instanceDataSsbo_);
+	glDeleteBuffers(1, &visibleInstanceDataSsbo_);
+
+	//cout << "MeshInstances deleted." << endl;
+}
+
+
+
+void MeshInstances::addInstances(const vector<mat4>& kTransforms) {
+	if (kTransforms.empty()) throw runtime_error("MeshInstances.addInstances|There should be at least one transformation.");
+
+	transforms_.insert(transforms_.end(), kTransforms.cbegin(), kTransforms.cend());
+
+	for (const mat4& ikTransform : kTransforms)
+		scales_.push_back(std::max({ glm::length(vec3(ikTransform[0u])), glm::length(vec3(ikTransform[1u])),
+			                         glm::length(vec3(ikTransform[2u])) }));
+
+	visibleInstances_.reserve(transforms_.size());
+
+	// the transformations are uploaded once; the visible ids are rewritten each frame
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceDataSsbo_);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(sizeof(mat4) * transforms_.size()), transforms_.data(),
+		         GL_STATIC_DRAW);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleInstanceDataSsbo_);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(sizeof(mat4) + sizeof(GLuint) * transforms_.size()),
+		         nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+}
+
+
+
+void MeshInstances::selectInstances(const vec3& kCenter, float radius, const mat4& kMeshModelMatrix,
+	                                const mat4& kViewProjectionMatrix, bool culling) {
+	meshModelMatrix_ = kMeshModelMatrix;
+	visibleInstances_.clear();
+
+	unsigned int nInstances = static_cast<unsigned int>(transforms_.size());
+
+	if (culling) {
+		frustum_.update(kViewProjectionMatrix);
+
+		// bounding sphere of the mesh in scene space, moved and scaled by each transformation
+		vec4 center = kMeshModelMatrix * vec4(kCenter, 1.0f);
+		radius *= std::max({ glm::length(vec3(kMeshModelMatrix[0u])), glm::length(vec3(kMeshModelMatrix[1u])),
+			                 glm::length(vec3(kMeshModelMatrix[2u])) });
+
+		for (unsigned int i = 0u; i < nInstances; i++)
+			if (frustum_.intersectsSphere(vec3(transforms_[i] * center), radius * scales_[i]))
+				visibleInstances_.push_back(i);
+	}
+	else
+		for (unsigned int i = 0u; i < nInstances; i++)
+			visibleInstances_.push_back(i);
+
+	// std430: mat4 meshModelMatrix, uint visibleInstances[]
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleInstanceDataSsbo_);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(mat4)), &meshModelMatrix_);
+	if (!visibleInstances_.empty())
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(sizeof(mat4)),
+			            static_cast<GLsizeiptr>(sizeof(GLuint) * visibleInstances_.size()), visibleInstances_.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+
+	GlDebug::countCalls(4u);
+}
+
+
+
+void MeshInstances::bindBuffers() const {
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshInstances::getInstanceDataBinding(), instanceDataSsbo_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshInstances::getVisibleInstanceDataBinding(), visibleInstanceDataSsbo_);
+
+	GlDebug::countCalls(2u);
+}
+
+
+
+unsigned int MeshInstances::getNumInstances() const {
+	return static_cast<unsigned int>(transforms_.size());
+}
+
+
+
+unsigned int MeshInstances::getNumVisibleInstances() const {
+	return static_cast<unsigned int>(visibleInstances_.size());
+}
+
+
+
+float MeshInstances::getMaxDistance(const vec3& kCenter, float radius, const mat4& kMeshModelMatrix) const {
+	vec4 center = kMeshModelMatrix * vec4(kCenter, 1.0f);
+	radius *= std::max({ glm::length(vec3(kMeshModelMatrix[0u])), glm::length(vec3(kMeshModelMatrix[1u])),
+		                 glm::length(vec3(kMeshModelMatrix[2u])) });
+
+	float maxDistance = 0.0f;
+
+	for (unsigned int i = 0u; i < transforms_.size(); i++)
+		maxDistance = std::max(maxDistance, glm::length(vec3(transforms_[i] * center)) + radius * scales_[i]);
+
+	return maxDistance;
+}
+
+
+
+string MeshInstances::toString() const {
+	return "Instances: " + to_string(visibleInstances_.size()) + " of " + to_string(transforms_.size()) + " visible";
+}
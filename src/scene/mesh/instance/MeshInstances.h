@@ -0,0 +1,92 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef MESH_INSTANCES_H
+#define MESH_INSTANCES_H
+
+#include <GL/gl3w.h>
+
+#include "camera/Frustum.h"
+#include "info/GlDebug.h"
+
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using glm::mat4;
+using glm::vec3;
+using glm::vec4;
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::runtime_error;
+using std::string;
+using std::to_string;
+using std::vector;
+
+
+
+// Copies of one mesh of the mesh batch, drawn with one instanced call. The transformations of the instances are in
+// scene space and stay on the GPU; each frame only the ids of the instances inside the frustum are uploaded, and the
+// vertex shader reads 'transforms[visibleInstances[gl_InstanceID]] * meshModelMatrix', see 'shaders/main/scene.vert'.
+class MeshInstances {
+public:
+	static GLuint getInstanceDataBinding();
+	static GLuint getVisibleInstanceDataBinding();
+
+
+	MeshInstances();
+	~MeshInstances();
+
+
+	// init: addInstances
+	//############################################################################
+	void addInstances(const vector<mat4>& kTransforms);
+
+
+	// render: 1) selectInstances
+	//         2) bindBuffers, render (see 'MeshBatch')
+	//############################################################################
+	// the sphere ('kCenter', 'radius') is in object space, 'kViewProjectionMatrix' in scene space;
+	// culling = false -> all instances
+	void selectInstances(const vec3& kCenter, float radius, const mat4& kMeshModelMatrix,
+		                 const mat4& kViewProjectionMatrix, bool culling);
+	void bindBuffers() const;
+
+
+	// get
+	//############################################################################
+	unsigned int getNumInstances() const;
+	unsigned int getNumVisibleInstances() const; // last selection
+
+	// largest distance from the scene origin of the instances of the sphere ('kCenter', 'radius', object space)
+	float getMaxDistance(const vec3& kCenter, float radius, const mat4& kMeshModelMatrix) const;
+
+	string toString() const;
+
+private:
+	MeshInstances(const MeshInstances&);
+	const MeshInstances& operator=(const MeshInstances&) {}
+
+	vector<mat4> transforms_;
+	vector<float> scales_; // largest axis scale of each transformation, for the bounding spheres
+	vector<GLuint> visibleInstances_;
+
+	Frustum frustum_; // scene space
+	mat4 meshModelMatrix_;
+
+	GLuint instanceDataSsbo_, visibleInstanceDataSsbo_;
+};
+
+#endif
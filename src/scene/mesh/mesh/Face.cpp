@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 31, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Face.h"
@@ -32,6 +32,16 @@ Face::Face(unsigned int id, unsigned int meshId, unsigned int modelId, const Mat
 
 
 
+Face::Face(unsigned int id, unsigned int modelId, const Material* pkMaterial):
+	       kId_(id), kMeshId_(id), kModelId_(modelId), pkMaterial_(pkMaterial),
+	       pTriangle_(nullptr), transformationMatrix_(mat4(1.0f)), nVertices_(3u), nFaces_(1u),
+	       rotationSpeed_(0.0f), twoSided_(false), wireframe_(false), hasShadow_(false),
+	       modelMatrix_(mat4(1.0f)), rotationMatrix_(mat4(1.0f)), rotationAxis_(vec3(0.0f, 1.0f, 0.0f)), rotationAngle_(0.0f) {
+	//cout << "Face " << toString() << " created." << endl;
+}
+
+
+
 Face::~Face() {
 	if (pTriangle_) delete pTriangle_;
 
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 31, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef FACE_H
@@ -118,6 +118,9 @@ public:
 	virtual string toString() const;
 
 protected:
+	// no triangle: the vertex data is kept by the derived class (see 'Mesh')
+	Face(unsigned int id, unsigned int modelId, const Material* pkMaterial);
+
 	const unsigned int kId_, kMeshId_, kModelId_;
 	const Material* pkMaterial_;
 
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 31, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Mesh.h"
@@ -8,8 +8,11 @@
 
 
 Mesh::Mesh(unsigned int id, unsigned int modelId, const Material* pkMaterial, 
-	       unsigned int nFaces, unsigned int nVertices, bool transparencySorting) : Face(id, id, modelId, pkMaterial),
-	       pTriangleStrip_(nullptr), pFaces_(nullptr), transparentFaces_(), transparencySorting_(false) {
+	       unsigned int nFaces, unsigned int nVertices, bool transparencySorting) : Face(id, modelId, pkMaterial),
+	       pFaces_(nullptr), pVertices_(nullptr), pTexCoords_(nullptr), pNormals_(nullptr), pTangents_(nullptr),
+	       pBitangents_(nullptr), boundingBoxMin_(vec3(0.0f)), boundingBoxMax_(vec3(0.0f)),
+	       boundingSphereCenter_(vec3(0.0f)), boundingSphereRadius_(0.0f), transparencySorting_(false),
+	       batchedTexCoords_(false), batchedNormals_(false), batchedTangentsAndBitangents_(false) {
 	if (nVertices < 3u) 
 		throw runtime_error("Mesh|Invalid number of vertices value.");
 	else if (nVertices == 3u && nFaces != 1u) 
@@ -20,9 +23,6 @@ Mesh::Mesh(unsigned int id, unsigned int modelId, const Material* pkMaterial,
 	nVertices_ = nVertices;
 	nFaces_ = nFaces;
 
-	delete pTriangle_; pTriangle_ = nullptr;
-	pTriangleStrip_ = new TriangleStrip(nVertices, nFaces * 3u);
-
 	if (pkMaterial->isTransparent()) transparencySorting_ = transparencySorting;
 
 	//cout << "Mesh " << toString() << " created." << endl;
@@ -31,8 +31,12 @@ Mesh::Mesh(unsigned int id, unsigned int modelId, const Material* pkMaterial,
 
 
 Mesh::~Mesh() {
-	delete pTriangleStrip_;
 	if (pFaces_) delete[] pFaces_;
+	if (pVertices_) delete[] pVertices_;
+	if (pTexCoords_) delete[] pTexCoords_;
+	if (pNormals_) delete[] pNormals_;
+	if (pTangents_) delete[] pTangents_;
+	if (pBitangents_) delete[] pBitangents_;
 
 	//cout << "Mesh " << toString() << " deleted." << endl;
 }
@@ -49,435 +53,229 @@ void Mesh::loadFaces(const uvec3* pkFaces) {
 	catch (const exception& kException) {
 		throw runtime_error("Mesh.loadFaces > copy > " + string(kException.what()));
 	}
+}
 
-	uvec1* pIndices = new uvec1[static_cast<size_t>(nFaces_) * 3u];
-	
-	for (unsigned int i = 0u; i < nFaces_; i++) {
-		pIndices[3u * i].x = pkFaces[i].x;
-		pIndices[3u * i + 1u].x = pkFaces[i].y;
-		pIndices[3u * i + 2u].x = pkFaces[i].z;
-	}
-
-	try {
-		pTriangleStrip_->loadIndices(pIndices);
-	}
-	catch (const exception& kException) {
-		delete[] pIndices;
-		throw runtime_error("Mesh.loadFaces > " + string(kException.what()));
-	}
-
-	delete[] pIndices;
-
-	if (transparencySorting_) {
-		transparentFaces_.clear();
 
-		for (unsigned int i = 0u; i < nFaces_; i++) {
-			try {
-				transparentFaces_.emplace_back(i, kId_, kModelId_, pkMaterial_);
-				Face* pFace = &transparentFaces_.back();
 
-				pFace->setTwoSided(twoSided_);
-				pFace->setWireframe(wireframe_);
+void Mesh::loadVertices(const vec3* pkVertices) {
+	if (!pFaces_) throw runtime_error("Mesh.loadVertices|Faces not loaded yet.");
 
-				pFace->transform(transformationMatrix_);
-				pFace->setRotationSpeed(rotationSpeed_);
-			}
-			catch (const exception& kException) {
-				throw runtime_error("Mesh.loadFaces > " + string(kException.what()));
-			}
-		}
-	}
+	loadVertices_(pkVertices);
+	computeBoundingVolumes_(pkVertices);
 }
 
 
 
-void Mesh::loadVertices(const vec3* pkVertices) {
+void Mesh::loadVertices(const vec3* pkVertices, const vec3& kBoundingBoxMin, const vec3& kBoundingBoxMax,
+	                    float boundingSphereRadius) {
 	if (!pFaces_) throw runtime_error("Mesh.loadVertices|Faces not loaded yet.");
 
-	try {
-		pTriangleStrip_->loadVertices(pkVertices);
-
-		if (transparencySorting_)
-			for (unsigned int i = 0u; i < nFaces_; i++) {
-				vec3 vert[3u];
-				vert[0u] = pkVertices[pFaces_[i].x];
-				vert[1u] = pkVertices[pFaces_[i].y];
-				vert[2u] = pkVertices[pFaces_[i].z];
-
-				for (Face& iFace : transparentFaces_)
-					if (iFace.getMeshId() == kId_ && iFace.getId() == i) {
-						iFace.loadVertices(vert);
-						break;
-					}
-			}		
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.loadVertices > " + string(kException.what()));
-	}
+	loadVertices_(pkVertices);
+
+	boundingBoxMin_ = kBoundingBoxMin;
+	boundingBoxMax_ = kBoundingBoxMax;
+	boundingSphereCenter_ = 0.5f * (boundingBoxMin_ + boundingBoxMax_);
+	boundingSphereRadius_ = boundingSphereRadius;
 }
 
 
 
 void Mesh::loadTexCoords(const vec2* pkTexCoords) {
-	if (!pFaces_) throw runtime_error("Mesh.loadTexCoords|Faces not loaded yet.");
+	if (!pVertices_) throw runtime_error("Mesh.loadTexCoords|Vertices not loaded yet.");
 
-	try {
-		pTriangleStrip_->loadTexCoords(pkTexCoords);
-
-		if (transparencySorting_)
-			for (unsigned int i = 0u; i < nFaces_; i++) {
-				vec2 tex[3u];
-				tex[0u] = pkTexCoords[pFaces_[i].x];
-				tex[1u] = pkTexCoords[pFaces_[i].y];
-				tex[2u] = pkTexCoords[pFaces_[i].z];
-				
-				for (Face& iFace : transparentFaces_)
-					if (iFace.getMeshId() == kId_ && iFace.getId() == i) {
-						iFace.loadTexCoords(tex);
-						break;
-					}
-			}		
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.loadTexCoords > " + string(kException.what()));
-	}
+	if (pTexCoords_) delete[] pTexCoords_;
+	pTexCoords_ = new vec2[nVertices_];
+	std::copy(pkTexCoords, pkTexCoords + nVertices_, pTexCoords_);
 }
 
 
 
 void Mesh::loadNormals(const vec3* pkNormals) {
-	if (!pFaces_) throw runtime_error("Mesh.loadNormals|Faces not loaded yet.");
+	if (!pVertices_) throw runtime_error("Mesh.loadNormals|Vertices not loaded yet.");
 
-	try {
-		pTriangleStrip_->loadNormals(pkNormals);
-
-		if (transparencySorting_)
-			for (unsigned int i = 0u; i < nFaces_; i++) {
-				vec3 norm[3u];
-				norm[0u] = pkNormals[pFaces_[i].x];
-				norm[1u] = pkNormals[pFaces_[i].y];
-				norm[2u] = pkNormals[pFaces_[i].z];
-
-				for (Face& iFace : transparentFaces_)
-					if (iFace.getMeshId() == kId_ && iFace.getId() == i) {
-						iFace.loadNormals(norm);
-						break;
-					}
-			}		
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.loadNormals > " + string(kException.what()));
-	}
+	if (pNormals_) delete[] pNormals_;
+	pNormals_ = new vec3[nVertices_];
+	std::copy(pkNormals, pkNormals + nVertices_, pNormals_);
 }
 
 
 
 void Mesh::loadTangentsAndBitangents(const vec3* pkTangents, const vec3* pkBitangents) {
-	if (!pFaces_) throw runtime_error("Mesh.loadTangentsAndBitangents|Faces not loaded yet.");
+	if (!pNormals_) throw runtime_error("Mesh.loadTangentsAndBitangents|Normals not loaded yet.");
 
-	try {
-		pTriangleStrip_->loadTangentsAndBitangents(pkTangents, pkBitangents);
-
-		if (transparencySorting_)
-			for (unsigned int i = 0u; i < nFaces_; i++) {
-				vec3 tg[3u];
-				vec3 bitg[3u];
-
-				tg[0u] = pkTangents[pFaces_[i].x];
-				tg[1u] = pkTangents[pFaces_[i].y];
-				tg[2u] = pkTangents[pFaces_[i].z];
-				bitg[0u] = pkBitangents[pFaces_[i].x];
-				bitg[1u] = pkBitangents[pFaces_[i].y];
-				bitg[2u] = pkBitangents[pFaces_[i].z];
-
-				for (Face& iFace : transparentFaces_)
-					if (iFace.getMeshId() == kId_ && iFace.getId() == i) {
-						iFace.loadTangentsAndBitangents(tg, bitg);
-						break;
-					}
-			}		
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.loadTangentsAndBitangents > " + string(kException.what()));
-	}
+	if (pTangents_) delete[] pTangents_;
+	pTangents_ = new vec3[nVertices_];
+	std::copy(pkTangents, pkTangents + nVertices_, pTangents_);
+
+	if (pBitangents_) delete[] pBitangents_;
+	pBitangents_ = new vec3[nVertices_];
+	std::copy(pkBitangents, pkBitangents + nVertices_, pBitangents_);
 }
 
 
 
-void Mesh::updateVertexBuffer() const {
-	try {
-		if (transparencySorting_)
-			for (const Face& ikFace : transparentFaces_)
-				ikFace.updateVertexBuffer();		
-		else pTriangleStrip_->updateVertexBuffer();
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.updateVertexBuffer > " + string(kException.what()));
-	}
-}
+void Mesh::setBatchedAttributes(bool hasTexCoords, bool hasNormals, bool hasTangentsAndBitangents) {
+	if (!pFaces_) throw runtime_error("Mesh.setBatchedAttributes|Faces not loaded yet.");
 
+	batchedTexCoords_ = hasTexCoords;
+	batchedNormals_ = hasNormals;
+	batchedTangentsAndBitangents_ = hasNormals && hasTangentsAndBitangents;
+}
 
 
-void Mesh::setAttribPointers(unsigned int programId, GLuint positionIndex) {
-	if (transparencySorting_)
-		for (Face& iFace : transparentFaces_)
-			iFace.setAttribPointers(programId, positionIndex);
 
-	else pTriangleStrip_->setAttribPointers(programId, positionIndex);
+unsigned int Mesh::getNumFaces() const {
+	return nFaces_;
 }
 
 
 
-void Mesh::setAttribPointers(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex) {
-	if (transparencySorting_)
-		for (Face& iFace : transparentFaces_)
-			iFace.setAttribPointers(programId, positionIndex, texCoordIndex);
-
-	else pTriangleStrip_->setAttribPointers(programId, positionIndex, texCoordIndex);
+const uvec3* Mesh::getFace(unsigned int id) const {
+	if (pFaces_ && id < nFaces_)
+		return &pFaces_[id];
+	else throw runtime_error("Mesh.getFace|Invalid id value or faces not loaded yet.");
 }
 
 
 
-void Mesh::setAttribPointers(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex) {
-	if (transparencySorting_)
-		for (Face& iFace : transparentFaces_)
-			iFace.setAttribPointers(programId, positionIndex, texCoordIndex, normalIndex);
-
-	else pTriangleStrip_->setAttribPointers(programId, positionIndex, texCoordIndex, normalIndex);
+unsigned int Mesh::getNumVertices() const {
+	return nVertices_;
 }
 
 
 
-void Mesh::setAttribPointers(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex,
-	                         GLuint tangentIndex, GLuint bitangentIndex) {
-	if (transparencySorting_)
-		for (Face& iFace : transparentFaces_)
-			iFace.setAttribPointers(programId, positionIndex, texCoordIndex, normalIndex, tangentIndex, bitangentIndex);
-	
-	else pTriangleStrip_->setAttribPointers(programId, positionIndex, texCoordIndex, normalIndex, tangentIndex, bitangentIndex);
+const vec3* Mesh::getVertex(unsigned int id) const {
+	if (pVertices_ && id < nVertices_)
+		return &pVertices_[id];
+	else throw runtime_error("Mesh.getVertex|Invalid id value or vertices not loaded yet.");
 }
 
 
 
-void Mesh::setTwoSided(bool twoSided) {
-	Face::setTwoSided(twoSided);
-	for (Face& iFace : transparentFaces_)
-		iFace.setTwoSided(twoSided);
+const vec2* Mesh::getTexCoord(unsigned int id) const {
+	if (pTexCoords_ && id < nVertices_)
+		return &pTexCoords_[id];
+	else throw runtime_error("Mesh.getTexCoord|Invalid id value or tex coords not loaded (or batched).");
 }
 
 
 
-void  Mesh::setWireframe(bool wireframe) {
-	Face::setWireframe(wireframe);
-	for (Face& iFace : transparentFaces_)
-		iFace.setWireframe(wireframe);
+const vec3* Mesh::getNormal(unsigned int id) const {
+	if (pNormals_ && id < nVertices_)
+		return &pNormals_[id];
+	else throw runtime_error("Mesh.getNormal|Invalid id value or normals not loaded (or batched).");
 }
 
 
 
-void Mesh::transform(const mat4& kMatrix) {
-	Face::transform(kMatrix);
-	for (Face& iFace : transparentFaces_)
-		try {
-			iFace.transform(kMatrix);
-		}
-		catch (const exception& kException) {
-			throw runtime_error("Mesh.transform > " + string(kException.what()));
-		}
+const vec3* Mesh::getTangent(unsigned int id) const {
+	if (pTangents_ && id < nVertices_)
+		return &pTangents_[id];
+	else throw runtime_error("Mesh.getTangent|Invalid id value or tangents not loaded (or batched).");
 }
 
 
 
-void Mesh::translate(const vec3& kDistance) {
-	Face::translate(kDistance);
-
-	for (Face& iFace : transparentFaces_)
-		try {
-			iFace.translate(kDistance);
-		}
-		catch (const exception& kException) {
-			throw runtime_error("Mesh.translate > " + string(kException.what()));
-		}
+const vec3* Mesh::getBitangent(unsigned int id) const {
+	if (pBitangents_ && id < nVertices_)
+		return &pBitangents_[id];
+	else throw runtime_error("Mesh.getBitangent|Invalid id value or bitangents not loaded (or batched).");
 }
 
 
 
-void Mesh::scale(const vec3& kScale) {
-	Face::scale(kScale);
-	for (Face& iFace : transparentFaces_)
-		try {
-			iFace.scale(kScale);
-		}
-		catch (const exception& kException) {
-			throw runtime_error("Mesh.scale > " + string(kException.what()));
-		}
+bool Mesh::hasFaces() const {
+	return (pFaces_ && (nFaces_ > 0u));
 }
 
 
 
-void Mesh::rotate(float angle, const vec3& kAxis) { // degrees
-	Face::rotate(angle, kAxis);
-	for (Face& iFace : transparentFaces_)
-		try {
-			iFace.rotate(angle, kAxis);
-		}
-		catch (const exception& kException) {
-			throw runtime_error("Mesh.rotate > " + string(kException.what()));
-		}
+bool Mesh::hasVertices() const {
+	return pVertices_ != nullptr;
 }
 
 
 
-void Mesh::setRotationSpeed(float speed) {
-	Face::setRotationSpeed(speed);
-	for (Face& iFace : transparentFaces_)
-		iFace.setRotationSpeed(speed);
+bool Mesh::hasTexCoords() const {
+	return batchedTexCoords_ || pTexCoords_;
 }
 
 
 
-void Mesh::updateRotation(float deltaTime) {
-	Face::updateRotation(deltaTime);
-	for (Face& iFace : transparentFaces_)
-		iFace.updateRotation(deltaTime);
+bool Mesh::hasNormals() const {
+	return batchedNormals_ || pNormals_;
 }
 
 
 
-void Mesh::render(unsigned int programId) const {
-	try {
-		if (transparencySorting_)
-			for (const Face& ikFace : transparentFaces_)
-				ikFace.render(programId);		
-		else pTriangleStrip_->render(programId);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.render > " + string(kException.what()));
-	}
+bool Mesh::hasTangentsAndBitangents() const {
+	return batchedTangentsAndBitangents_ || (pTangents_ && pBitangents_);
 }
 
 
 
-unsigned int Mesh::getNumFaces() const {
-	return pFaces_ ? nFaces_ : 0u;
+const vec3* Mesh::getBoundingBoxMin() const {
+	return &boundingBoxMin_;
 }
 
 
 
-unsigned int Mesh::getNumVertices() const {
-	return pTriangleStrip_->getNumVertices();
+const vec3* Mesh::getBoundingBoxMax() const {
+	return &boundingBoxMax_;
 }
 
 
 
-const vec3* Mesh::getVertex(unsigned int id) const {
-	try {
-		return pTriangleStrip_->getVertex(id);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.getVertex > " + string(kException.what()));
-	}
+const vec3* Mesh::getBoundingSphereCenter() const {
+	return &boundingSphereCenter_;
 }
 
 
 
-const vec2* Mesh::getTexCoord(unsigned int id) const {
-	try {
-		return pTriangleStrip_->getTexCoord(id);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.getTexCoord > " + string(kException.what()));
-	}
+float Mesh::getBoundingSphereRadius() const {
+	return boundingSphereRadius_;
 }
 
 
 
-const vec3* Mesh::getNormal(unsigned int id) const {
-	try {
-		return pTriangleStrip_->getNormal(id);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.getNormal > " + string(kException.what()));
-	}
+bool Mesh::hasTransparencySorting() const {
+	return transparencySorting_;
 }
 
 
 
-const vec3* Mesh::getTangent(unsigned int id) const {
-	try {
-		return pTriangleStrip_->getTangent(id);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Mesh.getTangent > " + string(kException.what()));
-	}
+string Mesh::toString() const {
+	return to_string(kModelId_) + "_" + to_string(kId_);
 }
 
 
 
-const vec3* Mesh::getBitangent(unsigned int id) const {
+void Mesh::loadVertices_(const vec3* pkVertices) {
+	if (pVertices_) delete[] pVertices_;
+	pVertices_ = new vec3[nVertices_];
+
 	try {
-		return pTriangleStrip_->getBitangent(id);
+		std::copy(pkVertices, pkVertices + nVertices_, pVertices_);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("Mesh.getBitangent > " + string(kException.what()));
+		throw runtime_error("Mesh.loadVertices_ > copy > " + string(kException.what()));
 	}
 }
 
 
 
-bool Mesh::hasFaces() const {
-	return (pFaces_ && (nFaces_ > 0u));
-}
-
-
-
-bool Mesh::hasVertices() const {
-	return pTriangleStrip_->hasVertices();
-}
-
-
-
-bool Mesh::hasTexCoords() const {
-	return pTriangleStrip_->hasTexCoords();
-}
-
-
-
-bool Mesh::hasNormals() const {
-	return pTriangleStrip_->hasNormals();
-}
-
-
-
-bool Mesh::hasTangentsAndBitangents() const {
-	return pTriangleStrip_->hasTangentsAndBitangents();
-}
-
-
-
-unsigned int Mesh::getNumTransparentFaces() const {
-	return static_cast<unsigned int>(transparentFaces_.size());
-}
-
+// object space; the sphere is centered on the box
+void Mesh::computeBoundingVolumes_(const vec3* pkVertices) {
+	boundingBoxMin_ = boundingBoxMax_ = pkVertices[0u];
 
-
-const Face* Mesh::getTransparentFace(unsigned int id) const {
-	unsigned int i = 0u;
-	for (const Face& ikFace : transparentFaces_) {
-		if (i == id) return &ikFace;
-		i++;
+	for (unsigned int i = 1u; i < nVertices_; i++) {
+		boundingBoxMin_ = glm::min(boundingBoxMin_, pkVertices[i]);
+		boundingBoxMax_ = glm::max(boundingBoxMax_, pkVertices[i]);
 	}
-	return nullptr;
-}
 
+	boundingSphereCenter_ = 0.5f * (boundingBoxMin_ + boundingBoxMax_);
+	boundingSphereRadius_ = 0.0f;
 
-
-bool Mesh::hasTransparentFaces() const {
-	return (transparentFaces_.size() > 0u);
-}
-
-
-
-string Mesh::toString() const {
-	return to_string(kModelId_) + "_" + to_string(kId_);
+	for (unsigned int i = 0u; i < nVertices_; i++)
+		boundingSphereRadius_ = std::max(boundingSphereRadius_, glm::distance(boundingSphereCenter_, pkVertices[i]));
 }
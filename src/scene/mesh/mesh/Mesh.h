@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 31, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef MESH_H
@@ -10,23 +10,20 @@
 
 #include "Face.h"
 #include "material/Material.h"
-#include "mesh/triangle/TriangleStrip.h"
 
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
-#include <glm/ext/vector_uint1.hpp>
-
 #include <algorithm>
 #include <exception>
 #include <iostream>
-#include <list>
 #include <stdexcept>
 #include <string>
 
 using glm::mat4;
-using glm::uvec1;
 using glm::uvec3;
 using glm::vec2;
 using glm::vec3;
@@ -34,13 +31,15 @@ using glm::vec3;
 using std::cout;
 using std::endl;
 using std::exception;
-using std::list;
 using std::runtime_error;
 using std::string;
 using std::to_string;
 
 
 
+// Mesh of a model, drawn by the mesh batch (see 'MeshBatch'): no GL object of its own, it keeps its faces and vertex
+// positions (bounding volumes, horizon occluder, depth sorting) and, unless written straight to the batch buffer, the
+// other vertex attributes until the batch is uploaded.
 class Mesh : public Face {
 public:
 	Mesh(unsigned int id, unsigned int modelId, const Material* pkMaterial,
@@ -51,54 +50,49 @@ public:
 	// init: 1) loadFaces
 	//       2) loadVertices
 	//       3) [loadTexCoords], [loadNormals]
-	//       4) [loadTangentsAndBitangents]
-	//       5) updateVertexBuffer
-	//       6) setAttribPointers (for each program)
+	//       4) [loadTangentsAndBitangents] or setBatchedAttributes
 	//############################################################################
 	void loadFaces(const uvec3* pkFaces);
 
 	virtual void loadVertices(const vec3* pkVertices);
+	// bounding volumes known (see 'MeshCache'), object space
+	void loadVertices(const vec3* pkVertices, const vec3& kBoundingBoxMin, const vec3& kBoundingBoxMax,
+		              float boundingSphereRadius);
 	
 	virtual void loadTexCoords(const vec2* pkTexCoords);
 	virtual void loadNormals(const vec3* pkNormals);
 	virtual void loadTangentsAndBitangents(const vec3* pkTangents, const vec3* pkBitangents);
 
-	virtual void updateVertexBuffer() const;	
-
-	virtual void setAttribPointers(unsigned int programId, GLuint positionIndex);
-	virtual void setAttribPointers(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex);
-	virtual void setAttribPointers(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex);
-	virtual void setAttribPointers(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex,
-		                           GLuint tangentIndex, GLuint bitangentIndex);
+	// or written straight to the batch buffer instead (see 'MeshBatch.mapMesh'): not kept, only reported by 'has...'
+	void setBatchedAttributes(bool hasTexCoords, bool hasNormals, bool hasTangentsAndBitangents);
 
 	
 	// set
 	//############################################################################
-	virtual void setTwoSided(bool twoSided);
-	virtual void setWireframe(bool wireframe);
+	//-> virtual void setTwoSided(bool twoSided);
+	//-> virtual void setWireframe(bool wireframe);
 
-	virtual void transform(const mat4& kMatrix);
-	virtual void translate(const vec3& kDistance);
-	virtual void scale(const vec3& kScale);
-	virtual void rotate(float angle, const vec3& kAxis); // degrees	
+	//-> virtual void transform(const mat4& kMatrix);
+	//-> virtual void translate(const vec3& kDistance);
+	//-> virtual void scale(const vec3& kScale);
+	//-> virtual void rotate(float angle, const vec3& kAxis); // degrees
 
-	virtual void setRotationSpeed(float speed);
+	//-> virtual void setRotationSpeed(float speed);
 
 	
-	// render: 1) updateRotation
-	//         2) render (with 'programId')
+	// render: updateRotation (drawn by the mesh batch)
 	//############################################################################
-	virtual void updateRotation(float deltaTime);
-	virtual void render(unsigned int programId) const;
+	//-> virtual void updateRotation(float deltaTime);
 
 
 	// get
 	//############################################################################
 	//-> const Material* getMaterial() const;
 
-	unsigned int getNumFaces() const;
+	unsigned int getNumFaces() const; // sized by the constructor, loaded or not
+	const uvec3* getFace(unsigned int id) const; // id = 0 ... numFaces - 1
 
-	virtual unsigned int getNumVertices() const;
+	virtual unsigned int getNumVertices() const; // sized by the constructor, loaded or not
 
 	virtual const vec3* getVertex(unsigned int id) const; // id = 0 ... numVertices - 1
 	virtual const vec2* getTexCoord(unsigned int id) const; // id = 0 ... numVertices - 1
@@ -113,9 +107,12 @@ public:
 	virtual bool hasNormals() const;
 	virtual bool hasTangentsAndBitangents() const;
 
-	unsigned int getNumTransparentFaces() const;
-	const Face* getTransparentFace(unsigned int id) const; // id = 0 ... numTransparentFaces - 1
-	bool hasTransparentFaces() const;	
+	const vec3* getBoundingBoxMin() const; // object space
+	const vec3* getBoundingBoxMax() const; // object space
+	const vec3* getBoundingSphereCenter() const; // object space
+	float getBoundingSphereRadius() const; // object space
+
+	bool hasTransparencySorting() const; // faces drawn back to front, see 'DepthSorter'
 
 	//-> bool isTwoSided() const;
 	//-> bool isWireframe() const;
@@ -133,10 +130,17 @@ private:
 	Mesh(const Mesh&);
 	const Mesh& operator=(const Mesh&) {}
 
-	TriangleStrip* pTriangleStrip_;
+	void loadVertices_(const vec3* pkVertices);
+	void computeBoundingVolumes_(const vec3* pkVertices);
+
 	uvec3* pFaces_;
-	list<Face> transparentFaces_;
+	vec3* pVertices_;
+	vec2* pTexCoords_; // not batched
+	vec3* pNormals_, * pTangents_, * pBitangents_; // not batched
+	vec3 boundingBoxMin_, boundingBoxMax_, boundingSphereCenter_;
+	float boundingSphereRadius_;
 	bool transparencySorting_;
+	bool batchedTexCoords_, batchedNormals_, batchedTangentsAndBitangents_;
 };
 
 #endif
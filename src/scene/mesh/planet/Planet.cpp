@@ -0,0 +1,224 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "Planet.h"
+
+
+
+const unsigned int Planet::kGridSize_ = 32u;
+const unsigned int Planet::kMaxLevel_ = 12u;
+const unsigned int Planet::kMaxNodes_ = 4096u;
+const float Planet::kPixelError_ = 2.0f;
+const float Planet::kMorphStart_ = 0.7f;
+const float Planet::kOccluderScale_ = 0.99f;
+
+
+
+GLuint Planet::getNodeDataBinding() {
+	return 2u;
+}
+
+
+
+Planet::Planet() : nodes_(), switchDistances_(), frustum_(), center_(vec3(0.0f)), eyePosition_(vec3(0.0f)), radius_(1.0f),
+                   vao_(0u), gridVbo_(0u), gridIbo_(0u), nodeDataSsbo_(0u), nGridIndices_(0) {
+	const unsigned int kRowSize = kGridSize_ + 1u;
+
+	vector<vec2> gridPositions;
+	gridPositions.reserve(kRowSize * kRowSize);
+
+	for (unsigned int j = 0u; j < kRowSize; j++)
+		for (unsigned int i = 0u; i < kRowSize; i++)
+			gridPositions.push_back(vec2(static_cast<float>(i), static_cast<float>(j)) / static_cast<float>(kGridSize_));
+
+	// two counterclockwise triangles per quad, seen from outside the sphere
+	vector<GLushort> gridIndices;
+	gridIndices.reserve(6u * kGridSize_ * kGridSize_);
+
+	for (unsigned int j = 0u; j < kGridSize_; j++)
+		for (unsigned int i = 0u; i < kGridSize_; i++) {
+			GLushort a = static_cast<GLushort>(j * kRowSize + i), b = static_cast<GLushort>(a + 1u);
+			GLushort c = static_cast<GLushort>(b + kRowSize), d = static_cast<GLushort>(a + kRowSize);
+
+			gridIndices.insert(gridIndices.end(), { a, b, c, a, c, d });
+		}
+
+	nGridIndices_ = static_cast<GLsizei>(gridIndices.size());
+	nodes_.reserve(kMaxNodes_);
+
+	glGenVertexArrays(1, &vao_);
+
+	glGenBuffers(1, &gridVbo_);
+	glGenBuffers(1, &gridIbo_);
+	glGenBuffers(1, &nodeDataSsbo_);
+
+	glBindBuffer(GL_ARRAY_BUFFER, gridVbo_);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(vec2) * gridPositions.size()), gridPositions.data(),
+		         GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0u);
+
+	GlState::bindVertexArray(0u); // the element array buffer binding is part of the vao state
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gridIbo_);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLushort) * gridIndices.size()), gridIndices.data(),
+		         GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0u);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, nodeDataSsbo_);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(sizeof(PLANET_DATA) + sizeof(NODE_DATA) * kMaxNodes_),
+		         nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+
+	//cout << "Planet created." << endl;
+}
+
+
+
+Planet::~Planet() {
+	glDeleteBuffers(1, &gridVbo_);
+	glDeleteBuffers(1, &gridIbo_);
+	glDeleteBuffers(1, &nodeDataSsbo_);
+
+	GlState::deleteVertexArray(vao_);
+
+	//cout << "Planet deleted." << endl;
+}
+
+
+
+void Planet::setAttribPointers(GLuint gridPositionIndex) {
+	GlState::bindVertexArray(vao_);
+	glBindBuffer(GL_ARRAY_BUFFER, gridVbo_);
+
+	glVertexAttribPointer(gridPositionIndex, 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(sizeof(vec2)), nullptr);
+	glEnableVertexAttribArray(gridPositionIndex);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gridIbo_);
+
+	GlState::bindVertexArray(0u);
+	glBindBuffer(GL_ARRAY_BUFFER, 0u);
+}
+
+
+
+void Planet::selectNodes(const vec3& kCenter, float radius, const mat4& kModelMatrix, const mat4& kViewMatrix,
+	                     const mat4& kProjectionMatrix, const vec3& kEyePosition, unsigned int viewportHeight) {
+	if (radius <= 0.0f) throw runtime_error("Planet.selectNodes|Invalid radius value.");
+
+	// selection in object space: frustum planes of the model-view-projection matrix, eye in object space
+	frustum_.update(kProjectionMatrix * kViewMatrix * kModelMatrix);
+	eyePosition_ = vec3(glm::inverse(kModelMatrix) * vec4(kEyePosition, 1.0f));
+	center_ = kCenter;
+	radius_ = radius;
+
+	// a node is split if it is nearer than the distance at which its triangle edges project to 'kPixelError_' pixels
+	// (the scale of the model cancels out); at least two node sizes, so that neighbours differ by one level at most
+	float pixelsPerUnit = 0.5f * static_cast<float>(viewportHeight) * kProjectionMatrix[1u][1u];
+	float nodeSize = radius * 0.5f * glm::pi<float>(); // arc of a cube face
+
+	switchDistances_.resize(kMaxLevel_ + 1u);
+	for (float& rSwitchDistance : switchDistances_) {
+		rSwitchDistance = std::max(nodeSize / static_cast<float>(kGridSize_) * pixelsPerUnit / kPixelError_, 2.0f * nodeSize);
+		nodeSize *= 0.5f;
+	}
+
+	nodes_.clear();
+	for (unsigned int face = 0u; face < 6u; face++)
+		selectNode_(face, 0u, vec2(-1.0f), 2.0f);
+
+	PLANET_DATA planet = {};
+	planet.eyePosition = vec4(eyePosition_, 1.0f);
+	planet.sphere = vec4(center_, radius_);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, nodeDataSsbo_);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(PLANET_DATA)), &planet);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(sizeof(PLANET_DATA)),
+		            static_cast<GLsizeiptr>(sizeof(NODE_DATA) * nodes_.size()), nodes_.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0u);
+
+	GlDebug::countCalls(4u);
+}
+
+
+
+void Planet::render() const {
+	if (nodes_.empty()) return;
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Planet::getNodeDataBinding(), nodeDataSsbo_);
+	GlState::bindVertexArray(vao_); // left bound, see GlState
+
+	glDrawElementsInstanced(GL_TRIANGLES, nGridIndices_, GL_UNSIGNED_SHORT, nullptr, static_cast<GLsizei>(nodes_.size()));
+
+	GlDebug::countCalls(2u);
+}
+
+
+
+unsigned int Planet::getNumNodes() const {
+	return static_cast<unsigned int>(nodes_.size());
+}
+
+
+
+unsigned int Planet::getNumTriangles() const {
+	return static_cast<unsigned int>(nodes_.size()) * 2u * kGridSize_ * kGridSize_;
+}
+
+
+
+string Planet::toString() const {
+	return "Planet: " + to_string(getNumNodes()) + " nodes, " + to_string(getNumTriangles()) + " triangles";
+}
+
+
+
+// point of the unit sphere above 'kFacePosition' ([-1, 1]) of a cube face, see 'shaders/main/planet.vert'
+vec3 Planet::getCubePoint_(unsigned int face, const vec2& kFacePosition) {
+	static const vec3 kU[6u] = { vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 0.0f, 1.0f), vec3(1.0f, 0.0f, 0.0f),
+		                         vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f) };
+	static const vec3 kV[6u] = { vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 0.0f, -1.0f),
+		                         vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f) };
+
+	return glm::normalize(glm::cross(kU[face], kV[face]) + kFacePosition.x * kU[face] + kFacePosition.y * kV[face]);
+}
+
+
+
+void Planet::selectNode_(unsigned int face, unsigned int level, const vec2& kOrigin, float size) {
+	// bounding sphere of the node, around the corners on the sphere
+	vec3 nodeCenter = center_ + radius_ * Planet::getCubePoint_(face, kOrigin + vec2(0.5f * size));
+	float nodeRadius = 0.0f;
+
+	for (const vec2& kCorner : { vec2(0.0f), vec2(size, 0.0f), vec2(size), vec2(0.0f, size) })
+		nodeRadius = std::max(nodeRadius, glm::length(center_ + radius_ * Planet::getCubePoint_(face, kOrigin + kCorner) -
+			                                          nodeCenter));
+
+	if (!frustum_.intersectsSphere(nodeCenter, nodeRadius)) return;
+	if (Frustum::isBehindHorizon(nodeCenter, nodeRadius, center_, kOccluderScale_ * radius_, eyePosition_)) return;
+
+	float distance = std::max(glm::length(nodeCenter - eyePosition_) - nodeRadius, 0.0f);
+
+	if (level < kMaxLevel_ && distance < switchDistances_.at(level) && nodes_.size() + 4u <= kMaxNodes_) {
+		float childSize = 0.5f * size;
+
+		selectNode_(face, level + 1u, kOrigin, childSize);
+		selectNode_(face, level + 1u, kOrigin + vec2(childSize, 0.0f), childSize);
+		selectNode_(face, level + 1u, kOrigin + vec2(childSize), childSize);
+		selectNode_(face, level + 1u, kOrigin + vec2(0.0f, childSize), childSize);
+		return;
+	}
+
+	// the vertices are fully morphed to the parent grid where the parent would be selected instead
+	float morphEnd = level > 0u ? switchDistances_.at(level - 1u) : std::numeric_limits<float>::max();
+
+	if (nodes_.size() >= kMaxNodes_) return;
+
+	NODE_DATA node = {};
+	node.origin = kOrigin;
+	node.size = size;
+	node.face = static_cast<GLuint>(face);
+	node.morphRange = vec2(kMorphStart_ * morphEnd, morphEnd);
+
+	nodes_.push_back(node);
+}
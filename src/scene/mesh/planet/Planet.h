@@ -0,0 +1,122 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef PLANET_H
+#define PLANET_H
+
+#include <GL/gl3w.h>
+
+#include "camera/Frustum.h"
+#include "info/GlDebug.h"
+#include "state/GlState.h"
+
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <glm/ext/scalar_constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using glm::mat4;
+using glm::vec2;
+using glm::vec3;
+using glm::vec4;
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::runtime_error;
+using std::string;
+using std::to_string;
+using std::vector;
+
+
+
+// CDLOD (continuous distance-dependent level of detail) sphere: a quadtree over each face of a cube projected on
+// the sphere. Each frame the nodes are selected from the eye distance, so that a triangle edge projects to about
+// 'kPixelError_' pixels, and drawn as instances of one shared grid patch. The vertices of a node morph to the grid
+// of its parent before the node is replaced by it, so there is no popping and no crack between levels.
+// The vertex positions, normals and texture coordinates are computed in the vertex shader, see 'planet.vert'.
+class Planet {
+public:
+	static GLuint getNodeDataBinding();
+
+
+	Planet();
+	~Planet();
+
+
+	// init: setAttribPointers
+	//############################################################################
+	void setAttribPointers(GLuint gridPositionIndex);
+
+
+	// render: 1) selectNodes
+	//         2) render
+	//############################################################################
+	// the sphere ('kCenter', 'radius') is in object space
+	void selectNodes(const vec3& kCenter, float radius, const mat4& kModelMatrix, const mat4& kViewMatrix,
+		             const mat4& kProjectionMatrix, const vec3& kEyePosition, unsigned int viewportHeight);
+	void render() const;
+
+
+	// get
+	//############################################################################
+	unsigned int getNumNodes() const; // last selection
+	unsigned int getNumTriangles() const; // last selection
+
+	string toString() const;
+
+private:
+	static const unsigned int kGridSize_; // quads per node side, defined also in planet.vert
+	static const unsigned int kMaxLevel_;
+	static const unsigned int kMaxNodes_;
+	static const float kPixelError_;
+	static const float kMorphStart_; // fraction of the morph range
+	static const float kOccluderScale_; // the coarsest triangles are below the sphere
+
+	static vec3 getCubePoint_(unsigned int face, const vec2& kFacePosition);
+
+	Planet(const Planet&);
+	const Planet& operator=(const Planet&) {}
+
+	void selectNode_(unsigned int face, unsigned int level, const vec2& kOrigin, float size);
+
+	// std430 layout, see 'shaders/main/planet.vert'
+	struct NODE_DATA {
+		vec2 origin; // face coordinates, [-1, 1]
+		GLfloat size;
+		GLuint face;
+		vec2 morphRange; // object space distances
+	};
+
+	struct PLANET_DATA {
+		vec4 eyePosition; // object space
+		vec4 sphere; // center, radius (object space)
+	};
+
+	vector<NODE_DATA> nodes_;
+	vector<float> switchDistances_; // per level, object space
+
+	Frustum frustum_; // object space
+	vec3 center_, eyePosition_;
+	float radius_;
+
+	GLuint vao_, gridVbo_, gridIbo_, nodeDataSsbo_;
+	GLsizei nGridIndices_;
+};
+
+#endif
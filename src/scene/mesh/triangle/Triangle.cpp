@@ -1,18 +1,13 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 21, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Triangle.h"
 
 
 
-Triangle::Triangle() : Triangle2D(), pVertices_(nullptr), pNormals_(nullptr), pTangents_(nullptr), pBitangents_(nullptr),
-                       normalsVbo_(0u), tangentsVbo_(0u), bitangentsVbo_(0u) {
-	glGenBuffers(1, &normalsVbo_);
-	glGenBuffers(1, &tangentsVbo_);
-	glGenBuffers(1, &bitangentsVbo_);
-	
+Triangle::Triangle() : Triangle2D(), pVertices_(nullptr), pNormals_(nullptr), pTangents_(nullptr), pBitangents_(nullptr) {
 	//cout << "Triangle created." << endl;
 }
 
@@ -21,10 +16,6 @@ Triangle::Triangle() : Triangle2D(), pVertices_(nullptr), pNormals_(nullptr), pT
 Triangle::~Triangle() {	
 	clearVerticesData_();
 
-	glDeleteBuffers(1, &normalsVbo_);
-	glDeleteBuffers(1, &tangentsVbo_);
-	glDeleteBuffers(1, &bitangentsVbo_);
-
 	//cout << "Triangle deleted." << endl;
 }
 
@@ -117,20 +108,13 @@ void Triangle::setAttribPointers(unsigned int programId, GLuint positionIndex, G
 
 void Triangle::render(unsigned int programId) const {
 	if (!pVertices_) throw runtime_error("Triangle.render|Vertices not loaded yet.");
-	if (!glIsBuffer(verticesVbo_))
-		throw runtime_error("Triangle.render|Vertex buffer data not loaded yet: vertices.");
-
-	if (pTexCoords_ && !glIsBuffer(texCoordsVbo_))
-		throw runtime_error("Triangle.render_|Vertex buffer data not loaded yet: tex coords.");
+	if (!pNormals_) throw runtime_error("Triangle.render|Normals not loaded yet.");
+	if (!hasVertexBuffer_) throw runtime_error("Triangle.render|Vertex buffer data not loaded yet: vertices.");
 
-	if (!pNormals_) throw runtime_error("Triangle.render|Normals not loaded yet.");	
-	if (!glIsBuffer(normalsVbo_))
-		throw runtime_error("Triangle.render|Vertex buffer data not loaded yet: normals.");
-
-	if (pTangents_ && !glIsBuffer(tangentsVbo_))
-		throw runtime_error("Triangle.render|Vertex buffer data not loaded yet: tangents.");
-	if (pBitangents_ && !glIsBuffer(bitangentsVbo_))
-		throw runtime_error("Triangle.render|Vertex buffer data not loaded yet: bitangents.");
+	if (GlDebug::isValidating()) {
+		GlDebug::countQueries(1u);
+		if (!glIsBuffer(verticesVbo_)) throw runtime_error("Triangle.render|Invalid vertex buffer: vertices.");
+	}
 
 	try {
 		render_(programId);
@@ -264,97 +248,54 @@ void Triangle::loadBitangents_(const vec3* pkBitangents) {
 
 
 void Triangle::updateVertexBuffer_() const {
-	Triangle2D::updateVertexBuffer_();
-
-	GLsizeiptr size3 = static_cast<GLsizeiptr>(3 * sizeof(GLfloat) * nVertices_);
-
-	if (pVertices_) {
-		GLfloat* pGlVertices = new GLfloat[static_cast<size_t>(nVertices_) * 3u];
-
-		for (GLsizei i = 0; i < nVertices_; i++) {
-			pGlVertices[3u * i] = pVertices_[i].x;
-			pGlVertices[3u * i + 1u] = pVertices_[i].y;
-			pGlVertices[3u * i + 2u] = pVertices_[i].z;
-		}
+	VERTEX_3D* pGlVertices = new VERTEX_3D[static_cast<size_t>(nVertices_)];
+	bool hasTangents = pTangents_ && pBitangents_;
 
-		glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size3, pGlVertices, GL_STATIC_DRAW);
+	for (GLsizei i = 0; i < nVertices_; i++) {
+		VERTEX_3D& rVertex = pGlVertices[i];
 
-		delete[] pGlVertices;
+		rVertex.position = pVertices_[i];
+		rVertex.texCoord = pTexCoords_ ? pTexCoords_[i] : vec2(0.0f);
+		rVertex.normal = pNormals_[i];
+		rVertex.tangent = hasTangents ? pTangents_[i] : vec3(0.0f);
+		rVertex.bitangent = hasTangents ? pBitangents_[i] : vec3(0.0f);
 	}
 
-	if (pNormals_) {
-		GLfloat* pGlNormals = new GLfloat[static_cast<size_t>(nVertices_) * 3u];
-
-		for (GLsizei i = 0; i < nVertices_; i++) {
-			pGlNormals[3u * i] = pNormals_[i].x;
-			pGlNormals[3u * i + 1u] = pNormals_[i].y;
-			pGlNormals[3u * i + 2u] = pNormals_[i].z;
-		}
-
-		glBindBuffer(GL_ARRAY_BUFFER, normalsVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size3, pGlNormals, GL_STATIC_DRAW);
-
-		delete[] pGlNormals;
-	}
-
-	if (pTangents_ && pBitangents_) {
-		GLfloat* pGlTangents = new GLfloat[static_cast<size_t>(nVertices_) * 3u];
-		GLfloat* pGlBitangents = new GLfloat[static_cast<size_t>(nVertices_) * 3u];
-
-		for (GLsizei i = 0; i < nVertices_; i++) {
-			pGlTangents[3u * i] = pTangents_[i].x;
-			pGlTangents[3u * i + 1u] = pTangents_[i].y;
-			pGlTangents[3u * i + 2u] = pTangents_[i].z;
-
-			pGlBitangents[3u * i] = pBitangents_[i].x;
-			pGlBitangents[3u * i + 1u] = pBitangents_[i].y;
-			pGlBitangents[3u * i + 2u] = pBitangents_[i].z;
-		}
-
-		glBindBuffer(GL_ARRAY_BUFFER, tangentsVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size3, pGlTangents, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(VERTEX_3D) * nVertices_), pGlVertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0u);
 
-		glBindBuffer(GL_ARRAY_BUFFER, bitangentsVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size3, pGlBitangents, GL_STATIC_DRAW);
+	delete[] pGlVertices;
 
-		delete[] pGlTangents;
-		delete[] pGlBitangents;
-	}
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0u);
+	hasVertexBuffer_ = true;
 }
 
 
 
 void Triangle::setAttribPointers_(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex,
 	                                                      GLuint tangentIndex, GLuint bitangentIndex, unsigned int nIndices) {
-	Triangle2D::setAttribPointers_(programId, positionIndex, texCoordIndex, normalIndex, tangentIndex, bitangentIndex, nIndices);
+	const GLsizei kStride = static_cast<GLsizei>(sizeof(VERTEX_3D));
 
-	glBindVertexArray(vaos_.at(programId));
+	bindVertexArray_(programId);
 
-	if (pVertices_ && glIsBuffer(verticesVbo_) && nIndices > 0u) {
+	if (hasVertexBuffer_) {
 		glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
-		glVertexAttribPointer(positionIndex, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(positionIndex);
-	}
 
-	if (pNormals_ && glIsBuffer(normalsVbo_) && nIndices > 2u) {
-		glBindBuffer(GL_ARRAY_BUFFER, normalsVbo_);
-		glVertexAttribPointer(normalIndex, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(normalIndex);
-	}
+		if (pVertices_ && nIndices > 0u)
+			setAttribPointer_(positionIndex, 3, kStride, offsetof(VERTEX_3D, position));
+
+		if (pTexCoords_ && nIndices > 1u)
+			setAttribPointer_(texCoordIndex, 2, kStride, offsetof(VERTEX_3D, texCoord));
 
-	if (pTangents_ && pBitangents_ && glIsBuffer(tangentsVbo_) && glIsBuffer(bitangentsVbo_) && nIndices == 5u) {
-		glBindBuffer(GL_ARRAY_BUFFER, tangentsVbo_);
-		glVertexAttribPointer(tangentIndex, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(tangentIndex);
+		if (pNormals_ && nIndices > 2u)
+			setAttribPointer_(normalIndex, 3, kStride, offsetof(VERTEX_3D, normal));
 
-		glBindBuffer(GL_ARRAY_BUFFER, bitangentsVbo_);
-		glVertexAttribPointer(bitangentIndex, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(bitangentIndex);
+		if (pTangents_ && pBitangents_ && nIndices == 5u) {
+			setAttribPointer_(tangentIndex, 3, kStride, offsetof(VERTEX_3D, tangent));
+			setAttribPointer_(bitangentIndex, 3, kStride, offsetof(VERTEX_3D, bitangent));
+		}
 	}
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0u);
-	glBindVertexArray(0u);
+	GlState::bindVertexArray(0u);
 }
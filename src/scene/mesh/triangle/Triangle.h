@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 13, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef TRIANGLE_H
@@ -14,6 +14,7 @@
 #include <glm/vec3.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <exception>
 #include <iostream>
 #include <stdexcept>
@@ -32,6 +33,22 @@ using std::string;
 
 class Triangle : public Triangle2D {
 public:
+	// interleaved vertex layout (56 bytes per vertex)
+	struct VERTEX_3D {
+		vec3 position;
+		vec2 texCoord;
+		vec3 normal;
+		vec3 tangent, bitangent;
+	};
+
+	// quantized interleaved vertex layout (20 bytes per vertex), see 'MeshBatch.setCompactVertices'
+	struct COMPACT_VERTEX_3D {
+		GLushort position[4u]; // unorm in the bounding box of the mesh; w: bitangent sign (0 -> -1)
+		GLushort texCoord[2u]; // unorm in the texture coordinate range of the mesh
+		GLshort normal[2u], tangent[2u]; // octahedral, snorm
+	};
+
+
 	Triangle();
 	virtual ~Triangle();
 
@@ -96,7 +113,6 @@ private:
 	const Triangle& operator=(const Triangle&) {}
 
 	vec3* pVertices_, * pNormals_, * pTangents_, * pBitangents_;
-	GLuint normalsVbo_, tangentsVbo_, bitangentsVbo_;
 };
 
 #endif
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 21, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Triangle2D.h"
@@ -8,10 +8,8 @@
 
 
 Triangle2D::Triangle2D() : nVertices_(3), pVertices2d_(nullptr), pTexCoords_(nullptr), pColors_(nullptr),
-	                       vaos_(), verticesVbo_(0u), texCoordsVbo_(0u), colorsVbo_(0u) {
+	                       vaos_(), verticesVbo_(0u), hasVertexBuffer_(false) {
 	glGenBuffers(1, &verticesVbo_);
-	glGenBuffers(1, &texCoordsVbo_);
-	glGenBuffers(1, &colorsVbo_);
 
 	//cout << "Triangle2D created." << endl;
 }
@@ -22,11 +20,9 @@ Triangle2D::~Triangle2D() {
 	clearVerticesData_();
 	
 	glDeleteBuffers(1, &verticesVbo_);
-	glDeleteBuffers(1, &texCoordsVbo_);
-	glDeleteBuffers(1, &colorsVbo_);
 	
 	for (GLuint iVao : vaos_)
-		if (iVao != 0u) glDeleteVertexArrays(1, &iVao);
+		if (iVao != 0u) GlState::deleteVertexArray(iVao);
 	
 	//cout << "Triangle2D deleted." << endl;
 }
@@ -98,14 +94,12 @@ void Triangle2D::setAttribPointers(unsigned int programId, GLuint positionIndex,
 
 void Triangle2D::render(unsigned int programId) const {
 	if (!pVertices2d_) throw runtime_error("Triangle2D.render|Vertices not loaded yet.");
-	if (!glIsBuffer(verticesVbo_))
-		throw runtime_error("Triangle2D.render|Vertex buffer data not loaded yet: vertices.");
-
-	if (pTexCoords_ && !glIsBuffer(texCoordsVbo_))
-		throw runtime_error("Triangle2D.render_|Vertex buffer data not loaded yet: tex coords.");
-
-	if (pColors_ && !glIsBuffer(colorsVbo_))
-		throw runtime_error("Triangle2D.render|Vertex buffer data not loaded yet: colors.");
+	if (!hasVertexBuffer_) throw runtime_error("Triangle2D.render|Vertex buffer data not loaded yet: vertices.");
+	
+	if (GlDebug::isValidating()) {
+		GlDebug::countQueries(1u);
+		if (!glIsBuffer(verticesVbo_)) throw runtime_error("Triangle2D.render|Invalid vertex buffer: vertices.");
+	}
 	
 	try {
 		render_(programId);
@@ -216,86 +210,48 @@ void Triangle2D::loadColors_(const vec3* pkColors) {
 
 
 void Triangle2D::updateVertexBuffer_() const {
-	GLsizeiptr size2 = static_cast<GLsizeiptr>(2 * sizeof(GLfloat) * nVertices_);
-	GLsizeiptr size3 = static_cast<GLsizeiptr>(3 * sizeof(GLfloat) * nVertices_);
-
-	if (pVertices2d_) {
-		GLfloat* pGlVertices = new GLfloat[static_cast<size_t>(nVertices_) * 2u];
-
-		for (GLsizei i = 0; i < nVertices_; i++) {
-			pGlVertices[2u * i] = pVertices2d_[i].x;
-			pGlVertices[2u * i + 1u] = pVertices2d_[i].y;
-		}
-
-		glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size2, pGlVertices, GL_STATIC_DRAW);
-
-		delete[] pGlVertices;
-	}
-
-	if (pTexCoords_) {
-		GLfloat* pGlTexCoords = new GLfloat[static_cast<size_t>(nVertices_) * 2u];
+	VERTEX_2D* pGlVertices = new VERTEX_2D[static_cast<size_t>(nVertices_)];
 
-		for (GLsizei i = 0; i < nVertices_; i++) {
-			pGlTexCoords[2u * i] = pTexCoords_[i].s;
-			pGlTexCoords[2u * i + 1u] = pTexCoords_[i].t;
-		}
+	for (GLsizei i = 0; i < nVertices_; i++) {
+		VERTEX_2D& rVertex = pGlVertices[i];
 
-		glBindBuffer(GL_ARRAY_BUFFER, texCoordsVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size2, pGlTexCoords, GL_STATIC_DRAW);
-
-		delete[] pGlTexCoords;
+		rVertex.position = pVertices2d_ ? pVertices2d_[i] : vec2(0.0f);
+		rVertex.texCoord = pTexCoords_ ? pTexCoords_[i] : vec2(0.0f);
+		rVertex.color = pColors_ ? pColors_[i] : vec3(0.0f);
 	}
 
-	if (pColors_) {
-		GLfloat* pGlColors = new GLfloat[static_cast<size_t>(nVertices_) * 3u];
-
-		for (GLsizei i = 0; i < nVertices_; i++) {
-			pGlColors[3u * i] = pColors_[i].x;
-			pGlColors[3u * i + 1u] = pColors_[i].y;
-			pGlColors[3u * i + 2u] = pColors_[i].z;
-		}
+	glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(VERTEX_2D) * nVertices_), pGlVertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0u);
 
-		glBindBuffer(GL_ARRAY_BUFFER, colorsVbo_);
-		glBufferData(GL_ARRAY_BUFFER, size3, pGlColors, GL_STATIC_DRAW);
+	delete[] pGlVertices;
 
-		delete[] pGlColors;
-	}
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0u);
+	hasVertexBuffer_ = true;
 }
 
 
 
 void Triangle2D::setAttribPointers_(unsigned int programId, GLuint positionIndex, GLuint texCoordIndex, GLuint normalIndex,
 	                                GLuint, GLuint, unsigned int nIndices) {
-	vaos_.resize(static_cast<size_t>(programId) + 1u, 0u);
+	const GLsizei kStride = static_cast<GLsizei>(sizeof(VERTEX_2D));
 
-	if (vaos_.at(programId) == 0u)
-		glGenVertexArrays(1, &vaos_.at(programId));
-	
-	glBindVertexArray(vaos_.at(programId));
+	bindVertexArray_(programId);
 
-	if (pVertices2d_ && glIsBuffer(verticesVbo_) && nIndices > 0u) {
+	if (hasVertexBuffer_) {
 		glBindBuffer(GL_ARRAY_BUFFER, verticesVbo_);
-		glVertexAttribPointer(positionIndex, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(positionIndex);
-	}
 
-	if (pTexCoords_ && glIsBuffer(texCoordsVbo_) && nIndices > 1u) {
-		glBindBuffer(GL_ARRAY_BUFFER, texCoordsVbo_);
-		glVertexAttribPointer(texCoordIndex, 2, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(texCoordIndex);
-	}
+		if (pVertices2d_ && nIndices > 0u)
+			setAttribPointer_(positionIndex, 2, kStride, offsetof(VERTEX_2D, position));
 
-	if (pColors_ && glIsBuffer(colorsVbo_) && nIndices > 2u) {
-		glBindBuffer(GL_ARRAY_BUFFER, colorsVbo_);
-		glVertexAttribPointer(normalIndex, 3, GL_FLOAT, GL_FALSE, 0, NULL);
-		glEnableVertexAttribArray(normalIndex);
+		if (pTexCoords_ && nIndices > 1u)
+			setAttribPointer_(texCoordIndex, 2, kStride, offsetof(VERTEX_2D, texCoord));
+
+		if (pColors_ && nIndices > 2u)
+			setAttribPointer_(normalIndex, 3, kStride, offsetof(VERTEX_2D, color));
 	}
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0u);
-	glBindVertexArray(0u);	
+	GlState::bindVertexArray(0u);
 }
 
 
@@ -304,11 +260,30 @@ void Triangle2D::render_(unsigned int programId) const {
 	if (programId < vaos_.size()) {
 		GLuint vao = vaos_.at(programId);
 		if (vao > 0u) {
-			glBindVertexArray(vao);
+			GlState::bindVertexArray(vao); // left bound, see GlState
 			glDrawArrays(GL_TRIANGLES, 0, nVertices_);
-			glBindVertexArray(0u);
+
+			GlDebug::countCalls(1u);
 		}
 		else throw runtime_error("Triangle2D.render_|Invalid program id value.");
 	}
 	else throw runtime_error("Triangle2D.render_|Invalid program id value.");
 }
+
+
+
+void Triangle2D::bindVertexArray_(unsigned int programId) {
+	vaos_.resize(std::max(vaos_.size(), static_cast<size_t>(programId) + 1u), 0u);
+
+	if (vaos_.at(programId) == 0u)
+		glGenVertexArrays(1, &vaos_.at(programId));
+
+	GlState::bindVertexArray(vaos_.at(programId));
+}
+
+
+
+void Triangle2D::setAttribPointer_(GLuint index, GLint size, GLsizei stride, size_t offset) const {
+	glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+	glEnableVertexAttribArray(index);
+}
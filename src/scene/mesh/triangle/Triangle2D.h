@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 13, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef TRIANGLE_2D_H
@@ -8,10 +8,14 @@
 
 #include <GL/gl3w.h>
 
+#include "info/GlDebug.h"
+#include "state/GlState.h"
+
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <exception>
 #include <iostream>
 #include <stdexcept>
@@ -85,12 +89,23 @@ protected:
 
 	virtual void render_(unsigned int programId) const;
 
+	void bindVertexArray_(unsigned int programId);
+	void setAttribPointer_(GLuint index, GLint size, GLsizei stride, size_t offset) const;
+
+	// interleaved vertex layout (one vbo per triangle set)
+	struct VERTEX_2D {
+		vec2 position;
+		vec2 texCoord;
+		vec3 color;
+	};
+
 	GLsizei nVertices_;
 	vec2* pVertices2d_, * pTexCoords_;
 	vec3* pColors_;
 
 	vector<GLuint> vaos_;
-	GLuint verticesVbo_, texCoordsVbo_, colorsVbo_;
+	GLuint verticesVbo_;
+	mutable bool hasVertexBuffer_; // set once by updateVertexBuffer_, replaces per-draw GL object queries
 
 private:
 	Triangle2D(const Triangle2D&);
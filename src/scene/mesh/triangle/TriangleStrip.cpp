@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 21, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "TriangleStrip.h"
@@ -8,7 +8,7 @@
 
 
 TriangleStrip::TriangleStrip(unsigned int nVertices, unsigned int nIndices) :
-	                         Triangle(), nIndices_(0), pIndices_(nullptr), indicesVbo_(0u) {
+	                         Triangle(), nIndices_(0), pIndices_(nullptr), indicesVbo_(0u), hasIndexBuffer_(false) {
 	if (nVertices >= 3u) nVertices_ = static_cast<GLsizei>(nVertices);
 	else throw runtime_error("TriangleStrip|Invalid number of vertices value.");
 
@@ -95,8 +95,12 @@ void TriangleStrip::updateVertexBuffer() const {
 
 void TriangleStrip::render(unsigned int programId) const {
 	if (!pIndices_) throw runtime_error("TriangleStrip.render|Indices not loaded yet.");
-	if (!glIsBuffer(indicesVbo_))
-		throw runtime_error("TriangleStrip.render|Vertex buffer data not loaded yet: indices.");
+	if (!hasIndexBuffer_) throw runtime_error("TriangleStrip.render|Vertex buffer data not loaded yet: indices.");
+
+	if (GlDebug::isValidating()) {
+		GlDebug::countQueries(1u);
+		if (!glIsBuffer(indicesVbo_)) throw runtime_error("TriangleStrip.render|Invalid vertex buffer: indices.");
+	}
 
 	Triangle::render(programId);
 }
@@ -153,12 +157,15 @@ void TriangleStrip::updateVertexBuffer_() const {
 		for (GLsizei i = 0; i < nIndices_; i++)
 			pGlIndices[i] = pIndices_[i].x;
 
+		GlState::bindVertexArray(0u); // the element array buffer binding is part of the vao state
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVbo_);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, size1, pGlIndices, GL_STATIC_DRAW);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0u);
 
 		delete[] pGlIndices;
-	}	
+
+		hasIndexBuffer_ = true;
+	}
 }
 
 
@@ -167,10 +174,10 @@ void TriangleStrip::setAttribPointers_(unsigned int programId, GLuint positionIn
 	                                                           GLuint tangentIndex, GLuint bitangentIndex, unsigned int nIndices) {
 	Triangle::setAttribPointers_(programId, positionIndex, texCoordIndex, normalIndex, tangentIndex, bitangentIndex, nIndices);
 
-	if (pIndices_ && glIsBuffer(indicesVbo_)) {
-		glBindVertexArray(vaos_.at(programId));
+	if (pIndices_ && hasIndexBuffer_) {
+		GlState::bindVertexArray(vaos_.at(programId));
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVbo_);
-		glBindVertexArray(0u);
+		GlState::bindVertexArray(0u);
 	}
 }
 
@@ -180,9 +187,10 @@ void TriangleStrip::render_(unsigned int programId) const {
 	if (programId < vaos_.size()) {
 		GLuint vao = vaos_.at(programId);
 		if (vao > 0u) {
-			glBindVertexArray(vao);
+			GlState::bindVertexArray(vao); // left bound, see GlState
 			glDrawElements(GL_TRIANGLES, nIndices_, GL_UNSIGNED_INT, NULL);
-			glBindVertexArray(0u);
+
+			GlDebug::countCalls(1u);
 		}
 		else throw runtime_error("TriangleStrip.render_|Invalid program id value.");
 	}
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 13, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef TRIANGLE_STRIP_H
@@ -107,6 +107,7 @@ private:
 	GLsizei nIndices_;
 	uvec1* pIndices_;
 	GLuint indicesVbo_;
+	mutable bool hasIndexBuffer_;
 };
 
 #endif
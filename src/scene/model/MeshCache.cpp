@@ -0,0 +1,418 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "MeshCache.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+const char MeshCache::kMagic_[4u] = { 'B', 'M', 'M', 'C' };
+const GLuint MeshCache::kVersion_ = 2u; // 2: optimized face and vertex order (see 'MeshOptimizer')
+const size_t MeshCache::kAlignment_ = 16u;
+
+
+
+string MeshCache::getCacheFileName(const string& kFileName) {
+	return kFileName + ".bmc";
+}
+
+
+
+MeshCache::MeshCache() : materials_(), meshes_(), transformations_(), data_(), pkMapping_(nullptr), mappingSize_(0u),
+	                     pkData_(nullptr), pFile_(nullptr), pFileMapping_(nullptr) {
+	//cout << "Mesh cache created." << endl;
+}
+
+
+
+MeshCache::~MeshCache() {
+	unmap_();
+
+	//cout << "Mesh cache deleted." << endl;
+}
+
+
+
+bool MeshCache::open(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps,
+	                 int removeComponents, bool normalize) {
+	unmap_();
+	materials_.clear();
+	meshes_.clear();
+	transformations_.clear();
+	data_.clear();
+
+	long long sourceSize = 0ll, sourceTime = 0ll;
+	if (!FileInfo::get(kFilePath + "/" + kFileName, sourceSize, sourceTime)) return false;
+	if (!map_(kFilePath + "/" + MeshCache::getCacheFileName(kFileName))) return false;
+
+	FILE_HEADER header = {};
+	bool valid = mappingSize_ >= sizeof(FILE_HEADER);
+	if (valid) std::memcpy(&header, pkMapping_, sizeof(FILE_HEADER));
+
+	valid = valid && string(header.magic, 4u) == string(MeshCache::kMagic_, 4u) && header.version == MeshCache::kVersion_ &&
+		    header.postProcessSteps == postProcessSteps && header.removeComponents == removeComponents &&
+		    (header.normalize != 0u) == normalize && header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+
+	size_t tablesSize = sizeof(FILE_HEADER) + header.nMaterials * sizeof(MATERIAL) + header.nMeshes * sizeof(MESH) +
+		                header.nTransformations * sizeof(TRANSFORMATION);
+	valid = valid && header.dataOffset >= tablesSize && header.dataOffset <= mappingSize_ &&
+		    header.dataSize <= mappingSize_ - header.dataOffset;
+
+	if (valid) {
+		const GLubyte* pkTable = pkMapping_ + sizeof(FILE_HEADER);
+
+		materials_.resize(header.nMaterials);
+		if (header.nMaterials > 0u) std::memcpy(materials_.data(), pkTable, header.nMaterials * sizeof(MATERIAL));
+		pkTable += header.nMaterials * sizeof(MATERIAL);
+
+		meshes_.resize(header.nMeshes);
+		if (header.nMeshes > 0u) std::memcpy(meshes_.data(), pkTable, header.nMeshes * sizeof(MESH));
+		pkTable += header.nMeshes * sizeof(MESH);
+
+		transformations_.resize(header.nTransformations);
+		if (header.nTransformations > 0u)
+			std::memcpy(transformations_.data(), pkTable, header.nTransformations * sizeof(TRANSFORMATION));
+
+		for (const MESH& ikMesh : meshes_)
+			if (ikMesh.dataOffset > header.dataSize || MeshCache::getDataSize_(ikMesh) > header.dataSize - ikMesh.dataOffset ||
+				ikMesh.materialId >= header.nMaterials) valid = false;
+	}
+
+	if (!valid) {
+		unmap_();
+		materials_.clear();
+		meshes_.clear();
+		transformations_.clear();
+		return false;
+	}
+
+	pkData_ = pkMapping_ + header.dataOffset;
+	return true;
+}
+
+
+
+void MeshCache::addMaterial(const MATERIAL& kMaterial) {
+	materials_.push_back(kMaterial);
+}
+
+
+
+void MeshCache::addMesh(const MESH& kMesh, const uvec3* pkFaces, const vec3* pkVertices, const vec2* pkTexCoords,
+	                    const vec3* pkNormals, const vec3* pkTangents, const vec3* pkBitangents) {
+	MESH mesh = kMesh;
+	mesh.hasTexCoords = pkTexCoords ? 1u : 0u;
+	mesh.hasNormals = pkNormals ? 1u : 0u;
+	mesh.hasTangentsAndBitangents = (pkNormals && pkTangents && pkBitangents) ? 1u : 0u;
+	addMesh(mesh);
+
+	uvec3* pFaces = nullptr;
+	vec3* pVertices = nullptr;
+	vec2* pTexCoords = nullptr;
+	vec3* pNormals = nullptr;
+	vec3* pTangents = nullptr;
+	vec3* pBitangents = nullptr;
+
+	getMeshData(static_cast<unsigned int>(meshes_.size() - 1u), pFaces, pVertices, pTexCoords, pNormals, pTangents,
+		        pBitangents);
+
+	std::copy(pkFaces, pkFaces + mesh.nFaces, pFaces);
+	std::copy(pkVertices, pkVertices + mesh.nVertices, pVertices);
+	if (pTexCoords) std::copy(pkTexCoords, pkTexCoords + mesh.nVertices, pTexCoords);
+	if (pNormals) std::copy(pkNormals, pkNormals + mesh.nVertices, pNormals);
+	if (pTangents) {
+		std::copy(pkTangents, pkTangents + mesh.nVertices, pTangents);
+		std::copy(pkBitangents, pkBitangents + mesh.nVertices, pBitangents);
+	}
+}
+
+
+
+void MeshCache::addMesh(const MESH& kMesh) {
+	MESH mesh = kMesh;
+	mesh.hasTexCoords = mesh.hasTexCoords ? 1u : 0u;
+	mesh.hasNormals = mesh.hasNormals ? 1u : 0u;
+	mesh.hasTangentsAndBitangents = (mesh.hasNormals && mesh.hasTangentsAndBitangents) ? 1u : 0u;
+	mesh.dataOffset = data_.size();
+
+	data_.resize(data_.size() + MeshCache::getDataSize_(mesh), 0u);
+	meshes_.push_back(mesh);
+}
+
+
+
+void MeshCache::addTransformation(GLuint meshId, const mat4& kMatrix) {
+	transformations_.push_back({ meshId, kMatrix });
+}
+
+
+
+MeshCache::MESH* MeshCache::getMeshData(unsigned int i, uvec3*& rpFaces, vec3*& rpVertices, vec2*& rpTexCoords,
+	                                     vec3*& rpNormals, vec3*& rpTangents, vec3*& rpBitangents) {
+	const MESH* pkMesh = &meshes_.at(i);
+
+	rpFaces = const_cast<uvec3*>(getFaces(pkMesh));
+	rpVertices = const_cast<vec3*>(getVertices(pkMesh));
+	rpTexCoords = const_cast<vec2*>(getTexCoords(pkMesh));
+	rpNormals = const_cast<vec3*>(getNormals(pkMesh));
+	rpTangents = const_cast<vec3*>(getTangents(pkMesh));
+	rpBitangents = const_cast<vec3*>(getBitangents(pkMesh));
+
+	return &meshes_.at(i);
+}
+
+
+
+bool MeshCache::write(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps,
+	                  int removeComponents, bool normalize) const {
+	FILE_HEADER header = {};
+	std::copy(MeshCache::kMagic_, MeshCache::kMagic_ + 4u, header.magic);
+	header.version = MeshCache::kVersion_;
+	header.postProcessSteps = postProcessSteps;
+	header.removeComponents = removeComponents;
+	header.normalize = normalize ? 1u : 0u;
+	header.nMaterials = static_cast<GLuint>(materials_.size());
+	header.nMeshes = static_cast<GLuint>(meshes_.size());
+	header.nTransformations = static_cast<GLuint>(transformations_.size());
+	if (!FileInfo::get(kFilePath + "/" + kFileName, header.sourceSize, header.sourceTime)) return false;
+
+	size_t tablesSize = sizeof(FILE_HEADER) + materials_.size() * sizeof(MATERIAL) + meshes_.size() * sizeof(MESH) +
+		                transformations_.size() * sizeof(TRANSFORMATION);
+	header.dataOffset = MeshCache::align_(tablesSize);
+	header.dataSize = data_.size();
+
+	string cacheFilePath = kFilePath + "/" + MeshCache::getCacheFileName(kFileName);
+	FILE* pFile;
+	fopen_s(&pFile, cacheFilePath.c_str(), "wb");
+	if (pFile == NULL) {
+		cout << "Mesh cache: cannot write the '" << cacheFilePath << "' file." << endl;
+		return false;
+	}
+
+	const GLubyte kPadding[16u] = {};
+	size_t paddingSize = static_cast<size_t>(header.dataOffset) - tablesSize;
+
+	bool written = std::fwrite(&header, sizeof(FILE_HEADER), 1u, pFile) == 1u;
+	written = written && std::fwrite(materials_.data(), sizeof(MATERIAL), materials_.size(), pFile) == materials_.size();
+	written = written && std::fwrite(meshes_.data(), sizeof(MESH), meshes_.size(), pFile) == meshes_.size();
+	written = written && std::fwrite(transformations_.data(), sizeof(TRANSFORMATION), transformations_.size(), pFile) ==
+		                 transformations_.size();
+	written = written && std::fwrite(kPadding, 1u, paddingSize, pFile) == paddingSize;
+	written = written && std::fwrite(data_.data(), 1u, data_.size(), pFile) == data_.size();
+
+	std::fclose(pFile);
+
+	// a partial file would only be rejected later, remove it now
+	if (!written) {
+		std::remove(cacheFilePath.c_str());
+		cout << "Mesh cache: cannot write the '" << cacheFilePath << "' file." << endl;
+		return false;
+	}
+
+	cout << "Mesh cache '" << MeshCache::getCacheFileName(kFileName) << "' written (" << meshes_.size() << " meshes, "
+		 << data_.size() / 1024u << " KB)." << endl;
+	return true;
+}
+
+
+
+bool MeshCache::isMapped() const {
+	return pkMapping_ != nullptr;
+}
+
+
+
+unsigned int MeshCache::getNumMaterials() const {
+	return static_cast<unsigned int>(materials_.size());
+}
+
+
+
+const MeshCache::MATERIAL* MeshCache::getMaterial(unsigned int id) const {
+	return (id < materials_.size()) ? &materials_[id] : nullptr;
+}
+
+
+
+unsigned int MeshCache::getNumMeshes() const {
+	return static_cast<unsigned int>(meshes_.size());
+}
+
+
+
+const MeshCache::MESH* MeshCache::getMesh(unsigned int i) const {
+	return (i < meshes_.size()) ? &meshes_[i] : nullptr;
+}
+
+
+
+unsigned int MeshCache::getNumTransformations() const {
+	return static_cast<unsigned int>(transformations_.size());
+}
+
+
+
+const MeshCache::TRANSFORMATION* MeshCache::getTransformation(unsigned int i) const {
+	return (i < transformations_.size()) ? &transformations_[i] : nullptr;
+}
+
+
+
+const uvec3* MeshCache::getFaces(const MESH* pkMesh) const {
+	return reinterpret_cast<const uvec3*>(getData_(pkMesh, 0u));
+}
+
+
+
+const vec3* MeshCache::getVertices(const MESH* pkMesh) const {
+	size_t offset = MeshCache::align_(pkMesh->nFaces * sizeof(uvec3));
+	return reinterpret_cast<const vec3*>(getData_(pkMesh, offset));
+}
+
+
+
+const vec2* MeshCache::getTexCoords(const MESH* pkMesh) const {
+	if (!pkMesh->hasTexCoords) return nullptr;
+
+	size_t offset = MeshCache::align_(pkMesh->nFaces * sizeof(uvec3)) + MeshCache::align_(pkMesh->nVertices * sizeof(vec3));
+	return reinterpret_cast<const vec2*>(getData_(pkMesh, offset));
+}
+
+
+
+const vec3* MeshCache::getNormals(const MESH* pkMesh) const {
+	if (!pkMesh->hasNormals) return nullptr;
+
+	size_t offset = MeshCache::align_(pkMesh->nFaces * sizeof(uvec3)) + MeshCache::align_(pkMesh->nVertices * sizeof(vec3));
+	if (pkMesh->hasTexCoords) offset += MeshCache::align_(pkMesh->nVertices * sizeof(vec2));
+	return reinterpret_cast<const vec3*>(getData_(pkMesh, offset));
+}
+
+
+
+const vec3* MeshCache::getTangents(const MESH* pkMesh) const {
+	if (!pkMesh->hasTangentsAndBitangents) return nullptr;
+
+	const GLubyte* pkNormals = reinterpret_cast<const GLubyte*>(getNormals(pkMesh));
+	return reinterpret_cast<const vec3*>(pkNormals + MeshCache::align_(pkMesh->nVertices * sizeof(vec3)));
+}
+
+
+
+const vec3* MeshCache::getBitangents(const MESH* pkMesh) const {
+	if (!pkMesh->hasTangentsAndBitangents) return nullptr;
+
+	const GLubyte* pkNormals = reinterpret_cast<const GLubyte*>(getNormals(pkMesh));
+	return reinterpret_cast<const vec3*>(pkNormals + 2u * MeshCache::align_(pkMesh->nVertices * sizeof(vec3)));
+}
+
+
+
+size_t MeshCache::align_(size_t size) {
+	return (size + MeshCache::kAlignment_ - 1u) / MeshCache::kAlignment_ * MeshCache::kAlignment_;
+}
+
+
+
+size_t MeshCache::getDataSize_(const MESH& kMesh) {
+	size_t verticesSize = MeshCache::align_(kMesh.nVertices * sizeof(vec3));
+	size_t size = MeshCache::align_(kMesh.nFaces * sizeof(uvec3)) + verticesSize;
+
+	if (kMesh.hasTexCoords) size += MeshCache::align_(kMesh.nVertices * sizeof(vec2));
+	if (kMesh.hasNormals) size += verticesSize;
+	if (kMesh.hasNormals && kMesh.hasTangentsAndBitangents) size += 2u * verticesSize;
+
+	return size;
+}
+
+
+
+// read only, the pages are loaded on first access
+bool MeshCache::map_(const string& kCacheFilePath) {
+#ifdef _WIN32
+	HANDLE file = CreateFileA(kCacheFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+	if (!fileMapping) {
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* pkView = MapViewOfFile(fileMapping, FILE_MAP_READ, 0u, 0u, 0u);
+	if (!pkView) {
+		CloseHandle(fileMapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	pFile_ = file;
+	pFileMapping_ = fileMapping;
+	pkMapping_ = static_cast<const GLubyte*>(pkView);
+	mappingSize_ = static_cast<size_t>(size.QuadPart);
+#else
+	int file = ::open(kCacheFilePath.c_str(), O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size <= 0) {
+		::close(file);
+		return false;
+	}
+
+	void* pView = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (pView == MAP_FAILED) return false;
+
+	pkMapping_ = static_cast<const GLubyte*>(pView);
+	mappingSize_ = static_cast<size_t>(info.st_size);
+#endif
+
+	return true;
+}
+
+
+
+void MeshCache::unmap_() {
+	if (!pkMapping_) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(pkMapping_);
+	CloseHandle(static_cast<HANDLE>(pFileMapping_));
+	CloseHandle(static_cast<HANDLE>(pFile_));
+#else
+	munmap(const_cast<GLubyte*>(pkMapping_), mappingSize_);
+#endif
+
+	pkMapping_ = nullptr;
+	mappingSize_ = 0u;
+	pkData_ = nullptr;
+	pFile_ = nullptr;
+	pFileMapping_ = nullptr;
+}
+
+
+
+const GLubyte* MeshCache::getData_(const MESH* pkMesh, size_t offset) const {
+	const GLubyte* pkData = pkMapping_ ? pkData_ : data_.data();
+	return pkData + pkMesh->dataOffset + offset;
+}
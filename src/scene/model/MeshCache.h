@@ -0,0 +1,160 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <GL/gl3w.h>
+
+#include "info/FileInfo.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using glm::mat4;
+using glm::uvec3;
+using glm::vec2;
+using glm::vec3;
+
+using std::cout;
+using std::endl;
+using std::FILE;
+using std::size_t;
+using std::string;
+using std::vector;
+
+
+
+// Binary cache of an imported model, '<model>.bmc' next to the model. 'Model3D' fills it while importing with Assimp
+// and writes it once the model is loaded; the next imports map it into memory and load the meshes straight from the
+// mapping, without Assimp. It keeps the material table (with the names of the first texture of each type), the
+// processed vertex and index arrays of each mesh with its bounding volumes, and the transformations of the nodes. The
+// header keeps the size and time of the model file and the import settings; an edited model is imported again (a
+// material library edited alone is not seen: delete the cache).
+class MeshCache {
+public:
+	struct TEXTURE {
+		char fileName[256u]; // empty -> none (or a longer name: not cached)
+		GLuint clampToEdge;
+	};
+
+	struct MATERIAL {
+		GLuint shadingModel, twoSided, wireframe;
+		GLfloat opacity;
+		vec3 ambientColor, diffuseColor, specularColor, emissiveColor;
+		GLfloat shininess, shininessStrength;
+		TEXTURE textures[4u]; // diffuse, specular, emissive, normal map
+	};
+
+	struct MESH {
+		GLuint id, materialId, nFaces, nVertices;
+		GLuint hasTexCoords, hasNormals, hasTangentsAndBitangents;
+		vec3 boundingBoxMin, boundingBoxMax;
+		GLfloat boundingSphereRadius;
+		unsigned long long dataOffset; // faces, vertices, [texture coordinates], [normals, [tangents, bitangents]]
+	};
+
+	struct TRANSFORMATION {
+		GLuint meshId;
+		mat4 matrix;
+	};
+
+	static string getCacheFileName(const string& kFileName);
+
+
+	MeshCache();
+	~MeshCache(); // unmapped
+
+
+	// read: open (false -> no cache, or out of date)
+	//############################################################################
+	bool open(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps, int removeComponents,
+		      bool normalize);
+
+
+	// write: 1) addMaterial, addMesh, addTransformation
+	//        2) write (false -> the cache cannot be written)
+	//############################################################################
+	void addMaterial(const MATERIAL& kMaterial);
+	void addMesh(const MESH& kMesh, const uvec3* pkFaces, const vec3* pkVertices, const vec2* pkTexCoords,
+		         const vec3* pkNormals, const vec3* pkTangents, const vec3* pkBitangents);
+	void addMesh(const MESH& kMesh); // arrays of 'kMesh.has...' reserved, see 'getMeshData'
+	void addTransformation(GLuint meshId, const mat4& kMatrix);
+
+	// a reserved mesh (its bounding volumes) and its arrays, filled by the caller (any thread, one per mesh) once all
+	// the meshes are added; nullptr -> none
+	MESH* getMeshData(unsigned int i, uvec3*& rpFaces, vec3*& rpVertices, vec2*& rpTexCoords, vec3*& rpNormals,
+		              vec3*& rpTangents, vec3*& rpBitangents);
+
+	bool write(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps, int removeComponents,
+		       bool normalize) const;
+
+
+	// get
+	//############################################################################
+	bool isMapped() const;
+
+	unsigned int getNumMaterials() const;
+	const MATERIAL* getMaterial(unsigned int id) const;
+	unsigned int getNumMeshes() const;
+	const MESH* getMesh(unsigned int i) const; // i = 0 ... numMeshes - 1 (not the id of the mesh)
+	unsigned int getNumTransformations() const;
+	const TRANSFORMATION* getTransformation(unsigned int i) const; // in the order of the nodes
+
+	// arrays of a mesh; nullptr -> none
+	const uvec3* getFaces(const MESH* pkMesh) const;
+	const vec3* getVertices(const MESH* pkMesh) const;
+	const vec2* getTexCoords(const MESH* pkMesh) const;
+	const vec3* getNormals(const MESH* pkMesh) const;
+	const vec3* getTangents(const MESH* pkMesh) const;
+	const vec3* getBitangents(const MESH* pkMesh) const;
+
+private:
+	static const char kMagic_[4u];
+	static const GLuint kVersion_;
+	static const size_t kAlignment_;
+
+	static size_t align_(size_t size);
+	static size_t getDataSize_(const MESH& kMesh);
+
+	MeshCache(const MeshCache&);
+	const MeshCache& operator=(const MeshCache&) {}
+
+	struct FILE_HEADER {
+		char magic[4u];
+		GLuint version;
+		GLuint postProcessSteps;
+		GLint removeComponents;
+		GLuint normalize;
+		GLuint nMaterials, nMeshes, nTransformations;
+		unsigned long long dataOffset, dataSize;
+		long long sourceSize, sourceTime;
+	};
+
+	bool map_(const string& kCacheFilePath);
+	void unmap_();
+	const GLubyte* getData_(const MESH* pkMesh, size_t offset) const;
+
+	vector<MATERIAL> materials_;
+	vector<MESH> meshes_;
+	vector<TRANSFORMATION> transformations_;
+	vector<GLubyte> data_; // written
+
+	const GLubyte* pkMapping_; // read: the whole file
+	size_t mappingSize_;
+	const GLubyte* pkData_; // the arrays of the meshes: in the mapping, or 'data_'
+	void* pFile_;
+	void* pFileMapping_;
+};
+
+#endif
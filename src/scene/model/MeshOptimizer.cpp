@@ -0,0 +1,299 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "MeshOptimizer.h"
+
+
+
+const unsigned int MeshOptimizer::kCacheSize_ = 16u;
+const float MeshOptimizer::kOverdrawThreshold_ = 1.05f; // cluster ACMR, relative to the ACMR of the whole mesh
+
+
+
+// the faces are kept in their imported order if the optimized order misses the cache more often
+bool MeshOptimizer::optimize(uvec3* pFaces, unsigned int nFaces, unsigned int nVertices, vec3* pVertices,
+	                         vec2* pTexCoords, vec3* pNormals, vec3* pTangents, vec3* pBitangents,
+	                         STATISTICS& rStatistics) {
+	rStatistics = {};
+	if (!pFaces || nFaces == 0u || nVertices == 0u) return false;
+
+	for (unsigned int i = 0u; i < nFaces; i++)
+		if (pFaces[i].x >= nVertices || pFaces[i].y >= nVertices || pFaces[i].z >= nVertices) return false;
+
+	unsigned int nUsedVertices = MeshOptimizer::getNumUsedVertices_(pFaces, nFaces, nVertices);
+	unsigned int nMisses = MeshOptimizer::getCacheMisses_(pFaces, nFaces, nVertices);
+	rStatistics.acmr = static_cast<float>(nMisses) / nFaces;
+	rStatistics.atvr = static_cast<float>(nMisses) / nUsedVertices;
+
+	vector<uvec3> faces(pFaces, pFaces + nFaces);
+	vector<unsigned int> clusters;
+
+	MeshOptimizer::optimizeVertexCache_(faces.data(), nFaces, nVertices, clusters);
+	float acmr = static_cast<float>(MeshOptimizer::getCacheMisses_(faces.data(), nFaces, nVertices)) / nFaces;
+	if (pVertices) MeshOptimizer::optimizeOverdraw_(faces.data(), nFaces, pVertices, acmr, clusters);
+
+	unsigned int nOptimizedMisses = MeshOptimizer::getCacheMisses_(faces.data(), nFaces, nVertices);
+	if (nOptimizedMisses < nMisses) std::copy(faces.begin(), faces.end(), pFaces);
+	else clusters.assign(1u, 0u);
+
+	vector<unsigned int> remap;
+	MeshOptimizer::optimizeVertexFetch_(pFaces, nFaces, nVertices, remap);
+
+	if (pVertices) MeshOptimizer::remapVertices_(pVertices, nVertices, remap);
+	if (pTexCoords) MeshOptimizer::remapVertices_(pTexCoords, nVertices, remap);
+	if (pNormals) MeshOptimizer::remapVertices_(pNormals, nVertices, remap);
+	if (pTangents) MeshOptimizer::remapVertices_(pTangents, nVertices, remap);
+	if (pBitangents) MeshOptimizer::remapVertices_(pBitangents, nVertices, remap);
+
+	nMisses = min(nOptimizedMisses, nMisses);
+	rStatistics.optimizedAcmr = static_cast<float>(nMisses) / nFaces;
+	rStatistics.optimizedAtvr = static_cast<float>(nMisses) / nUsedVertices;
+	rStatistics.nClusters = static_cast<unsigned int>(clusters.size());
+	return true;
+}
+
+
+
+unsigned int MeshOptimizer::getCacheSize() {
+	return MeshOptimizer::kCacheSize_;
+}
+
+
+
+// Tipsify: fans around a vertex, the next one taken among the vertices of the fan that are still in the cache (the
+// oldest one that stays in it while its remaining faces are emitted), else the last live vertex of the fan emitted
+// (dead-end stack), else the next live vertex in index order: there the cache is cold and a cluster starts. A vertex is
+// in the cache while 'time - cacheTimes[v] <= kCacheSize_'.
+void MeshOptimizer::optimizeVertexCache_(uvec3* pFaces, unsigned int nFaces, unsigned int nVertices,
+	                                     vector<unsigned int>& rClusters) {
+	const unsigned int kNone = ~0u;
+
+	// faces of each vertex
+	vector<unsigned int> offsets(nVertices + 1u, 0u), adjacency(3u * nFaces);
+	for (unsigned int i = 0u; i < nFaces; i++)
+		for (unsigned int j = 0u; j < 3u; j++) offsets[pFaces[i][j] + 1u]++;
+
+	for (unsigned int v = 0u; v < nVertices; v++) offsets[v + 1u] += offsets[v];
+
+	vector<unsigned int> liveFaces(nVertices);
+	for (unsigned int v = 0u; v < nVertices; v++) liveFaces[v] = offsets[v + 1u] - offsets[v];
+
+	vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+	for (unsigned int i = 0u; i < nFaces; i++)
+		for (unsigned int j = 0u; j < 3u; j++) adjacency[next[pFaces[i][j]]++] = i;
+
+	vector<uvec3> faces;
+	faces.reserve(nFaces);
+	vector<bool> emitted(nFaces, false);
+	vector<unsigned int> cacheTimes(nVertices, 0u);
+	unsigned int time = MeshOptimizer::kCacheSize_ + 1u;
+
+	vector<unsigned int> deadEnds, candidates;
+	unsigned int cursor = 0u;
+	unsigned int fanVertex = kNone;
+	rClusters.clear();
+
+	do {
+		if (fanVertex == kNone) {
+			while (cursor < nVertices && liveFaces[cursor] == 0u) cursor++;
+			if (cursor == nVertices) break;
+
+			fanVertex = cursor;
+			rClusters.push_back(static_cast<unsigned int>(faces.size()));
+		}
+
+		candidates.clear();
+		for (unsigned int i = offsets[fanVertex]; i < offsets[fanVertex + 1u]; i++) {
+			unsigned int face = adjacency[i];
+			if (emitted[face]) continue;
+
+			for (unsigned int j = 0u; j < 3u; j++) {
+				unsigned int v = pFaces[face][j];
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				liveFaces[v]--;
+
+				if (time - cacheTimes[v] > MeshOptimizer::kCacheSize_) cacheTimes[v] = time++;
+			}
+
+			faces.push_back(pFaces[face]);
+			emitted[face] = true;
+		}
+
+		unsigned int bestVertex = kNone;
+		int bestPriority = -1;
+		for (unsigned int v : candidates) {
+			if (liveFaces[v] == 0u) continue;
+
+			int priority = 0;
+			if (time - cacheTimes[v] + 2u * liveFaces[v] <= MeshOptimizer::kCacheSize_)
+				priority = static_cast<int>(time - cacheTimes[v]);
+
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				bestVertex = v;
+			}
+		}
+
+		while (bestVertex == kNone && !deadEnds.empty()) {
+			if (liveFaces[deadEnds.back()] > 0u) bestVertex = deadEnds.back();
+			deadEnds.pop_back();
+		}
+
+		fanVertex = bestVertex;
+	} while (faces.size() < nFaces);
+
+	std::copy(faces.begin(), faces.end(), pFaces);
+}
+
+
+
+// Sander et al. 2007: the clusters are split further where their own ACMR (from a cold cache) drops below
+// 'kOverdrawThreshold_' times the ACMR of the mesh, then sorted by how much they face away from the mesh centroid
+// (dot of the cluster normal with the offset of the cluster centroid); the outer faces are drawn first and hide the
+// inner ones from the depth test
+void MeshOptimizer::optimizeOverdraw_(uvec3* pFaces, unsigned int nFaces, const vec3* pkVertices, float acmr,
+	                                  vector<unsigned int>& rClusters) {
+	unsigned int nVertices = 0u;
+	for (unsigned int i = 0u; i < nFaces; i++)
+		nVertices = max(nVertices, max(pFaces[i].x, max(pFaces[i].y, pFaces[i].z)) + 1u);
+
+	vector<unsigned int> clusters;
+	vector<unsigned int> cacheTimes(nVertices, 0u);
+	unsigned int time = MeshOptimizer::kCacheSize_ + 1u;
+	float threshold = MeshOptimizer::kOverdrawThreshold_ * acmr;
+
+	rClusters.push_back(nFaces);
+	for (size_t c = 0u; c + 1u < rClusters.size(); c++) {
+		unsigned int nClusterMisses = 0u, nClusterFaces = 0u;
+
+		for (unsigned int i = rClusters[c]; i < rClusters[c + 1u]; i++) {
+			if (nClusterFaces == 0u) {
+				clusters.push_back(i);
+				nClusterMisses = 0u;
+				time += MeshOptimizer::kCacheSize_; // cold
+			}
+
+			for (unsigned int j = 0u; j < 3u; j++) {
+				unsigned int v = pFaces[i][j];
+				if (time - cacheTimes[v] > MeshOptimizer::kCacheSize_) {
+					cacheTimes[v] = time++;
+					nClusterMisses++;
+				}
+			}
+
+			nClusterFaces++;
+			if (nClusterMisses <= threshold * nClusterFaces) nClusterFaces = 0u;
+		}
+	}
+
+	rClusters.swap(clusters);
+	if (rClusters.size() < 2u) return;
+
+	vec3 meshCentroid(0.0f);
+	for (unsigned int i = 0u; i < nFaces; i++)
+		meshCentroid += pkVertices[pFaces[i].x] + pkVertices[pFaces[i].y] + pkVertices[pFaces[i].z];
+	meshCentroid /= 3.0f * nFaces;
+
+	vector<float> sortKeys(rClusters.size());
+	for (size_t c = 0u; c < rClusters.size(); c++) {
+		unsigned int last = c + 1u < rClusters.size() ? rClusters[c + 1u] : nFaces;
+		vec3 centroid(0.0f), normal(0.0f);
+
+		for (unsigned int i = rClusters[c]; i < last; i++) {
+			const vec3& kV0 = pkVertices[pFaces[i].x];
+			const vec3& kV1 = pkVertices[pFaces[i].y];
+			const vec3& kV2 = pkVertices[pFaces[i].z];
+
+			centroid += kV0 + kV1 + kV2;
+			normal += glm::cross(kV1 - kV0, kV2 - kV0); // area weighted
+		}
+
+		centroid /= 3.0f * (last - rClusters[c]);
+		float length = glm::length(normal);
+		sortKeys[c] = length > 0.0f ? glm::dot(centroid - meshCentroid, normal / length) : 0.0f;
+	}
+
+	vector<unsigned int> order(rClusters.size());
+	for (unsigned int c = 0u; c < order.size(); c++) order[c] = c;
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](unsigned int c0, unsigned int c1) {
+		return sortKeys[c0] > sortKeys[c1]; });
+
+	vector<uvec3> faces;
+	faces.reserve(nFaces);
+	vector<unsigned int> sortedClusters;
+	sortedClusters.reserve(rClusters.size());
+
+	for (unsigned int c : order) {
+		unsigned int last = c + 1u < rClusters.size() ? rClusters[c + 1u] : nFaces;
+		sortedClusters.push_back(static_cast<unsigned int>(faces.size()));
+		faces.insert(faces.end(), pFaces + rClusters[c], pFaces + last);
+	}
+
+	std::copy(faces.begin(), faces.end(), pFaces);
+	rClusters.swap(sortedClusters);
+}
+
+
+
+// 'rRemap[old index] = new index': by first use, the unused vertices last (in their order)
+void MeshOptimizer::optimizeVertexFetch_(uvec3* pFaces, unsigned int nFaces, unsigned int nVertices,
+	                                     vector<unsigned int>& rRemap) {
+	const unsigned int kNone = ~0u;
+
+	rRemap.assign(nVertices, kNone);
+	unsigned int nextVertex = 0u;
+
+	for (unsigned int i = 0u; i < nFaces; i++)
+		for (unsigned int j = 0u; j < 3u; j++) {
+			unsigned int& rV = pFaces[i][j];
+			if (rRemap[rV] == kNone) rRemap[rV] = nextVertex++;
+			rV = rRemap[rV];
+		}
+
+	for (unsigned int v = 0u; v < nVertices; v++)
+		if (rRemap[v] == kNone) rRemap[v] = nextVertex++;
+}
+
+
+
+template <typename T>
+void MeshOptimizer::remapVertices_(T* pVertices, unsigned int nVertices, const vector<unsigned int>& kRemap) {
+	vector<T> vertices(pVertices, pVertices + nVertices);
+
+	for (unsigned int v = 0u; v < nVertices; v++) pVertices[kRemap[v]] = vertices[v];
+}
+
+
+
+// FIFO: a vertex stays in the cache for the next 'kCacheSize_' misses
+unsigned int MeshOptimizer::getCacheMisses_(const uvec3* pkFaces, unsigned int nFaces, unsigned int nVertices) {
+	vector<unsigned int> cacheTimes(nVertices, 0u);
+	unsigned int time = MeshOptimizer::kCacheSize_ + 1u;
+
+	for (unsigned int i = 0u; i < nFaces; i++)
+		for (unsigned int j = 0u; j < 3u; j++) {
+			unsigned int v = pkFaces[i][j];
+			if (time - cacheTimes[v] > MeshOptimizer::kCacheSize_) cacheTimes[v] = time++;
+		}
+
+	return time - (MeshOptimizer::kCacheSize_ + 1u);
+}
+
+
+
+unsigned int MeshOptimizer::getNumUsedVertices_(const uvec3* pkFaces, unsigned int nFaces, unsigned int nVertices) {
+	vector<bool> used(nVertices, false);
+	unsigned int nUsedVertices = 0u;
+
+	for (unsigned int i = 0u; i < nFaces; i++)
+		for (unsigned int j = 0u; j < 3u; j++)
+			if (!used[pkFaces[i][j]]) {
+				used[pkFaces[i][j]] = true;
+				nUsedVertices++;
+			}
+
+	return nUsedVertices;
+}
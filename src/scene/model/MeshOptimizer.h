@@ -0,0 +1,69 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using glm::uvec3;
+using glm::vec2;
+using glm::vec3;
+
+using std::max;
+using std::min;
+using std::size_t;
+using std::vector;
+
+
+
+// Index and vertex order of an imported mesh (see 'Model3D'), optimized once and stored in the mesh cache. The faces are
+// reordered for the post-transform vertex cache (Tipsify, Sander et al. 2007), their clusters then sorted outside in
+// against overdraw, and the vertices renumbered in the order of their first use (vertex fetch locality). The faces keep
+// their winding. The statistics simulate a FIFO vertex cache of 'kCacheSize_' entries.
+class MeshOptimizer {
+public:
+	struct STATISTICS {
+		float acmr, atvr; // imported order: average cache miss ratio (per face), average transformed vertex ratio
+		float optimizedAcmr, optimizedAtvr;
+		unsigned int nClusters;
+	};
+
+	// the arrays of the mesh, reordered in place (nullptr -> none); false -> invalid indices, nothing changed
+	static bool optimize(uvec3* pFaces, unsigned int nFaces, unsigned int nVertices, vec3* pVertices, vec2* pTexCoords,
+		                 vec3* pNormals, vec3* pTangents, vec3* pBitangents, STATISTICS& rStatistics);
+
+	static unsigned int getCacheSize();
+
+private:
+	static const unsigned int kCacheSize_;
+	static const float kOverdrawThreshold_;
+
+	MeshOptimizer();
+	MeshOptimizer(const MeshOptimizer&);
+	const MeshOptimizer& operator=(const MeshOptimizer&) {}
+
+	// 'rClusters': first face of each cluster
+	static void optimizeVertexCache_(uvec3* pFaces, unsigned int nFaces, unsigned int nVertices,
+		                             vector<unsigned int>& rClusters);
+	static void optimizeOverdraw_(uvec3* pFaces, unsigned int nFaces, const vec3* pkVertices, float acmr,
+		                          vector<unsigned int>& rClusters);
+	static void optimizeVertexFetch_(uvec3* pFaces, unsigned int nFaces, unsigned int nVertices,
+		                             vector<unsigned int>& rRemap);
+
+	template <typename T>
+	static void remapVertices_(T* pVertices, unsigned int nVertices, const vector<unsigned int>& kRemap);
+
+	static unsigned int getCacheMisses_(const uvec3* pkFaces, unsigned int nFaces, unsigned int nVertices);
+	static unsigned int getNumUsedVertices_(const uvec3* pkFaces, unsigned int nFaces, unsigned int nVertices);
+};
+
+#endif
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Apr 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Model3D.h"
@@ -16,17 +16,49 @@ float Model3D::getMaxSmoothingAngle_() { // degrees
 const float Model3D::kEpsilon_ = 0.001f;
 const float Model3D::kLengthEpsilon_ = 0.01f;
 const unsigned int Model3D::kLineLength_ = 96u;
+const unsigned int Model3D::kVertexBlockSize_ = 1024u;
 
 
 
 unsigned int Model3D::modelId_ = 0;
+unsigned int Model3D::nThreads_ = 0u;
+
+
+
+void Model3D::setNumThreads(unsigned int nThreads) {
+	Model3D::nThreads_ = nThreads;
+}
 
 
 
 Model3D::Model3D(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps, int removeComponents,
 	             bool normalize, bool transparencySorting):
 	             pkAiScene_(nullptr), pkAiNode_(nullptr), kFilePath_(kFilePath), kFileName_(kFileName), importer_(),
-	             pMeshes_(nullptr), pMaterials_(nullptr), transparencySorting_(transparencySorting) {
+	             cache_(), postProcessSteps_(postProcessSteps), removeComponents_(removeComponents), normalize_(normalize),
+	             cached_(false), cacheable_(true), transformed_(false), native_(false),
+	             pMeshes_(nullptr), pMaterials_(nullptr), meshStatistics_(), transparencySorting_(transparencySorting) {
+	cached_ = cache_.open(kFilePath_, kFileName_, postProcessSteps, removeComponents, normalize);
+
+	if (!cached_ && ObjImporter::isSupported(kFileName_, postProcessSteps)) {
+		ObjImporter objImporter(Model3D::nThreads_, Model3D::getMaxSmoothingAngle_()); // only once the cache misses
+		cached_ = native_ = objImporter.import(kFilePath_, kFileName_, postProcessSteps, cache_);
+		if (native_) {
+			displayCacheInfo_();
+			objImporter.displayInfo();
+		}
+	}
+	else if (cached_) displayCacheInfo_();
+
+	if (cached_) {
+		Model3D::modelId_++;
+
+		if (cache_.getNumMaterials() == 0u)
+			throw runtime_error("Model3D|Model is incomplete. There should be at least one material.");
+		if (cache_.getNumMeshes() == 0u)
+			throw runtime_error("Model3D|Model is incomplete. There should be at least one mesh.");
+		return;
+	}
+
 	try {
 		readModel_(postProcessSteps, removeComponents, normalize);
 		Model3D::modelId_++;
@@ -66,57 +98,31 @@ Model3D::~Model3D()  {
 
 void Model3D::loadMaterials(list<Material>& rMaterials) {
 	pMaterials_ = &rMaterials;
+	unsigned int nMaterials = cached_ ? cache_.getNumMaterials() : pkAiScene_->mNumMaterials;
 
-	for (unsigned int i = 0u; i < pkAiScene_->mNumMaterials; i++) {
+	for (unsigned int i = 0u; i < nMaterials; i++) {
 		for (const Material& ikMaterial : *pMaterials_)
 			if (ikMaterial.getModelId() == (Model3D::modelId_ - 1u) && ikMaterial.getId() == i)
 				throw runtime_error("Model3D.loadMaterials|Material " + ikMaterial.toString() + " already loaded.");
 		
-		const aiMaterial* pkAiMaterial = pkAiScene_->mMaterials[i];
-		if (!pkAiMaterial)
-			throw runtime_error("Model3D.loadMaterials|Model is incomplete. Material " + to_string(i) + " is null.");		
+		if (!cached_) {
+			const aiMaterial* pkAiMaterial = pkAiScene_->mMaterials[i];
+			if (!pkAiMaterial)
+				throw runtime_error("Model3D.loadMaterials|Model is incomplete. Material " + to_string(i) + " is null.");
+
+			cache_.addMaterial(getMaterial_(pkAiMaterial));
+		}
 		
 		try {
 			pMaterials_->emplace_back(i, Model3D::modelId_ - 1u);
-			Material* pMaterial = &pMaterials_->back();
-
-			Material::ShadingModel shadingModel;
-			getMaterialShadingModel_(pkAiMaterial, shadingModel);
-			pMaterial->setShadingModel(shadingModel);
-
-			bool twoSided = isMaterialTwoSided_(pkAiMaterial);
-			pMaterial->setTwoSided(twoSided);
-
-			bool wireframe = isMaterialWireframe_(pkAiMaterial);
-			pMaterial->setWireframe(wireframe);
-
-			float opacity = getMaterialOpacity_(pkAiMaterial);
-			pMaterial->setOpacity(opacity);
-
-			vec3 color = getMaterialAmbientColor_(pkAiMaterial);
-			pMaterial->setAmbientColor(color);
-
-			color = getMaterialDiffuseColor_(pkAiMaterial);
-			pMaterial->setDiffuseColor(color);
-
-			color = getMaterialSpecularColor_(pkAiMaterial);
-			pMaterial->setSpecularColor(color);
-
-			color = getMaterialEmissiveColor_(pkAiMaterial);
-			pMaterial->setEmissiveColor(color);
-
-			float shininess = getMaterialShininess_(pkAiMaterial);
-			pMaterial->setShininess(shininess / 4.0f);
-
-			float strength = getMaterialShininessStrength_(pkAiMaterial);
-			pMaterial->setShininessStrength(strength);
+			setMaterial_(*cache_.getMaterial(i), &pMaterials_->back());
 		}
 		catch (const exception& kException) {
 			throw runtime_error("Model3D.loadMaterials > " + string(kException.what()));
 		}
 	}
 
-	displayMaterialInfo_();
+	if (!cached_) displayMaterialInfo_();
 }
 
 
@@ -131,86 +137,241 @@ void Model3D::loadTextures(list<ColorTexture>& rDiffuseTextures, list<ColorTextu
 
 	for (Material& iMaterial : *pMaterials_) {
 		if (iMaterial.getModelId() != Model3D::modelId_ - 1u) continue;
-		const aiMaterial* pkAiMaterial = pkAiScene_->mMaterials[iMaterial.getId()];
+		const MeshCache::MATERIAL* pkCachedMaterial = cache_.getMaterial(iMaterial.getId());
 		
 		try {
 			// only first texture in stack is implemented
-			const ColorTexture* pkTexture = nullptr;					
-			unsigned int texCount = getTextureCount_(pkAiMaterial, ColorTexture::TextureType::DIFFUSE);
-			for (unsigned int i = 0u; i < texCount; i++) {
-				cout << endl;
-				pkTexture = getTexture_(pkAiMaterial, rDiffuseTextures, ColorTexture::TextureType::DIFFUSE, i);
-				if (pkTexture) {
-					iMaterial.setDiffuseTexture(pkTexture);
-					break;
-				}
-			}
+			if (pkCachedMaterial->textures[0u].fileName[0u] != '\0') cout << endl;
 
-			pkTexture = nullptr;
-			texCount = getTextureCount_(pkAiMaterial, ColorTexture::TextureType::SPECULAR);
-			for (unsigned int i = 0u; i < texCount; i++) {
-				pkTexture = getTexture_(pkAiMaterial, rSpecularTextures, ColorTexture::TextureType::SPECULAR, i);
-				if (pkTexture) {
-					iMaterial.setSpecularTexture(pkTexture);
-					break;
-				}
-			}
+			const ColorTexture* pkTexture = getTexture_(pkCachedMaterial->textures[0u], rDiffuseTextures);
+			if (pkTexture) iMaterial.setDiffuseTexture(pkTexture);
 
-			pkTexture = nullptr;
-			texCount = getTextureCount_(pkAiMaterial, ColorTexture::TextureType::EMISSIVE);
-			for (unsigned int i = 0u; i < texCount; i++) {
-				pkTexture = getTexture_(pkAiMaterial, rEmissiveTextures, ColorTexture::TextureType::EMISSIVE, i);
-				if (pkTexture) {
-					iMaterial.setEmissiveTexture(pkTexture);
-					break;
-				}
-			}
+			pkTexture = getTexture_(pkCachedMaterial->textures[1u], rSpecularTextures);
+			if (pkTexture) iMaterial.setSpecularTexture(pkTexture);
 
-			pkTexture = nullptr;
-			texCount = getTextureCount_(pkAiMaterial, ColorTexture::TextureType::NORMAL_MAP);
-			for (unsigned int i = 0u; i < texCount; i++) {
-				pkTexture = getTexture_(pkAiMaterial, rNormalMapTextures, ColorTexture::TextureType::NORMAL_MAP, i);
-				if (pkTexture) {
-					iMaterial.setNormalMapTexture(pkTexture);
-					break;
-				}
-			}
+			pkTexture = getTexture_(pkCachedMaterial->textures[2u], rEmissiveTextures);
+			if (pkTexture) iMaterial.setEmissiveTexture(pkTexture);
+
+			pkTexture = getTexture_(pkCachedMaterial->textures[3u], rNormalMapTextures);
+			if (pkTexture) iMaterial.setNormalMapTexture(pkTexture);
 		}
 		catch (const exception& kException) {
 			throw runtime_error("Model3D.loadTextures > " + string(kException.what()));
 		}
 	}
 
-	displayTextureInfo_();
+	if (!cached_) displayTextureInfo_();
 }
 
 
 
 void Model3D::loadMeshes(list<Mesh>& rMeshes) {
+	loadMeshes(rMeshes, nullptr);
+}
+
+
+
+void Model3D::loadMeshes(list<Mesh>& rMeshes, MeshBatch* pMeshBatch) {
 	if (!pMaterials_ || pMaterials_->size() == 0u)
 		throw runtime_error("Model3D.loadMeshes|Materials must be loaded before meshes.");
 
 	pMeshes_ = &rMeshes;
 
-	for (unsigned int i = 0u; i < pkAiScene_->mNumMeshes; i++) {
+	// one mapped buffer pair for the whole model, sized up front
+	unsigned int nVertices = 0u, nIndices = 0u;
+	if (pMeshBatch) getNumMeshVertices_(nVertices, nIndices);
+	if (nVertices == 0u) pMeshBatch = nullptr;
+
+	try {
+		if (pMeshBatch) pMeshBatch->mapVertexData(nVertices, nIndices);
+		loadMeshes_(pMeshBatch);
+	}
+	catch (const exception& kException) {
+		if (pMeshBatch) pMeshBatch->unmapVertexData();
+		throw runtime_error("Model3D.loadMeshes > " + string(kException.what()));
+	}
+
+	if (pMeshBatch && !pMeshBatch->unmapVertexData())
+		throw runtime_error("Model3D.loadMeshes|Vertex data lost. The model should be imported again.");
+
+	if (!cached_) displayMeshInfo_();
+}
+
+
+
+// from the cache (or the OBJ importer), or else imported with Assimp; imported: then written to the cache
+void Model3D::loadTransformations() {
+	if (!pMeshes_ || pMeshes_->size() == 0u)
+		throw runtime_error("Model3D.loadTransformations|Meshes must be loaded before transformations.");
+	if (transformed_ || (!cached_ && pkAiNode_ != pkAiScene_->mRootNode))
+		throw runtime_error("Model3D.loadTransformations|Transformations already loaded.");
+
+	try {
+		if (cached_)
+			for (unsigned int i = 0u; i < cache_.getNumTransformations(); i++) {
+				const MeshCache::TRANSFORMATION* pkTransformation = cache_.getTransformation(i);
+
+				for (Mesh& iMesh : *pMeshes_)
+					if (iMesh.getModelId() == (Model3D::modelId_ - 1u) && iMesh.getId() == pkTransformation->meshId) {
+						iMesh.transform(pkTransformation->matrix);
+						break;
+					}
+			}
+		else loadTransformations_(pkAiNode_, aiMatrix4x4());
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Model3D.loadTransformations > " + string(kException.what()));
+	}
+
+	transformed_ = true;
+	if (native_) cache_.write(kFilePath_, kFileName_, postProcessSteps_, removeComponents_, normalize_);
+	if (cached_) return;
+
+	displayNodeInfo_();
+
+	if (cacheable_) cache_.write(kFilePath_, kFileName_, postProcessSteps_, removeComponents_, normalize_);
+}
+
+
+
+void Model3D::readModel_(unsigned int postProcessSteps, int removeComponents, bool normalize) {
+	// configures the aiProcess_PreTransformVertices step
+	importer_.SetPropertyInteger(AI_CONFIG_PP_PTV_NORMALIZE, static_cast<int>(normalize));
+	importer_.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, removeComponents); // configures the aiProcess_RemoveComponent step
+	// configures the aiProcess_GenSmoothNormals step
+	importer_.SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", Model3D::getMaxSmoothingAngle_());
+
+
+	if (!importer_.ValidateFlags(postProcessSteps))
+		throw runtime_error("Model3D.readModel_|Assimp post processing flags are not valid.");
+
+	pkAiScene_ = importer_.ReadFile(kFilePath_ + "/" + kFileName_, postProcessSteps);
+	string error = importer_.GetErrorString();
+
+	if (pkAiScene_ && error.empty()) {
+		cout << endl << string(Model3D::kLineLength_, '#') << endl;
+		cout << endl << "Import of model '" << kFileName_ << "' succeeded." << endl;
+	}
+	else {
+		string errorMessage = "Model3D.readModel_|Cannot read '" + kFileName_ + "' file.";
+		if (!error.empty()) errorMessage += "\n" + error;
+		throw runtime_error(errorMessage);
+	}
+		
+	if (((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATED) > 0u) ||
+		((pkAiScene_->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT) > 0u)) {
+		cout << endl;
+
+		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATED) > 0u)
+			cout << "aiProcess_ValidateDataStructure: validation is successful." << endl;
+
+		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT) > 0u)
+			cout << "aiProcess_JoinIdenticalVertices: the vertices of the output meshes aren't in the internal\nverbose format"
+			" anymore." << endl;
+	}
+
+	if (((pkAiScene_->mFlags & AI_SCENE_FLAGS_INCOMPLETE) > 0u) ||
+		((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATION_WARNING) > 0u) ||
+		((pkAiScene_->mFlags & AI_SCENE_FLAGS_TERRAIN) > 0u)) {
+		cout << endl << "Warning(s):" << endl;
+
+		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_INCOMPLETE) > 0u)
+			cout << "- scene data structure that was imported is not complete." << endl;
+
+		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATION_WARNING) > 0u)
+			cout << "- aiProcess_ValidateDataStructure: validation is successful but some issues have been found." << endl;
+
+		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_TERRAIN) > 0u)
+			cout << "- pure height-map terrain data." << endl;
+	}
+
+	displayModelInfo_();
+}
+
+
+
+// batch: the meshes are created and their vertex data mapped here, in order; they are converted afterwards
+void Model3D::loadMeshes_(MeshBatch* pMeshBatch) {
+	unsigned int nMeshes = cached_ ? cache_.getNumMeshes() : pkAiScene_->mNumMeshes;
+	if (!cached_) meshStatistics_.assign(nMeshes, MeshOptimizer::STATISTICS());
+	vector<MESH_JOB> jobs; // batch: converted once all the meshes are created, see 'convertMeshes_'
+
+	for (unsigned int i = 0u; i < nMeshes; i++) {
+		const MeshCache::MESH* pkCachedMesh = cached_ ? cache_.getMesh(i) : nullptr;
+		const aiMesh* pkAiMesh = cached_ ? nullptr : pkAiScene_->mMeshes[i];
+		unsigned int id = cached_ ? pkCachedMesh->id : i;
+
 		for (const Mesh& ikMesh : *pMeshes_)
-			if (ikMesh.getModelId() == (Model3D::modelId_ - 1u) && ikMesh.getId() == i)
-				throw runtime_error("Model3D.loadMeshes|Mesh " + ikMesh.toString() + " already loaded.");
+			if (ikMesh.getModelId() == (Model3D::modelId_ - 1u) && ikMesh.getId() == id)
+				throw runtime_error("Model3D.loadMeshes_|Mesh " + ikMesh.toString() + " already loaded.");
 		
-		const aiMesh* pkAiMesh = pkAiScene_->mMeshes[i];
-		if (!pkAiMesh)
-			throw runtime_error("Model3D.loadMeshes|Model is incomplete. Mesh " + to_string(i) + " is null.");		
+		if (!cached_ && !pkAiMesh)
+			throw runtime_error("Model3D.loadMeshes_|Model is incomplete. Mesh " + to_string(i) + " is null.");		
 
+		unsigned int materialId = cached_ ? pkCachedMesh->materialId : pkAiMesh->mMaterialIndex;
 		const Material* pkMaterial = nullptr;
 		for (const Material& ikMaterial : *pMaterials_)
-			if (ikMaterial.getModelId() == (Model3D::modelId_ - 1u) && ikMaterial.getId() == pkAiMesh->mMaterialIndex) {
+			if (ikMaterial.getModelId() == (Model3D::modelId_ - 1u) && ikMaterial.getId() == materialId) {
 				pkMaterial = &ikMaterial;
 				break;
 			}
 
 		if (!pkMaterial) {
-			Material mat(pkAiMesh->mMaterialIndex, Model3D::modelId_ - 1u);
-			throw runtime_error("Model3D.loadMeshes|Material " + mat.toString() + " not found.");
+			Material mat(materialId, Model3D::modelId_ - 1u);
+			throw runtime_error("Model3D.loadMeshes_|Material " + mat.toString() + " not found.");
+		}
+
+		if (pMeshBatch) {
+			// see 'getMeshFaces_'
+			if (!cached_ && (!pkAiMesh->HasFaces() || pkAiMesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE)) continue;
+
+			MESH_JOB job = {};
+			job.pkAiMesh = pkAiMesh;
+			job.pkCachedMesh = pkCachedMesh;
+
+			try {
+				unsigned int nFaces = cached_ ? pkCachedMesh->nFaces : pkAiMesh->mNumFaces;
+				unsigned int nVertices = cached_ ? pkCachedMesh->nVertices :
+					                               (pkAiMesh->HasPositions() ? pkAiMesh->mNumVertices : 0u);
+
+				pMeshes_->emplace_back(id, Model3D::modelId_ - 1u, pkMaterial, nFaces, nVertices, transparencySorting_);
+				job.pMesh = &pMeshes_->back();
+				job.pMeshBatch = pMeshBatch;
+				job.mappedMeshId = pMeshBatch->mapMesh(job.pMesh);
+
+				// reserved, filled in place
+				if (!cached_) {
+					MeshCache::MESH cachedMesh = {};
+					cachedMesh.id = id;
+					cachedMesh.materialId = materialId;
+					cachedMesh.nFaces = nFaces;
+					cachedMesh.nVertices = nVertices;
+					cachedMesh.hasTexCoords = getMeshTextureCoords_(pkAiMesh) ? 1u : 0u;
+					cachedMesh.hasNormals = pkAiMesh->HasNormals() ? 1u : 0u;
+					cachedMesh.hasTangentsAndBitangents = pkAiMesh->HasTangentsAndBitangents() ? 1u : 0u;
+					cache_.addMesh(cachedMesh);
+					job.cachedMeshId = cache_.getNumMeshes() - 1u;
+				}
+			}
+			catch (const exception& kException) {
+				throw runtime_error("Model3D.loadMeshes_ > " + string(kException.what()));
+			}
+
+			jobs.push_back(job);
+			continue;
+		}
+
+		// straight from the mapped cache
+		if (cached_) {
+			try {
+				loadMesh_(id, pkMaterial, pkCachedMesh->nFaces, pkCachedMesh->nVertices, cache_.getFaces(pkCachedMesh),
+					      cache_.getVertices(pkCachedMesh), cache_.getTexCoords(pkCachedMesh), cache_.getNormals(pkCachedMesh),
+					      cache_.getTangents(pkCachedMesh), cache_.getBitangents(pkCachedMesh), pkCachedMesh);
+			}
+			catch (const exception& kException) {
+				throw runtime_error("Model3D.loadMeshes_ > " + string(kException.what()));
+			}
+			continue;
 		}
 		
 		uvec3* pFaces = nullptr;
@@ -233,17 +394,21 @@ void Model3D::loadMeshes(list<Mesh>& rMeshes) {
 				if (pNormals)
 					getMeshTangentsAndBitangents_(pkAiMesh, pNormals, pTangents, pBitangents, nVertices);
 
-				pMeshes_->emplace_back(i, Model3D::modelId_ - 1u, pkMaterial, nFaces, nVertices, transparencySorting_);
-				Mesh* pMesh = &pMeshes_->back();
-
-				pMesh->loadFaces(pFaces);
-
-				if (pVertices) pMesh->loadVertices(pVertices);
-				if (pTexCoords) pMesh->loadTexCoords(pTexCoords);
-				if (pNormals) {
-					pMesh->loadNormals(pNormals);
-					if (pTangents && pBitangents) pMesh->loadTangentsAndBitangents(pTangents, pBitangents);
-				}
+				MeshOptimizer::optimize(pFaces, nFaces, nVertices, pVertices, pTexCoords, pNormals, pTangents, pBitangents,
+					                    meshStatistics_.at(id));
+
+				Mesh* pMesh = loadMesh_(id, pkMaterial, nFaces, nVertices, pFaces, pVertices, pTexCoords, pNormals,
+					                    pTangents, pBitangents, nullptr);
+
+				MeshCache::MESH cachedMesh = {};
+				cachedMesh.id = id;
+				cachedMesh.materialId = materialId;
+				cachedMesh.nFaces = nFaces;
+				cachedMesh.nVertices = nVertices;
+				cachedMesh.boundingBoxMin = *pMesh->getBoundingBoxMin();
+				cachedMesh.boundingBoxMax = *pMesh->getBoundingBoxMax();
+				cachedMesh.boundingSphereRadius = pMesh->getBoundingSphereRadius();
+				cache_.addMesh(cachedMesh, pFaces, pVertices, pTexCoords, pNormals, pTangents, pBitangents);
 			}
 		}
 		catch (const exception& kException) {
@@ -253,7 +418,7 @@ void Model3D::loadMeshes(list<Mesh>& rMeshes) {
 			if (pNormals) delete[] pNormals;
 			if (pTangents) delete[] pTangents;
 			if (pBitangents) delete[] pBitangents;
-			throw runtime_error("Model3D.loadMeshes > " + string(kException.what()));
+			throw runtime_error("Model3D.loadMeshes_ > " + string(kException.what()));
 		}
 
 		if (pFaces) delete[] pFaces;
@@ -264,81 +429,205 @@ void Model3D::loadMeshes(list<Mesh>& rMeshes) {
 		if (pBitangents) delete[] pBitangents;
 	}
 
-	displayMeshInfo_();
+	try {
+		if (!jobs.empty()) convertMeshes_(jobs);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Model3D.loadMeshes_ > " + string(kException.what()));
+	}
 }
 
 
 
-void Model3D::loadTransformations() {
-	if (!pMeshes_ || pMeshes_->size() == 0u)
-		throw runtime_error("Model3D.loadTransformations|Meshes must be loaded before transformations.");
-	if (pkAiNode_ != pkAiScene_->mRootNode)
-		throw runtime_error("Model3D.loadTransformations|Transformations already loaded.");
+// the meshes are independent: converted by a pool of worker threads, each taking the next mesh (the largest first)
+void Model3D::convertMeshes_(vector<MESH_JOB>& rJobs) {
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 
-	try {
-		loadTransformations_(pkAiNode_, aiMatrix4x4());
-	}
-	catch (const exception& kException) {
-		throw runtime_error("Model3D.loadTransformations > " + string(kException.what()));
+	std::sort(rJobs.begin(), rJobs.end(), [](const MESH_JOB& kJob0, const MESH_JOB& kJob1) {
+		return kJob0.pMesh->getNumFaces() > kJob1.pMesh->getNumFaces(); });
+
+	unsigned int nThreads = Model3D::nThreads_ > 0u ? Model3D::nThreads_ : max(thread::hardware_concurrency(), 1u);
+	nThreads = min(nThreads, static_cast<unsigned int>(rJobs.size()));
+
+	atomic<size_t> nextJob(0u);
+	vector<string> errors(nThreads);
+
+	auto convert = [this, &rJobs, &nextJob, &errors](unsigned int iThread) {
+		for (size_t i = nextJob++; i < rJobs.size(); i = nextJob++)
+			try {
+				convertMesh_(rJobs.at(i));
+			}
+			catch (const exception& kException) {
+				errors.at(iThread) = kException.what();
+				nextJob = rJobs.size(); // the other threads stop after their mesh
+				return;
+			}
+	};
+
+	if (nThreads == 1u) convert(0u);
+	else {
+		vector<thread> threads;
+		threads.reserve(nThreads);
+
+		for (unsigned int iThread = 0u; iThread < nThreads; iThread++)
+			threads.emplace_back(convert, iThread);
+
+		for (thread& rThread : threads) rThread.join();
 	}
 
-	displayNodeInfo_();
-}
+	for (const string& kError : errors)
+		if (!kError.empty()) throw runtime_error("Model3D.convertMeshes_ > " + kError);
 
+	std::chrono::duration<double, std::milli> convertTime = std::chrono::steady_clock::now() - startTime;
+	cout << "Meshes of model '" << kFileName_ << "' converted (" << rJobs.size() << " meshes, " << nThreads
+		 << " threads) in " << convertTime.count() << " ms." << endl;
+}
 
 
-void Model3D::readModel_(unsigned int postProcessSteps, int removeComponents, bool normalize) {
-	// configures the aiProcess_PreTransformVertices step
-	importer_.SetPropertyInteger(AI_CONFIG_PP_PTV_NORMALIZE, static_cast<int>(normalize));
-	importer_.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, removeComponents); // configures the aiProcess_RemoveComponent step
-	// configures the aiProcess_GenSmoothNormals step
-	importer_.SetPropertyFloat("PP_GSN_MAX_SMOOTHING_ANGLE", Model3D::getMaxSmoothingAngle_());
 
+// any thread: the mesh, its cache arrays and its mapped vertex data are its own
+void Model3D::convertMesh_(const MESH_JOB& kJob) {
+	Mesh* pMesh = kJob.pMesh;
 
-	if (!importer_.ValidateFlags(postProcessSteps))
-		throw runtime_error("Model3D.readModel_|Assimp post processing flags are not valid.");
+	if (kJob.pkCachedMesh) {
+		const MeshCache::MESH* pkCachedMesh = kJob.pkCachedMesh;
 
-	pkAiScene_ = importer_.ReadFile(kFilePath_ + "/" + kFileName_, postProcessSteps);
-	string error = importer_.GetErrorString();
+		pMesh->loadFaces(cache_.getFaces(pkCachedMesh));
+		pMesh->loadVertices(cache_.getVertices(pkCachedMesh), pkCachedMesh->boundingBoxMin, pkCachedMesh->boundingBoxMax,
+			                pkCachedMesh->boundingSphereRadius);
+		pMesh->setBatchedAttributes(pkCachedMesh->hasTexCoords != 0u, pkCachedMesh->hasNormals != 0u,
+			                        pkCachedMesh->hasTangentsAndBitangents != 0u);
 
-	if (pkAiScene_ && error.empty()) {
-		cout << endl << string(Model3D::kLineLength_, '#') << endl;
-		cout << endl << "Import of model '" << kFileName_ << "' succeeded." << endl;
+		kJob.pMeshBatch->writeMesh(kJob.mappedMeshId, cache_.getFaces(pkCachedMesh), cache_.getVertices(pkCachedMesh),
+			                       cache_.getTexCoords(pkCachedMesh), cache_.getNormals(pkCachedMesh),
+			                       cache_.getTangents(pkCachedMesh), cache_.getBitangents(pkCachedMesh));
 	}
 	else {
-		string errorMessage = "Model3D.readModel_|Cannot read '" + kFileName_ + "' file.";
-		if (!error.empty()) errorMessage += "\n" + error;
-		throw runtime_error(errorMessage);
-	}
-		
-	if (((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATED) > 0u) ||
-		((pkAiScene_->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT) > 0u)) {
-		cout << endl;
+		const aiMesh* pkAiMesh = kJob.pkAiMesh;
 
-		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATED) > 0u)
-			cout << "aiProcess_ValidateDataStructure: validation is successful." << endl;
+		uvec3* pFaces = nullptr;
+		vec3* pVertices = nullptr;
+		vec2* pTexCoords = nullptr;
+		vec3* pNormals = nullptr;
+		vec3* pTangents = nullptr;
+		vec3* pBitangents = nullptr;
+		MeshCache::MESH* pCachedMesh = cache_.getMeshData(kJob.cachedMeshId, pFaces, pVertices, pTexCoords, pNormals,
+			                                              pTangents, pBitangents);
 
-		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_NON_VERBOSE_FORMAT) > 0u)
-			cout << "aiProcess_JoinIdenticalVertices: the vertices of the output meshes aren't in the internal\nverbose format"
-			" anymore." << endl;
+		for (unsigned int i = 0u; i < pkAiMesh->mNumFaces; i++) {
+			const aiFace* pkAiFace = &pkAiMesh->mFaces[i];
+
+			if (pkAiFace->mNumIndices == 3u)
+				pFaces[i] = uvec3(pkAiFace->mIndices[0u], pkAiFace->mIndices[1u], pkAiFace->mIndices[2u]);
+		}
+
+		for (unsigned int i = 0u; i < pkAiMesh->mNumVertices; i++)
+			pVertices[i] = vec3(pkAiMesh->mVertices[i].x, pkAiMesh->mVertices[i].y, pkAiMesh->mVertices[i].z);
+
+		convertMeshVertices_(pkAiMesh, getMeshTextureCoords_(pkAiMesh), pTexCoords, pNormals, pTangents, pBitangents);
+		MeshOptimizer::optimize(pFaces, pMesh->getNumFaces(), pMesh->getNumVertices(), pVertices, pTexCoords, pNormals,
+			                    pTangents, pBitangents, meshStatistics_.at(pMesh->getId()));
+
+		pMesh->loadFaces(pFaces);
+		pMesh->loadVertices(pVertices);
+		pMesh->setBatchedAttributes(pTexCoords != nullptr, pNormals != nullptr, pTangents != nullptr);
+
+		pCachedMesh->boundingBoxMin = *pMesh->getBoundingBoxMin();
+		pCachedMesh->boundingBoxMax = *pMesh->getBoundingBoxMax();
+		pCachedMesh->boundingSphereRadius = pMesh->getBoundingSphereRadius();
+
+		kJob.pMeshBatch->writeMesh(kJob.mappedMeshId, pFaces, pVertices, pTexCoords, pNormals, pTangents, pBitangents);
 	}
+}
 
-	if (((pkAiScene_->mFlags & AI_SCENE_FLAGS_INCOMPLETE) > 0u) ||
-		((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATION_WARNING) > 0u) ||
-		((pkAiScene_->mFlags & AI_SCENE_FLAGS_TERRAIN) > 0u)) {
-		cout << endl << "Warning(s):" << endl;
 
-		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_INCOMPLETE) > 0u)
-			cout << "- scene data structure that was imported is not complete." << endl;
 
-		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_VALIDATION_WARNING) > 0u)
-			cout << "- aiProcess_ValidateDataStructure: validation is successful but some issues have been found." << endl;
+void Model3D::getNumMeshVertices_(unsigned int& rnVertices, unsigned int& rnIndices) const {
+	rnVertices = 0u;
+	rnIndices = 0u;
 
-		if ((pkAiScene_->mFlags & AI_SCENE_FLAGS_TERRAIN) > 0u)
-			cout << "- pure height-map terrain data." << endl;
+	if (cached_)
+		for (unsigned int i = 0u; i < cache_.getNumMeshes(); i++) {
+			rnVertices += cache_.getMesh(i)->nVertices;
+			rnIndices += 3u * cache_.getMesh(i)->nFaces;
+		}
+	else
+		for (unsigned int i = 0u; i < pkAiScene_->mNumMeshes; i++) {
+			const aiMesh* pkAiMesh = pkAiScene_->mMeshes[i];
+
+			// see 'getMeshFaces_'
+			if (pkAiMesh && pkAiMesh->HasFaces() && pkAiMesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE &&
+				pkAiMesh->HasPositions()) {
+				rnVertices += pkAiMesh->mNumVertices;
+				rnIndices += 3u * pkAiMesh->mNumFaces;
+			}
+		}
+}
+
+
+
+// only the first texture of each type is implemented
+MeshCache::MATERIAL Model3D::getMaterial_(const aiMaterial* pkAiMaterial) {
+	const ColorTexture::TextureType kTextureTypes[4u] = {
+		ColorTexture::TextureType::DIFFUSE, ColorTexture::TextureType::SPECULAR,
+		ColorTexture::TextureType::EMISSIVE, ColorTexture::TextureType::NORMAL_MAP };
+
+	MeshCache::MATERIAL material = {};
+
+	Material::ShadingModel shadingModel;
+	getMaterialShadingModel_(pkAiMaterial, shadingModel);
+	material.shadingModel = static_cast<GLuint>(shadingModel);
+
+	material.twoSided = isMaterialTwoSided_(pkAiMaterial) ? 1u : 0u;
+	material.wireframe = isMaterialWireframe_(pkAiMaterial) ? 1u : 0u;
+	material.opacity = getMaterialOpacity_(pkAiMaterial);
+
+	material.ambientColor = getMaterialAmbientColor_(pkAiMaterial);
+	material.diffuseColor = getMaterialDiffuseColor_(pkAiMaterial);
+	material.specularColor = getMaterialSpecularColor_(pkAiMaterial);
+	material.emissiveColor = getMaterialEmissiveColor_(pkAiMaterial);
+
+	material.shininess = getMaterialShininess_(pkAiMaterial);
+	material.shininessStrength = getMaterialShininessStrength_(pkAiMaterial);
+
+	for (unsigned int i = 0u; i < 4u; i++) {
+		unsigned int texCount = getTextureCount_(pkAiMaterial, kTextureTypes[i]);
+
+		for (unsigned int j = 0u; j < texCount; j++) {
+			string fileName;
+			if (!getTextureFileName_(pkAiMaterial, kTextureTypes[i], j, fileName)) continue;
+
+			MeshCache::TEXTURE& rTexture = material.textures[i];
+			if (fileName.length() < sizeof(rTexture.fileName)) {
+				std::copy(fileName.begin(), fileName.end(), rTexture.fileName);
+				rTexture.clampToEdge = getTextureMappingMode_(pkAiMaterial, kTextureTypes[i], j) ? 1u : 0u;
+			}
+			else {
+				cout << "Mesh cache: texture name '" << fileName << "' too long, the model is not cached." << endl;
+				cacheable_ = false;
+			}
+			break;
+		}
 	}
 
-	displayModelInfo_();
+	return material;
+}
+
+
+
+void Model3D::setMaterial_(const MeshCache::MATERIAL& kMaterial, Material* pMaterial) const {
+	pMaterial->setShadingModel(static_cast<Material::ShadingModel>(kMaterial.shadingModel));
+	pMaterial->setTwoSided(kMaterial.twoSided != 0u);
+	pMaterial->setWireframe(kMaterial.wireframe != 0u);
+	pMaterial->setOpacity(kMaterial.opacity);
+
+	pMaterial->setAmbientColor(kMaterial.ambientColor);
+	pMaterial->setDiffuseColor(kMaterial.diffuseColor);
+	pMaterial->setSpecularColor(kMaterial.specularColor);
+	pMaterial->setEmissiveColor(kMaterial.emissiveColor);
+
+	pMaterial->setShininess(kMaterial.shininess / 4.0f);
+	pMaterial->setShininessStrength(kMaterial.shininessStrength);
 }
 
 
@@ -527,8 +816,8 @@ unsigned int Model3D::getTextureCount_(const aiMaterial* pkAiMaterial, ColorText
 
 
 
-const ColorTexture* Model3D::getTexture_(const aiMaterial* pkAiMaterial, list<ColorTexture>& rTextures,
-	                                     ColorTexture::TextureType textureType, unsigned int textureNo) const {
+bool Model3D::getTextureFileName_(const aiMaterial* pkAiMaterial, ColorTexture::TextureType textureType,
+	                                  unsigned int textureNo, string& rFileName) const {
 	aiString texPath;
 	bool success = false;
 
@@ -551,12 +840,19 @@ const ColorTexture* Model3D::getTexture_(const aiMaterial* pkAiMaterial, list<Co
 	case ColorTexture::TextureType::NONE:
 		break;
 	}
-	
-	const ColorTexture* pkTexture = nullptr;
 
-	if (success) {
-		string fileName = texPath.data;
+	if (success) rFileName = texPath.data;
+	return success;
+}
+
+
 
+// nullptr -> no texture
+const ColorTexture* Model3D::getTexture_(const MeshCache::TEXTURE& kTexture, list<ColorTexture>& rTextures) const {
+	string fileName = kTexture.fileName;
+	const ColorTexture* pkTexture = nullptr;
+
+	if (!fileName.empty()) {
 		for (const ColorTexture& ikTexture : rTextures)
 			if (ikTexture.getFileName() == fileName) {
 				pkTexture = &ikTexture;
@@ -565,13 +861,15 @@ const ColorTexture* Model3D::getTexture_(const aiMaterial* pkAiMaterial, list<Co
 
 		if (!pkTexture) {
 			try {
-				bool clampToEdge = getTextureMappingMode_(pkAiMaterial, textureType, textureNo);
+				bool clampToEdge = kTexture.clampToEdge != 0u;
 				bool linearFiltering = true, mipmapping = true;
 
 				rTextures.emplace_back(kFilePath_, fileName, !clampToEdge, linearFiltering, mipmapping);
 				pkTexture = &rTextures.back();
 
-				if (pkTexture->isDDS())
+				if (!pkTexture->isResident())
+					cout << "Texture '" << fileName << "' queued." << endl;
+				else if (pkTexture->isDDS())
 					cout << "DDS texture '" << fileName << "' loaded." << endl;
 				else cout << "Texture '" << fileName << "' loaded." << endl;
 
@@ -747,6 +1045,73 @@ void Model3D::getMeshTangentsAndBitangents_(const aiMesh* pkAiMesh, const vec3*
 
 
 
+// only first layer of 2D ('uv') texture is implemented
+const aiVector3D* Model3D::getMeshTextureCoords_(const aiMesh* pkAiMesh) const {
+	for (unsigned int i = 0u; i < pkAiMesh->GetNumUVChannels(); i++)
+		if (pkAiMesh->HasTextureCoords(i) && pkAiMesh->mNumUVComponents[i] == 2u)
+			return pkAiMesh->mTextureCoords[i];
+
+	return nullptr;
+}
+
+
+
+// as 'getMeshTextureCoords_', 'getMeshNormals_' and 'getMeshTangentsAndBitangents_', by blocks (see 'VertexKernels')
+void Model3D::convertMeshVertices_(const aiMesh* pkAiMesh, const aiVector3D* pkAiTexCoords, vec2* pTexCoords,
+	                               vec3* pNormals, vec3* pTangents, vec3* pBitangents) const {
+	static_assert(sizeof(aiVector3D) == 3u * sizeof(float), "Assimp vectors should be xyz triples of floats.");
+
+	for (unsigned int first = 0u; first < pkAiMesh->mNumVertices; first += Model3D::kVertexBlockSize_) {
+		unsigned int nVertices = min(Model3D::kVertexBlockSize_, pkAiMesh->mNumVertices - first);
+
+		if (pNormals && !VertexKernels::normalize(&pkAiMesh->mNormals[first].x, pNormals + first, nVertices,
+			                                      Model3D::kEpsilon_, Model3D::kLengthEpsilon_))
+			throw runtime_error("Model3D.convertMeshVertices_|Invalid normal vector.");
+
+		if (pTangents) {
+			if (!VertexKernels::normalize(&pkAiMesh->mTangents[first].x, pTangents + first, nVertices,
+				                          Model3D::kEpsilon_, Model3D::kLengthEpsilon_))
+				throw runtime_error("Model3D.convertMeshVertices_|Invalid tangent vector.");
+
+			if (!VertexKernels::normalize(&pkAiMesh->mBitangents[first].x, pBitangents + first, nVertices,
+				                          Model3D::kEpsilon_, Model3D::kLengthEpsilon_))
+				throw runtime_error("Model3D.convertMeshVertices_|Invalid bitangent vector.");
+
+			VertexKernels::orientBitangents(pNormals + first, pTangents + first, pBitangents + first, nVertices);
+		}
+
+		if (pTexCoords)
+			for (unsigned int i = first; i < first + nVertices; i++)
+				pTexCoords[i] = vec2(pkAiTexCoords[i].x, pkAiTexCoords[i].y);
+	}
+}
+
+
+
+Mesh* Model3D::loadMesh_(unsigned int id, const Material* pkMaterial, unsigned int nFaces, unsigned int nVertices,
+	                     const uvec3* pkFaces, const vec3* pkVertices, const vec2* pkTexCoords, const vec3* pkNormals,
+	                     const vec3* pkTangents, const vec3* pkBitangents, const MeshCache::MESH* pkCachedMesh) {
+	pMeshes_->emplace_back(id, Model3D::modelId_ - 1u, pkMaterial, nFaces, nVertices, transparencySorting_);
+	Mesh* pMesh = &pMeshes_->back();
+
+	pMesh->loadFaces(pkFaces);
+
+	if (pkVertices && pkCachedMesh)
+		pMesh->loadVertices(pkVertices, pkCachedMesh->boundingBoxMin, pkCachedMesh->boundingBoxMax,
+			                pkCachedMesh->boundingSphereRadius);
+	else if (pkVertices) pMesh->loadVertices(pkVertices);
+
+	if (pkTexCoords) pMesh->loadTexCoords(pkTexCoords);
+	if (pkNormals) {
+		pMesh->loadNormals(pkNormals);
+		if (pkTangents && pkBitangents) pMesh->loadTangentsAndBitangents(pkTangents, pkBitangents);
+	}
+
+	return pMesh;
+}
+
+
+
 void Model3D::loadTransformations_(const aiNode* pkAiNode, const aiMatrix4x4& kTransformationMatrix) {
 	aiMatrix4x4 matrix = kTransformationMatrix * pkAiNode->mTransformation;
 
@@ -756,10 +1121,12 @@ void Model3D::loadTransformations_(const aiNode* pkAiNode, const aiMatrix4x4& kT
 		for (Mesh& iMesh : *pMeshes_)
 			try {
 				if (iMesh.getModelId() == (Model3D::modelId_ - 1u) && iMesh.getId() == id) {
-					iMesh.transform(mat4(matrix[0u][0u], matrix[1u][0u], matrix[2u][0u], matrix[3u][0u],
-										 matrix[0u][1u], matrix[1u][1u], matrix[2u][1u], matrix[3u][1u],
-										 matrix[0u][2u], matrix[1u][2u], matrix[2u][2u], matrix[3u][2u],
-										 matrix[0u][3u], matrix[1u][3u], matrix[2u][3u], matrix[3u][3u]));
+					mat4 transformationMatrix(matrix[0u][0u], matrix[1u][0u], matrix[2u][0u], matrix[3u][0u],
+						                      matrix[0u][1u], matrix[1u][1u], matrix[2u][1u], matrix[3u][1u],
+						                      matrix[0u][2u], matrix[1u][2u], matrix[2u][2u], matrix[3u][2u],
+						                      matrix[0u][3u], matrix[1u][3u], matrix[2u][3u], matrix[3u][3u]);
+					iMesh.transform(transformationMatrix);
+					cache_.addTransformation(id, transformationMatrix);
 					break;
 				}
 			}
@@ -801,6 +1168,15 @@ void Model3D::displayModelInfo_() const {
 
 
 
+void Model3D::displayCacheInfo_() const {
+	cout << endl << string(Model3D::kLineLength_, '#') << endl;
+	cout << endl << "Model '" << kFileName_ << (native_ ? "' imported by the OBJ importer (" :
+		 "' loaded from its mesh cache (") << cache_.getNumMeshes() << " meshes, " << cache_.getNumMaterials()
+		 << " materials)." << endl;
+}
+
+
+
 void Model3D::displayMaterialInfo_() const {
 	cout << endl << "Materials:" << endl;
 	cout << "   id  name                            shading model  twosided  wireframe  opacity (blend mode)" << endl;
@@ -943,6 +1319,22 @@ void Model3D::displayMeshInfo_() const {
 		bool hasBones = pkAiMesh->HasBones() && pkAiMesh->mNumBones > 0u;
 		cout << " " << setw(5) << left << (hasBones ? "yes" : "no") << endl;
 	}
+
+	cout << endl << "Mesh optimization (FIFO vertex cache of " << MeshOptimizer::getCacheSize() << " vertices):" << endl;
+	cout << "   id  ACMR imported  optimized  ATVR imported  optimized  clusters" << endl;
+	cout << string(Model3D::kLineLength_, '-') << endl;
+
+	for (const Mesh& ikMesh : *pMeshes_) {
+		if (ikMesh.getModelId() != Model3D::modelId_ - 1u || ikMesh.getId() >= meshStatistics_.size()) continue;
+		const MeshOptimizer::STATISTICS& kStatistics = meshStatistics_.at(ikMesh.getId());
+		if (kStatistics.nClusters == 0u) continue; // not optimized
+
+		cout << setw(5) << right << ikMesh.toString().substr(0u, 5u) << "  ";
+		cout << std::fixed << std::setprecision(3);
+		cout << setw(13) << right << kStatistics.acmr << "  " << setw(9) << kStatistics.optimizedAcmr << "  ";
+		cout << setw(13) << right << kStatistics.atvr << "  " << setw(9) << kStatistics.optimizedAtvr << "  ";
+		cout << setw(8) << right << kStatistics.nClusters << endl;
+	}
 }
 
 
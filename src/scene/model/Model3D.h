@@ -1,13 +1,19 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 23, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef MODEL_H
 #define MODEL_H
 
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjImporter.h"
+#include "VertexKernels.h"
 #include "material/Material.h"
+#include "mesh/batch/MeshBatch.h"
 #include "mesh/mesh/Mesh.h"
+#include "mesh/triangle/Triangle.h"
 #include "texture/texture/ColorTexture.h"
 
 #include <assimp/Importer.hpp>
@@ -19,6 +25,8 @@
 #include <glm/vec3.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <exception>
 #include <iomanip>
@@ -26,27 +34,45 @@
 #include <list>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 using glm::mat4;
 using glm::uvec3;
 using glm::vec2;
 using glm::vec3;
 
+using std::atomic;
 using std::cout;
 using std::endl;
 using std::exception;
 using std::left;
 using std::list;
+using std::max;
+using std::min;
 using std::right;
 using std::runtime_error;
 using std::setw;
 using std::string;
+using std::thread;
 using std::to_string;
+using std::vector;
 
 
 
+// The model is imported with Assimp, then written to its mesh cache once loaded ('loadTransformations'); while the
+// cache is up to date (see 'MeshCache'), the next imports load it from the cache instead, without Assimp. Loaded for a
+// mesh batch, the vertex attributes are converted once, from the Assimp meshes (or the cache) straight into its mapped
+// buffer; the meshes then keep only their faces and vertices (bounding volumes, transparency sorting). The meshes are
+// converted in parallel, by a thread per core ('setNumThreads'). The imported meshes are reordered for the vertex cache
+// and against overdraw as they are converted (see 'MeshOptimizer'); the cache keeps the optimized order. Without a
+// cache, the OBJ models are imported by 'ObjImporter' into the cache, as if loaded from it, when it supports the post
+// processing steps; otherwise, or if it cannot parse the file, with Assimp.
 class Model3D {
 public:
+	static void setNumThreads(unsigned int nThreads); // 0 -> one per core (default)
+
+
 	Model3D(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps, int removeComponents,
 		    bool normalize, bool transparencySorting);
 	~Model3D();
@@ -61,6 +87,7 @@ public:
 	void loadTextures(list<ColorTexture>& rDiffuseTextures,  list<ColorTexture>& rSpecularTextures, 
 		              list<ColorTexture>& rEmissiveTextures, list<ColorTexture>& rNormalMapTextures);
 	void loadMeshes(list<Mesh>& rMeshes);
+	void loadMeshes(list<Mesh>& rMeshes, MeshBatch* pMeshBatch); // see 'MeshBatch.mapVertexData'
 	void loadTransformations();
 
 private:
@@ -69,6 +96,9 @@ private:
 	static const float kEpsilon_;
 	static const float kLengthEpsilon_;
 	static const unsigned int kLineLength_;
+	static const unsigned int kVertexBlockSize_;
+
+	static unsigned int nThreads_;
 
 	static unsigned int modelId_;
 
@@ -77,6 +107,24 @@ private:
 
 	void readModel_(unsigned int postProcessSteps, int removeComponents, bool normalize);
 
+	// a mesh loaded for the batch: 'pkCachedMesh' (read) or 'pkAiMesh' (and the cache mesh written)
+	struct MESH_JOB {
+		const aiMesh* pkAiMesh;
+		const MeshCache::MESH* pkCachedMesh;
+		unsigned int cachedMeshId;
+		Mesh* pMesh;
+		MeshBatch* pMeshBatch;
+		unsigned int mappedMeshId;
+	};
+
+	void loadMeshes_(MeshBatch* pMeshBatch); // nullptr -> the meshes keep all their attributes
+	void convertMeshes_(vector<MESH_JOB>& rJobs);
+	void convertMesh_(const MESH_JOB& kJob);
+	void getNumMeshVertices_(unsigned int& rnVertices, unsigned int& rnIndices) const; // all the meshes
+
+	MeshCache::MATERIAL getMaterial_(const aiMaterial* pkAiMaterial); // with the first texture of each type
+	void setMaterial_(const MeshCache::MATERIAL& kMaterial, Material* pMaterial) const;
+
 	string getMaterialName_(const aiMaterial* pkAiMaterial) const;
 
 	string getMaterialShadingModel_(const aiMaterial* pkAiMaterial, Material::ShadingModel& rShadingModel) const;
@@ -99,8 +147,9 @@ private:
 
 	unsigned int getTextureCount_(const aiMaterial* pkAiMaterial, ColorTexture::TextureType textureType) const;
 
-	const ColorTexture* getTexture_(const aiMaterial* pkAiMaterial, list<ColorTexture>& rTextures,
-		                            ColorTexture::TextureType textureType, unsigned int textureNo) const;
+	bool getTextureFileName_(const aiMaterial* pkAiMaterial, ColorTexture::TextureType textureType, unsigned int textureNo,
+		                     string& rFileName) const;
+	const ColorTexture* getTexture_(const MeshCache::TEXTURE& kTexture, list<ColorTexture>& rTextures) const;
 	
 	bool getTextureMappingMode_(const aiMaterial* pkAiMaterial, ColorTexture::TextureType textureType,
 		                        unsigned int textureNo) const; // true -> GL_TEXTURE_WRAP_S = GL_TEXTURE_WRAP_T = GL_CLAMP_TO_EDGE
@@ -113,9 +162,21 @@ private:
 	void getMeshTangentsAndBitangents_(const aiMesh* pkAiMesh, const vec3* pkNormals,
 		                               vec3*& rpTangents, vec3*& rpBitangents, unsigned int nVertices) const;
 
+	const aiVector3D* getMeshTextureCoords_(const aiMesh* pkAiMesh) const; // nullptr -> none
+
+	// converted and normalized into the cache arrays (nullptr -> none)
+	void convertMeshVertices_(const aiMesh* pkAiMesh, const aiVector3D* pkAiTexCoords, vec2* pTexCoords, vec3* pNormals,
+		                      vec3* pTangents, vec3* pBitangents) const;
+
+	// 'pkCachedMesh': bounding volumes, nullptr -> computed
+	Mesh* loadMesh_(unsigned int id, const Material* pkMaterial, unsigned int nFaces, unsigned int nVertices,
+		            const uvec3* pkFaces, const vec3* pkVertices, const vec2* pkTexCoords, const vec3* pkNormals,
+		            const vec3* pkTangents, const vec3* pkBitangents, const MeshCache::MESH* pkCachedMesh);
+
 	void loadTransformations_(const aiNode* pkAiNode, const aiMatrix4x4& kTransformationMatrix);
 
 	void displayModelInfo_() const;
+	void displayCacheInfo_() const; // loaded from the mesh cache, or imported by the OBJ importer
 	void displayMaterialInfo_() const;
 	void displayTextureInfo_() const;
 	void displayMeshInfo_() const;
@@ -131,8 +192,15 @@ private:
 
 	Assimp::Importer importer_;
 
+	MeshCache cache_; // read, or written while importing
+	unsigned int postProcessSteps_;
+	int removeComponents_;
+	bool normalize_, cached_, cacheable_, transformed_;
+	bool native_; // 'cache_' filled by 'ObjImporter' (and 'cached_'), written once loaded
+
 	list<Mesh>* pMeshes_;
 	list<Material>* pMaterials_;
+	vector<MeshOptimizer::STATISTICS> meshStatistics_; // imported: by mesh id, written by the thread of the mesh
 
 	bool transparencySorting_;
 };
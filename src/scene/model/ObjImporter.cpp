@@ -0,0 +1,1157 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "ObjImporter.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+// always welded, fanned into triangles; points and lines skipped, as degenerate triangles
+const unsigned int ObjImporter::kSupportedSteps_ = aiProcess_JoinIdenticalVertices | aiProcess_Triangulate |
+                                                   aiProcess_CalcTangentSpace | aiProcess_GenNormals |
+                                                   aiProcess_GenSmoothNormals | aiProcess_ValidateDataStructure |
+                                                   aiProcess_RemoveRedundantMaterials | aiProcess_FixInfacingNormals |
+                                                   aiProcess_SortByPType | aiProcess_FindDegenerates |
+                                                   aiProcess_FindInvalidData | aiProcess_OptimizeMeshes |
+                                                   aiProcess_ImproveCacheLocality;
+const size_t ObjImporter::kMinChunkSize_ = 1u << 20u;
+const unsigned int ObjImporter::kChunksPerThread_ = 4u;
+const float ObjImporter::kEpsilon_ = 0.001f;
+const float ObjImporter::kLengthEpsilon_ = 0.01f;
+const std::uint64_t ObjImporter::kDigitPowersOf10_[9u] = { 1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u,
+                                                           10000000u, 100000000u };
+const double ObjImporter::kPowersOf10_[23u] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+
+
+bool ObjImporter::isSupported(const string& kFileName, unsigned int postProcessSteps) {
+	if (kFileName.length() < 4u || (postProcessSteps & ~ObjImporter::kSupportedSteps_) != 0u) return false;
+
+	string extension = kFileName.substr(kFileName.length() - 4u);
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+		           [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	return extension == ".obj";
+}
+
+
+
+ObjImporter::ObjImporter(unsigned int nThreads, float maxSmoothingAngle) :
+	                     nThreads_(nThreads > 0u ? nThreads : max(thread::hardware_concurrency(), 1u)),
+	                     maxSmoothingAngle_(maxSmoothingAngle), postProcessSteps_(0u), pkMapping_(nullptr),
+	                     mappingSize_(0u), pFile_(nullptr), pFileMapping_(nullptr), chunks_(), positions_(),
+	                     texCoords_(), normals_(), materials_(), materialIds_(), defaultMaterialId_(~0u),
+	                     meshJobs_(), nTriangles_(0u), parseTime_(0.0), buildTime_(0.0) {
+	//cout << "OBJ importer created." << endl;
+}
+
+
+
+ObjImporter::~ObjImporter() {
+	unmap_();
+
+	//cout << "OBJ importer deleted." << endl;
+}
+
+
+
+bool ObjImporter::import(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps,
+	                     MeshCache& rCache) {
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	postProcessSteps_ = postProcessSteps;
+	chunks_.clear();
+	positions_.clear();
+	texCoords_.clear();
+	normals_.clear();
+	materials_.clear();
+	materialIds_.clear();
+	defaultMaterialId_ = ~0u;
+	meshJobs_.clear();
+	nTriangles_ = 0u;
+
+	if (!map_(kFilePath + "/" + kFileName)) {
+		cout << "OBJ importer: cannot map the '" << kFileName << "' file, imported with Assimp." << endl;
+		return false;
+	}
+
+	// chunks of whole lines, a few per thread (load balance)
+	size_t chunkSize = max(ObjImporter::kMinChunkSize_, mappingSize_ / (nThreads_ * ObjImporter::kChunksPerThread_) + 1u);
+	const char* pkEnd = pkMapping_ + mappingSize_;
+
+	for (const char* pkChar = pkMapping_; pkChar < pkEnd;) {
+		const char* pkChunkEnd = pkEnd;
+
+		if (static_cast<size_t>(pkEnd - pkChar) > chunkSize) {
+			const char* pkLineEnd = static_cast<const char*>(std::memchr(pkChar + chunkSize, '\n',
+				                                                         pkEnd - (pkChar + chunkSize)));
+			if (pkLineEnd) pkChunkEnd = pkLineEnd + 1;
+		}
+
+		chunks_.emplace_back();
+		chunks_.back().pkBegin = pkChar;
+		chunks_.back().pkEnd = pkChunkEnd;
+		pkChar = pkChunkEnd;
+	}
+
+	runJobs_(chunks_.size(), [this](size_t i) {
+		try {
+			parseChunk_(chunks_[i]);
+		}
+		catch (const exception& kException) {
+			chunks_[i].error = kException.what();
+		}
+	});
+
+	for (const CHUNK& kChunk : chunks_)
+		if (!kChunk.error.empty()) {
+			cout << "OBJ importer: " << kChunk.error << " in '" << kFileName << "', imported with Assimp." << endl;
+			return false;
+		}
+
+	// the libraries, in the order of the 'mtllib' lines
+	vector<string> materialLibraries;
+	for (const CHUNK& kChunk : chunks_)
+		for (const string& kLibrary : kChunk.materialLibraries)
+			if (std::find(materialLibraries.begin(), materialLibraries.end(), kLibrary) == materialLibraries.end())
+				materialLibraries.push_back(kLibrary);
+
+	for (const string& kLibrary : materialLibraries) loadMaterialLibrary_(kFilePath, kLibrary);
+
+	for (const MeshCache::MATERIAL& kMaterial : materials_)
+		for (const MeshCache::TEXTURE& kTexture : kMaterial.textures)
+			if (kTexture.fileName[sizeof(kTexture.fileName) - 1u] != '\0') {
+				cout << "OBJ importer: texture name too long, imported with Assimp." << endl;
+				return false;
+			}
+
+	if (!joinChunks_()) {
+		cout << "OBJ importer: invalid faces in '" << kFileName << "', imported with Assimp." << endl;
+		return false;
+	}
+
+	std::chrono::steady_clock::time_point parseEndTime = std::chrono::steady_clock::now();
+	parseTime_ = std::chrono::duration<double, std::milli>(parseEndTime - startTime).count();
+
+	// the largest first
+	vector<unsigned int> order(meshJobs_.size());
+	for (unsigned int i = 0u; i < order.size(); i++) order[i] = i;
+	std::sort(order.begin(), order.end(), [this](unsigned int i, unsigned int j) {
+		return meshJobs_[i].nTriangles > meshJobs_[j].nTriangles; });
+
+	runJobs_(order.size(), [this, &order](size_t i) {
+		MESH_JOB& rJob = meshJobs_[order[i]];
+
+		try {
+			buildMesh_(rJob);
+		}
+		catch (const exception& kException) {
+			rJob.error = kException.what();
+		}
+	});
+
+	for (const MESH_JOB& kJob : meshJobs_)
+		if (!kJob.error.empty()) {
+			cout << "OBJ importer: " << kJob.error << " in '" << kFileName << "', imported with Assimp." << endl;
+			return false;
+		}
+
+	for (const MeshCache::MATERIAL& kMaterial : materials_) rCache.addMaterial(kMaterial);
+
+	for (const MESH_JOB& kJob : meshJobs_) {
+		rCache.addMesh(kJob.mesh, kJob.faces.data(), kJob.vertices.data(), kJob.texCoords.empty() ? nullptr :
+			           kJob.texCoords.data(), kJob.normals.empty() ? nullptr : kJob.normals.data(),
+			           kJob.tangents.empty() ? nullptr : kJob.tangents.data(),
+			           kJob.bitangents.empty() ? nullptr : kJob.bitangents.data());
+		rCache.addTransformation(kJob.id, mat4(1.0f));
+	}
+
+	buildTime_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parseEndTime).count();
+
+	// the arrays are in the cache
+	chunks_.clear();
+	positions_.clear();
+	texCoords_.clear();
+	normals_.clear();
+	meshJobs_.clear();
+	unmap_();
+	return true;
+}
+
+
+
+void ObjImporter::displayInfo() const {
+	cout << "OBJ importer: " << nTriangles_ << " triangles parsed in " << parseTime_ << " ms";
+	if (parseTime_ > 0.0) cout << " (" << static_cast<double>(mappingSize_) / (1000.0 * parseTime_) << " MB/s)";
+	cout << ", meshes built in " << buildTime_ << " ms (" << nThreads_ << " threads)." << endl;
+}
+
+
+
+bool ObjImporter::parseFloat_(const char*& rpkChar, const char* pkEnd, float& rValue) {
+	const char* pkChar = ObjImporter::skipSpaces_(rpkChar, pkEnd);
+	const char* pkStart = pkChar;
+
+	bool negative = false;
+	if (pkChar < pkEnd && (*pkChar == '-' || *pkChar == '+')) negative = *pkChar++ == '-';
+
+	std::uint64_t mantissa = 0u;
+	unsigned int nSignificant = 0u, nDropped = 0u;
+	int exponent = 0;
+
+	unsigned int nDigits = ObjImporter::parseDigits_(pkChar, pkEnd, mantissa, nSignificant, nDropped);
+	exponent += static_cast<int>(nDropped);
+
+	if (pkChar < pkEnd && *pkChar == '.') {
+		pkChar++;
+		nDropped = 0u;
+		unsigned int nFractionDigits = ObjImporter::parseDigits_(pkChar, pkEnd, mantissa, nSignificant, nDropped);
+		exponent -= static_cast<int>(nFractionDigits - nDropped);
+		nDigits += nFractionDigits;
+	}
+
+	if (nDigits == 0u) return false;
+
+	if (pkChar < pkEnd && (*pkChar == 'e' || *pkChar == 'E')) {
+		const char* pkExponent = pkChar + 1;
+		long long value = 0;
+		if (!ObjImporter::parseIndex_(pkExponent, pkEnd, value)) return false;
+
+		exponent += static_cast<int>(std::max(std::min(value, 1000ll), -1000ll));
+		pkChar = pkExponent;
+	}
+
+	// exact: mantissa and power of 10 both doubles, a single rounding; otherwise (rare) by the C library
+	double value = 0.0;
+	if (mantissa > (1ull << 53u) || exponent < -22 || exponent > 22)
+		value = std::strtod(string(pkStart, pkChar).c_str(), nullptr);
+	else {
+		value = exponent >= 0 ? static_cast<double>(mantissa) * ObjImporter::kPowersOf10_[exponent] :
+		                        static_cast<double>(mantissa) / ObjImporter::kPowersOf10_[-exponent];
+		if (negative) value = -value;
+	}
+
+	rValue = static_cast<float>(value);
+	rpkChar = pkChar;
+	return true;
+}
+
+
+
+bool ObjImporter::parseIndex_(const char*& rpkChar, const char* pkEnd, long long& rValue) {
+	const char* pkChar = rpkChar;
+
+	bool negative = false;
+	if (pkChar < pkEnd && (*pkChar == '-' || *pkChar == '+')) negative = *pkChar++ == '-';
+
+	std::uint64_t value = 0u;
+	unsigned int nSignificant = 0u, nDropped = 0u;
+	if (ObjImporter::parseDigits_(pkChar, pkEnd, value, nSignificant, nDropped) == 0u || nDropped > 0u ||
+		value > 0x7fffffffull) return false;
+
+	rValue = negative ? -static_cast<long long>(value) : static_cast<long long>(value);
+	rpkChar = pkChar;
+	return true;
+}
+
+
+
+unsigned int ObjImporter::parseDigits_(const char*& rpkChar, const char* pkEnd, std::uint64_t& rMantissa,
+	                                   unsigned int& rnSignificant, unsigned int& rnDropped) {
+	const char* pkChar = rpkChar;
+
+	// the leading zeros are not significant
+	if (rnSignificant == 0u) while (pkChar < pkEnd && *pkChar == '0') pkChar++;
+
+	// the other digits, 8 characters at a time
+	while (pkEnd - pkChar >= 8) {
+		std::uint64_t chars;
+		std::memcpy(&chars, pkChar, 8u);
+
+		unsigned int nDigits = ObjImporter::getNumDigits_(chars);
+		if (nDigits == 0u || rnSignificant + nDigits > 19u) break;
+
+		// the digits in the high bytes, '0' in the low ones
+		if (nDigits < 8u) chars = (chars << (8u * (8u - nDigits))) | (0x3030303030303030ull >> (8u * nDigits));
+		std::uint32_t digits = ObjImporter::parseEightDigits_(chars);
+		rMantissa = rMantissa * ObjImporter::kDigitPowersOf10_[nDigits] + digits;
+		rnSignificant += nDigits;
+
+		pkChar += nDigits;
+		if (nDigits < 8u) break;
+	}
+
+	for (; pkChar < pkEnd && *pkChar >= '0' && *pkChar <= '9'; pkChar++) {
+		unsigned int digit = static_cast<unsigned int>(*pkChar - '0');
+
+		if (rnSignificant >= 19u) rnDropped++;
+		else {
+			rMantissa = rMantissa * 10u + digit;
+			rnSignificant++;
+		}
+	}
+
+	unsigned int nDigits = static_cast<unsigned int>(pkChar - rpkChar);
+	rpkChar = pkChar;
+	return nDigits;
+}
+
+
+
+// characters '0' ... '9' before the first other one: bytes of (chars ^ '0') >= 10 -> high bit set (a carry only
+// from a byte before)
+unsigned int ObjImporter::getNumDigits_(std::uint64_t chars) {
+	std::uint64_t values = chars ^ 0x3030303030303030ull;
+	std::uint64_t others = ((values + 0x7676767676767676ull) | values) & 0x8080808080808080ull;
+	if (others == 0u) return 8u;
+
+	// the bytes before the first other one, counted by a multiplication
+	std::uint64_t below = ((others & (~others + 1u)) - 1u) & 0x0101010101010101ull;
+	return static_cast<unsigned int>((below * 0x0101010101010101ull) >> 56u) - 1u;
+}
+
+
+
+// the first character in the low byte: pairs, then quadruples of digits combined by multiplications
+std::uint32_t ObjImporter::parseEightDigits_(std::uint64_t chars) {
+	chars -= 0x3030303030303030ull;
+	chars = (chars * 10u) + (chars >> 8u);
+	chars = (((chars & 0x000000FF000000FFull) * (100u + (1000000ull << 32u))) +
+		     (((chars >> 16u) & 0x000000FF000000FFull) * (1u + (10000ull << 32u)))) >> 32u;
+	return static_cast<std::uint32_t>(chars);
+}
+
+
+
+const char* ObjImporter::skipSpaces_(const char* pkChar, const char* pkEnd) {
+	while (pkChar < pkEnd && (*pkChar == ' ' || *pkChar == '\t' || *pkChar == '\r')) pkChar++;
+	return pkChar;
+}
+
+
+
+string ObjImporter::getRemainder_(const char* pkChar, const char* pkEnd) {
+	pkChar = ObjImporter::skipSpaces_(pkChar, pkEnd);
+	while (pkEnd > pkChar && (pkEnd[-1] == ' ' || pkEnd[-1] == '\t' || pkEnd[-1] == '\r')) pkEnd--;
+	return string(pkChar, pkEnd);
+}
+
+
+
+bool ObjImporter::isKeyword_(const char* pkChar, const char* pkEnd, const char* pkKeyword) {
+	size_t length = std::strlen(pkKeyword);
+	return static_cast<size_t>(pkEnd - pkChar) > length && std::memcmp(pkChar, pkKeyword, length) == 0 &&
+		   (pkChar[length] == ' ' || pkChar[length] == '\t');
+}
+
+
+
+std::uint64_t ObjImporter::hash_(const std::uint32_t* pkWords, unsigned int nWords) {
+	std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+
+	for (unsigned int i = 0u; i < nWords; i++) {
+		hash = (hash ^ pkWords[i]) * 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32u;
+	}
+
+	return hash;
+}
+
+
+
+// read only, the pages are loaded on first access
+bool ObjImporter::map_(const string& kFilePath) {
+	unmap_();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(kFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+	if (!fileMapping) {
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* pkView = MapViewOfFile(fileMapping, FILE_MAP_READ, 0u, 0u, 0u);
+	if (!pkView) {
+		CloseHandle(fileMapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	pFile_ = file;
+	pFileMapping_ = fileMapping;
+	pkMapping_ = static_cast<const char*>(pkView);
+	mappingSize_ = static_cast<size_t>(size.QuadPart);
+#else
+	int file = ::open(kFilePath.c_str(), O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size <= 0) {
+		::close(file);
+		return false;
+	}
+
+	void* pView = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (pView == MAP_FAILED) return false;
+
+	pkMapping_ = static_cast<const char*>(pView);
+	mappingSize_ = static_cast<size_t>(info.st_size);
+#endif
+
+	return true;
+}
+
+
+
+void ObjImporter::unmap_() {
+	if (!pkMapping_) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(pkMapping_);
+	CloseHandle(static_cast<HANDLE>(pFileMapping_));
+	CloseHandle(static_cast<HANDLE>(pFile_));
+#else
+	munmap(const_cast<char*>(pkMapping_), mappingSize_);
+#endif
+
+	pkMapping_ = nullptr;
+	pFile_ = nullptr;
+	pFileMapping_ = nullptr;
+}
+
+
+
+// the jobs do not throw: each keeps its error
+void ObjImporter::runJobs_(size_t nJobs, const function<void(size_t)>& kJob) const {
+	unsigned int nThreads = static_cast<unsigned int>(min(static_cast<size_t>(nThreads_), nJobs));
+	atomic<size_t> nextJob(0u);
+
+	auto run = [nJobs, &kJob, &nextJob]() {
+		for (size_t i = nextJob++; i < nJobs; i = nextJob++) kJob(i);
+	};
+
+	if (nThreads <= 1u) run();
+	else {
+		vector<thread> threads;
+		threads.reserve(nThreads);
+
+		for (unsigned int iThread = 0u; iThread < nThreads; iThread++) threads.emplace_back(run);
+		for (thread& rThread : threads) rThread.join();
+	}
+}
+
+
+
+// 'v', 'vt', 'vn', 'f', 'usemtl' and 'mtllib' lines; the others ('o', 'g', 's', 'l', 'p', ...) skipped
+void ObjImporter::parseChunk_(CHUNK& rChunk) const {
+	vector<ivec3> polygon;
+	vector<unsigned int> relative;
+
+	rChunk.runs.push_back({ 0u, true, string() });
+
+	for (const char* pkChar = rChunk.pkBegin; pkChar < rChunk.pkEnd;) {
+		const char* pkLineEnd = static_cast<const char*>(std::memchr(pkChar, '\n', rChunk.pkEnd - pkChar));
+		if (!pkLineEnd) pkLineEnd = rChunk.pkEnd;
+
+		const char* pkLine = ObjImporter::skipSpaces_(pkChar, pkLineEnd);
+		pkChar = pkLineEnd < rChunk.pkEnd ? pkLineEnd + 1 : rChunk.pkEnd;
+		if (pkLine == pkLineEnd || *pkLine == '#') continue;
+
+		bool valid = true;
+
+		if (ObjImporter::isKeyword_(pkLine, pkLineEnd, "v")) {
+			const char* pkNumber = pkLine + 1;
+			vec3 position;
+			valid = ObjImporter::parseFloat_(pkNumber, pkLineEnd, position.x) &&
+				    ObjImporter::parseFloat_(pkNumber, pkLineEnd, position.y) &&
+				    ObjImporter::parseFloat_(pkNumber, pkLineEnd, position.z); // [w], [r g b] skipped
+			rChunk.positions.push_back(position);
+		}
+		else if (ObjImporter::isKeyword_(pkLine, pkLineEnd, "vt")) {
+			const char* pkNumber = pkLine + 2;
+			vec2 texCoord(0.0f);
+			valid = ObjImporter::parseFloat_(pkNumber, pkLineEnd, texCoord.x);
+			ObjImporter::parseFloat_(pkNumber, pkLineEnd, texCoord.y); // [v], [w] skipped
+			rChunk.texCoords.push_back(texCoord);
+		}
+		else if (ObjImporter::isKeyword_(pkLine, pkLineEnd, "vn")) {
+			const char* pkNumber = pkLine + 2;
+			vec3 normal;
+			valid = ObjImporter::parseFloat_(pkNumber, pkLineEnd, normal.x) &&
+				    ObjImporter::parseFloat_(pkNumber, pkLineEnd, normal.y) &&
+				    ObjImporter::parseFloat_(pkNumber, pkLineEnd, normal.z);
+			rChunk.normals.push_back(normal);
+		}
+		else if (ObjImporter::isKeyword_(pkLine, pkLineEnd, "f"))
+			valid = parseFace_(rChunk, pkLine + 1, pkLineEnd, polygon, relative);
+		else if (ObjImporter::isKeyword_(pkLine, pkLineEnd, "usemtl")) {
+			size_t nTriangles = rChunk.corners.size() / 3u;
+			if (rChunk.runs.back().firstTriangle == nTriangles) rChunk.runs.pop_back(); // no faces
+
+			rChunk.runs.push_back({ nTriangles, false, ObjImporter::getRemainder_(pkLine + 6, pkLineEnd) });
+		}
+		else if (ObjImporter::isKeyword_(pkLine, pkLineEnd, "mtllib"))
+			rChunk.materialLibraries.push_back(ObjImporter::getRemainder_(pkLine + 6, pkLineEnd));
+
+		if (!valid) {
+			string line(pkLine, min(static_cast<size_t>(pkLineEnd - pkLine), static_cast<size_t>(32u)));
+			rChunk.error = "invalid line '" + ObjImporter::getRemainder_(line.data(), line.data() + line.size()) + "'";
+			return;
+		}
+	}
+}
+
+
+
+// corners 'v', 'v/vt', 'v//vn' or 'v/vt/vn'; 1-based indices, or negative: relative to the last vertex
+bool ObjImporter::parseFace_(CHUNK& rChunk, const char* pkChar, const char* pkEnd, vector<ivec3>& rPolygon,
+	                         vector<unsigned int>& rRelative) const {
+	const size_t kCounts[3u] = { rChunk.positions.size(), rChunk.texCoords.size(), rChunk.normals.size() };
+	rPolygon.clear();
+	rRelative.clear();
+
+	for (;;) {
+		pkChar = ObjImporter::skipSpaces_(pkChar, pkEnd);
+		if (pkChar == pkEnd || *pkChar == '#') break;
+
+		long long indices[3u] = { 0, 0, 0 };
+		bool given[3u] = { true, false, false };
+
+		if (!ObjImporter::parseIndex_(pkChar, pkEnd, indices[0u])) return false;
+
+		if (pkChar < pkEnd && *pkChar == '/') {
+			pkChar++;
+			if (pkChar < pkEnd && *pkChar != '/') {
+				if (!ObjImporter::parseIndex_(pkChar, pkEnd, indices[1u])) return false;
+				given[1u] = true;
+			}
+
+			if (pkChar < pkEnd && *pkChar == '/') {
+				pkChar++;
+				if (!ObjImporter::parseIndex_(pkChar, pkEnd, indices[2u])) return false;
+				given[2u] = true;
+			}
+		}
+
+		if (pkChar < pkEnd && *pkChar != ' ' && *pkChar != '\t' && *pkChar != '\r') return false;
+
+		ivec3 corner(-1);
+		unsigned int relative = 0u;
+
+		for (unsigned int i = 0u; i < 3u; i++) {
+			if (!given[i]) continue;
+			if (indices[i] == 0) return false;
+
+			if (indices[i] > 0) corner[i] = static_cast<int>(indices[i] - 1);
+			else {
+				corner[i] = static_cast<int>(static_cast<long long>(kCounts[i]) + indices[i]); // joined later
+				relative |= 1u << i;
+			}
+		}
+
+		rPolygon.push_back(corner);
+		rRelative.push_back(relative);
+	}
+
+	// a fan: (0, i, i + 1)
+	for (size_t i = 1u; i + 1u < rPolygon.size(); i++) {
+		const size_t kCorners[3u] = { 0u, i, i + 1u };
+
+		for (size_t iCorner : kCorners) {
+			for (unsigned int j = 0u; j < 3u; j++)
+				if ((rRelative[iCorner] & (1u << j)) != 0u) rChunk.relativeCorners.push_back(3u * rChunk.corners.size() + j);
+
+			rChunk.corners.push_back(rPolygon[iCorner]);
+		}
+	}
+
+	return true;
+}
+
+
+
+// as Assimp: 'Kd' 0.6 and 'illum' 1 by default, 'd' or 1 - 'Tr' as the opacity; the first of the texture options,
+// '-clamp', kept
+void ObjImporter::loadMaterialLibrary_(const string& kFilePath, const string& kFileName) {
+	FILE* pFile;
+	fopen_s(&pFile, (kFilePath + "/" + kFileName).c_str(), "rb");
+	if (pFile == NULL) {
+		cout << "OBJ importer: cannot read the '" << kFileName << "' material library." << endl;
+		return;
+	}
+
+	string text;
+	char buffer[4096u];
+	for (size_t nRead; (nRead = std::fread(buffer, 1u, sizeof(buffer), pFile)) > 0u;) text.append(buffer, nRead);
+	std::fclose(pFile);
+
+	MeshCache::MATERIAL* pMaterial = nullptr;
+	const char* pkEnd = text.data() + text.size();
+
+	for (const char* pkChar = text.data(); pkChar < pkEnd;) {
+		const char* pkLineEnd = static_cast<const char*>(std::memchr(pkChar, '\n', pkEnd - pkChar));
+		if (!pkLineEnd) pkLineEnd = pkEnd;
+
+		const char* pkLine = ObjImporter::skipSpaces_(pkChar, pkLineEnd);
+		pkChar = pkLineEnd < pkEnd ? pkLineEnd + 1 : pkEnd;
+		if (pkLine == pkLineEnd || *pkLine == '#') continue;
+
+		const char* pkKeywordEnd = pkLine;
+		while (pkKeywordEnd < pkLineEnd && *pkKeywordEnd != ' ' && *pkKeywordEnd != '\t') pkKeywordEnd++;
+		string keyword(pkLine, pkKeywordEnd);
+
+		if (keyword == "newmtl") {
+			string name = ObjImporter::getRemainder_(pkKeywordEnd, pkLineEnd);
+			if (materialIds_.count(name) > 0u) {
+				pMaterial = &materials_[materialIds_[name]]; // redefined
+				continue;
+			}
+
+			materialIds_[name] = static_cast<unsigned int>(materials_.size());
+			materials_.push_back(MeshCache::MATERIAL());
+			pMaterial = &materials_.back();
+
+			pMaterial->shadingModel = static_cast<GLuint>(Material::ShadingModel::GOURAUD);
+			pMaterial->opacity = 1.0f;
+			pMaterial->diffuseColor = vec3(0.6f);
+			pMaterial->shininessStrength = 1.0f;
+			continue;
+		}
+
+		if (!pMaterial) continue;
+
+		const char* pkNumber = pkKeywordEnd;
+		float value = 0.0f;
+		vec3 color(0.0f);
+		bool isColor = ObjImporter::parseFloat_(pkNumber, pkLineEnd, color.r);
+		if (isColor && !ObjImporter::parseFloat_(pkNumber, pkLineEnd, color.g)) color = vec3(color.r);
+		else if (isColor) ObjImporter::parseFloat_(pkNumber, pkLineEnd, color.b);
+		value = color.r;
+
+		int textureId = -1;
+
+		if (keyword == "Ka" && isColor) pMaterial->ambientColor = color;
+		else if (keyword == "Kd" && isColor) pMaterial->diffuseColor = color;
+		else if (keyword == "Ks" && isColor) pMaterial->specularColor = color;
+		else if (keyword == "Ke" && isColor) pMaterial->emissiveColor = color;
+		else if (keyword == "Ns" && isColor) pMaterial->shininess = value;
+		else if (keyword == "d" && isColor) pMaterial->opacity = value;
+		else if (keyword == "Tr" && isColor) pMaterial->opacity = 1.0f - value;
+		else if (keyword == "illum" && isColor) {
+			int model = static_cast<int>(value);
+			Material::ShadingModel shadingModel = Material::ShadingModel::GOURAUD;
+			if (model == 0) shadingModel = Material::ShadingModel::NO_SHADING;
+			else if (model == 2) shadingModel = Material::ShadingModel::PHONG;
+
+			pMaterial->shadingModel = static_cast<GLuint>(shadingModel);
+		}
+		else if (keyword == "map_Kd") textureId = 0;
+		else if (keyword == "map_Ks") textureId = 1;
+		else if (keyword == "map_Ke" || keyword == "map_emissive") textureId = 2;
+		else if (keyword == "map_Kn" || keyword == "norm") textureId = 3;
+
+		if (textureId < 0) continue;
+
+		// options: '-name [value ...]', then the file name
+		const char* pkOption = ObjImporter::skipSpaces_(pkKeywordEnd, pkLineEnd);
+		bool clampToEdge = false;
+
+		while (pkOption < pkLineEnd && *pkOption == '-') {
+			const char* pkOptionEnd = pkOption;
+			while (pkOptionEnd < pkLineEnd && *pkOptionEnd != ' ' && *pkOptionEnd != '\t') pkOptionEnd++;
+			string option(pkOption, pkOptionEnd);
+			pkOption = ObjImporter::skipSpaces_(pkOptionEnd, pkLineEnd);
+
+			unsigned int nValues = (option == "-o" || option == "-s" || option == "-t") ? 3u :
+				                   (option == "-mm") ? 2u : 1u;
+
+			for (unsigned int i = 0u; i < nValues && pkOption < pkLineEnd; i++) {
+				const char* pkValueEnd = pkOption;
+				while (pkValueEnd < pkLineEnd && *pkValueEnd != ' ' && *pkValueEnd != '\t') pkValueEnd++;
+
+				// '-o', '-s', '-t': 1 to 3 numbers
+				float number;
+				const char* pkValue = pkOption;
+				if (nValues == 3u && i > 0u && !(ObjImporter::parseFloat_(pkValue, pkValueEnd, number) &&
+					                             pkValue == pkValueEnd)) break;
+
+				if (option == "-clamp") clampToEdge = string(pkOption, pkValueEnd) == "on";
+				pkOption = ObjImporter::skipSpaces_(pkValueEnd, pkLineEnd);
+			}
+		}
+
+		string fileName = ObjImporter::getRemainder_(pkOption, pkLineEnd);
+		MeshCache::TEXTURE& rTexture = pMaterial->textures[textureId];
+		if (fileName.empty() || rTexture.fileName[0u] != '\0') continue; // the first one
+
+		// too long: the last character set, see 'import'
+		std::copy(fileName.begin(), fileName.begin() + min(fileName.length(), sizeof(rTexture.fileName)),
+			      rTexture.fileName);
+		rTexture.clampToEdge = clampToEdge ? 1u : 0u;
+	}
+}
+
+
+
+bool ObjImporter::joinChunks_() {
+	unsigned long long nPositions = 0u, nTexCoords = 0u, nNormals = 0u;
+
+	for (CHUNK& rChunk : chunks_) {
+		rChunk.positionBase = static_cast<unsigned int>(nPositions);
+		rChunk.texCoordBase = static_cast<unsigned int>(nTexCoords);
+		rChunk.normalBase = static_cast<unsigned int>(nNormals);
+
+		nPositions += rChunk.positions.size();
+		nTexCoords += rChunk.texCoords.size();
+		nNormals += rChunk.normals.size();
+	}
+
+	if (nPositions > 0x7fffffffull || nTexCoords > 0x7fffffffull || nNormals > 0x7fffffffull) return false;
+
+	positions_.resize(static_cast<size_t>(nPositions));
+	texCoords_.resize(static_cast<size_t>(nTexCoords));
+	normals_.resize(static_cast<size_t>(nNormals));
+
+	runJobs_(chunks_.size(), [this](size_t i) {
+		CHUNK& rChunk = chunks_[i];
+		const int kBases[3u] = { static_cast<int>(rChunk.positionBase), static_cast<int>(rChunk.texCoordBase),
+			                     static_cast<int>(rChunk.normalBase) };
+
+		for (size_t iRelative : rChunk.relativeCorners)
+			rChunk.corners[iRelative / 3u][static_cast<int>(iRelative % 3u)] += kBases[iRelative % 3u];
+
+		std::copy(rChunk.positions.begin(), rChunk.positions.end(), positions_.begin() + rChunk.positionBase);
+		std::copy(rChunk.texCoords.begin(), rChunk.texCoords.end(), texCoords_.begin() + rChunk.texCoordBase);
+		std::copy(rChunk.normals.begin(), rChunk.normals.end(), normals_.begin() + rChunk.normalBase);
+
+		vector<vec3>().swap(rChunk.positions);
+		vector<vec2>().swap(rChunk.texCoords);
+		vector<vec3>().swap(rChunk.normals);
+	});
+
+	// 'usemtl' runs: a mesh per material, in the order of their first faces
+	vector<unsigned int> meshIds; // by material id, ~0 -> none
+	unsigned int materialId = ~0u; // before the first 'usemtl'
+
+	for (unsigned int iChunk = 0u; iChunk < chunks_.size(); iChunk++) {
+		const CHUNK& kChunk = chunks_[iChunk];
+		size_t nTriangles = kChunk.corners.size() / 3u;
+
+		for (size_t iRun = 0u; iRun < kChunk.runs.size(); iRun++) {
+			const RUN& kRun = kChunk.runs[iRun];
+			size_t end = iRun + 1u < kChunk.runs.size() ? kChunk.runs[iRun + 1u].firstTriangle : nTriangles;
+
+			if (!kRun.inherited) {
+				unordered_map<string, unsigned int>::const_iterator kIterator = materialIds_.find(kRun.materialName);
+				materialId = kIterator != materialIds_.end() ? kIterator->second : ~0u;
+			}
+
+			if (end == kRun.firstTriangle) continue;
+
+			unsigned int runMaterialId = materialId != ~0u ? materialId : getDefaultMaterialId_();
+			if (meshIds.size() <= runMaterialId) meshIds.resize(runMaterialId + 1u, ~0u);
+
+			if (meshIds[runMaterialId] == ~0u) {
+				meshIds[runMaterialId] = static_cast<unsigned int>(meshJobs_.size());
+				meshJobs_.emplace_back();
+				meshJobs_.back().id = meshIds[runMaterialId];
+				meshJobs_.back().materialId = runMaterialId;
+				meshJobs_.back().nTriangles = 0u;
+			}
+
+			MESH_JOB& rJob = meshJobs_[meshIds[runMaterialId]];
+			rJob.segments.push_back({ iChunk, kRun.firstTriangle, end });
+			rJob.nTriangles += end - kRun.firstTriangle;
+			nTriangles_ += end - kRun.firstTriangle;
+		}
+	}
+
+	if (meshJobs_.empty()) return false;
+
+	// only the materials of the meshes, in the order of the libraries
+	if ((postProcessSteps_ & aiProcess_RemoveRedundantMaterials) != 0u) {
+		vector<unsigned int> materialRemap(materials_.size(), ~0u);
+		vector<MeshCache::MATERIAL> materials;
+
+		for (unsigned int i = 0u; i < materials_.size(); i++)
+			if (i < meshIds.size() && meshIds[i] != ~0u) {
+				materialRemap[i] = static_cast<unsigned int>(materials.size());
+				materials.push_back(materials_[i]);
+			}
+
+		for (MESH_JOB& rJob : meshJobs_) rJob.materialId = materialRemap[rJob.materialId];
+		materials_.swap(materials);
+	}
+
+	return true;
+}
+
+
+
+// faces before any 'usemtl', or of an unknown material
+unsigned int ObjImporter::getDefaultMaterialId_() {
+	if (defaultMaterialId_ == ~0u) {
+		MeshCache::MATERIAL material = {};
+		material.shadingModel = static_cast<GLuint>(Material::ShadingModel::GOURAUD);
+		material.opacity = 1.0f;
+		material.diffuseColor = vec3(0.6f);
+		material.shininessStrength = 1.0f;
+
+		defaultMaterialId_ = static_cast<unsigned int>(materials_.size());
+		materials_.push_back(material);
+	}
+
+	return defaultMaterialId_;
+}
+
+
+
+// any thread: the job is its own, the joined arrays are read only
+void ObjImporter::buildMesh_(MESH_JOB& rJob) const {
+	bool generateNormals = (postProcessSteps_ & (aiProcess_GenNormals | aiProcess_GenSmoothNormals)) != 0u;
+	bool smoothNormals = (postProcessSteps_ & aiProcess_GenSmoothNormals) != 0u;
+	bool findInvalidData = (postProcessSteps_ & aiProcess_FindInvalidData) != 0u;
+
+	// the corners, validated; texture coordinates and normals only if given for all of them
+	vector<ivec3> corners;
+	corners.reserve(3u * rJob.nTriangles);
+	bool hasTexCoords = true, hasNormals = true, validNormals = true;
+
+	for (const SEGMENT& kSegment : rJob.segments) {
+		const vector<ivec3>& kChunkCorners = chunks_[kSegment.chunkId].corners;
+		corners.insert(corners.end(), kChunkCorners.begin() + 3u * kSegment.first,
+			           kChunkCorners.begin() + 3u * kSegment.end);
+	}
+
+	for (const ivec3& kCorner : corners) {
+		if (kCorner.x < 0 || kCorner.y < -1 || kCorner.z < -1 || static_cast<size_t>(kCorner.x) >= positions_.size() ||
+			(kCorner.y >= 0 && static_cast<size_t>(kCorner.y) >= texCoords_.size()) ||
+			(kCorner.z >= 0 && static_cast<size_t>(kCorner.z) >= normals_.size()))
+			throw runtime_error("invalid vertex index");
+
+		hasTexCoords = hasTexCoords && kCorner.y >= 0;
+		hasNormals = hasNormals && kCorner.z >= 0;
+		if (kCorner.z >= 0 && glm::length(normals_[kCorner.z]) < ObjImporter::kLengthEpsilon_) validNormals = false;
+	}
+
+	// zeroed normals: as Assimp, removed (then generated) if 'aiProcess_FindInvalidData'
+	if (hasNormals && !validNormals) {
+		if (!findInvalidData) throw runtime_error("invalid normal vector");
+		hasNormals = false;
+	}
+
+	// degenerate triangles (two corners at the same position) removed
+	vector<GLuint> cornerPositions;
+	vector<vec3> positions;
+	weldPositions_(corners, cornerPositions, positions);
+
+	size_t nCorners = 0u;
+	for (size_t i = 0u; i < corners.size(); i += 3u) {
+		if (cornerPositions[i] == cornerPositions[i + 1u] || cornerPositions[i] == cornerPositions[i + 2u] ||
+			cornerPositions[i + 1u] == cornerPositions[i + 2u]) continue;
+
+		for (size_t j = 0u; j < 3u; j++) {
+			corners[nCorners + j] = corners[i + j];
+			cornerPositions[nCorners + j] = cornerPositions[i + j];
+		}
+		nCorners += 3u;
+	}
+
+	if (nCorners == 0u) throw runtime_error("mesh without triangles");
+	corners.resize(nCorners);
+	cornerPositions.resize(nCorners);
+
+	vector<vec3> cornerNormals;
+	if (!hasNormals && generateNormals) generateNormals_(cornerPositions, positions, smoothNormals, cornerNormals);
+
+	// welded: the vertices of each position chained (few, but on texture seams and creases)
+	vector<GLuint> heads(positions.size(), ~0u), next;
+	vector<VERTEX_KEY> keys;
+	rJob.faces.resize(nCorners / 3u);
+
+	for (size_t i = 0u; i < nCorners; i++) {
+		VERTEX_KEY key = {};
+		key.position = cornerPositions[i];
+		key.texCoord = hasTexCoords ? corners[i].y : -1;
+		key.normal = hasNormals ? corners[i].z : -1;
+		if (!cornerNormals.empty()) key.generatedNormal = cornerNormals[i];
+
+		GLuint vertex = heads[key.position];
+		while (vertex != ~0u && std::memcmp(&keys[vertex], &key, sizeof(VERTEX_KEY)) != 0) vertex = next[vertex];
+
+		if (vertex == ~0u) {
+			vertex = static_cast<GLuint>(keys.size());
+			keys.push_back(key);
+			next.push_back(heads[key.position]);
+			heads[key.position] = vertex;
+		}
+
+		rJob.faces[i / 3u][static_cast<int>(i % 3u)] = vertex;
+	}
+
+	size_t nVertices = keys.size();
+	rJob.vertices.resize(nVertices);
+	if (hasTexCoords) rJob.texCoords.resize(nVertices);
+	if (hasNormals || !cornerNormals.empty()) rJob.normals.resize(nVertices);
+
+	for (size_t i = 0u; i < nVertices; i++) {
+		rJob.vertices[i] = positions[keys[i].position];
+		if (hasTexCoords) rJob.texCoords[i] = texCoords_[keys[i].texCoord];
+		if (hasNormals) rJob.normals[i] = normals_[keys[i].normal];
+		else if (!cornerNormals.empty()) rJob.normals[i] = keys[i].generatedNormal;
+	}
+
+	if (hasNormals) {
+		vector<vec3> normals(rJob.normals);
+		if (!VertexKernels::normalize(&normals[0u].x, rJob.normals.data(), nVertices, ObjImporter::kEpsilon_,
+			                          ObjImporter::kLengthEpsilon_))
+			throw runtime_error("invalid normal vector");
+
+		if ((postProcessSteps_ & aiProcess_FixInfacingNormals) != 0u) fixInfacingNormals_(rJob);
+	}
+
+	if ((postProcessSteps_ & aiProcess_CalcTangentSpace) != 0u && hasTexCoords && !rJob.normals.empty())
+		generateTangents_(rJob);
+
+	unsigned int nFaces = static_cast<unsigned int>(rJob.faces.size());
+	MeshOptimizer::STATISTICS statistics;
+	MeshOptimizer::optimize(rJob.faces.data(), nFaces, static_cast<unsigned int>(nVertices), rJob.vertices.data(),
+		                    rJob.texCoords.empty() ? nullptr : rJob.texCoords.data(),
+		                    rJob.normals.empty() ? nullptr : rJob.normals.data(),
+		                    rJob.tangents.empty() ? nullptr : rJob.tangents.data(),
+		                    rJob.bitangents.empty() ? nullptr : rJob.bitangents.data(), statistics);
+
+	// bounding volumes, as 'Mesh'
+	MeshCache::MESH& rMesh = rJob.mesh;
+	rMesh = {};
+	rMesh.id = rJob.id;
+	rMesh.materialId = rJob.materialId;
+	rMesh.nFaces = nFaces;
+	rMesh.nVertices = static_cast<GLuint>(nVertices);
+	rMesh.boundingBoxMin = rMesh.boundingBoxMax = rJob.vertices[0u];
+
+	for (const vec3& kVertex : rJob.vertices) {
+		rMesh.boundingBoxMin = glm::min(rMesh.boundingBoxMin, kVertex);
+		rMesh.boundingBoxMax = glm::max(rMesh.boundingBoxMax, kVertex);
+	}
+
+	vec3 center = 0.5f * (rMesh.boundingBoxMin + rMesh.boundingBoxMax);
+	for (const vec3& kVertex : rJob.vertices)
+		rMesh.boundingSphereRadius = max(rMesh.boundingSphereRadius, glm::distance(center, kVertex));
+}
+
+
+
+// the indices of the mesh numbered in the order of their first use (an array over their range, or a hash table if
+// sparse), then the positions with the same bits (-0 as 0) welded by hashing, as the 'JoinIdenticalVertices' and
+// 'GenSmoothNormals' steps of Assimp
+void ObjImporter::weldPositions_(const vector<ivec3>& kCorners, vector<GLuint>& rCornerPositions,
+	                             vector<vec3>& rPositions) const {
+	int first = kCorners.empty() ? 0 : kCorners[0u].x, last = first;
+	for (const ivec3& kCorner : kCorners) {
+		first = min(first, kCorner.x);
+		last = max(last, kCorner.x);
+	}
+
+	size_t range = static_cast<size_t>(last - first) + 1u;
+	bool dense = range <= 2u * kCorners.size();
+	size_t tableSize = 16u;
+	while (!dense && tableSize < 2u * kCorners.size()) tableSize *= 2u;
+
+	vector<GLuint> ids(dense ? range : 0u, ~0u), table(dense ? 0u : tableSize, ~0u);
+	vector<int> indices; // by id
+	rCornerPositions.resize(kCorners.size());
+
+	for (size_t i = 0u; i < kCorners.size(); i++) {
+		int index = kCorners[i].x;
+		GLuint* pId = nullptr;
+
+		if (dense) pId = &ids[static_cast<size_t>(index - first)];
+		else {
+			std::uint32_t word = static_cast<std::uint32_t>(index);
+			size_t slot = static_cast<size_t>(ObjImporter::hash_(&word, 1u)) & (tableSize - 1u);
+			while (table[slot] != ~0u && indices[table[slot]] != index) slot = (slot + 1u) & (tableSize - 1u);
+			pId = &table[slot];
+		}
+
+		if (*pId == ~0u) {
+			*pId = static_cast<GLuint>(indices.size());
+			indices.push_back(index);
+		}
+
+		rCornerPositions[i] = *pId;
+	}
+
+	// by bits
+	tableSize = 16u;
+	while (tableSize < 2u * indices.size()) tableSize *= 2u;
+	table.assign(tableSize, ~0u);
+	vector<GLuint> positionIds(indices.size());
+
+	for (size_t i = 0u; i < indices.size(); i++) {
+		vec3 position = positions_[indices[i]] + vec3(0.0f);
+
+		std::uint32_t words[3u];
+		std::memcpy(words, &position, sizeof(words));
+		size_t slot = static_cast<size_t>(ObjImporter::hash_(words, 3u)) & (tableSize - 1u);
+
+		while (table[slot] != ~0u && std::memcmp(&rPositions[table[slot]], &position, sizeof(vec3)) != 0)
+			slot = (slot + 1u) & (tableSize - 1u);
+
+		if (table[slot] == ~0u) {
+			table[slot] = static_cast<GLuint>(rPositions.size());
+			rPositions.push_back(position);
+		}
+
+		positionIds[i] = table[slot];
+	}
+
+	for (GLuint& rPosition : rCornerPositions) rPosition = positionIds[rPosition];
+}
+
+
+
+// as Assimp: the unit normals of the faces around a position within 'maxSmoothingAngle_' of the face, summed in the
+// same order for each corner (equal sums: welded)
+void ObjImporter::generateNormals_(const vector<GLuint>& kCornerPositions, const vector<vec3>& kPositions, bool smooth,
+	                               vector<vec3>& rCornerNormals) const {
+	size_t nCorners = kCornerPositions.size();
+	vector<vec3> faceNormals(nCorners / 3u);
+
+	for (size_t i = 0u; i < faceNormals.size(); i++) {
+		const vec3& kPosition0 = kPositions[kCornerPositions[3u * i]];
+		vec3 normal = glm::cross(kPositions[kCornerPositions[3u * i + 1u]] - kPosition0,
+			                     kPositions[kCornerPositions[3u * i + 2u]] - kPosition0);
+		float length = glm::length(normal);
+		faceNormals[i] = length > 0.0f ? normal / length : vec3(0.0f);
+	}
+
+	rCornerNormals.resize(nCorners);
+
+	if (!smooth) {
+		for (size_t i = 0u; i < nCorners; i++)
+			rCornerNormals[i] = faceNormals[i / 3u] != vec3(0.0f) ? faceNormals[i / 3u] : vec3(0.0f, 0.0f, 1.0f);
+		return;
+	}
+
+	// the faces around each position
+	vector<GLuint> offsets(kPositions.size() + 1u, 0u);
+	for (GLuint position : kCornerPositions) offsets[position + 1u]++;
+	for (size_t i = 1u; i < offsets.size(); i++) offsets[i] += offsets[i - 1u];
+
+	vector<GLuint> faces(nCorners), cursors(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0u; i < nCorners; i++) faces[cursors[kCornerPositions[i]]++] = static_cast<GLuint>(i / 3u);
+
+	float limit = std::cos(glm::radians(maxSmoothingAngle_));
+
+	for (size_t i = 0u; i < nCorners; i++) {
+		const vec3& kFaceNormal = faceNormals[i / 3u];
+		GLuint position = kCornerPositions[i];
+		vec3 normal(0.0f);
+
+		for (GLuint j = offsets[position]; j < offsets[position + 1u]; j++) {
+			const vec3& kNormal = faceNormals[faces[j]];
+			if (kFaceNormal == vec3(0.0f) || glm::dot(kFaceNormal, kNormal) >= limit) normal += kNormal;
+		}
+
+		float length = glm::length(normal);
+		if (length >= ObjImporter::kLengthEpsilon_) rCornerNormals[i] = normal / length;
+		else rCornerNormals[i] = kFaceNormal != vec3(0.0f) ? kFaceNormal : vec3(0.0f, 0.0f, 1.0f);
+	}
+}
+
+
+
+// per vertex, the tangents and bitangents of its faces (weighted by their area in texture space), orthogonalized to
+// the normal; as 'Model3D', right-handed
+void ObjImporter::generateTangents_(MESH_JOB& rJob) const {
+	size_t nVertices = rJob.vertices.size();
+	rJob.tangents.assign(nVertices, vec3(0.0f));
+	rJob.bitangents.assign(nVertices, vec3(0.0f));
+
+	for (const uvec3& kFace : rJob.faces) {
+		vec3 edge1 = rJob.vertices[kFace.y] - rJob.vertices[kFace.x];
+		vec3 edge2 = rJob.vertices[kFace.z] - rJob.vertices[kFace.x];
+		vec2 delta1 = rJob.texCoords[kFace.y] - rJob.texCoords[kFace.x];
+		vec2 delta2 = rJob.texCoords[kFace.z] - rJob.texCoords[kFace.x];
+
+		float determinant = delta1.x * delta2.y - delta2.x * delta1.y;
+		if (determinant == 0.0f || !std::isfinite(determinant)) continue;
+
+		float sign = determinant < 0.0f ? -1.0f : 1.0f;
+		vec3 tangent = (edge1 * delta2.y - edge2 * delta1.y) * sign;
+		vec3 bitangent = (edge2 * delta1.x - edge1 * delta2.x) * sign;
+
+		for (unsigned int i = 0u; i < 3u; i++) {
+			rJob.tangents[kFace[i]] += tangent;
+			rJob.bitangents[kFace[i]] += bitangent;
+		}
+	}
+
+	for (size_t i = 0u; i < nVertices; i++) {
+		const vec3& kNormal = rJob.normals[i];
+
+		vec3 tangent = rJob.tangents[i] - kNormal * glm::dot(kNormal, rJob.tangents[i]);
+		float length = glm::length(tangent);
+		if (length < ObjImporter::kLengthEpsilon_ * glm::length(rJob.tangents[i]) || length == 0.0f)
+			tangent = glm::cross(kNormal, std::abs(kNormal.x) < 0.9f ? vec3(1.0f, 0.0f, 0.0f) : vec3(0.0f, 1.0f, 0.0f));
+		rJob.tangents[i] = glm::normalize(tangent);
+
+		vec3 bitangent = rJob.bitangents[i] - kNormal * glm::dot(kNormal, rJob.bitangents[i]);
+		length = glm::length(bitangent);
+		if (length < ObjImporter::kLengthEpsilon_ * glm::length(rJob.bitangents[i]) || length == 0.0f)
+			bitangent = glm::cross(kNormal, rJob.tangents[i]);
+		rJob.bitangents[i] = glm::normalize(bitangent);
+	}
+
+	VertexKernels::orientBitangents(rJob.normals.data(), rJob.tangents.data(), rJob.bitangents.data(), nVertices);
+}
+
+
+
+// normals and winding flipped where the box of the vertices moved by their normals is the smaller one (not planar)
+void ObjImporter::fixInfacingNormals_(MESH_JOB& rJob) const {
+	vec3 min0(1e10f), max0(-1e10f), min1(1e10f), max1(-1e10f);
+
+	for (size_t i = 0u; i < rJob.vertices.size(); i++) {
+		min1 = glm::min(min1, rJob.vertices[i]);
+		max1 = glm::max(max1, rJob.vertices[i]);
+		min0 = glm::min(min0, rJob.vertices[i] + rJob.normals[i]);
+		max0 = glm::max(max0, rJob.vertices[i] + rJob.normals[i]);
+	}
+
+	vec3 delta0 = max0 - min0, delta1 = max1 - min1;
+	if ((delta0.x > 0.0f) != (delta1.x > 0.0f) || (delta0.y > 0.0f) != (delta1.y > 0.0f) ||
+		(delta0.z > 0.0f) != (delta1.z > 0.0f)) return;
+
+	if (delta1.x < 0.05f * std::sqrt(delta1.y * delta1.z) || delta1.y < 0.05f * std::sqrt(delta1.z * delta1.x) ||
+		delta1.z < 0.05f * std::sqrt(delta1.y * delta1.x)) return;
+
+	if (std::abs(delta0.x * delta0.y * delta0.z) >= std::abs(delta1.x * delta1.y * delta1.z)) return;
+
+	for (vec3& rNormal : rJob.normals) rNormal = -rNormal;
+	for (uvec3& rFace : rJob.faces) std::swap(rFace.y, rFace.z);
+}
@@ -0,0 +1,203 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef OBJ_IMPORTER_H
+#define OBJ_IMPORTER_H
+
+#include <GL/gl3w.h>
+
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "VertexKernels.h"
+#include "material/Material.h"
+
+#include <assimp/postprocess.h>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using glm::ivec3;
+using glm::mat4;
+using glm::uvec3;
+using glm::vec2;
+using glm::vec3;
+
+using std::atomic;
+using std::cout;
+using std::endl;
+using std::exception;
+using std::FILE;
+using std::function;
+using std::max;
+using std::min;
+using std::runtime_error;
+using std::size_t;
+using std::string;
+using std::thread;
+using std::unordered_map;
+using std::vector;
+
+
+
+// Native importer of Wavefront OBJ models (and their MTL material libraries), for 'Model3D': it fills a mesh cache
+// (see 'MeshCache') as an import with Assimp would, without the generic Assimp scene. The mapped file is parsed in
+// chunks of whole lines by a thread per core, the numbers without the C library (up to 8 digits at a time, SWAR); the
+// chunks are then joined (relative indices, 'usemtl' runs) into a mesh per material, in the order of their first
+// faces. Each mesh is then built by a thread of its own: polygons fanned into triangles, vertices welded by hashing
+// (same position, texture coordinates and normal), smooth normals and tangents generated, then reordered (see
+// 'MeshOptimizer'). Only the post processing steps 'kSupportedSteps_' are supported, the other imports are left to
+// Assimp ('isSupported'), as are the files it cannot parse ('import' -> false).
+class ObjImporter {
+public:
+	static bool isSupported(const string& kFileName, unsigned int postProcessSteps); // '.obj', 'kSupportedSteps_'
+
+
+	ObjImporter(unsigned int nThreads, float maxSmoothingAngle); // 0 -> a thread per core; degrees
+	~ObjImporter(); // unmapped
+
+
+	// 'rCache' filled (materials, meshes, identity transformations); false -> not imported, 'rCache' untouched
+	bool import(const string& kFilePath, const string& kFileName, unsigned int postProcessSteps, MeshCache& rCache);
+
+	void displayInfo() const; // sizes and times of the last import
+
+private:
+	static const unsigned int kSupportedSteps_;
+	static const size_t kMinChunkSize_;
+	static const unsigned int kChunksPerThread_;
+	static const float kEpsilon_;
+	static const float kLengthEpsilon_;
+	static const std::uint64_t kDigitPowersOf10_[9u];
+	static const double kPowersOf10_[23u];
+
+	// numbers of a line: 'rpkChar' moved past the number; false -> none
+	static bool parseFloat_(const char*& rpkChar, const char* pkEnd, float& rValue);
+	static bool parseIndex_(const char*& rpkChar, const char* pkEnd, long long& rValue);
+	// 19 significant digits at most, the others dropped; returns the number of digits read
+	static unsigned int parseDigits_(const char*& rpkChar, const char* pkEnd, std::uint64_t& rMantissa,
+		                             unsigned int& rnSignificant, unsigned int& rnDropped);
+	static unsigned int getNumDigits_(std::uint64_t chars); // 8 characters, the first one in the low byte
+	static std::uint32_t parseEightDigits_(std::uint64_t chars);
+
+	static const char* skipSpaces_(const char* pkChar, const char* pkEnd);
+	static string getRemainder_(const char* pkChar, const char* pkEnd); // the rest of the line, trimmed
+	static bool isKeyword_(const char* pkChar, const char* pkEnd, const char* pkKeyword); // followed by a space
+
+	static std::uint64_t hash_(const std::uint32_t* pkWords, unsigned int nWords);
+
+	ObjImporter(const ObjImporter&);
+	const ObjImporter& operator=(const ObjImporter&) {}
+
+	// the triangles of a chunk from 'firstTriangle' on, up to the next run
+	struct RUN {
+		size_t firstTriangle;
+		bool inherited; // the material of the previous chunk
+		string materialName;
+	};
+
+	// a range of whole lines, parsed on its own
+	struct CHUNK {
+		const char* pkBegin, * pkEnd;
+		vector<vec3> positions;
+		vector<vec2> texCoords;
+		vector<vec3> normals;
+		vector<ivec3> corners; // 3 per triangle: position, texture coordinates, normal (0-based, -1 -> none)
+		vector<size_t> relativeCorners; // 3 * corner + component: relative to the first vertex of the chunk
+		vector<RUN> runs; // 'usemtl', the first one inherited
+		vector<string> materialLibraries; // 'mtllib'
+		unsigned int positionBase, texCoordBase, normalBase; // joined: first vertex of the chunk
+		string error;
+	};
+
+	// the triangles [first, end) of a chunk
+	struct SEGMENT {
+		unsigned int chunkId;
+		size_t first, end;
+	};
+
+	struct MESH_JOB {
+		unsigned int id, materialId;
+		vector<SEGMENT> segments;
+		size_t nTriangles;
+		string error;
+
+		MeshCache::MESH mesh;
+		vector<uvec3> faces;
+		vector<vec3> vertices, normals, tangents, bitangents;
+		vector<vec2> texCoords;
+	};
+
+	// welded vertex: the indices of its attributes, or its generated normal
+	struct VERTEX_KEY {
+		GLuint position; // welded position
+		GLint texCoord, normal;
+		vec3 generatedNormal;
+	};
+
+	bool map_(const string& kFilePath);
+	void unmap_();
+
+	void runJobs_(size_t nJobs, const function<void(size_t)>& kJob) const; // by a pool of 'nThreads_' threads
+
+	void parseChunk_(CHUNK& rChunk) const;
+	bool parseFace_(CHUNK& rChunk, const char* pkChar, const char* pkEnd, vector<ivec3>& rPolygon,
+		            vector<unsigned int>& rRelative) const; // polygon: fanned into triangles
+	void loadMaterialLibrary_(const string& kFilePath, const string& kFileName); // missing -> default material
+	bool joinChunks_(); // relative indices, then the meshes by material
+	unsigned int getDefaultMaterialId_();
+
+	void buildMesh_(MESH_JOB& rJob) const;
+	void weldPositions_(const vector<ivec3>& kCorners, vector<GLuint>& rCornerPositions, vector<vec3>& rPositions) const;
+	void generateNormals_(const vector<GLuint>& kCornerPositions, const vector<vec3>& kPositions, bool smooth,
+		                  vector<vec3>& rCornerNormals) const;
+	void generateTangents_(MESH_JOB& rJob) const;
+	void fixInfacingNormals_(MESH_JOB& rJob) const; // as Assimp: the bounding box of the vertices moved by their normals
+
+	unsigned int nThreads_;
+	float maxSmoothingAngle_;
+	unsigned int postProcessSteps_;
+
+	const char* pkMapping_;
+	size_t mappingSize_; // kept once unmapped, see 'displayInfo'
+	void* pFile_;
+	void* pFileMapping_;
+
+	vector<CHUNK> chunks_;
+	vector<vec3> positions_; // joined
+	vector<vec2> texCoords_;
+	vector<vec3> normals_;
+
+	vector<MeshCache::MATERIAL> materials_; // loaded libraries, then the default material if used
+	unordered_map<string, unsigned int> materialIds_;
+	unsigned int defaultMaterialId_; // ~0 -> none
+	vector<MESH_JOB> meshJobs_;
+
+	size_t nTriangles_;
+	double parseTime_, buildTime_; // ms
+};
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "VertexKernels.h"
+
+
+
+bool VertexKernels::normalize(const float* pkVectors, vec3* pUnitVectors, size_t nVectors, float epsilon,
+	                          float minLength) {
+	float* pOut = &pUnitVectors[0u].x;
+	size_t i = 0u;
+
+#if defined(VERTEX_KERNELS_AVX)
+	const __m256 kOne = _mm256_set1_ps(1.0f);
+	const __m256 kEpsilon = _mm256_set1_ps(epsilon);
+	const __m256 kMinLength = _mm256_set1_ps(minLength);
+	const __m256 kAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+	for (; i + 8u <= nVectors; i += 8u) {
+		__m128 x0, y0, z0, x1, y1, z1;
+		VertexKernels::load_(pkVectors + i * 3u, x0, y0, z0);
+		VertexKernels::load_(pkVectors + i * 3u + 12u, x1, y1, z1);
+
+		__m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+		__m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+		__m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+
+		__m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+			                                         _mm256_mul_ps(z, z)));
+		if (_mm256_movemask_ps(_mm256_cmp_ps(length, kMinLength, _CMP_LT_OQ)) != 0) return false;
+
+		__m256 rescale = _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(kOne, length), kAbsMask), kEpsilon, _CMP_GT_OQ);
+		__m256 scale = _mm256_blendv_ps(kOne, _mm256_div_ps(kOne, length), rescale);
+		x = _mm256_mul_ps(x, scale);
+		y = _mm256_mul_ps(y, scale);
+		z = _mm256_mul_ps(z, scale);
+
+		VertexKernels::store_(pOut + i * 3u, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+			                  _mm256_castps256_ps128(z));
+		VertexKernels::store_(pOut + i * 3u + 12u, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+			                  _mm256_extractf128_ps(z, 1));
+	}
+#endif
+
+#if defined(VERTEX_KERNELS_SSE2)
+	for (; i + 4u <= nVectors; i += 4u) {
+		__m128 x, y, z;
+		VertexKernels::load_(pkVectors + i * 3u, x, y, z);
+		if (!VertexKernels::normalize_(x, y, z, epsilon, minLength)) return false;
+		VertexKernels::store_(pOut + i * 3u, x, y, z);
+	}
+#elif defined(VERTEX_KERNELS_NEON)
+	const float32x4_t kOne = vdupq_n_f32(1.0f);
+	const float32x4_t kEpsilon = vdupq_n_f32(epsilon);
+	const float32x4_t kMinLength = vdupq_n_f32(minLength);
+
+	for (; i + 4u <= nVectors; i += 4u) {
+		float32x4x3_t vectors = vld3q_f32(pkVectors + i * 3u); // transposed on load
+		float32x4_t length = vsqrtq_f32(vaddq_f32(vaddq_f32(vmulq_f32(vectors.val[0u], vectors.val[0u]),
+			                                                vmulq_f32(vectors.val[1u], vectors.val[1u])),
+			                                      vmulq_f32(vectors.val[2u], vectors.val[2u])));
+		if (vmaxvq_u32(vcltq_f32(length, kMinLength)) != 0u) return false;
+
+		uint32x4_t rescale = vcgtq_f32(vabsq_f32(vsubq_f32(kOne, length)), kEpsilon);
+		float32x4_t scale = vbslq_f32(rescale, vdivq_f32(kOne, length), kOne);
+		for (unsigned int j = 0u; j < 3u; j++) vectors.val[j] = vmulq_f32(vectors.val[j], scale);
+
+		vst3q_f32(pOut + i * 3u, vectors);
+	}
+#endif
+
+	for (; i < nVectors; i++)
+		if (!VertexKernels::normalize_(pkVectors + i * 3u, pUnitVectors[i], epsilon, minLength)) return false;
+
+	return true;
+}
+
+
+
+void VertexKernels::orientBitangents(const vec3* pkNormals, const vec3* pkTangents, vec3* pBitangents, size_t nVectors) {
+	size_t i = 0u;
+
+#if defined(VERTEX_KERNELS_SSE2)
+	const __m128 kZero = _mm_setzero_ps();
+	const __m128 kSignMask = _mm_set1_ps(-0.0f);
+
+	for (; i + 4u <= nVectors; i += 4u) {
+		__m128 nx, ny, nz, tx, ty, tz, bx, by, bz;
+		VertexKernels::load_(&pkNormals[i].x, nx, ny, nz);
+		VertexKernels::load_(&pkTangents[i].x, tx, ty, tz);
+		VertexKernels::load_(&pBitangents[i].x, bx, by, bz);
+
+		__m128 cx = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty));
+		__m128 cy = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz));
+		__m128 cz = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx));
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, bx), _mm_mul_ps(cy, by)), _mm_mul_ps(cz, bz));
+
+		__m128 flip = _mm_and_ps(_mm_cmplt_ps(dot, kZero), kSignMask);
+		if (_mm_movemask_ps(flip) == 0) continue;
+
+		VertexKernels::store_(&pBitangents[i].x, _mm_xor_ps(bx, flip), _mm_xor_ps(by, flip), _mm_xor_ps(bz, flip));
+	}
+#elif defined(VERTEX_KERNELS_NEON)
+	const float32x4_t kZero = vdupq_n_f32(0.0f);
+
+	for (; i + 4u <= nVectors; i += 4u) {
+		float32x4x3_t n = vld3q_f32(&pkNormals[i].x);
+		float32x4x3_t t = vld3q_f32(&pkTangents[i].x);
+		float32x4x3_t b = vld3q_f32(&pBitangents[i].x);
+
+		float32x4_t cx = vsubq_f32(vmulq_f32(n.val[1u], t.val[2u]), vmulq_f32(n.val[2u], t.val[1u]));
+		float32x4_t cy = vsubq_f32(vmulq_f32(n.val[2u], t.val[0u]), vmulq_f32(n.val[0u], t.val[2u]));
+		float32x4_t cz = vsubq_f32(vmulq_f32(n.val[0u], t.val[1u]), vmulq_f32(n.val[1u], t.val[0u]));
+		float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(cx, b.val[0u]), vmulq_f32(cy, b.val[1u])),
+			                        vmulq_f32(cz, b.val[2u]));
+
+		uint32x4_t flip = vcltq_f32(dot, kZero);
+		if (vmaxvq_u32(flip) == 0u) continue;
+
+		for (unsigned int j = 0u; j < 3u; j++) b.val[j] = vbslq_f32(flip, vnegq_f32(b.val[j]), b.val[j]);
+		vst3q_f32(&pBitangents[i].x, b);
+	}
+#endif
+
+	for (; i < nVectors; i++)
+		if (glm::dot(glm::cross(pkNormals[i], pkTangents[i]), pBitangents[i]) < 0.0f)
+			pBitangents[i] = -pBitangents[i];
+}
+
+
+
+bool VertexKernels::normalize_(const float* pkVector, vec3& rUnitVector, float epsilon, float minLength) {
+	vec3 vector = vec3(pkVector[0u], pkVector[1u], pkVector[2u]);
+	float length = glm::length(vector);
+
+	if (length < minLength) return false;
+
+	rUnitVector = std::abs(1.0f - length) > epsilon ? vector / length : vector;
+	return true;
+}
+
+
+
+#ifdef VERTEX_KERNELS_SSE2
+// in: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+void VertexKernels::load_(const float* pkVectors, __m128& rX, __m128& rY, __m128& rZ) {
+	__m128 a = _mm_loadu_ps(pkVectors);
+	__m128 b = _mm_loadu_ps(pkVectors + 4u);
+	__m128 c = _mm_loadu_ps(pkVectors + 8u);
+
+	rX = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	rY = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+		                _MM_SHUFFLE(2, 0, 2, 0));
+	rZ = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+}
+
+
+
+void VertexKernels::store_(float* pVectors, __m128 x, __m128 y, __m128 z) {
+	__m128 xyLow = _mm_unpacklo_ps(x, y), xyHigh = _mm_unpackhi_ps(x, y);
+
+	_mm_storeu_ps(pVectors, _mm_shuffle_ps(xyLow, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+	_mm_storeu_ps(pVectors + 4u, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xyHigh,
+		                                        _MM_SHUFFLE(1, 0, 2, 0)));
+	_mm_storeu_ps(pVectors + 8u, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+		                                        _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+
+
+bool VertexKernels::normalize_(__m128& rX, __m128& rY, __m128& rZ, float epsilon, float minLength) {
+	const __m128 kOne = _mm_set1_ps(1.0f);
+	const __m128 kAbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+	__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rX, rX), _mm_mul_ps(rY, rY)), _mm_mul_ps(rZ, rZ)));
+	if (_mm_movemask_ps(_mm_cmplt_ps(length, _mm_set1_ps(minLength))) != 0) return false;
+
+	// SSE2 select: (mask & a) | (~mask & b)
+	__m128 rescale = _mm_cmpgt_ps(_mm_and_ps(_mm_sub_ps(kOne, length), kAbsMask), _mm_set1_ps(epsilon));
+	__m128 scale = _mm_or_ps(_mm_and_ps(rescale, _mm_div_ps(kOne, length)), _mm_andnot_ps(rescale, kOne));
+
+	rX = _mm_mul_ps(rX, scale);
+	rY = _mm_mul_ps(rY, scale);
+	rZ = _mm_mul_ps(rZ, scale);
+	return true;
+}
+#endif
@@ -0,0 +1,57 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef VERTEX_KERNELS_H
+#define VERTEX_KERNELS_H
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define VERTEX_KERNELS_SSE2
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define VERTEX_KERNELS_AVX
+#include <immintrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define VERTEX_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+using glm::vec3;
+
+using std::size_t;
+
+
+
+// Per-vertex math of the mesh conversion (see 'Model3D'), on arrays of xyz triples. The triples are transposed to
+// x / y / z registers and processed 4 at a time (SSE2, NEON on AArch64), 8 at a time with AVX for 'normalize',
+// otherwise (and for the last ones) one at a time.
+class VertexKernels {
+public:
+	// vectors within 'epsilon' of unit length are kept as they are; false -> a vector shorter than 'minLength'
+	static bool normalize(const float* pkVectors, vec3* pUnitVectors, size_t nVectors, float epsilon, float minLength);
+	// flipped where (normal x tangent) . bitangent < 0: right-handed tangent frames
+	static void orientBitangents(const vec3* pkNormals, const vec3* pkTangents, vec3* pBitangents, size_t nVectors);
+
+private:
+	VertexKernels();
+	VertexKernels(const VertexKernels&);
+	const VertexKernels& operator=(const VertexKernels&) {}
+
+	static bool normalize_(const float* pkVector, vec3& rUnitVector, float epsilon, float minLength);
+
+#ifdef VERTEX_KERNELS_SSE2
+	static void load_(const float* pkVectors, __m128& rX, __m128& rY, __m128& rZ); // 4 triples
+	static void store_(float* pVectors, __m128 x, __m128 y, __m128 z);
+	static bool normalize_(__m128& rX, __m128& rY, __m128& rZ, float epsilon, float minLength);
+#endif
+};
+
+#endif
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Program.h"
@@ -11,21 +11,17 @@ GLuint Program::installedProgramId_ = 0u;
 
 
 
-Program::Program(): id_(0u), maxDrawBuffers_(0), maxVertexAttribs_(0),
-                    vsIds_(), gsIds_(), fsIds_(), toStr_(), linked_(false) {
+Program::Program(): id_(0u), vsIds_(), tcsIds_(), tesIds_(), gsIds_(), fsIds_(), toStr_(), linked_(false), linking_(false) {
 	id_ = glCreateProgram();
 	if (id_ == 0u) throw runtime_error("Program|Create program failed.");
 
-	glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers_);
-	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttribs_);
-
 	//cout << "Program " << id_ << " created." << endl;
 }
 
 
 
 Program::~Program() {
-	glDeleteProgram(id_);
+	GlState::deleteProgram(id_);
 
 	//cout << "Program " << id_ << " deleted." << endl;
 }
@@ -33,7 +29,7 @@ Program::~Program() {
 
 
 void Program::setAttribLocation(const GLchar* pkName, GLuint location) const {
-	if (location < static_cast<GLuint>(maxVertexAttribs_))
+	if (location < static_cast<GLuint>(GlState::getMaxVertexAttribs()))
 		glBindAttribLocation(id_, location, pkName);
 	else throw runtime_error("Program.setAttribLocation|Attribute location exceeds maximum number allowed.");
 }
@@ -41,7 +37,7 @@ void Program::setAttribLocation(const GLchar* pkName, GLuint location) const {
 
 
 void Program::setOutputLocation(const GLchar* pkName, GLuint location) const {
-	if (location < static_cast<GLuint>(maxDrawBuffers_))
+	if (location < static_cast<GLuint>(GlState::getMaxDrawBuffers()))
 		glBindFragDataLocation(id_, location, pkName);
 	else throw runtime_error("Program.setOutputLocation|Output location exceeds maximum number allowed.");
 }
@@ -56,10 +52,20 @@ void Program::link(list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShade
 
 
 void Program::link(list<GLuint>& rVertexShaderList, list<GLuint>& rGeometryShaderList, list<GLuint>& rFragmentShaderList) {
+	list<GLuint> tessControlShaderList, tessEvaluationShaderList;
+	link(rVertexShaderList, tessControlShaderList, tessEvaluationShaderList, rGeometryShaderList, rFragmentShaderList);
+}
+
+
+
+void Program::link(list<GLuint>& rVertexShaderList, list<GLuint>& rTessControlShaderList,
+	               list<GLuint>& rTessEvaluationShaderList, list<GLuint>& rGeometryShaderList, list<GLuint>& rFragmentShaderList) {
 	if (rVertexShaderList.empty())
 		throw runtime_error("Program.link|No vertex shader provided.");
 	if (rFragmentShaderList.empty())
 		throw runtime_error("Program.link|No fragment shader provided.");
+	if (!rTessControlShaderList.empty() && rTessEvaluationShaderList.empty())
+		throw runtime_error("Program.link|No tessellation evaluation shader provided.");
 	rVertexShaderList.sort(); rVertexShaderList.unique();
 	rFragmentShaderList.sort(); rFragmentShaderList.unique();
 
@@ -68,38 +74,91 @@ void Program::link(list<GLuint>& rVertexShaderList, list<GLuint>& rGeometryShade
 	if (*rFragmentShaderList.begin() == 0u)
 		throw runtime_error("Program.link|Invalid fragment shader id value.");
 
-	if (rGeometryShaderList.empty()) {
-		if (linked_ && rVertexShaderList == vsIds_ && rFragmentShaderList == fsIds_)
-			throw runtime_error("Program.link|Program " + to_string(id_) + " already linked.");
+	if (!rTessControlShaderList.empty()) {
+		rTessControlShaderList.sort(); rTessControlShaderList.unique();
+		if (*rTessControlShaderList.begin() == 0u)
+			throw runtime_error("Program.link|Invalid tessellation control shader id value.");
+	}
+	if (!rTessEvaluationShaderList.empty()) {
+		rTessEvaluationShaderList.sort(); rTessEvaluationShaderList.unique();
+		if (*rTessEvaluationShaderList.begin() == 0u)
+			throw runtime_error("Program.link|Invalid tessellation evaluation shader id value.");
 	}
-	else {
+	if (!rGeometryShaderList.empty()) {
 		rGeometryShaderList.sort(); rGeometryShaderList.unique();
 		if (*rGeometryShaderList.begin() == 0u)
 			throw runtime_error("Program.link|Invalid geometry shader id value.");
-		if (linked_ && rVertexShaderList == vsIds_ && rGeometryShaderList == gsIds_ && rFragmentShaderList == fsIds_)
-			throw runtime_error("Program.link|Program " + to_string(id_) + " already linked.");
 	}
+
+	if (linking_)
+		throw runtime_error("Program.link|Program " + to_string(id_) + " already being linked.");
+	if (linked_ && rVertexShaderList == vsIds_ && rTessControlShaderList == tcsIds_ &&
+		rTessEvaluationShaderList == tesIds_ && rGeometryShaderList == gsIds_ && rFragmentShaderList == fsIds_)
+		throw runtime_error("Program.link|Program " + to_string(id_) + " already linked.");
 		
 	for (GLuint iShader: rVertexShaderList)
 		glAttachShader(id_, iShader);
+	for (GLuint iShader : rTessControlShaderList)
+		glAttachShader(id_, iShader);
+	for (GLuint iShader : rTessEvaluationShaderList)
+		glAttachShader(id_, iShader);
 	for (GLuint iShader : rGeometryShaderList)
 		glAttachShader(id_, iShader);
 	for (GLuint iShader : rFragmentShaderList)
 		glAttachShader(id_, iShader);
-	 
+
+	glProgramParameteri(id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(id_);
 
 	for (GLuint iShader : rVertexShaderList)
 		glDetachShader(id_, iShader);
+	for (GLuint iShader : rTessControlShaderList)
+		glDetachShader(id_, iShader);
+	for (GLuint iShader : rTessEvaluationShaderList)
+		glDetachShader(id_, iShader);
 	for (GLuint iShader : rGeometryShaderList)
 		glDetachShader(id_, iShader);
 	for (GLuint iShader : rFragmentShaderList)
 		glDetachShader(id_, iShader);
 
+	linking_ = true;
+	vsIds_ = rVertexShaderList;
+	tcsIds_ = rTessControlShaderList;
+	tesIds_ = rTessEvaluationShaderList;
+	gsIds_ = rGeometryShaderList;
+	fsIds_ = rFragmentShaderList;
+}
+
+
+
+void Program::finishLinking() {
+	if (!linking_) throw runtime_error("Program.finishLinking|Program " + to_string(id_) + " not being linked.");
+	linking_ = false;
+
+	// waits for the driver if the linking is not complete yet
 	GLint linkedStatus;
 	glGetProgramiv(id_, GL_LINK_STATUS, &linkedStatus);
 	if (linkedStatus == GL_FALSE) {
-		string errorMessage = "Program.link|Program linking failed. ";
+		string errorMessage = "Program.finishLinking|Program linking failed. ";
+
+		// the compile status of the shaders is only checked here, see 'Shader.compile'
+		for (const list<GLuint>* ipkShaderList : { &vsIds_, &tcsIds_, &tesIds_, &gsIds_, &fsIds_ })
+			for (GLuint iShader : *ipkShaderList) {
+				GLint compiledStatus;
+				glGetShaderiv(iShader, GL_COMPILE_STATUS, &compiledStatus);
+				if (compiledStatus == GL_FALSE) {
+					errorMessage += "Shader " + to_string(iShader) + " compilation failed. ";
+					GLint len;
+					glGetShaderiv(iShader, GL_INFO_LOG_LENGTH, &len);
+					if (len > 0) {
+						GLchar* pLog = new GLchar[static_cast<size_t>(len)];
+						glGetShaderInfoLog(iShader, len, &len, pLog);
+						errorMessage += pLog;
+						delete[] pLog;
+					}
+				}
+			}
+
 		GLint len;
 		glGetProgramiv(id_, GL_INFO_LOG_LENGTH, &len);
 		if (len > 0) {
@@ -112,9 +171,6 @@ void Program::link(list<GLuint>& rVertexShaderList, list<GLuint>& rGeometryShade
 	}
 
 	linked_ = true;
-	vsIds_ = rVertexShaderList;
-	gsIds_ = rGeometryShaderList;
-	fsIds_ = rFragmentShaderList;
 
 	toStr_ = toString_();
 	cout << "Program " << toStr_ << " succesfully linked." << endl;
@@ -122,9 +178,30 @@ void Program::link(list<GLuint>& rVertexShaderList, list<GLuint>& rGeometryShade
 
 
 
+bool Program::link(const string& kBinaryKey) {
+	if (linked_ || linking_) throw runtime_error("Program.link|Program " + to_string(id_) + " already linked.");
+
+	if (!ProgramCache::load(id_, kBinaryKey)) return false;
+
+	linked_ = true;
+	toStr_ = to_string(id_) + " (binary " + kBinaryKey + ")";
+	cout << "Program " << toStr_ << " loaded from the program cache." << endl;
+
+	return true;
+}
+
+
+
+void Program::saveBinary(const string& kBinaryKey) const {
+	if (linked_) ProgramCache::save(id_, kBinaryKey);
+	else throw runtime_error("Program.saveBinary|Program " + to_string(id_) + " not linked.");
+}
+
+
+
 void Program::start() const {
 	if (linked_) {
-		glUseProgram(id_);
+		GlState::useProgram(id_);
 		Program::installedProgramId_ = id_;
 	}
 	else throw runtime_error("Program.start|Program " + to_string(id_) + " not linked.");
@@ -133,7 +210,7 @@ void Program::start() const {
 
 
 void Program::stop() const {
-	glUseProgram(0u);
+	// the program stays bound until another one is started, so restarting it is skipped (see GlState)
 	Program::installedProgramId_ = 0u;
 }
 
@@ -141,8 +218,10 @@ void Program::stop() const {
 
 void Program::setUniformi(GLint location, GLint value) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform1i(location, value);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformi|Program " + to_string(id_) + " not installed.");	
 	else throw runtime_error("Program.setUniformi|Program " + to_string(id_) + " not linked.");
 }
@@ -151,8 +230,10 @@ void Program::setUniformi(GLint location, GLint value) const {
 
 void Program::setUniformui(GLint location, GLuint value) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform1ui(location, value);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformui|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformui|Program " + to_string(id_) + " not linked.");	
 }
@@ -161,8 +242,10 @@ void Program::setUniformui(GLint location, GLuint value) const {
 
 void Program::setUniformf(GLint location, GLfloat value) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform1f(location, value);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformf|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformf|Program " + to_string(id_) + " not linked.");	
 }
@@ -171,8 +254,10 @@ void Program::setUniformf(GLint location, GLfloat value) const {
 
 void Program::setUniformVector2i(GLint location, const GLint* pkVector) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform2iv(location, 1, pkVector);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformVector2i|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformVector2i|Program " + to_string(id_) + " not linked.");	
 }
@@ -181,8 +266,10 @@ void Program::setUniformVector2i(GLint location, const GLint* pkVector) const {
 
 void Program::setUniformVector2ui(GLint location, const GLuint* pkVector) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform2uiv(location, 1, pkVector);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformVector2ui|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformVector2ui|Program " + to_string(id_) + " not linked.");	
 }
@@ -191,8 +278,10 @@ void Program::setUniformVector2ui(GLint location, const GLuint* pkVector) const
 
 void Program::setUniformVector2f(GLint location, const GLfloat* pkVector) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform2fv(location, 1, pkVector);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformVector2f|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformVector2f|Program " + to_string(id_) + " not linked.");	
 }
@@ -201,8 +290,10 @@ void Program::setUniformVector2f(GLint location, const GLfloat* pkVector) const
 
 void Program::setUniformVector3f(GLint location, const GLfloat* pkVector) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform3fv(location, 1, pkVector);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformVector3f|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformVector3f|Program " + to_string(id_) + " not linked.");	
 }
@@ -211,8 +302,10 @@ void Program::setUniformVector3f(GLint location, const GLfloat* pkVector) const
 
 void Program::setUniformVector4f(GLint location, const GLfloat* pkVector) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniform4fv(location, 1, pkVector);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformVector4f|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformVector4f|Program " + to_string(id_) + " not linked.");	
 }
@@ -221,8 +314,10 @@ void Program::setUniformVector4f(GLint location, const GLfloat* pkVector) const
 
 void Program::setUniformMatrix4f(GLint location, const GLfloat* pkMatrix) const {
 	if (linked_)
-		if (isInstalled())
+		if (isInstalled()) {
 			glUniformMatrix4fv(location, 1, GL_FALSE, pkMatrix);
+			GlDebug::countCalls(1u);
+		}
 		else throw runtime_error("Program.setUniformMatrix4f|Program " + to_string(id_) + " not installed.");
 	else throw runtime_error("Program.setUniformMatrix4f|Program " + to_string(id_) + " not linked.");	
 }
@@ -259,6 +354,23 @@ bool Program::isLinked() const {
 
 
 
+bool Program::isLinking() const {
+	return linking_;
+}
+
+
+
+bool Program::isLinkCompleted() const {
+	if (!linking_) return true;
+	if (!GlState::hasParallelShaderCompile()) return true; // unknown, 'finishLinking' may wait
+
+	GLint completionStatus;
+	glGetProgramiv(id_, GL_COMPLETION_STATUS_ARB, &completionStatus);
+	return completionStatus == GL_TRUE;
+}
+
+
+
 bool Program::isInstalled() const {
 	return Program::installedProgramId_ == id_;
 }
@@ -285,6 +397,20 @@ string Program::toString_() const {
 		result += to_string(iShader) + " ";
 	result.erase(result.end() - 1u);
 
+	if (!tcsIds_.empty()) {
+		result += ", tcs: ";
+		for (GLuint iShader : tcsIds_)
+			result += to_string(iShader) + " ";
+		result.erase(result.end() - 1u);
+	}
+
+	if (!tesIds_.empty()) {
+		result += ", tes: ";
+		for (GLuint iShader : tesIds_)
+			result += to_string(iShader) + " ";
+		result.erase(result.end() - 1u);
+	}
+
 	if (!gsIds_.empty()) {
 		result += ", gs: ";
 		for (GLuint iShader : gsIds_)
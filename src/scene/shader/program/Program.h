@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 13, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef PROGRAM_H
@@ -8,6 +8,10 @@
 
 #include <GL/gl3w.h>
 
+#include "info/GlDebug.h"
+#include "shader/program/ProgramCache.h"
+#include "state/GlState.h"
+
 #include <iostream>
 #include <list>
 #include <stdexcept>
@@ -29,13 +33,20 @@ public:
 
 
 	// init: 1) setAttribLocation, [setOutputLocation]
-	//       2) link
+	//       2) link (from the shaders: starts the linking, 'finishLinking' checks it) or link (from the program cache)
+	//       3) [saveBinary]
 	//############################################################################
 	void setAttribLocation(const GLchar* pkName, GLuint location) const;
 	void setOutputLocation(const GLchar* pkName, GLuint location) const;
 
 	void link(list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList);
 	void link(list<GLuint>& rVertexShaderList, list<GLuint>& rGeometryShaderList, list<GLuint>& rFragmentShaderList);
+	void link(list<GLuint>& rVertexShaderList, list<GLuint>& rTessControlShaderList,
+		      list<GLuint>& rTessEvaluationShaderList, list<GLuint>& rGeometryShaderList, list<GLuint>& rFragmentShaderList);
+	void finishLinking(); // waits for the linking started by 'link' (shaders) if needed
+	bool link(const string& kBinaryKey); // from the program cache; false -> not cached, link the shaders instead
+
+	void saveBinary(const string& kBinaryKey) const; // to the program cache
 
 
 	// render: 1) start
@@ -65,6 +76,8 @@ public:
 	GLint getUniformLocation(const GLchar* pkName) const;
 
 	bool isLinked() const;
+	bool isLinking() const; // 'link' (shaders) called, 'finishLinking' not yet
+	bool isLinkCompleted() const; // polls GL_COMPLETION_STATUS_KHR, see 'GlState.hasParallelShaderCompile'
 	bool isInstalled() const;
 
 	GLuint getId() const;
@@ -79,10 +92,9 @@ private:
 	string toString_() const;
 
 	GLuint id_;	
-	GLint maxDrawBuffers_, maxVertexAttribs_;
-	list<GLuint> vsIds_, gsIds_, fsIds_;
+	list<GLuint> vsIds_, tcsIds_, tesIds_, gsIds_, fsIds_;
 	string toStr_;
-	bool linked_;
+	bool linked_, linking_;
 };
 
 #endif
@@ -0,0 +1,183 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "ProgramCache.h"
+
+
+
+const char ProgramCache::kMagic_[4u] = { 'B', 'M', 'P', 'B' };
+
+string ProgramCache::directory_ = "";
+bool ProgramCache::hasDirectory_ = false;
+unsigned int ProgramCache::nLoaded_ = 0u, ProgramCache::nStored_ = 0u;
+
+
+
+// 64-bit FNV-1a of the GL strings and the source code, as 16 hexadecimal digits
+string ProgramCache::computeKey(const string& kSourceCode) {
+	const unsigned long long kPrime = 1099511628211ull;
+	unsigned long long hash = 14695981039346656037ull;
+
+	string text = "";
+	for (GLenum iName : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+		const GLubyte* pkString = glGetString(iName);
+		if (pkString) text += reinterpret_cast<const char*>(pkString);
+		text += '\n';
+	}
+	text += kSourceCode;
+
+	for (char iCharacter : text) {
+		hash ^= static_cast<unsigned char>(iCharacter);
+		hash *= kPrime;
+	}
+
+	const char kDigits[] = "0123456789abcdef";
+	string key(16u, '0');
+	for (unsigned int i = 0u; i < 16u; i++)
+		key[15u - i] = kDigits[(hash >> (4u * i)) & 0xfull];
+
+	return key;
+}
+
+
+
+bool ProgramCache::contains(const string& kKey) {
+	string filePath = ProgramCache::getFilePath_(kKey);
+	if (filePath.empty()) return false;
+
+	FILE* pFile;
+	fopen_s(&pFile, filePath.c_str(), "rb");
+	if (pFile == NULL) return false;
+
+	std::fclose(pFile);
+	return true;
+}
+
+
+
+bool ProgramCache::load(GLuint program, const string& kKey) {
+	string filePath = ProgramCache::getFilePath_(kKey);
+	if (filePath.empty()) return false;
+
+	FILE* pFile;
+	fopen_s(&pFile, filePath.c_str(), "rb");
+	if (pFile == NULL) return false;
+
+	FILE_HEADER header;
+	size_t count = std::fread(&header, sizeof(FILE_HEADER), 1u, pFile);
+	if (count != 1u || std::string(header.magic, 4u) != std::string(ProgramCache::kMagic_, 4u) || header.length <= 0) {
+		std::fclose(pFile);
+		return false;
+	}
+
+	vector<char> binary(static_cast<size_t>(header.length));
+	count = std::fread(binary.data(), 1u, binary.size(), pFile);
+	std::fclose(pFile);
+	if (count != binary.size()) return false;
+
+	// the driver may reject a binary of another build, then the program is left unlinked
+	glProgramBinary(program, header.format, binary.data(), header.length);
+
+	GLint linkedStatus;
+	glGetProgramiv(program, GL_LINK_STATUS, &linkedStatus);
+	if (linkedStatus == GL_FALSE) return false;
+
+	ProgramCache::nLoaded_++;
+	return true;
+}
+
+
+
+void ProgramCache::save(GLuint program, const string& kKey) {
+	string filePath = ProgramCache::getFilePath_(kKey);
+	if (filePath.empty()) return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+
+	FILE_HEADER header;
+	std::copy(ProgramCache::kMagic_, ProgramCache::kMagic_ + 4u, header.magic);
+	header.format = 0u;
+	header.length = 0;
+
+	vector<char> binary(static_cast<size_t>(length));
+	glGetProgramBinary(program, length, &header.length, &header.format, binary.data());
+	if (header.length <= 0) return;
+
+	FILE* pFile;
+	fopen_s(&pFile, filePath.c_str(), "wb");
+	if (pFile == NULL) {
+		cout << "Program cache: cannot write the '" << filePath << "' file." << endl;
+		return;
+	}
+
+	bool written = std::fwrite(&header, sizeof(FILE_HEADER), 1u, pFile) == 1u &&
+		           std::fwrite(binary.data(), 1u, static_cast<size_t>(header.length), pFile) ==
+		           static_cast<size_t>(header.length);
+	std::fclose(pFile);
+
+	// a partial file would only be rejected later, remove it now
+	if (written) ProgramCache::nStored_++;
+	else std::remove(filePath.c_str());
+}
+
+
+
+unsigned int ProgramCache::getNumLoaded() {
+	return ProgramCache::nLoaded_;
+}
+
+
+
+unsigned int ProgramCache::getNumStored() {
+	return ProgramCache::nStored_;
+}
+
+
+
+string ProgramCache::toString() {
+	string directory = ProgramCache::getDirectory_();
+
+	return "Program cache: " + to_string(ProgramCache::nLoaded_) + " loaded, " + to_string(ProgramCache::nStored_) +
+		   " stored (" + (directory.empty() ? string("off") : directory) + ")";
+}
+
+
+
+string ProgramCache::getDirectory_() {
+	if (!ProgramCache::hasDirectory_) {
+		ProgramCache::hasDirectory_ = true;
+
+		char* pLocalAppData = nullptr;
+		size_t len = 0u;
+		if (_dupenv_s(&pLocalAppData, &len, "LOCALAPPDATA") == 0 && pLocalAppData) {
+			string directory = string(pLocalAppData) + "/BlueMarble";
+			std::free(pLocalAppData);
+
+			// an existing directory is not an error
+			_mkdir(directory.c_str());
+			directory += "/ProgramCache";
+			_mkdir(directory.c_str());
+
+			FILE* pFile;
+			fopen_s(&pFile, (directory + "/.probe").c_str(), "wb");
+			if (pFile != NULL) {
+				std::fclose(pFile);
+				std::remove((directory + "/.probe").c_str());
+				ProgramCache::directory_ = directory;
+			}
+		}
+	}
+
+	return ProgramCache::directory_;
+}
+
+
+
+string ProgramCache::getFilePath_(const string& kKey) {
+	string directory = ProgramCache::getDirectory_();
+	return directory.empty() ? "" : directory + "/" + kKey + ".bin";
+}
@@ -0,0 +1,70 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <GL/gl3w.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <direct.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::FILE;
+using std::size_t;
+using std::string;
+using std::to_string;
+using std::vector;
+
+
+
+// On-disk cache of linked program binaries (glGetProgramBinary / glProgramBinary), one file per program in
+// '%LOCALAPPDATA%/BlueMarble/ProgramCache'. The key hashes the source code of the shaders (with their '#define'
+// headers) and the GL vendor, renderer and version strings, so an edited shader or another driver misses the cache;
+// a binary rejected by the driver is a miss too, and the program is linked from source and stored again.
+// A cache that cannot be read or written is skipped, it never stops the program.
+class ProgramCache {
+public:
+	// get
+	//############################################################################
+	static string computeKey(const string& kSourceCode); // needs a current GL context
+
+	static bool contains(const string& kKey);
+	static bool load(GLuint program, const string& kKey); // true -> 'program' is linked
+	static void save(GLuint program, const string& kKey); // 'program' linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+
+	static unsigned int getNumLoaded();
+	static unsigned int getNumStored();
+
+	static string toString();
+
+private:
+	static const char kMagic_[4u];
+
+	static string getDirectory_(); // empty -> no cache
+	static string getFilePath_(const string& kKey);
+
+	ProgramCache();
+	ProgramCache(const ProgramCache&);
+	const ProgramCache& operator=(const ProgramCache&) {}
+
+	struct FILE_HEADER {
+		char magic[4u];
+		GLenum format;
+		GLint length;
+	};
+
+	static string directory_;
+	static bool hasDirectory_;
+	static unsigned int nLoaded_, nStored_;
+};
+
+#endif
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Shader.h"
@@ -8,9 +8,12 @@
 
 
 Shader::Shader(GLenum shaderType): id_(0u), shaderType_ (shaderType), path_(), header_(), toStr_(), fileList_(),
-                                   ppSource_(nullptr), nFiles_(0), compiled_(false) {
+                                   ppSource_(nullptr), nFiles_(0), binarySize_(0u), constantIndices_(), constantValues_(),
+                                   binary_(false), compiled_(false) {
 	switch (shaderType) {
 		case GL_VERTEX_SHADER:
+		case GL_TESS_CONTROL_SHADER:
+		case GL_TESS_EVALUATION_SHADER:
 		case GL_GEOMETRY_SHADER:
 		case GL_FRAGMENT_SHADER:
 			id_ = glCreateShader(shaderType);
@@ -78,30 +81,67 @@ void Shader::readSourceCode(const string& kPath, const list<string>& kFileList,
 
 
 
+// SPIR-V module of 'shaders/spirv/build.bat', compiled without parsing GLSL text
+void Shader::readBinary(const string& kPath, const string& kFileName) {
+	if (ppSource_)
+		throw runtime_error("Shader.readBinary|" + getType_() + " " + to_string(id_) + " source file(s) already loaded.");
+
+	nFiles_ = 1;
+	path_ = kPath;
+	fileList_ = { kFileName };
+	header_ = "";
+	binary_ = true;
+	toStr_ = toString_();
+
+	ppSource_ = new GLchar*[1u];
+	ppSource_[0u] = nullptr;
+
+	try {
+		if (kPath.empty()) binarySize_ = readFile_(kFileName.c_str(), 0u);
+		else binarySize_ = readFile_((kPath + "/" + kFileName).c_str(), 0u);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Shader.readBinary > " + string(kException.what()));
+	}
+
+	if (binarySize_ == 0u || binarySize_ % 4u != 0u)
+		throw runtime_error("Shader.readBinary|The '" + kFileName + "' file is not a SPIR-V module.");
+}
+
+
+
+void Shader::setSpecializationConstants(const vector<GLuint>& kIndices, const vector<GLuint>& kValues) {
+	if (!binary_)
+		throw runtime_error("Shader.setSpecializationConstants|" + getType_() + " " + to_string(id_) + " not a SPIR-V module.");
+	if (compiled_)
+		throw runtime_error("Shader.setSpecializationConstants|" + getType_() + " " + to_string(id_) + " already compiled.");
+	if (kIndices.size() != kValues.size())
+		throw runtime_error("Shader.setSpecializationConstants|Invalid number of values.");
+
+	constantIndices_ = kIndices;
+	constantValues_ = kValues;
+}
+
+
+
 void Shader::compile() {
 	if (!ppSource_)
 		throw runtime_error("Shader.compile|" + getType_() + " " + to_string(id_) + " source file(s) not loaded yet.");
 	if (compiled_)
 		throw runtime_error("Shader.compile|" + getType_() + " " + to_string(id_) + " already compiled.");
 
-	glShaderSource(id_, nFiles_, const_cast<const GLchar**> (ppSource_), NULL);
-	glCompileShader(id_);
-
-	GLint compiledStatus;
-	glGetShaderiv(id_, GL_COMPILE_STATUS, &compiledStatus);
-	if (compiledStatus == GL_FALSE) {
-		string errorMessage = "Shader.compile|Shader compilation failed. ";
-		GLint len;
-		glGetShaderiv(id_, GL_INFO_LOG_LENGTH, &len);
-		if (len > 0) {
-			GLchar* pLog = new GLchar[static_cast<size_t>(len)];
-			glGetShaderInfoLog(id_, len, &len, pLog);
-			errorMessage += pLog;
-			delete[] pLog;
-		}
-		throw runtime_error(errorMessage);
+	if (binary_) {
+		glShaderBinary(1, &id_, GL_SHADER_BINARY_FORMAT_SPIR_V, ppSource_[0u], static_cast<GLsizei>(binarySize_));
+		glSpecializeShader(id_, "main", static_cast<GLuint>(constantIndices_.size()), constantIndices_.data(),
+			               constantValues_.data());
+	}
+	else {
+		glShaderSource(id_, nFiles_, const_cast<const GLchar**> (ppSource_), NULL);
+		glCompileShader(id_);
 	}
 
+	// the compile status is checked with the link status (see 'Program.finishLinking'): querying it here would wait
+	// for the compilation, which can run on the driver threads (see 'GlState.hasParallelShaderCompile')
 	compiled_ = true;
 	//cout << getType_() << " " << id_ << " succesfully compiled." << endl;
 }
@@ -135,6 +175,33 @@ string Shader::getHeader() const {
 
 
 
+string Shader::getSourceCode() const {
+	if (!ppSource_)
+		throw runtime_error("Shader.getSourceCode|" + getType_() + " " + to_string(id_) + " source file(s) not loaded yet.");
+
+	if (binary_) {
+		string sourceCode(ppSource_[0u], binarySize_);
+		for (size_t i = 0u; i < constantIndices_.size(); i++)
+			sourceCode += "\n" + to_string(constantIndices_[i]) + "=" + to_string(constantValues_[i]);
+
+		return sourceCode;
+	}
+
+	string sourceCode = "";
+	for (GLsizei i = 0; i < nFiles_; i++)
+		if (ppSource_[i]) sourceCode += ppSource_[i];
+
+	return sourceCode;
+}
+
+
+
+bool Shader::isBinary() const {
+	return binary_;
+}
+
+
+
 bool Shader::isCompiled() const {
 	return compiled_;
 }
@@ -154,7 +221,7 @@ string Shader::toString() const {
 
 
 
-void Shader::readFile_(const char* pkFileName, unsigned int fileNo) {
+size_t Shader::readFile_(const char* pkFileName, unsigned int fileNo) {
 	FILE* pFile;
 	fopen_s(&pFile, pkFileName, "rb");
 
@@ -190,6 +257,7 @@ void Shader::readFile_(const char* pkFileName, unsigned int fileNo) {
 	ppSource_[fileNo][len] = 0u;
 
 	std::fclose(pFile);
+	return static_cast<size_t>(len);
 }
 
 
@@ -199,6 +267,12 @@ string Shader::getType_() const {
 	case GL_VERTEX_SHADER:
 		return "Vertex shader";
 		break;
+	case GL_TESS_CONTROL_SHADER:
+		return "Tessellation control shader";
+		break;
+	case GL_TESS_EVALUATION_SHADER:
+		return "Tessellation evaluation shader";
+		break;
 	case GL_GEOMETRY_SHADER:
 		return "Geometry shader";
 		break;
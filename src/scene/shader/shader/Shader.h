@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 13, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef SHADER_H
@@ -14,6 +14,7 @@
 #include <list>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 using std::cout;
 using std::endl;
@@ -24,6 +25,7 @@ using std::runtime_error;
 using std::size_t;
 using std::string;
 using std::to_string;
+using std::vector;
 
 
 
@@ -33,11 +35,13 @@ public:
 	~Shader();
 
 
-	// init: 1) readSourceCode
+	// init: 1) readSourceCode (GLSL) or readBinary (SPIR-V module), [setSpecializationConstants]
 	//       2) compile
 	//############################################################################
 	void readSourceCode(const string& kPath, const list<string>& kFileList, const string& kHeader);
-	void compile();
+	void readBinary(const string& kPath, const string& kFileName);
+	void setSpecializationConstants(const vector<GLuint>& kIndices, const vector<GLuint>& kValues); // SPIR-V module
+	void compile(); // SPIR-V module: glShaderBinary and glSpecializeShader
 
 
 	// get
@@ -47,8 +51,10 @@ public:
 	string getPath() const;
 	list<string> getFileList() const;
 	string getHeader() const;
+	string getSourceCode() const; // header and files, or module and specialization constants, as passed to the driver
 
-	bool isCompiled() const;
+	bool isBinary() const;
+	bool isCompiled() const; // compilation started, errors are reported by 'Program.finishLinking'
 	
 	GLuint getId() const;
 	string toString() const;
@@ -57,7 +63,7 @@ private:
 	Shader(const Shader&);
 	const Shader& operator=(const Shader&) {}
 
-	void readFile_(const char* pkFileName, unsigned int fileNo);
+	size_t readFile_(const char* pkFileName, unsigned int fileNo); // length
 	string getType_() const;
 	string toString_() const;
 
@@ -67,7 +73,9 @@ private:
 	list<string> fileList_;	
 	GLchar** ppSource_;
 	GLsizei nFiles_;
-	bool compiled_;
+	size_t binarySize_;
+	vector<GLuint> constantIndices_, constantValues_;
+	bool binary_, compiled_;
 };
 
 #endif
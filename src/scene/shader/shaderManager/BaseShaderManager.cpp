@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 31, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "BaseShaderManager.h"
@@ -17,10 +17,21 @@ BaseShaderManager::~BaseShaderManager() {
 
 void BaseShaderManager::compileShaders() {
 	try {
-		for (Shader& iShader : vertexShaders_)
-			iShader.compile();
-		for (Shader& iShader : fragmentShaders_)
-			iShader.compile();
+		// programs missing from the program cache, their shaders are compiled
+		list<BaseProgram::ProgramMode> programModes;
+		for (const pair<BaseProgram::ProgramMode, Shader*>& ikRef : vertexShaderRef_)
+			programModes.push_back(ikRef.first);
+		programModes.sort(); programModes.unique();
+		programModes.remove_if([this](BaseProgram::ProgramMode iMode) {
+			return ProgramCache::contains(getProgramKey_(iMode));
+		});
+
+		for (const list<pair<BaseProgram::ProgramMode, Shader*>>* ipkShaderRef :
+			 { &vertexShaderRef_, &tessControlShaderRef_, &tessEvaluationShaderRef_, &fragmentShaderRef_ })
+			for (const pair<BaseProgram::ProgramMode, Shader*>& ikRef : *ipkShaderRef)
+				if (!ikRef.second->isCompiled() &&
+					std::find(programModes.cbegin(), programModes.cend(), ikRef.first) != programModes.cend())
+					ikRef.second->compile();
 	}
 	catch (const exception& kException) {
 		throw runtime_error("BaseShaderManager.compileShaders > " + string(kException.what()));
@@ -29,6 +40,17 @@ void BaseShaderManager::compileShaders() {
 
 
 
+unsigned int BaseShaderManager::getNumLinkingPrograms() const {
+	unsigned int nPrograms = 0u;
+	for (const pair<BaseProgram*, string>& ikProgram : pendingPrograms_)
+		if (ikProgram.first->isLinking() && !ikProgram.first->isLinkCompleted())
+			nPrograms++;
+
+	return nPrograms;
+}
+
+
+
 void BaseShaderManager::setWindowSize(const uvec2& kSize) {
 	if (kSize.x == 0u || kSize.y == 0u)
 		throw runtime_error("BaseShaderManager.setWindowSize|Invalid window size value.");
@@ -38,14 +60,15 @@ void BaseShaderManager::setWindowSize(const uvec2& kSize) {
 
 
 void BaseShaderManager::stopProgram() const {
-	pCurrentProgram_->stop();
+	if (pCurrentProgram_) pCurrentProgram_->stop();
 }
 
 
 
 BaseShaderManager::BaseShaderManager(const uvec2& kWindowSize): ppPrograms_(nullptr), pCurrentProgram_(nullptr), nPrograms_(0u),
-                                     windowSize_(kWindowSize), vertexShaders_(), fragmentShaders_(),
-                                     vertexShaderRef_(), fragmentShaderRef_() {
+                                     windowSize_(kWindowSize), pendingPrograms_(), vertexShaders_(), tessControlShaders_(),
+                                     tessEvaluationShaders_(), fragmentShaders_(), vertexShaderRef_(),
+                                     tessControlShaderRef_(), tessEvaluationShaderRef_(), fragmentShaderRef_() {
 	if (kWindowSize.x == 0u || kWindowSize.y == 0u)
 		throw runtime_error("BaseShaderManager|Invalid window size value.");
 
@@ -57,19 +80,8 @@ BaseShaderManager::BaseShaderManager(const uvec2& kWindowSize): ppPrograms_(null
 void BaseShaderManager::addVertexShaderSourceCode_(BaseProgram::ProgramMode programMode,
 	                                               const string& kPath, const list<string>& kFileList, const string& kHeader) {
 	try {
-		Shader* pShader = nullptr;
-		for (Shader& iShader : vertexShaders_)
-			if (iShader.getPath() == kPath && iShader.getFileList() == kFileList && iShader.getHeader() == kHeader) {
-				pShader = &iShader;
-				break;
-			}
-
-		if (!pShader) {
-			vertexShaders_.emplace_back(GL_VERTEX_SHADER);
-			pShader = &vertexShaders_.back();
-			pShader->readSourceCode(kPath, kFileList, kHeader);
-		}
-		if (pShader) vertexShaderRef_.push_back(std::make_pair(programMode, pShader));
+		BaseShaderManager::addShaderSourceCode_(GL_VERTEX_SHADER, vertexShaders_, vertexShaderRef_,
+			                                    programMode, kPath, kFileList, kHeader);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("BaseShaderManager.addVertexShaderSourceCode_ > " + string(kException.what()));
@@ -78,22 +90,37 @@ void BaseShaderManager::addVertexShaderSourceCode_(BaseProgram::ProgramMode prog
 
 
 
+void BaseShaderManager::addTessControlShaderSourceCode_(BaseProgram::ProgramMode programMode,
+	                                                    const string& kPath, const list<string>& kFileList, const string& kHeader) {
+	try {
+		BaseShaderManager::addShaderSourceCode_(GL_TESS_CONTROL_SHADER, tessControlShaders_, tessControlShaderRef_,
+			                                    programMode, kPath, kFileList, kHeader);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.addTessControlShaderSourceCode_ > " + string(kException.what()));
+	}
+}
+
+
+
+void BaseShaderManager::addTessEvaluationShaderSourceCode_(BaseProgram::ProgramMode programMode,
+	                                                       const string& kPath, const list<string>& kFileList, const string& kHeader) {
+	try {
+		BaseShaderManager::addShaderSourceCode_(GL_TESS_EVALUATION_SHADER, tessEvaluationShaders_, tessEvaluationShaderRef_,
+			                                    programMode, kPath, kFileList, kHeader);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.addTessEvaluationShaderSourceCode_ > " + string(kException.what()));
+	}
+}
+
+
+
 void BaseShaderManager::addFragmentShaderSourceCode_(BaseProgram::ProgramMode programMode,
 	                                                 const string& kPath, const list<string>& kFileList, const string& kHeader) {
 	try {
-		Shader* pShader = nullptr;
-		for (Shader& iShader : fragmentShaders_)
-			if (iShader.getPath() == kPath && iShader.getFileList() == kFileList && iShader.getHeader() == kHeader) {
-				pShader = &iShader;
-				break;
-			}
-
-		if (!pShader) {
-			fragmentShaders_.emplace_back(GL_FRAGMENT_SHADER);
-			pShader = &fragmentShaders_.back();
-			pShader->readSourceCode(kPath, kFileList, kHeader);
-		}
-		if (pShader) fragmentShaderRef_.push_back(std::make_pair(programMode, pShader));
+		BaseShaderManager::addShaderSourceCode_(GL_FRAGMENT_SHADER, fragmentShaders_, fragmentShaderRef_,
+			                                    programMode, kPath, kFileList, kHeader);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("BaseShaderManager.addFragmentShaderSourceCode_ > " + string(kException.what()));
@@ -102,23 +129,220 @@ void BaseShaderManager::addFragmentShaderSourceCode_(BaseProgram::ProgramMode pr
 
 
 
+void BaseShaderManager::addShaderBinary_(GLenum shaderType, BaseProgram::ProgramMode programMode, const string& kPath,
+	                                     const string& kFileName) {
+	list<Shader>* pShaders = nullptr;
+	list<pair<BaseProgram::ProgramMode, Shader*>>* pShaderRef = nullptr;
+	switch (shaderType) {
+	case GL_VERTEX_SHADER:
+		pShaders = &vertexShaders_;
+		pShaderRef = &vertexShaderRef_;
+		break;
+	case GL_TESS_CONTROL_SHADER:
+		pShaders = &tessControlShaders_;
+		pShaderRef = &tessControlShaderRef_;
+		break;
+	case GL_TESS_EVALUATION_SHADER:
+		pShaders = &tessEvaluationShaders_;
+		pShaderRef = &tessEvaluationShaderRef_;
+		break;
+	case GL_FRAGMENT_SHADER:
+		pShaders = &fragmentShaders_;
+		pShaderRef = &fragmentShaderRef_;
+		break;
+	default:
+		throw runtime_error("BaseShaderManager.addShaderBinary_|Invalid shader type value.");
+	}
+
+	try {
+		pShaders->emplace_back(shaderType);
+		pShaders->back().readBinary(kPath, kFileName);
+		pShaderRef->push_back(std::make_pair(programMode, &pShaders->back()));
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.addShaderBinary_ > " + string(kException.what()));
+	}
+}
+
+
+
+bool BaseShaderManager::hasShaderBinaries_(BaseProgram::ProgramMode programMode) const {
+	for (const pair<BaseProgram::ProgramMode, Shader*>& ikRef : vertexShaderRef_)
+		if (ikRef.first == programMode && ikRef.second->isBinary()) return true;
+
+	return false;
+}
+
+
+
+void BaseShaderManager::addPermutation_(BaseProgram::ProgramMode baseMode, BaseProgram::ProgramMode permutationMode,
+	                                    const string& kHeader, const vector<GLuint>& kConstantIndices,
+	                                    const vector<GLuint>& kConstantValues) {
+	bool binaries = hasShaderBinaries_(baseMode);
+
+	try {
+		BaseShaderManager::addPermutation_(baseMode, permutationMode, binaries, kHeader, kConstantIndices, kConstantValues,
+			                               vertexShaders_, vertexShaderRef_);
+		BaseShaderManager::addPermutation_(baseMode, permutationMode, binaries, kHeader, kConstantIndices, kConstantValues,
+			                               tessControlShaders_, tessControlShaderRef_);
+		BaseShaderManager::addPermutation_(baseMode, permutationMode, binaries, kHeader, kConstantIndices, kConstantValues,
+			                               tessEvaluationShaders_, tessEvaluationShaderRef_);
+		BaseShaderManager::addPermutation_(baseMode, permutationMode, binaries, kHeader, kConstantIndices, kConstantValues,
+			                               fragmentShaders_, fragmentShaderRef_);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.addPermutation_ > " + string(kException.what()));
+	}
+}
+
+
+
 void BaseShaderManager::linkProgram_(BaseProgram::ProgramMode programMode, 
 	                                 list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList) {
-	for (const pair<BaseProgram::ProgramMode, Shader*> ikRef : vertexShaderRef_)
-		if (ikRef.first == programMode) {
-			const Shader* pkShader = ikRef.second;
-			GLuint id = pkShader->getId();
-			if (pkShader->isCompiled())
-				rVertexShaderList.push_back(id);
-			else throw runtime_error("BaseShaderManager.linkProgram_|Vertex shader " + to_string(id) + " not compiled.");
+	list<GLuint> tessControlShaderList, tessEvaluationShaderList;
+	linkProgram_(programMode, rVertexShaderList, tessControlShaderList, tessEvaluationShaderList, rFragmentShaderList);
+}
+
+
+
+void BaseShaderManager::linkProgram_(BaseProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList,
+	                                 list<GLuint>& rTessControlShaderList, list<GLuint>& rTessEvaluationShaderList,
+	                                 list<GLuint>& rFragmentShaderList) {
+	try {
+		BaseShaderManager::getShaderIds_(programMode, vertexShaderRef_, rVertexShaderList);
+		BaseShaderManager::getShaderIds_(programMode, tessControlShaderRef_, rTessControlShaderList);
+		BaseShaderManager::getShaderIds_(programMode, tessEvaluationShaderRef_, rTessEvaluationShaderList);
+		BaseShaderManager::getShaderIds_(programMode, fragmentShaderRef_, rFragmentShaderList);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.linkProgram_ > " + string(kException.what()));
+	}
+}
+
+
+
+string BaseShaderManager::getProgramKey_(BaseProgram::ProgramMode programMode) const {
+	try {
+		string sourceCode = "";
+		BaseShaderManager::addProgramSourceCode_(programMode, vertexShaderRef_, sourceCode);
+		BaseShaderManager::addProgramSourceCode_(programMode, tessControlShaderRef_, sourceCode);
+		BaseShaderManager::addProgramSourceCode_(programMode, tessEvaluationShaderRef_, sourceCode);
+		BaseShaderManager::addProgramSourceCode_(programMode, fragmentShaderRef_, sourceCode);
+
+		return ProgramCache::computeKey(sourceCode);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.getProgramKey_ > " + string(kException.what()));
+	}
+}
+
+
+
+void BaseShaderManager::addPendingProgram_(BaseProgram* pProgram, const string& kBinaryKey) {
+	pendingPrograms_.push_back(std::make_pair(pProgram, kBinaryKey));
+}
+
+
+
+void BaseShaderManager::finishProgram_(BaseProgram* pProgram) {
+	list<pair<BaseProgram*, string>>::iterator iProgram = pendingPrograms_.begin();
+	while (iProgram != pendingPrograms_.end() && iProgram->first != pProgram)
+		iProgram++;
+	if (iProgram == pendingPrograms_.end()) return;
+
+	string key = iProgram->second;
+	pendingPrograms_.erase(iProgram);
+
+	try {
+		if (pProgram->isLinking()) {
+			pProgram->finishLinking();
+			pProgram->saveBinary(key);
 		}
 
-	for (const pair<BaseProgram::ProgramMode, Shader*> ikRef : fragmentShaderRef_)
+		setUpProgram_(pProgram);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseShaderManager.finishProgram_ > " + string(kException.what()));
+	}
+}
+
+
+
+bool BaseShaderManager::isPendingProgram_(const BaseProgram* pkProgram) const {
+	for (const pair<BaseProgram*, string>& ikProgram : pendingPrograms_)
+		if (ikProgram.first == pkProgram) return true;
+
+	return false;
+}
+
+
+
+void BaseShaderManager::addShaderSourceCode_(GLenum shaderType, list<Shader>& rShaders,
+	                                         list<pair<BaseProgram::ProgramMode, Shader*>>& rShaderRef,
+	                                         BaseProgram::ProgramMode programMode,
+	                                         const string& kPath, const list<string>& kFileList, const string& kHeader) {
+	Shader* pShader = nullptr;
+	for (Shader& iShader : rShaders)
+		if (iShader.getPath() == kPath && iShader.getFileList() == kFileList && iShader.getHeader() == kHeader) {
+			pShader = &iShader;
+			break;
+		}
+
+	if (!pShader) {
+		rShaders.emplace_back(shaderType);
+		pShader = &rShaders.back();
+		pShader->readSourceCode(kPath, kFileList, kHeader);
+	}
+	if (pShader) rShaderRef.push_back(std::make_pair(programMode, pShader));
+}
+
+
+
+void BaseShaderManager::addPermutation_(BaseProgram::ProgramMode baseMode, BaseProgram::ProgramMode permutationMode,
+	                                    bool binaries, const string& kHeader, const vector<GLuint>& kConstantIndices,
+	                                    const vector<GLuint>& kConstantValues, list<Shader>& rShaders,
+	                                    list<pair<BaseProgram::ProgramMode, Shader*>>& rShaderRef) {
+	list<const Shader*> baseShaders;
+	for (const pair<BaseProgram::ProgramMode, Shader*>& ikRef : rShaderRef)
+		if (ikRef.first == baseMode && ikRef.second->isBinary() == binaries) baseShaders.push_back(ikRef.second);
+
+	for (const Shader* ipkShader : baseShaders)
+		if (binaries) {
+			// one module per permutation: the specialization happens when it is compiled
+			rShaders.emplace_back(ipkShader->getShaderType());
+			rShaders.back().readBinary(ipkShader->getPath(), ipkShader->getFileList().front());
+			rShaders.back().setSpecializationConstants(kConstantIndices, kConstantValues);
+			rShaderRef.push_back(std::make_pair(permutationMode, &rShaders.back()));
+		}
+		else BaseShaderManager::addShaderSourceCode_(ipkShader->getShaderType(), rShaders, rShaderRef, permutationMode,
+			                                         ipkShader->getPath(), ipkShader->getFileList(),
+			                                         ipkShader->getHeader() + kHeader);
+}
+
+
+
+void BaseShaderManager::getShaderIds_(BaseProgram::ProgramMode programMode,
+	                                  const list<pair<BaseProgram::ProgramMode, Shader*>>& kShaderRef, list<GLuint>& rShaderList) {
+	for (const pair<BaseProgram::ProgramMode, Shader*>& ikRef : kShaderRef)
 		if (ikRef.first == programMode) {
-			const Shader* pkShader = ikRef.second;
-			GLuint id = pkShader->getId();
-			if (pkShader->isCompiled())
-				rFragmentShaderList.push_back(id);
-			else throw runtime_error("BaseShaderManager.linkProgram_|Fragment shader " + to_string(id) + " not compiled.");
+			Shader* pShader = ikRef.second;
+			if (!pShader->isCompiled())
+				try {
+					pShader->compile();
+				}
+				catch (const exception& kException) {
+					throw runtime_error("BaseShaderManager.getShaderIds_ > " + string(kException.what()));
+				}
+			rShaderList.push_back(pShader->getId());
 		}
 }
+
+
+
+void BaseShaderManager::addProgramSourceCode_(BaseProgram::ProgramMode programMode,
+	                                          const list<pair<BaseProgram::ProgramMode, Shader*>>& kShaderRef,
+	                                          string& rSourceCode) {
+	for (const pair<BaseProgram::ProgramMode, Shader*>& ikRef : kShaderRef)
+		if (ikRef.first == programMode)
+			rSourceCode += to_string(ikRef.second->getShaderType()) + "\n" + ikRef.second->getSourceCode() + "\n";
+}
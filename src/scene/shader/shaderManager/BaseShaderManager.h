@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 31, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef BASE_SHADER_MANAGER_H
@@ -8,17 +8,20 @@
 
 #include <GL/gl3w.h>
 
+#include "shader/program/ProgramCache.h"
 #include "shader/shader/Shader.h"
 #include "shader/shaderProgram/BaseProgram.h"
 
 #include <glm/vec2.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <list>
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 using glm::uvec2;
 
@@ -30,6 +33,7 @@ using std::pair;
 using std::runtime_error;
 using std::string;
 using std::to_string;
+using std::vector;
 
 
 
@@ -37,7 +41,12 @@ class BaseShaderManager {
 public:
 	virtual ~BaseShaderManager();
 
-	void compileShaders();
+	// the shaders of the program modes, skipping the programs found in the program cache (the permutations are compiled
+	// by the managers that request them, see 'MainShaderManager')
+	virtual void compileShaders();
+
+	// programs still linking, polled while the scene is loading (0 without parallel shader compile, see 'GlState')
+	unsigned int getNumLinkingPrograms() const;
 
 	virtual void setWindowSize(const uvec2& kSize);
 
@@ -48,10 +57,36 @@ protected:
 
 	void addVertexShaderSourceCode_(BaseProgram::ProgramMode programMode,
 		                            const string& kPath, const list<string>& kFileList, const string& kHeader);
+	void addTessControlShaderSourceCode_(BaseProgram::ProgramMode programMode,
+		                                 const string& kPath, const list<string>& kFileList, const string& kHeader);
+	void addTessEvaluationShaderSourceCode_(BaseProgram::ProgramMode programMode,
+		                                    const string& kPath, const list<string>& kFileList, const string& kHeader);
 	void addFragmentShaderSourceCode_(BaseProgram::ProgramMode programMode, 
 		                              const string& kPath, const list<string>& kFileList, const string& kHeader);
 
+	// SPIR-V module of one stage (see 'Shader.readBinary'), used instead of the source code by the permutations
+	void addShaderBinary_(GLenum shaderType, BaseProgram::ProgramMode programMode, const string& kPath,
+		                  const string& kFileName);
+	bool hasShaderBinaries_(BaseProgram::ProgramMode programMode) const;
+
+	// the shaders of 'baseMode', referenced by 'permutationMode': the SPIR-V modules with the specialization constants
+	// if 'baseMode' has any, otherwise the source code with 'kHeader' appended to the headers
+	void addPermutation_(BaseProgram::ProgramMode baseMode, BaseProgram::ProgramMode permutationMode, const string& kHeader,
+		                 const vector<GLuint>& kConstantIndices, const vector<GLuint>& kConstantValues);
+
 	void linkProgram_(BaseProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList);
+	void linkProgram_(BaseProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList,
+		              list<GLuint>& rTessControlShaderList, list<GLuint>& rTessEvaluationShaderList,
+		              list<GLuint>& rFragmentShaderList);
+
+	string getProgramKey_(BaseProgram::ProgramMode programMode) const; // program cache key, needs a current GL context
+
+	// a program being linked (or loaded from the program cache) is finished and set up when first used, so 'linkProgram'
+	// returns at once and makes no state change: it may run on a worker thread with a shared context
+	void addPendingProgram_(BaseProgram* pProgram, const string& kBinaryKey);
+	void finishProgram_(BaseProgram* pProgram); // waits for the linking, stores the binary, calls 'setUpProgram_'
+	bool isPendingProgram_(const BaseProgram* pkProgram) const;
+	virtual void setUpProgram_(BaseProgram* pProgram) = 0; // uniforms set once
 	
 	BaseProgram** ppPrograms_;
 	BaseProgram* pCurrentProgram_;
@@ -63,8 +98,27 @@ private:
 	BaseShaderManager(const BaseShaderManager&);
 	const BaseShaderManager& operator=(const BaseShaderManager&) {}
 
-	list<Shader> vertexShaders_, fragmentShaders_;
-	list<pair<BaseProgram::ProgramMode, Shader*>> vertexShaderRef_, fragmentShaderRef_;
+	// shared by the add...ShaderSourceCode_ methods: a shader with the same source code is reused
+	static void addShaderSourceCode_(GLenum shaderType, list<Shader>& rShaders,
+		                             list<pair<BaseProgram::ProgramMode, Shader*>>& rShaderRef,
+		                             BaseProgram::ProgramMode programMode,
+		                             const string& kPath, const list<string>& kFileList, const string& kHeader);
+	// a shader not compiled yet (its programs were cached, but a binary got rejected) is compiled here
+	static void addPermutation_(BaseProgram::ProgramMode baseMode, BaseProgram::ProgramMode permutationMode, bool binaries,
+		                        const string& kHeader, const vector<GLuint>& kConstantIndices,
+		                        const vector<GLuint>& kConstantValues, list<Shader>& rShaders,
+		                        list<pair<BaseProgram::ProgramMode, Shader*>>& rShaderRef);
+	static void getShaderIds_(BaseProgram::ProgramMode programMode,
+		                      const list<pair<BaseProgram::ProgramMode, Shader*>>& kShaderRef, list<GLuint>& rShaderList);
+
+	static void addProgramSourceCode_(BaseProgram::ProgramMode programMode,
+		                              const list<pair<BaseProgram::ProgramMode, Shader*>>& kShaderRef, string& rSourceCode);
+
+	list<pair<BaseProgram*, string>> pendingPrograms_; // program cache key
+
+	list<Shader> vertexShaders_, tessControlShaders_, tessEvaluationShaders_, fragmentShaders_;
+	list<pair<BaseProgram::ProgramMode, Shader*>> vertexShaderRef_, tessControlShaderRef_, tessEvaluationShaderRef_,
+		                                          fragmentShaderRef_;
 };
 
 #endif
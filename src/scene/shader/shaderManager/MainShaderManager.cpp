@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "MainShaderManager.h"
@@ -31,35 +31,44 @@ GLint MainShaderManager::getNormalMapTextureUnit() {
 
 
 
-MainShaderManager::MainShaderManager(const uvec2& kWindowSize): BaseShaderManager(kWindowSize),
-                                     pNoShadingProgram_(nullptr), pFlatShadingProgram_(nullptr), pGouraudShadingProgram_(nullptr),
-	                                 pPhongShadingProgram_(nullptr), pNormalMappingProgram_(nullptr) {
-	try {
-		pNoShadingProgram_ = new MainProgram();
-		pFlatShadingProgram_ = new MainProgram();
-		pGouraudShadingProgram_ = new MainProgram();
-		pPhongShadingProgram_ = new MainProgram();
-		pNormalMappingProgram_ = new MainProgram();
-	}
-	catch (const exception& kException) {
-		if (pNoShadingProgram_) delete pNoShadingProgram_;
-		if (pFlatShadingProgram_) delete pFlatShadingProgram_;
-		if (pGouraudShadingProgram_) delete pGouraudShadingProgram_;
-		if (pPhongShadingProgram_) delete pPhongShadingProgram_;
-		if (pNormalMappingProgram_) delete pNormalMappingProgram_;
+GLint MainShaderManager::getDiffusePageTableUnit() {
+	return 4;
+}
 
-		throw runtime_error("MainShaderManager > " + string(kException.what()));
-	}
 
-	nPrograms_ = 5u;
-	ppPrograms_ = new BaseProgram*[nPrograms_];
-	ppPrograms_[0u] = pNoShadingProgram_;
-	ppPrograms_[1u] = pFlatShadingProgram_;
-	ppPrograms_[2u] = pGouraudShadingProgram_;
-	ppPrograms_[3u] = pPhongShadingProgram_;
-	ppPrograms_[4u] = pNormalMappingProgram_;
 
-	pCurrentProgram_ = pNoShadingProgram_;
+GLint MainShaderManager::getSpecularPageTableUnit() {
+	return 5;
+}
+
+
+
+GLint MainShaderManager::getEmissivePageTableUnit() {
+	return 6;
+}
+
+
+
+GLint MainShaderManager::getNormalMapPageTableUnit() {
+	return 7;
+}
+
+
+
+GLuint MainShaderManager::getFrameDataBinding() {
+	return 0u;
+}
+
+
+
+MainShaderManager::MainShaderManager(const uvec2& kWindowSize): BaseShaderManager(kWindowSize),
+                                     frameData_(), frameDataUbo_(0u), programs_(), requestedPrograms_() {
+	glGenBuffers(1, &frameDataUbo_);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameDataUbo_);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FRAME_DATA), &frameData_, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0u);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, MainShaderManager::getFrameDataBinding(), frameDataUbo_);
 
 	//cout << "Main shader manager created." << endl;
 }
@@ -67,11 +76,10 @@ MainShaderManager::MainShaderManager(const uvec2& kWindowSize): BaseShaderManage
 
 
 MainShaderManager::~MainShaderManager() {
-	delete pNoShadingProgram_;
-	delete pFlatShadingProgram_;
-	delete pGouraudShadingProgram_;
-	delete pPhongShadingProgram_;
-	delete pNormalMappingProgram_;
+	for (const pair<const unsigned int, MainProgram*>& ikProgram : programs_)
+		delete ikProgram.second;
+
+	glDeleteBuffers(1, &frameDataUbo_);
 
 	//cout << "Main shader manager deleted." << endl;
 }
@@ -118,281 +126,278 @@ void MainShaderManager::addFragmentShaderSourceCode(MainProgram::ProgramMode pro
 
 
 
-void MainShaderManager::linkProgram(MainProgram::ProgramMode programMode) {
+void MainShaderManager::addTessellationShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
+	                                                    const list<string>& kTessControlShaderFileList,
+	                                                    const string& kTessControlShaderHeader,
+	                                                    const list<string>& kTessEvaluationShaderFileList,
+	                                                    const string& kTessEvaluationShaderHeader) {
 	try {
-		list<GLuint> vertexShaderList, fragmentShaderList;
-		BaseShaderManager::linkProgram_(static_cast<BaseProgram::ProgramMode>(programMode), vertexShaderList, fragmentShaderList);
-
-		switch (programMode) {
-		case MainProgram::ProgramMode::NO_SHADING:
-			pNoShadingProgram_->link(programMode, vertexShaderList, fragmentShaderList);
-			pCurrentProgram_ = pNoShadingProgram_;
-			break;
-		case MainProgram::ProgramMode::FLAT:
-			pFlatShadingProgram_->link(programMode, vertexShaderList, fragmentShaderList);
-			pCurrentProgram_ = pFlatShadingProgram_;
-			break;
-		case MainProgram::ProgramMode::GOURAUD:
-			pGouraudShadingProgram_->link(programMode, vertexShaderList, fragmentShaderList);
-			pCurrentProgram_ = pGouraudShadingProgram_;
-			break;
-		case MainProgram::ProgramMode::PHONG:
-			pPhongShadingProgram_->link(programMode, vertexShaderList, fragmentShaderList);
-			pCurrentProgram_ = pPhongShadingProgram_;
-			break;
-		case MainProgram::ProgramMode::NORMAL_MAPPING:
-			pNormalMappingProgram_->link(programMode, vertexShaderList, fragmentShaderList);
-			pCurrentProgram_ = pNormalMappingProgram_;
-			break;
-		default:
-			return;
-		}
-
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-
-		pProgram->start();
-
-		pProgram->setDiffuseTextureUnit(MainShaderManager::getDiffuseTextureUnit());
-		pProgram->setSpecularTextureUnit(MainShaderManager::getSpecularTextureUnit());
-		pProgram->setEmissiveTextureUnit(MainShaderManager::getEmissiveTextureUnit());
-		pProgram->setNormalMapTextureUnit(MainShaderManager::getNormalMapTextureUnit());
-
-		pProgram->stop();
+		BaseShaderManager::addTessControlShaderSourceCode_(static_cast<BaseProgram::ProgramMode>(programMode),
+			                                               kPath, kTessControlShaderFileList, kTessControlShaderHeader);
+		BaseShaderManager::addTessEvaluationShaderSourceCode_(static_cast<BaseProgram::ProgramMode>(programMode),
+			                                                  kPath, kTessEvaluationShaderFileList, kTessEvaluationShaderHeader);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.linkProgram > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.addTessellationShaderSourceCode > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setAttribPointers(Face* pMesh) const {
-	for (unsigned int i = 0u; i < nPrograms_; i++) {
-		MainProgram* pProgram = static_cast<MainProgram*>(ppPrograms_[i]);
-		pProgram->setAttribPointers(pMesh);
-	}
-}
-
+void MainShaderManager::addShaderBinaries(MainProgram::ProgramMode programMode, const string& kPath,
+	                                      const string& kModuleName) {
+	string filePath = kPath + "/" + kModuleName;
+	bool hasVertexShader = MainShaderManager::fileExists_(filePath + ".vert.spv");
+	bool hasTessControlShader = MainShaderManager::fileExists_(filePath + ".tesc.spv");
+	bool hasTessEvaluationShader = MainShaderManager::fileExists_(filePath + ".tese.spv");
+	bool hasFragmentShader = MainShaderManager::fileExists_(filePath + ".frag.spv");
 
+	// all stages or none, a program cannot mix modules and source code of the same stages
+	if (!GlState::hasSpirvShaders()) {
+		cout << "SPIR-V shaders not supported, '" << kModuleName << "' compiled from the source code." << endl;
+		return;
+	}
+	if (!hasVertexShader || !hasFragmentShader || hasTessControlShader != hasTessEvaluationShader) {
+		cout << "SPIR-V modules '" << filePath << ".*.spv' not found (see 'shaders/spirv/build.bat'), "
+			 << "compiled from the source code." << endl;
+		return;
+	}
 
-void MainShaderManager::setShadingParameters(bool ambientLightOn, bool diffuseLightOn, 
-	                                         bool specularLightOn, bool emissiveLightOn) const {
 	try {
-		for (unsigned int i = 0u; i < nPrograms_; i++) {
-			MainProgram* pProgram = static_cast<MainProgram*>(ppPrograms_[i]);
-
-			pProgram->start();
-			pProgram->setAmbientLightOn(static_cast<GLuint>(ambientLightOn));
-			pProgram->setDiffuseLightOn(static_cast<GLuint>(diffuseLightOn));
-			pProgram->setSpecularLightOn(static_cast<GLuint>(specularLightOn));
-			pProgram->setEmissiveLightOn(static_cast<GLuint>(emissiveLightOn));
-			pProgram->stop();
+		BaseProgram::ProgramMode baseMode = static_cast<BaseProgram::ProgramMode>(programMode);
+
+		BaseShaderManager::addShaderBinary_(GL_VERTEX_SHADER, baseMode, kPath, kModuleName + ".vert.spv");
+		if (hasTessControlShader) {
+			BaseShaderManager::addShaderBinary_(GL_TESS_CONTROL_SHADER, baseMode, kPath, kModuleName + ".tesc.spv");
+			BaseShaderManager::addShaderBinary_(GL_TESS_EVALUATION_SHADER, baseMode, kPath, kModuleName + ".tese.spv");
 		}
+		BaseShaderManager::addShaderBinary_(GL_FRAGMENT_SHADER, baseMode, kPath, kModuleName + ".frag.spv");
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setShadingParameters > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.addShaderBinaries > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setLightEyeDirection(const vec3& kDirection) const {
+void MainShaderManager::requestProgram(MainProgram::ProgramMode programMode, unsigned int features) {
 	try {
-		for (unsigned int i = 0u; i < nPrograms_; i++) {
-			MainProgram* pProgram = static_cast<MainProgram*>(ppPrograms_[i]);
-
-			pProgram->start();
-			pProgram->setLightEyeDirection(value_ptr(kDirection));
-			pProgram->stop();
-		}
+		addProgram_(programMode, features);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setLightEyeDirection > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.requestProgram > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setLightParameters(const vec3& kAmbientColor,
-	                                       const vec3& kDiffuseColor, const vec3& kSpecularColor) const {
+// the base program modes are never linked, only their permutations
+void MainShaderManager::compileShaders() {
 	try {
-		for (unsigned int i = 0u; i < nPrograms_; i++) {
-			MainProgram* pProgram = static_cast<MainProgram*>(ppPrograms_[i]);
+		while (!requestedPrograms_.empty()) {
+			unsigned int key = requestedPrograms_.front();
+			requestedPrograms_.pop_front();
 
-			pProgram->start();
-			pProgram->setLightColor(value_ptr(kAmbientColor), value_ptr(kDiffuseColor), value_ptr(kSpecularColor));
-			pProgram->stop();
+			linkPermutation_(key);
 		}
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setLightParameters > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.compileShaders > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::startProgram(MainProgram::ProgramMode programMode) {
-	switch (programMode) {
-	case MainProgram::ProgramMode::NO_SHADING:
-		pCurrentProgram_ = pNoShadingProgram_;
-		break;
-	case MainProgram::ProgramMode::FLAT:
-		pCurrentProgram_ = pFlatShadingProgram_;
-		break;
-	case MainProgram::ProgramMode::GOURAUD:
-		pCurrentProgram_ = pGouraudShadingProgram_;
-		break;
-	case MainProgram::ProgramMode::PHONG:
-		pCurrentProgram_ = pPhongShadingProgram_;
-		break;
-	case MainProgram::ProgramMode::NORMAL_MAPPING:
-		pCurrentProgram_ = pNormalMappingProgram_;
-		break;
-	default:
-		throw runtime_error("MainShaderManager.startProgram|Invalid program mode value.");
-	}
+void MainShaderManager::setAttribPointers(MeshBatch* pMeshBatch) const {
+	MainProgram::setAttribPointers(pMeshBatch);
+}
 
-	try {
-		pCurrentProgram_->start();
-	}
-	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.startProgram > " + string(kException.what()));
-	}
+
+
+void MainShaderManager::setAttribPointers(Planet* pPlanet) const {
+	MainProgram::setAttribPointers(pPlanet);
 }
 
 
 
-void MainShaderManager::render(const Face* pkMesh) const {
-	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->render(pkMesh);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.render > " + string(kException.what()));
-	}
+void MainShaderManager::setLightEyeDirection(const vec3& kDirection) {
+	frameData_.lightEyeDirection = kDirection;
+
+	updateFrameData_();
+}
+
+
+
+void MainShaderManager::setLightParameters(const vec3& kAmbientColor,
+	                                       const vec3& kDiffuseColor, const vec3& kSpecularColor) {
+	frameData_.lightAmbientColor = kAmbientColor;
+	frameData_.lightDiffuseColor = kDiffuseColor;
+	frameData_.lightSpecularColor = kSpecularColor;
+
+	updateFrameData_();
 }
 
 
 
-void MainShaderManager::setModelViewMatrix(const mat4& kMatrix) const {
+void MainShaderManager::startProgram(MainProgram::ProgramMode programMode, unsigned int features) {
 	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setModelViewMatrix(value_ptr(kMatrix));
+		pCurrentProgram_ = getProgram_(programMode, features);
+		BaseShaderManager::finishProgram_(pCurrentProgram_);
+
+		pCurrentProgram_->start();
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setModelViewMatrix > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.startProgram > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setModelViewProjectionMatrix(const mat4& kMatrix) const {
+void MainShaderManager::render(const MeshBatch* pkMeshBatch, unsigned int firstDrawId, unsigned int nDraws) const {
 	try {
 		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setModelViewProjectionMatrix(value_ptr(kMatrix));
+		pProgram->render(pkMeshBatch, firstDrawId, nDraws);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setModelViewProjectionMatrix > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.render > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setNormalMatrix(const mat4& kMatrix) const {
+void MainShaderManager::render(const MeshBatch* pkMeshBatch, unsigned int drawId,
+	                           const MeshInstances* pkMeshInstances) const {
 	try {
 		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setNormalMatrix(value_ptr(kMatrix));
+		pProgram->render(pkMeshBatch, drawId, pkMeshInstances);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setNormalMatrix > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.render > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setMaterialParameters(Material::ShadingModel shadingModel) const {
+void MainShaderManager::setTessellation(const vec4& kGlobeSphere, const vec2& kViewportSize, float edgeLength,
+	                                    float fixedLevel) const {
 	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setMaterialShadingModel(static_cast<GLuint>(shadingModel));
+		static_cast<MainProgram*>(pCurrentProgram_)->setTessellation(kGlobeSphere, kViewportSize, edgeLength, fixedLevel);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setMaterialParameters > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.setTessellation > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setMaterialParameters(const vec3& kAmbientColor, const vec3& kDiffuseColor,
-	                                          const vec3& kSpecularColor, const vec3& kEmissiveColor) const {
+void MainShaderManager::render(const Planet* pkPlanet, unsigned int drawId) const {
 	try {
 		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-
-		pProgram->setMaterialColor(value_ptr(kAmbientColor), value_ptr(kDiffuseColor), value_ptr(kSpecularColor),
-			                       value_ptr(kEmissiveColor));
+		pProgram->render(pkPlanet, drawId);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setMaterialParameters > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.render > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setMaterialParameters(float shininess, float opacity) const {
-	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
+// the samplers have explicit bindings (the texture units), the frame data is one upload shared by all programs
+void MainShaderManager::setUpProgram_(BaseProgram*) {}
 
-		pProgram->setMaterialShininess(shininess);
-		pProgram->setMaterialOpacity(opacity);	
-	}
-	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setMaterialParameters > " + string(kException.what()));
-	}
+
+
+bool MainShaderManager::fileExists_(const string& kFilePath) {
+	FILE* pFile;
+	fopen_s(&pFile, kFilePath.c_str(), "rb");
+	if (pFile == NULL) return false;
+
+	std::fclose(pFile);
+	return true;
 }
 
 
 
-void MainShaderManager::setDiffuseTexParameters(bool hasTexture, bool compressed) const {
+MainProgram* MainShaderManager::addProgram_(MainProgram::ProgramMode programMode, unsigned int features) {
+	if (programMode < MainProgram::ProgramMode::NO_SHADING || programMode > MainProgram::ProgramMode::GLOBE)
+		throw runtime_error("MainShaderManager.addProgram_|Invalid program mode value.");
+
+	unsigned int key = static_cast<unsigned int>(programMode) | (features << 8u);
+	map<unsigned int, MainProgram*>::const_iterator it = programs_.find(key);
+	if (it != programs_.cend()) return it->second;
+
 	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setDiffuseTexParameters(static_cast<GLuint>(hasTexture), static_cast<GLuint>(compressed));
+		vector<GLuint> constantIndices, constantValues;
+		MainProgram::getFeatureConstants(features, constantIndices, constantValues);
+		BaseShaderManager::addPermutation_(static_cast<BaseProgram::ProgramMode>(programMode),
+			                               static_cast<BaseProgram::ProgramMode>(key),
+			                               MainProgram::getFeatureHeader(features), constantIndices, constantValues);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setDiffuseTexParameters > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.addProgram_ > " + string(kException.what()));
 	}
+
+	MainProgram* pProgram = new MainProgram();
+	programs_[key] = pProgram;
+	requestedPrograms_.push_back(key);
+
+	return pProgram;
 }
 
 
 
-void MainShaderManager::setSpecularTexParameters(bool hasTexture, bool compressed) const {
+MainProgram* MainShaderManager::getProgram_(MainProgram::ProgramMode programMode, unsigned int features) {
 	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setSpecularTexParameters(static_cast<GLuint>(hasTexture), static_cast<GLuint>(compressed));
+		MainProgram* pProgram = addProgram_(programMode, features);
+
+		unsigned int key = static_cast<unsigned int>(programMode) | (features << 8u);
+		list<unsigned int>::iterator iKey = std::find(requestedPrograms_.begin(), requestedPrograms_.end(), key);
+		if (iKey != requestedPrograms_.end()) {
+			requestedPrograms_.erase(iKey);
+			linkPermutation_(key);
+		}
+
+		return pProgram;
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setSpecularTexParameter > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.getProgram_ > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setEmissiveTexParameters(bool hasTexture, bool compressed) const {
+void MainShaderManager::linkPermutation_(unsigned int key) {
+	MainProgram::ProgramMode programMode = static_cast<MainProgram::ProgramMode>(key & 0xFFu);
+	BaseProgram::ProgramMode permutationMode = static_cast<BaseProgram::ProgramMode>(key);
+	MainProgram* pProgram = programs_.at(key);
+
 	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setEmissiveTexParameters(static_cast<GLuint>(hasTexture), static_cast<GLuint>(compressed));
+		// the binary of the program cache, otherwise the shaders are compiled and the linking starts (see 'finishProgram_')
+		string binaryKey = BaseShaderManager::getProgramKey_(permutationMode);
+		if (!pProgram->link(programMode, binaryKey)) {
+			list<GLuint> vertexShaderList, tessControlShaderList, tessEvaluationShaderList, fragmentShaderList;
+			BaseShaderManager::linkProgram_(permutationMode, vertexShaderList, tessControlShaderList, tessEvaluationShaderList,
+				                            fragmentShaderList);
+
+			if (tessEvaluationShaderList.empty())
+				pProgram->link(programMode, vertexShaderList, fragmentShaderList);
+			else pProgram->link(programMode, vertexShaderList, tessControlShaderList, tessEvaluationShaderList,
+				                fragmentShaderList);
+		}
+
+		BaseShaderManager::addPendingProgram_(pProgram, binaryKey);
 	}
 	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setEmissiveTexParameters > " + string(kException.what()));
+		throw runtime_error("MainShaderManager.linkPermutation_ > " + string(kException.what()));
 	}
 }
 
 
 
-void MainShaderManager::setNormalTexParameters(bool hasTexture, bool compressed) const {
-	try {
-		MainProgram* pProgram = static_cast<MainProgram*>(pCurrentProgram_);
-		pProgram->setNormalTexParameters(static_cast<GLuint>(hasTexture), static_cast<GLuint>(compressed));
-	}
-	catch (const exception& kException) {
-		throw runtime_error("MainShaderManager.setNormalTexParameters > " + string(kException.what()));
-	}
+void MainShaderManager::updateFrameData_() const {
+	glBindBuffer(GL_UNIFORM_BUFFER, frameDataUbo_);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FRAME_DATA), &frameData_);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0u);
+
+	GlDebug::countCalls(3u);
 }
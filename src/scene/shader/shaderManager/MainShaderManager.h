@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef MAIN_SHADER_MANAGER_H
@@ -9,44 +9,66 @@
 #include <GL/gl3w.h>
 
 #include "BaseShaderManager.h"
+#include "info/GlDebug.h"
 #include "light/light/BaseLight.h"
 #include "material/Material.h"
-#include "mesh/mesh/Face.h"
+#include "mesh/batch/MeshBatch.h"
+#include "mesh/instance/MeshInstances.h"
+#include "mesh/planet/Planet.h"
 #include "shader/shaderProgram/MainProgram.h"
+#include "state/GlState.h"
 
 #include <glm/mat4x4.hpp>
 #include <glm/trigonometric.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cstdio>
 #include <exception>
 #include <iostream>
 #include <list>
+#include <map>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 using glm::mat4;
 using glm::uvec2;
 using glm::value_ptr;
+using glm::vec2;
 using glm::vec3;
+using glm::vec4;
 
 using std::cout;
 using std::endl;
 using std::exception;
+using std::FILE;
 using std::list;
+using std::map;
 using std::runtime_error;
 using std::string;
+using std::vector;
 
 
 
 class MainShaderManager : public BaseShaderManager {
 public:
+	// defined also in shading.frag ('layout (binding = ...)')
 	static GLint getDiffuseTextureUnit();
 	static GLint getSpecularTextureUnit();
 	static GLint getEmissiveTextureUnit();
 	static GLint getNormalMapTextureUnit();
+	// page tables of the virtual textures (their atlas uses the unit of the texture), see 'VirtualTexture'
+	static GLint getDiffusePageTableUnit();
+	static GLint getSpecularPageTableUnit();
+	static GLint getEmissivePageTableUnit();
+	static GLint getNormalMapPageTableUnit();
+
+	static GLuint getFrameDataBinding(); // uniform buffer binding point of 'FrameBlock'
 
 
 	MainShaderManager(const uvec2& kWindowSize);
@@ -54,9 +76,12 @@ public:
 
 
 	// init: 1) addShaderSourceCode/addVertexShaderSourceCode/addFragmentShaderSourceCode
-	//          (for each programMode: 'NO_SHADING', 'FLAT', 'GOURAUD', 'PHONG', 'NORMAL_MAPPING')
-	//       2) compileShaders
-	//       3) linkProgram (for each programMode: 'NO_SHADING', 'FLAT', 'GOURAUD', 'PHONG', 'NORMAL_MAPPING')
+	//          (for each programMode: 'NO_SHADING', 'FLAT', 'GOURAUD', 'PHONG', 'NORMAL_MAPPING', 'PLANET', 'GLOBE')
+	//          [addTessellationShaderSourceCode] (programMode 'GLOBE')
+	//          [addShaderBinaries] (SPIR-V modules of a programMode, instead of its source code)
+	//       2) [requestProgram] (programMode and 'MainProgram::Feature' bits of each mesh)
+	//       3) compileShaders (the requested permutations, finished by the first 'startProgram' of each)
+	//       4) [getNumLinkingPrograms]
 	//############################################################################
 	void addShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
 		                     const list<string>& kVertexShaderFileList, const string& kVertexShaderHeader,
@@ -65,54 +90,83 @@ public:
 		                           const list<string>& kFileList, const string& kHeader);
 	void addFragmentShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
 		                             const list<string>& kFileList, const string& kHeader);
+	void addTessellationShaderSourceCode(MainProgram::ProgramMode programMode, const string& kPath,
+		                                 const list<string>& kTessControlShaderFileList, const string& kTessControlShaderHeader,
+		                                 const list<string>& kTessEvaluationShaderFileList,
+		                                 const string& kTessEvaluationShaderHeader);
+
+	// '<kModuleName>.vert.spv', '.frag.spv' [, '.tesc.spv', '.tese.spv'] of 'shaders/spirv/build.bat'; the features of
+	// a permutation are then specialization constants; the source code stays in use if SPIR-V is not supported
+	// or a module is missing
+	void addShaderBinaries(MainProgram::ProgramMode programMode, const string& kPath, const string& kModuleName);
 
-	//-> void compileShaders();
-	void linkProgram(MainProgram::ProgramMode programMode);
+	// a permutation is compiled and linked (or loaded from the program cache) once: by the next 'compileShaders' once
+	// requested, otherwise when first started; 'compileShaders' makes no GL state change, so it may run on a worker
+	// thread with a shared context
+	void requestProgram(MainProgram::ProgramMode programMode, unsigned int features);
+	virtual void compileShaders();
+	//-> unsigned int getNumLinkingPrograms() const;
 
 
-	// init: setAttribPointers (for each object 'pMesh')
+	// init: setAttribPointers (for each object 'pMeshBatch' / 'pPlanet')
 	//############################################################################
-	void setAttribPointers(Face* pMesh) const;
+	void setAttribPointers(MeshBatch* pMeshBatch) const;
+	void setAttribPointers(Planet* pPlanet) const;
 
 
 	// set
 	//############################################################################
-	void setShadingParameters(bool ambientLightOn, bool diffuseLightOn, bool specularLightOn, bool emissiveLightOn) const;
-	void setLightEyeDirection(const vec3& kDirection) const;
-	void setLightParameters(const vec3& kAmbientColor, const vec3& kDiffuseColor, const vec3& kSpecularColor) const;
+	void setLightEyeDirection(const vec3& kDirection);
+	void setLightParameters(const vec3& kAmbientColor, const vec3& kDiffuseColor, const vec3& kSpecularColor);
 
 	
-	// render (object 'pkMesh'): 
-	//         1) startProgram (programMode = 'NO_SHADING' / 'FLAT' / 'GOURAUD' / 'PHONG' / 'NORMAL_MAPPING')
-	//         2) [set...Matrix], [setMaterialParameters], [set...TexParameters]
-	//         3) [render]
-	//         4) stopProgram
+	// render (object 'pkMeshBatch' / 'pkPlanet'):
+	//         1) startProgram (programMode = 'NO_SHADING' / 'FLAT' / 'GOURAUD' / 'PHONG' / 'NORMAL_MAPPING' / 'PLANET' / 'GLOBE',
+	//                          'MainProgram::Feature' bits of the material, the mesh and the light)
+	//         2) [render]
+	//         3) stopProgram
 	//############################################################################
-	void startProgram(MainProgram::ProgramMode programMode);
+	void startProgram(MainProgram::ProgramMode programMode, unsigned int features);
 	//-> void stopProgram() const;
 
-	void render(const Face* pkMesh) const;	
-
-	void setModelViewMatrix(const mat4& kMatrix) const;
-	void setModelViewProjectionMatrix(const mat4& kMatrix) const;
-	void setNormalMatrix(const mat4& kMatrix) const;
-
-	void setMaterialParameters(Material::ShadingModel shadingModel) const;
-	void setMaterialParameters(const vec3& kAmbientColor, const vec3& kDiffuseColor,
-		                       const vec3& kSpecularColor, const vec3& kEmissiveColor) const;
-	void setMaterialParameters(float shininess, float opacity) const;
-
-	void setDiffuseTexParameters(bool hasTexture, bool compressed) const;
-	void setSpecularTexParameters(bool hasTexture, bool compressed) const;
-	void setEmissiveTexParameters(bool hasTexture, bool compressed) const;
-	void setNormalTexParameters(bool hasTexture, bool compressed) const;
+	void render(const MeshBatch* pkMeshBatch, unsigned int firstDrawId, unsigned int nDraws) const;
+	// programMode 'NO_SHADING' ... 'NORMAL_MAPPING': visible instances of the mesh 'drawId'
+	void render(const MeshBatch* pkMeshBatch, unsigned int drawId, const MeshInstances* pkMeshInstances) const;
+	// programMode 'GLOBE', see 'MainProgram'
+	void setTessellation(const vec4& kGlobeSphere, const vec2& kViewportSize, float edgeLength, float fixedLevel) const;
+	void render(const Planet* pkPlanet, unsigned int drawId) const; // per-draw data of 'drawId' in the mesh batch
 
 private:
 	MainShaderManager(const MainShaderManager&);
 	const MainShaderManager& operator=(const MainShaderManager&) {}
+
+	virtual void setUpProgram_(BaseProgram* pProgram);
+
+	static bool fileExists_(const string& kFilePath);
+
+	MainProgram* addProgram_(MainProgram::ProgramMode programMode, unsigned int features); // created on first use
+	MainProgram* getProgram_(MainProgram::ProgramMode programMode, unsigned int features); // linking started
+	void linkPermutation_(unsigned int key); // from the program cache, otherwise the shaders are compiled
+
+	void updateFrameData_() const;
+
+	// std140 layout of 'FrameBlock', defined also in structures.glsl
+	struct FRAME_DATA {
+		vec3 lightEyeDirection;
+		GLfloat padding0;
+		vec3 lightAmbientColor;
+		GLfloat padding1;
+		vec3 lightDiffuseColor;
+		GLfloat padding2;
+		vec3 lightSpecularColor;
+		GLfloat padding3;
+	} frameData_;
+
+	GLuint frameDataUbo_;
 	
-	MainProgram* pNoShadingProgram_, * pFlatShadingProgram_, * pGouraudShadingProgram_, 
-		       * pPhongShadingProgram_, * pNormalMappingProgram_;
+	// key: programMode | features << 8, also the 'BaseProgram::ProgramMode' of the shaders of the permutation
+	map<unsigned int, MainProgram*> programs_;
+	list<unsigned int> requestedPrograms_; // keys of the permutations not compiled yet
 };
 
 #endif
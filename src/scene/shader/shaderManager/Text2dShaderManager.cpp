@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Text2dShaderManager.h"
@@ -82,22 +82,24 @@ void Text2dShaderManager::addFragmentShaderSourceCode(Text2dProgram::ProgramMode
 
 void Text2dShaderManager::linkProgram(Text2dProgram::ProgramMode programMode) {
 	try {
-		list<GLuint> vertexShaderList, fragmentShaderList;
-		BaseShaderManager::linkProgram_(static_cast<BaseProgram::ProgramMode>(programMode), vertexShaderList, fragmentShaderList);
-
 		switch (programMode) {
 		case Text2dProgram::ProgramMode::TEXT_2D:
-			pText2dProgram_->link(programMode, vertexShaderList, fragmentShaderList);
 			break;
 		default:
 			return;
 		}
 
-		pText2dProgram_->start();
-		pText2dProgram_->setWindowSize(value_ptr(windowSize_));
+		// the binary of the program cache, otherwise the linking of the shaders starts (see 'finishProgram_')
+		string key = BaseShaderManager::getProgramKey_(static_cast<BaseProgram::ProgramMode>(programMode));
+		if (!pText2dProgram_->link(programMode, key)) {
+			list<GLuint> vertexShaderList, fragmentShaderList;
+			BaseShaderManager::linkProgram_(static_cast<BaseProgram::ProgramMode>(programMode), vertexShaderList,
+				                            fragmentShaderList);
 
-		pText2dProgram_->setTextureUnit(Text2dShaderManager::getTextureUnit());
-		pText2dProgram_->stop();
+			pText2dProgram_->link(programMode, vertexShaderList, fragmentShaderList);
+		}
+
+		BaseShaderManager::addPendingProgram_(pText2dProgram_, key);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Text2dShaderManager.linkProgram > " + string(kException.what()));
@@ -114,6 +116,7 @@ void Text2dShaderManager::setAttribPointers(Text2D* pText2D) const {
 
 void Text2dShaderManager::setWindowSize(const uvec2& kSize) {
 	BaseShaderManager::setWindowSize(kSize);
+	if (BaseShaderManager::isPendingProgram_(pText2dProgram_)) return; // set by 'setUpProgram_'
 
 	try {
 		pText2dProgram_->start();
@@ -136,6 +139,8 @@ void Text2dShaderManager::startProgram(Text2dProgram::ProgramMode programMode) {
 	}
 	
 	try {
+		BaseShaderManager::finishProgram_(pText2dProgram_);
+
 		pText2dProgram_->start();
 	}
 	catch (const exception& kException) {
@@ -164,3 +169,13 @@ void Text2dShaderManager::setTextParameters(bool inverseColor) const {
 		throw runtime_error("Text2dShaderManager.setTextParameters > " + string(kException.what()));
 	}
 }
+
+
+
+void Text2dShaderManager::setUpProgram_(BaseProgram*) {
+	pText2dProgram_->start();
+	pText2dProgram_->setWindowSize(value_ptr(windowSize_));
+
+	pText2dProgram_->setTextureUnit(Text2dShaderManager::getTextureUnit());
+	pText2dProgram_->stop();
+}
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef TEXT2D_SHADER_MANAGER_H
@@ -45,7 +45,8 @@ public:
 
 	// init: 1) addShaderSourceCode/addVertexShaderSourceCode/addFragmentShaderSourceCode (programMode = 'TEXT_2D')
 	//       2) compileShaders
-	//       3) linkProgram (programMode = 'TEXT_2D')
+	//       3) linkProgram (programMode = 'TEXT_2D', finished by the first 'startProgram')
+	//       4) [getNumLinkingPrograms]
 	//############################################################################
 	void addShaderSourceCode(Text2dProgram::ProgramMode programMode, const string& kPath,
 		                     const list<string>& kVertexShaderFileList, const string& kVertexShaderHeader,
@@ -57,6 +58,7 @@ public:
 
 	//-> void compileShaders();
 	void linkProgram(Text2dProgram::ProgramMode programMode);
+	//-> unsigned int getNumLinkingPrograms() const;
 
 
 	// init: setAttribPointers (for each object 'pText2D')
@@ -84,6 +86,8 @@ public:
 private:
 	Text2dShaderManager(const Text2dShaderManager&);
 	const Text2dShaderManager& operator=(const Text2dShaderManager&) {}
+
+	virtual void setUpProgram_(BaseProgram* pProgram); // window size, texture unit
 	
 	Text2dProgram* pText2dProgram_;
 };
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 13, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "BaseProgram.h"
@@ -69,12 +69,35 @@ void BaseProgram::stop() const {
 
 
 
+void BaseProgram::saveBinary(const string& kBinaryKey) const {
+	try {
+		pProgram_->saveBinary(kBinaryKey);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("BaseProgram.saveBinary > " + string(kException.what()));
+	}
+}
+
+
+
 bool BaseProgram::isLinked() const {
 	return pProgram_->isLinked();
 }
 
 
 
+bool BaseProgram::isLinking() const {
+	return pProgram_->isLinking();
+}
+
+
+
+bool BaseProgram::isLinkCompleted() const {
+	return pProgram_->isLinkCompleted();
+}
+
+
+
 bool BaseProgram::isInstalled() const {
 	return pProgram_->isInstalled();
 }
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef BASE_PROGRAM_H
@@ -29,10 +29,17 @@ public:
 
 	virtual ~BaseProgram();	
 
+	// waits for the linking started from the shaders (see 'Program.link'), then queries the locations
+	virtual void finishLinking() = 0;
+
 	virtual void start() const;
 	void stop() const;
 
+	void saveBinary(const string& kBinaryKey) const; // to the program cache, once linked
+
 	bool isLinked() const;
+	bool isLinking() const;
+	bool isLinkCompleted() const; // 'finishLinking' will not wait
 	bool isInstalled() const;
 
 protected:
@@ -1,352 +1,244 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "MainProgram.h"
 
 
 
-MainProgram::MainProgram() : BaseProgram(), shdLight_(), shdMaterial_(), shdScene_(),
-                             shdModelViewMatrix_(-1), shdModelViewProjectionMatrix_(-1), shdNormalMatrix_(-1),
-	                         shdHasDiffuseTexture_(-1), shdHasSpecularTexture_(-1), shdHasEmissiveTexture_(-1), 
-	                         shdHasNormalMapTexture_(-1), shdDiffuseTexSampler_(-1), shdSpecularTexSampler_(-1),
-	                         shdEmissiveTexSampler_(-1), shdNormalMapTexSampler_(-1), shdDiffuseCompressed_(-1),
-	                         shdSpecularCompressed_(-1), shdEmissiveCompressed_(-1), shdNormalMapCompressed_(-1) {
-	//cout << "Main program created." << endl;
-}
-
+const unsigned int MainProgram::kNumFeatures_ = 19u;
 
+const char* const MainProgram::kpFeatureNames_[19u] = {
+	"HAS_DIFFUSE_TEXTURE", "HAS_SPECULAR_TEXTURE", "HAS_EMISSIVE_TEXTURE", "HAS_NORMAL_MAP_TEXTURE", "DIFFUSE_COMPRESSED",
+	"SPECULAR_COMPRESSED", "EMISSIVE_COMPRESSED", "NORMAL_MAP_COMPRESSED", "TWO_SIDED", "AMBIENT_LIGHT_ON", "DIFFUSE_LIGHT_ON",
+	"SPECULAR_LIGHT_ON", "EMISSIVE_LIGHT_ON", "DIFFUSE_VIRTUAL", "SPECULAR_VIRTUAL", "EMISSIVE_VIRTUAL", "NORMAL_MAP_VIRTUAL",
+	"VIRTUAL_TEXTURE_FEEDBACK", "COMPACT_VERTICES" };
 
-MainProgram::~MainProgram() {
-	//cout << "Main program deleted." << endl;
-}
-
-
-
-void MainProgram::link(MainProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList) {
-	try {
-		bindAttribLocations_(programMode);
-		bindOutputLocations_(programMode);
 
-		pProgram_->link(rVertexShaderList, rFragmentShaderList);
 
-		queryUniformLocations_(programMode);
-	}
-	catch (const exception& kException) {
-		throw runtime_error("MainProgram.link > " + string(kException.what()));
-	}
+bool MainProgram::hasFeature(unsigned int features, MainProgram::Feature feature) {
+	return (features & static_cast<unsigned int>(feature)) != 0u;
 }
 
 
 
-void MainProgram::setAttribPointers(Face* pMesh) const {
-	pMesh->setAttribPointers(pProgram_->getId(), BaseProgram::getVerticesAttribLocation_(),
-		                     BaseProgram::getTexCoordsAttribLocation_(), BaseProgram::getNormalsAttribLocation_(),
-		                     BaseProgram::getTangentsAttribLocation_(), BaseProgram::getBitangentsAttribLocation_());
-}
+// the GLSL source declares the features as constants, the SPIR-V modules as specialization constants (see
+// 'getFeatureConstants' and 'shaders/main/structures.glsl')
+string MainProgram::getFeatureHeader(unsigned int features) {
+	string header = "";
+	for (unsigned int i = 0u; i < MainProgram::kNumFeatures_; i++)
+		header += "const bool " + string(MainProgram::kpFeatureNames_[i]) + " = " + ((features >> i) & 1u ? "true" : "false") +
+		          ";\n";
 
-
-
-void MainProgram::start() const {
-	if (pProgram_->isLinked())
-		BaseProgram::start();
-	else throw runtime_error("MainProgram.start|Main program " + to_string(pProgram_->getId()) + " not linked.");
+	return header;
 }
 
 
 
-void MainProgram::render(const Face* pkMesh) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled())
-			try {
-				pkMesh->render(pProgram_->getId());
-			}
-			catch (const exception& kException) {
-				throw runtime_error("MainProgram.render > " + string(kException.what()));
-			}
-		else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
-
+void MainProgram::getFeatureConstants(unsigned int features, vector<GLuint>& rIndices, vector<GLuint>& rValues) {
+	rIndices.clear();
+	rValues.clear();
 
-void MainProgram::setAmbientLightOn(GLuint on) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdScene_.ambientLightOn != -1)
-				pProgram_->setUniformui(shdScene_.ambientLightOn, on);
-		}
-		else throw runtime_error("MainProgram.setAmbientLightOn|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setAmbientLightOn|Main program " + to_string(pProgram_->getId()) + " not linked.");
+	// constant_id = bit of the feature
+	for (unsigned int i = 0u; i < MainProgram::kNumFeatures_; i++) {
+		rIndices.push_back(static_cast<GLuint>(i));
+		rValues.push_back(static_cast<GLuint>((features >> i) & 1u));
+	}
 }
 
 
 
-void MainProgram::setDiffuseLightOn(GLuint on) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdScene_.diffuseLightOn != -1)
-				pProgram_->setUniformui(shdScene_.diffuseLightOn, on);
-		}
-		else throw runtime_error("MainProgram.setDiffuseLightOn|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setDiffuseLightOn|Main program " + to_string(pProgram_->getId()) + " not linked.");
+// the attribute locations are the same in all programs, see 'BaseProgram'
+void MainProgram::setAttribPointers(MeshBatch* pMeshBatch) {
+	pMeshBatch->setAttribPointers(BaseProgram::getVerticesAttribLocation_(), BaseProgram::getTexCoordsAttribLocation_(),
+		                          BaseProgram::getNormalsAttribLocation_(), BaseProgram::getTangentsAttribLocation_(),
+		                          BaseProgram::getBitangentsAttribLocation_());
 }
 
 
 
-void MainProgram::setSpecularLightOn(GLuint on) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdScene_.specularLightOn != -1)
-				pProgram_->setUniformui(shdScene_.specularLightOn, on);
-		}
-		else throw 
-			runtime_error("MainProgram.setSpecularLightOn|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setSpecularLightOn|Main program " + to_string(pProgram_->getId()) + " not linked.");
+void MainProgram::setAttribPointers(Planet* pPlanet) {
+	pPlanet->setAttribPointers(BaseProgram::getVerticesAttribLocation_());
 }
 
 
 
-void MainProgram::setEmissiveLightOn(GLuint on) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdScene_.emissiveLightOn != -1)
-				pProgram_->setUniformui(shdScene_.emissiveLightOn, on);
-		}
-		else throw
-			runtime_error("MainProgram.setEmissiveLightOn|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setEmissiveLightOn|Main program " + to_string(pProgram_->getId()) + " not linked.");
+MainProgram::MainProgram() : BaseProgram(), programMode_(MainProgram::ProgramMode::NO_SHADING),
+	                         primitiveMode_(GL_TRIANGLES),
+	                         shdDrawIdOffset_(-1), shdInstanced_(-1),
+	                         shdGlobeSphere_(-1),
+	                         shdViewportSize_(-1), shdTessellationEdgeLength_(-1), shdFixedTessellationLevel_(-1) {
+	//cout << "Main program created." << endl;
 }
 
 
 
-void MainProgram::setLightEyeDirection(const GLfloat* pkDirection) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdLight_.eDirection != -1)
-				pProgram_->setUniformVector3f(shdLight_.eDirection, pkDirection);
-		}
-		else throw 
-			runtime_error("MainProgram.setLightEyeDirection|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setLightEyeDirection|Main program " + to_string(pProgram_->getId()) + " not linked.");
+MainProgram::~MainProgram() {
+	//cout << "Main program deleted." << endl;
 }
 
 
 
-void MainProgram::setLightColor(const GLfloat* pkAmbient, const GLfloat* pkDiffuse, const GLfloat* pkSpecular) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdLight_.ambientColor != -1)
-				pProgram_->setUniformVector3f(shdLight_.ambientColor, pkAmbient);
-
-			if (shdLight_.diffuseColor != -1)
-				pProgram_->setUniformVector3f(shdLight_.diffuseColor, pkDiffuse);
-
-			if (shdLight_.specularColor != -1)
-				pProgram_->setUniformVector3f(shdLight_.specularColor, pkSpecular);			
-		}
-		else throw runtime_error("MainProgram.setLightColor|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setLightColor|Main program " + to_string(pProgram_->getId()) + " not linked.");
+void MainProgram::link(MainProgram::ProgramMode programMode,
+	                   list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList) {
+	list<GLuint> tessControlShaderList, tessEvaluationShaderList;
+	link(programMode, rVertexShaderList, tessControlShaderList, tessEvaluationShaderList, rFragmentShaderList);
 }
 
 
 
-void MainProgram::setModelViewMatrix(const GLfloat* pkMatrix) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled())
-			pProgram_->setUniformMatrix4f(shdModelViewMatrix_, pkMatrix);
-		
-		else throw 
-			runtime_error("MainProgram.setModelViewMatrix|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setModelViewMatrix|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
+void MainProgram::link(MainProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList,
+	                   list<GLuint>& rTessControlShaderList, list<GLuint>& rTessEvaluationShaderList,
+	                   list<GLuint>& rFragmentShaderList) {
+	try {
+		bindAttribLocations_(programMode);
+		bindOutputLocations_(programMode);
 
+		list<GLuint> geometryShaderList;
+		pProgram_->link(rVertexShaderList, rTessControlShaderList, rTessEvaluationShaderList, geometryShaderList,
+			            rFragmentShaderList);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("MainProgram.link > " + string(kException.what()));
+	}
 
-void MainProgram::setModelViewProjectionMatrix(const GLfloat* pkMatrix) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled())
-			pProgram_->setUniformMatrix4f(shdModelViewProjectionMatrix_, pkMatrix);
-		
-		else throw runtime_error
-		          ("MainProgram.setModelViewProjectionMatrix|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error
-	              ("MainProgram.setModelViewProjectionMatrix|Main program " + to_string(pProgram_->getId()) + " not linked.");
+	programMode_ = programMode;
+	primitiveMode_ = rTessEvaluationShaderList.empty() ? GL_TRIANGLES : GL_PATCHES;
+	setUniformLocations_(programMode);
 }
 
 
 
-void MainProgram::setNormalMatrix(const GLfloat* pkMatrix) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled())
-			pProgram_->setUniformMatrix4f(shdNormalMatrix_, pkMatrix);
-		
-		else throw runtime_error("MainProgram.setNormalMatrix|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setNormalMatrix|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
+bool MainProgram::link(MainProgram::ProgramMode programMode, const string& kBinaryKey) {
+	try {
+		bindAttribLocations_(programMode);
+		bindOutputLocations_(programMode);
 
+		if (!pProgram_->link(kBinaryKey)) return false;
+	}
+	catch (const exception& kException) {
+		throw runtime_error("MainProgram.link > " + string(kException.what()));
+	}
 
-void MainProgram::setMaterialShadingModel(GLuint shadingModel) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdMaterial_.shadingModel != -1)
-				pProgram_->setUniformui(shdMaterial_.shadingModel, shadingModel);
-		}
-		else throw 
-			runtime_error("MainProgram.setMaterialShadingModel|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setMaterialShadingModel|Main program " + to_string(pProgram_->getId()) + " not linked.");
+	programMode_ = programMode;
+	primitiveMode_ = programMode == MainProgram::ProgramMode::GLOBE ? GL_PATCHES : GL_TRIANGLES;
+	setUniformLocations_(programMode);
+	return true;
 }
 
 
 
-void MainProgram::setMaterialColor(const GLfloat* pkAmbient, const GLfloat* pkDiffuse, 
-	                               const GLfloat* pkSpecular, const GLfloat* pkEmissive) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			pProgram_->setUniformVector3f(shdMaterial_.diffuseColor, pkDiffuse);
-
-			if (shdMaterial_.ambientColor != -1)
-				pProgram_->setUniformVector3f(shdMaterial_.ambientColor, pkAmbient);
-
-			if (shdMaterial_.specularColor != -1)
-				pProgram_->setUniformVector3f(shdMaterial_.specularColor, pkSpecular);
-
-			if (shdMaterial_.emissiveColor != -1)
-				pProgram_->setUniformVector3f(shdMaterial_.emissiveColor, pkEmissive);
-		}
-		else throw runtime_error("MainProgram.setMaterialColor|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setMaterialColor|Main program " + to_string(pProgram_->getId()) + " not linked.");
+void MainProgram::finishLinking() {
+	try {
+		pProgram_->finishLinking();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("MainProgram.finishLinking > " + string(kException.what()));
+	}
 }
 
 
 
-void MainProgram::setMaterialShininess(GLfloat shininess) const {
+void MainProgram::start() const {
 	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdMaterial_.shininess != -1)
-				pProgram_->setUniformf(shdMaterial_.shininess, shininess);
-		}
-		else throw 
-			runtime_error("MainProgram.setMaterialShininess|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setMaterialShininess|Main program " + to_string(pProgram_->getId()) + " not linked.");
+		BaseProgram::start();
+	else throw runtime_error("MainProgram.start|Main program " + to_string(pProgram_->getId()) + " not linked.");
 }
 
 
 
-void MainProgram::setMaterialOpacity(GLfloat opacity) const {
+void MainProgram::render(const MeshBatch* pkMeshBatch, unsigned int firstDrawId, unsigned int nDraws) const {
 	if (pProgram_->isLinked())
 		if (pProgram_->isInstalled())
-			pProgram_->setUniformf(shdMaterial_.opacity, opacity);
-		
-		else throw 
-			runtime_error("MainProgram.setMaterialOpacity|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setMaterialOpacity|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
-
-
-void MainProgram::setDiffuseTexParameters(GLuint hasTexture, GLuint compressed) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			pProgram_->setUniformui(shdHasDiffuseTexture_, hasTexture);
-			pProgram_->setUniformui(shdDiffuseCompressed_, compressed);
-		}
-		else throw 
-			runtime_error("MainProgram.setDiffuseTexParameters|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setDiffuseTexParameters|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
-
-
-void MainProgram::setSpecularTexParameters(GLuint hasTexture, GLuint compressed) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			pProgram_->setUniformui(shdHasSpecularTexture_, hasTexture);
-			pProgram_->setUniformui(shdSpecularCompressed_, compressed);
-		}
-		else throw 
-			runtime_error("MainProgram.setSpecularTexParameters|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setSpecularTexParameters|Main program " + to_string(pProgram_->getId()) + " not linked.");
+			try {
+				// a call for each run of draws with the same index type, gl_DrawID restarts at 0
+				for (unsigned int drawId = firstDrawId; drawId < firstDrawId + nDraws; ) {
+					unsigned int nRenderedDraws = pkMeshBatch->getNumRenderedDraws(drawId, firstDrawId + nDraws - drawId);
+					if (nRenderedDraws == 0u) nRenderedDraws = firstDrawId + nDraws - drawId; // invalid, see 'render'
+
+					pProgram_->setUniformui(shdDrawIdOffset_, static_cast<GLuint>(drawId));
+					pkMeshBatch->render(drawId, nRenderedDraws, primitiveMode_);
+					drawId += nRenderedDraws;
+				}
+			}
+			catch (const exception& kException) {
+				throw runtime_error("MainProgram.render > " + string(kException.what()));
+			}
+		else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not installed.");
+	else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not linked.");
 }
 
 
 
-void MainProgram::setEmissiveTexParameters(GLuint hasTexture, GLuint compressed) const {
+void MainProgram::render(const MeshBatch* pkMeshBatch, unsigned int drawId, const MeshInstances* pkMeshInstances) const {
 	if (pProgram_->isLinked())
 		if (pProgram_->isInstalled()) {
-			pProgram_->setUniformui(shdHasEmissiveTexture_, hasTexture);
-			pProgram_->setUniformui(shdEmissiveCompressed_, compressed);
-		}
-		else throw 
-			runtime_error("MainProgram.setEmissiveTexParameters|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setEmissiveTexParameters|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
+			if (shdInstanced_ == -1)
+				throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " without instancing.");
 
+			try {
+				pProgram_->setUniformui(shdDrawIdOffset_, static_cast<GLuint>(drawId));
+				pProgram_->setUniformui(shdInstanced_, 1u);
 
-void MainProgram::setNormalTexParameters(GLuint hasTexture, GLuint compressed) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled()) {
-			if (shdHasNormalMapTexture_ != -1)
-				pProgram_->setUniformui(shdHasNormalMapTexture_, hasTexture);
+				pkMeshInstances->bindBuffers();
+				pkMeshBatch->renderInstanced(drawId, pkMeshInstances->getNumVisibleInstances(), primitiveMode_);
 
-			if (shdNormalMapCompressed_ != -1)
-				pProgram_->setUniformui(shdNormalMapCompressed_, compressed);
+				pProgram_->setUniformui(shdInstanced_, 0u);
+			}
+			catch (const exception& kException) {
+				throw runtime_error("MainProgram.render > " + string(kException.what()));
+			}
 		}
-		else throw 
-			runtime_error("MainProgram.setNormalTexParameters|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setNormalTexParameters|Main program " + to_string(pProgram_->getId()) + " not linked.");
-}
-
-
-
-void MainProgram::setDiffuseTextureUnit(GLint textureUnit) const {
-	if (pProgram_->isLinked())
-		if (pProgram_->isInstalled())
-			pProgram_->setUniformi(shdDiffuseTexSampler_, textureUnit);
-		
-		else throw 
-			runtime_error("MainProgram.setDiffuseTextureUnit|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setDiffuseTextureUnit|Main program " + to_string(pProgram_->getId()) + " not linked.");
+		else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not installed.");
+	else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not linked.");
 }
 
 
 
-void MainProgram::setSpecularTextureUnit(GLint textureUnit) const {
+void MainProgram::render(const Planet* pkPlanet, unsigned int drawId) const {
 	if (pProgram_->isLinked())
 		if (pProgram_->isInstalled())
-			pProgram_->setUniformi(shdSpecularTexSampler_, textureUnit);
-		
-		else throw 
-			runtime_error("MainProgram.setSpecularTextureUnit|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setSpecularTextureUnit|Main program " + to_string(pProgram_->getId()) + " not linked.");
+			try {
+				pProgram_->setUniformui(shdDrawIdOffset_, static_cast<GLuint>(drawId));
+				pkPlanet->render();
+			}
+			catch (const exception& kException) {
+				throw runtime_error("MainProgram.render > " + string(kException.what()));
+			}
+		else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not installed.");
+	else throw runtime_error("MainProgram.render|Main program " + to_string(pProgram_->getId()) + " not linked.");
 }
 
 
 
-void MainProgram::setEmissiveTextureUnit(GLint textureUnit) const {
+void MainProgram::setDrawIdOffset(GLuint offset) const {
 	if (pProgram_->isLinked())
 		if (pProgram_->isInstalled())
-			pProgram_->setUniformi(shdEmissiveTexSampler_, textureUnit);
+			pProgram_->setUniformui(shdDrawIdOffset_, offset);
 		
-		else throw 
-			runtime_error("MainProgram.setEmissiveTextureUnit|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setEmissiveTextureUnit|Main program " + to_string(pProgram_->getId()) + " not linked.");
+		else throw runtime_error("MainProgram.setDrawIdOffset|Main program " + to_string(pProgram_->getId()) + " not installed.");
+	else throw runtime_error("MainProgram.setDrawIdOffset|Main program " + to_string(pProgram_->getId()) + " not linked.");
 }
 
 
 
-void MainProgram::setNormalMapTextureUnit(GLint textureUnit) const {
+void MainProgram::setTessellation(const vec4& kGlobeSphere, const vec2& kViewportSize, float edgeLength,
+	                              float fixedLevel) const {
 	if (pProgram_->isLinked())
 		if (pProgram_->isInstalled()) {
-			if (shdNormalMapTexSampler_ != -1)
-				pProgram_->setUniformi(shdNormalMapTexSampler_, textureUnit);
+			if (shdGlobeSphere_ == -1)
+				throw runtime_error("MainProgram.setTessellation|Main program " + to_string(pProgram_->getId()) +
+					                " without tessellation.");
+
+			pProgram_->setUniformVector4f(shdGlobeSphere_, value_ptr(kGlobeSphere));
+			pProgram_->setUniformVector2f(shdViewportSize_, value_ptr(kViewportSize));
+			pProgram_->setUniformf(shdTessellationEdgeLength_, edgeLength);
+			pProgram_->setUniformf(shdFixedTessellationLevel_, fixedLevel);
 		}
 		else throw
-			runtime_error("MainProgram.setNormalMapTextureUnit|Main program " + to_string(pProgram_->getId()) + " not installed.");
-	else throw runtime_error("MainProgram.setNormalMapTextureUnit|Main program " + to_string(pProgram_->getId()) + " not linked.");
+			runtime_error("MainProgram.setTessellation|Main program " + to_string(pProgram_->getId()) + " not installed.");
+	else throw runtime_error("MainProgram.setTessellation|Main program " + to_string(pProgram_->getId()) + " not linked.");
 }
 
 
@@ -365,8 +257,13 @@ void MainProgram::bindAttribLocations_(MainProgram::ProgramMode programMode) {
 			break;
 
 		case MainProgram::ProgramMode::NORMAL_MAPPING:
+		case MainProgram::ProgramMode::GLOBE:
 			pProgram_->setAttribLocation("mTangent", BaseProgram::getTangentsAttribLocation_());
 			pProgram_->setAttribLocation("mBitangent", BaseProgram::getBitangentsAttribLocation_());
+			break;
+
+		case MainProgram::ProgramMode::PLANET: // the other attributes are computed in the vertex shader
+			pProgram_->setAttribLocation("mGridPosition", BaseProgram::getVerticesAttribLocation_());
 		}
 	}
 	catch (const exception& kException) {
@@ -387,68 +284,30 @@ void MainProgram::bindOutputLocations_(MainProgram::ProgramMode) {
 
 
 
-void MainProgram::queryUniformLocations_(MainProgram::ProgramMode programMode) {
-	try {
-		shdLight_ = { -1, -1, -1, -1 };
-		shdMaterial_ = { -1, -1, -1, -1, -1, -1, -1 };
-		shdScene_ = { -1, -1, -1, -1 };
-
-		shdHasNormalMapTexture_ = shdNormalMapTexSampler_ = shdNormalMapCompressed_ = -1;
-		
-		shdMaterial_.opacity = pProgram_->getUniformLocation("material.opacity");
-
-		shdModelViewMatrix_ = pProgram_->getUniformLocation("modelViewMatrix");
-		shdModelViewProjectionMatrix_ = pProgram_->getUniformLocation("modelViewProjectionMatrix");
-		shdNormalMatrix_ = pProgram_->getUniformLocation("normalMatrix");
-
-		shdHasDiffuseTexture_ = pProgram_->getUniformLocation("hasDiffuseTexture");
-		shdHasSpecularTexture_ = pProgram_->getUniformLocation("hasSpecularTexture");
-		shdHasEmissiveTexture_ = pProgram_->getUniformLocation("hasEmissiveTexture");
-
-		shdDiffuseTexSampler_ = pProgram_->getUniformLocation("diffuseTexSampler");
-		shdSpecularTexSampler_ = pProgram_->getUniformLocation("specularTexSampler");
-		shdEmissiveTexSampler_ = pProgram_->getUniformLocation("emissiveTexSampler");
-
-		shdDiffuseCompressed_ = pProgram_->getUniformLocation("diffuseCompressed");
-		shdSpecularCompressed_ = pProgram_->getUniformLocation("specularCompressed");
-		shdEmissiveCompressed_ = pProgram_->getUniformLocation("emissiveCompressed");
-
-		switch (programMode) {
-		case MainProgram::ProgramMode::NORMAL_MAPPING:
-			shdHasNormalMapTexture_ = pProgram_->getUniformLocation("hasNormalMapTexture");
-			shdNormalMapTexSampler_ = pProgram_->getUniformLocation("normalMapTexSampler");
-			shdNormalMapCompressed_ = pProgram_->getUniformLocation("normalMapCompressed");
-
-		case MainProgram::ProgramMode::PHONG:
-		case MainProgram::ProgramMode::GOURAUD:
-		case MainProgram::ProgramMode::FLAT:
-			shdMaterial_.ambientColor = pProgram_->getUniformLocation("material.ambientColor");
-			shdMaterial_.specularColor = pProgram_->getUniformLocation("material.specularColor");
-			shdMaterial_.emissiveColor = pProgram_->getUniformLocation("material.emissiveColor");
-			shdMaterial_.shininess = pProgram_->getUniformLocation("material.shininess");
-
-			shdScene_.ambientLightOn = pProgram_->getUniformLocation("scene.ambientLightOn");
-			shdScene_.diffuseLightOn = pProgram_->getUniformLocation("scene.diffuseLightOn");
-			shdScene_.specularLightOn = pProgram_->getUniformLocation("scene.specularLightOn");
-			shdScene_.emissiveLightOn = pProgram_->getUniformLocation("scene.emissiveLightOn");
-
-			{
-				string name = "light.eDirection";
-				shdLight_.eDirection = pProgram_->getUniformLocation(name.c_str());
-				name = "light.ambientColor";
-				shdLight_.ambientColor = pProgram_->getUniformLocation(name.c_str());
-				name = "light.diffuseColor";
-				shdLight_.diffuseColor = pProgram_->getUniformLocation(name.c_str());
-				name = "light.specularColor";
-				shdLight_.specularColor = pProgram_->getUniformLocation(name.c_str());
-			}
-
-		case MainProgram::ProgramMode::NO_SHADING:
-			shdMaterial_.shadingModel = pProgram_->getUniformLocation("material.shadingModel");
-			shdMaterial_.diffuseColor = pProgram_->getUniformLocation("material.diffuseColor");
-		}
-	}
-	catch (const exception& kException) {
-		throw runtime_error("MainProgram.queryUniformLocations_ > " + string(kException.what()));
+// explicit locations (layout (location = ...) in 'shaders/main'), the SPIR-V modules have no uniform names;
+// the samplers have explicit bindings, the texture units of 'MainShaderManager'
+void MainProgram::setUniformLocations_(MainProgram::ProgramMode programMode) {
+	shdDrawIdOffset_ = 0; // structures.glsl
+	shdInstanced_ = -1;
+	shdViewportSize_ = shdTessellationEdgeLength_ = shdFixedTessellationLevel_ = shdGlobeSphere_ = -1;
+
+	switch (programMode) {
+	case MainProgram::ProgramMode::GLOBE: // globe.tesc, globe.tese
+		shdViewportSize_ = 2;
+		shdTessellationEdgeLength_ = 3;
+		shdFixedTessellationLevel_ = 4;
+		shdGlobeSphere_ = 5;
+		break;
+
+	case MainProgram::ProgramMode::PLANET:
+		break;
+
+	case MainProgram::ProgramMode::NORMAL_MAPPING:
+	case MainProgram::ProgramMode::PHONG:
+	case MainProgram::ProgramMode::GOURAUD:
+	case MainProgram::ProgramMode::FLAT:
+	case MainProgram::ProgramMode::NO_SHADING:
+		shdInstanced_ = 1; // scene.vert
+		break;
 	}
 }
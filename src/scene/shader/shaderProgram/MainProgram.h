@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef MAIN_PROGRAM_H
@@ -10,13 +10,25 @@
 
 #include "BaseProgram.h"
 #include "light/light/BaseLight.h"
-#include "mesh/mesh/Face.h"
+#include "mesh/batch/MeshBatch.h"
+#include "mesh/instance/MeshInstances.h"
+#include "mesh/planet/Planet.h"
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
 
 #include <exception>
 #include <iostream>
 #include <list>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+using glm::value_ptr;
+using glm::vec2;
+using glm::vec4;
 
 using std::cout;
 using std::endl;
@@ -25,98 +37,92 @@ using std::list;
 using std::runtime_error;
 using std::string;
 using std::to_string;
+using std::vector;
 
 
 
 class MainProgram : public BaseProgram {
 public:
-	enum class ProgramMode { NO_SHADING = 1u, FLAT = 2u, GOURAUD = 3u, PHONG = 4u, NORMAL_MAPPING = 5u };
+	enum class ProgramMode { NO_SHADING = 1u, FLAT = 2u, GOURAUD = 3u, PHONG = 4u, NORMAL_MAPPING = 5u, PLANET = 6u,
+	                        GLOBE = 7u };
+
+	// compile-time features of a program permutation, one bit each: 'getFeatureHeader' turns them into constants of the
+	// GLSL source, 'getFeatureConstants' into the specialization constants of the SPIR-V modules (constant_id = bit),
+	// so the shaders have no branches on the material textures or the light switches (see 'shaders/main')
+	enum class Feature { DIFFUSE_TEXTURE = 0x1u, SPECULAR_TEXTURE = 0x2u, EMISSIVE_TEXTURE = 0x4u,
+	                     NORMAL_MAP_TEXTURE = 0x8u, DIFFUSE_COMPRESSED = 0x10u, SPECULAR_COMPRESSED = 0x20u,
+	                     EMISSIVE_COMPRESSED = 0x40u, NORMAL_MAP_COMPRESSED = 0x80u, TWO_SIDED = 0x100u,
+	                     AMBIENT_LIGHT = 0x200u, DIFFUSE_LIGHT = 0x400u, SPECULAR_LIGHT = 0x800u,
+	                     EMISSIVE_LIGHT = 0x1000u, DIFFUSE_VIRTUAL = 0x2000u, SPECULAR_VIRTUAL = 0x4000u,
+	                     EMISSIVE_VIRTUAL = 0x8000u, NORMAL_MAP_VIRTUAL = 0x10000u, VIRTUAL_TEXTURE_FEEDBACK = 0x20000u,
+	                     COMPACT_VERTICES = 0x40000u }; // see 'MeshBatch.setCompactVertices'
+
+	static bool hasFeature(unsigned int features, MainProgram::Feature feature);
+	static string getFeatureHeader(unsigned int features);
+	static void getFeatureConstants(unsigned int features, vector<GLuint>& rIndices, vector<GLuint>& rValues);
+
+	static void setAttribPointers(MeshBatch* pMeshBatch);
+	static void setAttribPointers(Planet* pPlanet);
 
 
 	MainProgram();
 	virtual ~MainProgram();
 
 
-	// init: link, setAttribPointers (for each object 'pMesh')
+	// init: link (shaders, then finishLinking) or link (program cache), setAttribPointers (mesh batch, planet)
 	//############################################################################
 	void link(MainProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList);
+	void link(MainProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList,
+		      list<GLuint>& rTessControlShaderList, list<GLuint>& rTessEvaluationShaderList,
+		      list<GLuint>& rFragmentShaderList);
+	// false -> not in the program cache
+	bool link(MainProgram::ProgramMode programMode, const string& kBinaryKey);
 
-	void setAttribPointers(Face* pMesh) const;	
+	virtual void finishLinking(); // after 'link' (shaders)
 
 		
-	// render (object 'pkMesh'): 1) start
-	//                           2) [set...]
-	//                           3) [render]
-	//                           4) stop
+	// render (mesh batch, planet): 1) start
+	//                                2) [set...]
+	//                                3) [render]
+	//                                4) stop
 	//############################################################################
 	virtual void start() const;
 	//-> void stop() const;
 
-	void render(const Face* pkMesh) const;
-
-	void setAmbientLightOn(GLuint on) const;
-	void setDiffuseLightOn(GLuint on) const;
-	void setSpecularLightOn(GLuint on) const;
-	void setEmissiveLightOn(GLuint on) const;
+	void render(const MeshBatch* pkMeshBatch, unsigned int firstDrawId, unsigned int nDraws) const;
+	void render(const MeshBatch* pkMeshBatch, unsigned int drawId, const MeshInstances* pkMeshInstances) const;
+	void render(const Planet* pkPlanet, unsigned int drawId) const;
 
-	void setLightEyeDirection(const GLfloat* pkDirection) const;
-	void setLightColor(const GLfloat* pkAmbient, const GLfloat* pkDiffuse, const GLfloat* pkSpecular) const;
+	void setDrawIdOffset(GLuint offset) const;
 
-	void setModelViewMatrix(const GLfloat* pkMatrix) const;
-	void setModelViewProjectionMatrix(const GLfloat* pkMatrix) const;
-	void setNormalMatrix(const GLfloat* pkMatrix) const;
-
-	void setMaterialShadingModel(GLuint shadingModel) const;
-	void setMaterialColor(const GLfloat* pkAmbient, const GLfloat* pkDiffuse,
-		                  const GLfloat* pkSpecular, const GLfloat* pkEmissive) const;
-	void setMaterialShininess(GLfloat shininess) const;
-	void setMaterialOpacity(GLfloat opacity) const;
-
-	void setDiffuseTexParameters(GLuint hasTexture, GLuint compressed) const;
-	void setSpecularTexParameters(GLuint hasTexture, GLuint compressed) const;
-	void setEmissiveTexParameters(GLuint hasTexture, GLuint compressed) const;
-	void setNormalTexParameters(GLuint hasTexture, GLuint compressed) const;
-
-	void setDiffuseTextureUnit(GLint textureUnit) const;
-	void setSpecularTextureUnit(GLint textureUnit) const;
-	void setEmissiveTextureUnit(GLint textureUnit) const;
-	void setNormalMapTextureUnit(GLint textureUnit) const;
+	// 'GLOBE': sphere (center, radius) in object space; 'fixedLevel' = 0 -> levels from the projected edge length (pixels)
+	void setTessellation(const vec4& kGlobeSphere, const vec2& kViewportSize, float edgeLength, float fixedLevel) const;
 
 
 	// get
 	//############################################################################
 	//-> bool isLinked() const;
+	//-> bool isLinking() const;
+	//-> bool isLinkCompleted() const;
 	//-> bool isInstalled() const;
 
 private:
+	static const unsigned int kNumFeatures_;
+	static const char* const kpFeatureNames_[19u]; // in the order of the bits, see 'shaders/main/structures.glsl'
+
 	MainProgram(const MainProgram&);
 	const MainProgram& operator=(const MainProgram&) {}
 
 	void bindAttribLocations_(MainProgram::ProgramMode programMode);
 	void bindOutputLocations_(MainProgram::ProgramMode programMode);
-	void queryUniformLocations_(MainProgram::ProgramMode programMode);
-
-	struct SHD_LIGHT {
-		GLint eDirection = -1;
-		GLint ambientColor = -1, diffuseColor = -1, specularColor = -1;
-	} shdLight_;
-
-	struct SHD_MATERIAL {
-		GLint shadingModel = -1;
-		GLint ambientColor = -1, diffuseColor = -1, specularColor = -1, emissiveColor = -1;
-		GLint shininess = -1;
-		GLint opacity = -1;
-	} shdMaterial_;
+	void setUniformLocations_(MainProgram::ProgramMode programMode);
 
-	struct SHD_SCENE {
-		GLint ambientLightOn = -1, diffuseLightOn = -1, specularLightOn = -1, emissiveLightOn = -1;	
-	} shdScene_;
+	MainProgram::ProgramMode programMode_; // last linked
 
-	GLint shdModelViewMatrix_, shdModelViewProjectionMatrix_, shdNormalMatrix_;
+	GLenum primitiveMode_; // GL_PATCHES in 'GLOBE' mode
 
-	GLint shdHasDiffuseTexture_, shdHasSpecularTexture_, shdHasEmissiveTexture_, shdHasNormalMapTexture_;
-	GLint shdDiffuseTexSampler_, shdSpecularTexSampler_, shdEmissiveTexSampler_, shdNormalMapTexSampler_;
-	GLint shdDiffuseCompressed_, shdSpecularCompressed_, shdEmissiveCompressed_, shdNormalMapCompressed_;
+	GLint shdDrawIdOffset_, shdInstanced_;
+	GLint shdGlobeSphere_, shdViewportSize_, shdTessellationEdgeLength_, shdFixedTessellationLevel_;
 };
 
 #endif
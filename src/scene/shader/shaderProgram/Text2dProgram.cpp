@@ -1,13 +1,14 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "Text2dProgram.h"
 
 
 
-Text2dProgram::Text2dProgram(): BaseProgram(), shdWindowSize_(-1), shdInverseColor_(-1), shdTexSampler_(-1)  {
+Text2dProgram::Text2dProgram(): BaseProgram(), programMode_(Text2dProgram::ProgramMode::TEXT_2D),
+                                shdWindowSize_(-1), shdInverseColor_(-1), shdTexSampler_(-1)  {
 	//cout << "Text 2D program created." << endl;
 }
 
@@ -26,12 +27,44 @@ void Text2dProgram::link(Text2dProgram::ProgramMode programMode,
 		bindOutputLocations_(programMode);
 
 		pProgram_->link(rVertexShaderList, rFragmentShaderList);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Text2dProgram.link > " + string(kException.what()));
+	}
+
+	programMode_ = programMode;
+}
+
+
+
+bool Text2dProgram::link(Text2dProgram::ProgramMode programMode, const string& kBinaryKey) {
+	try {
+		bindAttribLocations_(programMode);
+		bindOutputLocations_(programMode);
+
+		if (!pProgram_->link(kBinaryKey)) return false;
 
 		queryUniformLocations_(programMode);
 	}
 	catch (const exception& kException) {
 		throw runtime_error("Text2dProgram.link > " + string(kException.what()));
 	}
+
+	programMode_ = programMode;
+	return true;
+}
+
+
+
+void Text2dProgram::finishLinking() {
+	try {
+		pProgram_->finishLinking();
+
+		queryUniformLocations_(programMode_);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("Text2dProgram.finishLinking > " + string(kException.what()));
+	}
 }
 
 
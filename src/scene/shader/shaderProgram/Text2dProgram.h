@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Jan 14, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef TEXT_2D_PROGRAM_H
@@ -36,9 +36,12 @@ public:
 	virtual ~Text2dProgram();
 
 
-	// init: link, setAttribPointers (for each object 'pText2D')
+	// init: link (shaders, then finishLinking) or link (program cache), setAttribPointers (for each object 'pText2D')
 	//############################################################################
 	void link(Text2dProgram::ProgramMode programMode, list<GLuint>& rVertexShaderList, list<GLuint>& rFragmentShaderList);
+	bool link(Text2dProgram::ProgramMode programMode, const string& kBinaryKey); // false -> not in the program cache
+
+	virtual void finishLinking(); // after 'link' (shaders)
 
 	void setAttribPointers(Text2D* pText2D) const;
 		
@@ -63,6 +66,8 @@ public:
 	// get
 	//############################################################################
 	//-> bool isLinked() const;
+	//-> bool isLinking() const;
+	//-> bool isLinkCompleted() const;
 	//-> bool isInstalled() const;
 
 private:
@@ -73,6 +78,8 @@ private:
 	void bindOutputLocations_(Text2dProgram::ProgramMode programMode);
 	void queryUniformLocations_(Text2dProgram::ProgramMode programMode);
 
+	Text2dProgram::ProgramMode programMode_; // last linked
+
 	GLint shdWindowSize_, shdInverseColor_, shdTexSampler_;
 };
 
@@ -0,0 +1,283 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "GlState.h"
+
+
+
+GLint GlState::maxCombinedTextureImageUnits_ = 0, GlState::maxDrawBuffers_ = 0, GlState::maxTextureSize_ = 0;
+GLint GlState::maxVertexAttribs_ = 0;
+int GlState::parallelShaderCompile_ = -1, GlState::spirvShaders_ = -1;
+
+// initial values are the GL defaults of a new context
+GLuint GlState::program_ = 0u, GlState::vao_ = 0u, GlState::activeTextureUnit_ = 0u;
+vector<GLuint> GlState::textures_;
+
+bool GlState::blend_ = false, GlState::cullFace_ = false, GlState::depthTest_ = false;
+GLenum GlState::blendSourceFactor_ = GL_ONE, GlState::blendDestinationFactor_ = GL_ZERO;
+GLenum GlState::cullFaceMode_ = GL_BACK, GlState::depthFunction_ = GL_LESS, GlState::polygonMode_ = GL_FILL;
+GLint GlState::patchVertices_ = 3;
+
+
+
+GLint GlState::getMaxCombinedTextureImageUnits() {
+	if (GlState::maxCombinedTextureImageUnits_ == 0)
+		glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &GlState::maxCombinedTextureImageUnits_);
+
+	return GlState::maxCombinedTextureImageUnits_;
+}
+
+
+
+GLint GlState::getMaxDrawBuffers() {
+	if (GlState::maxDrawBuffers_ == 0)
+		glGetIntegerv(GL_MAX_DRAW_BUFFERS, &GlState::maxDrawBuffers_);
+
+	return GlState::maxDrawBuffers_;
+}
+
+
+
+GLint GlState::getMaxTextureSize() {
+	if (GlState::maxTextureSize_ == 0)
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &GlState::maxTextureSize_);
+
+	return GlState::maxTextureSize_;
+}
+
+
+
+GLint GlState::getMaxVertexAttribs() {
+	if (GlState::maxVertexAttribs_ == 0)
+		glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &GlState::maxVertexAttribs_);
+
+	return GlState::maxVertexAttribs_;
+}
+
+
+
+bool GlState::hasParallelShaderCompile() {
+	if (GlState::parallelShaderCompile_ == -1) {
+		GlState::parallelShaderCompile_ = 0;
+
+		// not part of the core profile loaded by gl3w
+		PFNGLMAXSHADERCOMPILERTHREADSKHRPROC pMaxShaderCompilerThreads = nullptr;
+
+		GLint nExtensions = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &nExtensions);
+		for (GLint i = 0; i < nExtensions && !pMaxShaderCompilerThreads; i++) {
+			const char* pkName = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+			if (!pkName) continue;
+
+			if (std::strcmp(pkName, "GL_KHR_parallel_shader_compile") == 0)
+				pMaxShaderCompilerThreads =
+					reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(gl3wGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+			else if (std::strcmp(pkName, "GL_ARB_parallel_shader_compile") == 0)
+				pMaxShaderCompilerThreads =
+					reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(gl3wGetProcAddress("glMaxShaderCompilerThreadsARB"));
+		}
+
+		if (pMaxShaderCompilerThreads) {
+			pMaxShaderCompilerThreads(0xFFFFFFFFu); // implementation-dependent maximum
+			GlState::parallelShaderCompile_ = 1;
+		}
+	}
+
+	return GlState::parallelShaderCompile_ == 1;
+}
+
+
+
+bool GlState::hasSpirvShaders() {
+	if (GlState::spirvShaders_ == -1) {
+		GlState::spirvShaders_ = 0;
+
+		GLint nFormats = 0;
+		glGetIntegerv(GL_NUM_SHADER_BINARY_FORMATS, &nFormats);
+		if (nFormats > 0) {
+			vector<GLint> formats(static_cast<size_t>(nFormats));
+			glGetIntegerv(GL_SHADER_BINARY_FORMATS, formats.data());
+
+			for (GLint iFormat : formats)
+				if (iFormat == GL_SHADER_BINARY_FORMAT_SPIR_V) GlState::spirvShaders_ = 1;
+		}
+	}
+
+	return GlState::spirvShaders_ == 1;
+}
+
+
+
+void GlState::useProgram(GLuint program) {
+	if (GlState::changes_(GlState::program_ != program)) {
+		glUseProgram(program);
+		GlState::program_ = program;
+	}
+}
+
+
+
+void GlState::bindVertexArray(GLuint vao) {
+	if (GlState::changes_(GlState::vao_ != vao)) {
+		glBindVertexArray(vao);
+		GlState::vao_ = vao;
+	}
+}
+
+
+
+void GlState::bindTexture(GLuint textureUnit, GLuint texture) {
+	if (GlState::textures_.empty())
+		GlState::textures_.assign(static_cast<size_t>(GlState::getMaxCombinedTextureImageUnits()), 0u);
+
+	if (textureUnit >= GlState::textures_.size()) throw runtime_error("GlState.bindTexture|Invalid texture unit value.");
+
+	if (GlState::changes_(GlState::textures_.at(textureUnit) != texture)) {
+		GlState::setActiveTexture_(textureUnit);
+
+		glBindTexture(GL_TEXTURE_2D, texture);
+		GlState::textures_.at(textureUnit) = texture;
+	}
+}
+
+
+
+void GlState::bindTexture(GLuint texture) {
+	GlState::bindTexture(GlState::activeTextureUnit_, texture);
+}
+
+
+
+void GlState::setBlend(bool enabled) {
+	GlState::setCapability_(GL_BLEND, enabled, GlState::blend_);
+}
+
+
+
+void GlState::setBlendFunc(GLenum sourceFactor, GLenum destinationFactor) {
+	bool changed = GlState::blendSourceFactor_ != sourceFactor || GlState::blendDestinationFactor_ != destinationFactor;
+
+	if (GlState::changes_(changed)) {
+		glBlendFunc(sourceFactor, destinationFactor);
+		GlState::blendSourceFactor_ = sourceFactor;
+		GlState::blendDestinationFactor_ = destinationFactor;
+	}
+}
+
+
+
+void GlState::setCullFace(bool enabled) {
+	GlState::setCapability_(GL_CULL_FACE, enabled, GlState::cullFace_);
+}
+
+
+
+void GlState::setCullFaceMode(GLenum mode) {
+	if (GlState::changes_(GlState::cullFaceMode_ != mode)) {
+		glCullFace(mode);
+		GlState::cullFaceMode_ = mode;
+	}
+}
+
+
+
+void GlState::setDepthTest(bool enabled) {
+	GlState::setCapability_(GL_DEPTH_TEST, enabled, GlState::depthTest_);
+}
+
+
+
+void GlState::setDepthFunc(GLenum function) {
+	if (GlState::changes_(GlState::depthFunction_ != function)) {
+		glDepthFunc(function);
+		GlState::depthFunction_ = function;
+	}
+}
+
+
+
+void GlState::setPolygonMode(GLenum mode) {
+	if (GlState::changes_(GlState::polygonMode_ != mode)) {
+		glPolygonMode(GL_FRONT_AND_BACK, mode);
+		GlState::polygonMode_ = mode;
+	}
+}
+
+
+
+void GlState::setPatchVertices(GLint nVertices) {
+	if (GlState::changes_(GlState::patchVertices_ != nVertices)) {
+		glPatchParameteri(GL_PATCH_VERTICES, nVertices);
+		GlState::patchVertices_ = nVertices;
+	}
+}
+
+
+
+void GlState::deleteProgram(GLuint program) {
+	if (GlState::program_ == program) GlState::useProgram(0u);
+
+	glDeleteProgram(program);
+}
+
+
+
+void GlState::deleteVertexArray(GLuint vao) {
+	glDeleteVertexArrays(1, &vao);
+
+	if (GlState::vao_ == vao) GlState::vao_ = 0u;
+}
+
+
+
+void GlState::deleteTexture(GLuint texture) {
+	glDeleteTextures(1, &texture);
+
+	for (GLuint& rTexture : GlState::textures_)
+		if (rTexture == texture) rTexture = 0u;
+}
+
+
+
+GLuint GlState::getProgram() {
+	return GlState::program_;
+}
+
+
+
+GLuint GlState::getVertexArray() {
+	return GlState::vao_;
+}
+
+
+
+bool GlState::changes_(bool changed) {
+	if (changed) GlDebug::countCalls(1u);
+	else GlDebug::countSkippedCalls(1u);
+
+	return changed;
+}
+
+
+
+void GlState::setCapability_(GLenum capability, bool enabled, bool& rState) {
+	if (GlState::changes_(rState != enabled)) {
+		if (enabled) glEnable(capability);
+		else glDisable(capability);
+
+		rState = enabled;
+	}
+}
+
+
+
+void GlState::setActiveTexture_(GLuint textureUnit) {
+	if (GlState::activeTextureUnit_ != textureUnit) {
+		glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(textureUnit));
+		GlState::activeTextureUnit_ = textureUnit;
+
+		GlDebug::countCalls(1u);
+	}
+}
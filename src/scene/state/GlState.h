@@ -0,0 +1,88 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <GL/gl3w.h>
+
+#include "info/GlDebug.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using std::runtime_error;
+using std::vector;
+
+
+
+// Shadows the current GL state; calls that would not change it are skipped (and counted, see 'GlDebug').
+// All state changes below must go through this class, otherwise the shadowed state is out of date.
+class GlState {
+public:
+	// get (queried once)
+	//############################################################################
+	static GLint getMaxCombinedTextureImageUnits();
+	static GLint getMaxDrawBuffers();
+	static GLint getMaxTextureSize();
+	static GLint getMaxVertexAttribs();
+	// GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile: compiling and linking run on driver threads,
+	// GL_COMPLETION_STATUS_KHR can be polled (the first query sets the driver's own number of threads)
+	static bool hasParallelShaderCompile();
+	// GL_SHADER_BINARY_FORMAT_SPIR_V among the shader binary formats (GL 4.6 / GL_ARB_gl_spirv)
+	static bool hasSpirvShaders();
+
+
+	// set
+	//############################################################################
+	static void useProgram(GLuint program);
+	static void bindVertexArray(GLuint vao);
+	static void bindTexture(GLuint textureUnit, GLuint texture); // GL_TEXTURE_2D
+	static void bindTexture(GLuint texture); // active texture unit
+
+	static void setBlend(bool enabled);
+	static void setBlendFunc(GLenum sourceFactor, GLenum destinationFactor);
+	static void setCullFace(bool enabled);
+	static void setCullFaceMode(GLenum mode);
+	static void setDepthTest(bool enabled);
+	static void setDepthFunc(GLenum function);
+	static void setPolygonMode(GLenum mode); // GL_FRONT_AND_BACK
+	static void setPatchVertices(GLint nVertices);
+
+
+	// delete (GL resets the bindings of deleted objects)
+	//############################################################################
+	static void deleteProgram(GLuint program);
+	static void deleteVertexArray(GLuint vao);
+	static void deleteTexture(GLuint texture);
+
+
+	// get
+	//############################################################################
+	static GLuint getProgram();
+	static GLuint getVertexArray();
+
+private:
+	GlState();
+	GlState(const GlState&);
+	const GlState& operator=(const GlState&) {}
+
+	static bool changes_(bool changed);
+	static void setCapability_(GLenum capability, bool enabled, bool& rState);
+	static void setActiveTexture_(GLuint textureUnit);
+
+	static GLint maxCombinedTextureImageUnits_, maxDrawBuffers_, maxTextureSize_, maxVertexAttribs_;
+	static int parallelShaderCompile_, spirvShaders_; // -1: not queried yet
+
+	static GLuint program_, vao_, activeTextureUnit_;
+	static vector<GLuint> textures_;
+
+	static bool blend_, cullFace_, depthTest_;
+	static GLenum blendSourceFactor_, blendDestinationFactor_, cullFaceMode_, depthFunction_, polygonMode_;
+	static GLint patchVertices_;
+};
+
+#endif
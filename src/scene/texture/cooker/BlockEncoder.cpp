@@ -0,0 +1,317 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "BlockEncoder.h"
+
+
+
+const GLsizei BlockEncoder::kBlockSize = 4;
+const GLuint BlockEncoder::kNumTexels_ = 16u;
+
+
+
+void BlockEncoder::encodeBC1(const GLubyte* pkTexels, GLubyte* pBlock) {
+	bool alpha = true;
+	BlockEncoder::encodeColor_(pkTexels, alpha, pBlock);
+}
+
+
+
+void BlockEncoder::encodeBC3(const GLubyte* pkTexels, GLubyte* pBlock) {
+	bool alpha = false; // the color block of BC3 has always 4 colors
+
+	BlockEncoder::encodeBC4(pkTexels, 3u, pBlock);
+	BlockEncoder::encodeColor_(pkTexels, alpha, pBlock + 8u);
+}
+
+
+
+// 8 values between the endpoints (the first endpoint the largest)
+void BlockEncoder::encodeBC4(const GLubyte* pkTexels, GLuint channel, GLubyte* pBlock) {
+	std::memset(pBlock, 0, 8u);
+
+	GLint minValue = 255, maxValue = 0;
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		minValue = min(minValue, static_cast<GLint>(pkTexels[i * 4u + channel]));
+		maxValue = max(maxValue, static_cast<GLint>(pkTexels[i * 4u + channel]));
+	}
+
+	GLint palette[8u] = { maxValue, minValue };
+	for (GLint i = 2; i < 8; i++)
+		palette[i] = ((8 - i) * maxValue + (i - 1) * minValue + 3) / 7;
+
+	GLuint position = 0u;
+	BlockEncoder::writeBits_(pBlock, position, static_cast<GLuint>(maxValue), 8u);
+	BlockEncoder::writeBits_(pBlock, position, static_cast<GLuint>(minValue), 8u);
+
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		GLint value = pkTexels[i * 4u + channel];
+		GLuint index = 0u;
+
+		if (maxValue > minValue)
+			for (GLuint iEntry = 1u; iEntry < 8u; iEntry++)
+				if (std::abs(palette[iEntry] - value) < std::abs(palette[index] - value)) index = iEntry;
+
+		BlockEncoder::writeBits_(pBlock, position, index, 3u);
+	}
+}
+
+
+
+void BlockEncoder::encodeBC5(const GLubyte* pkTexels, GLubyte* pBlock) {
+	BlockEncoder::encodeBC4(pkTexels, 0u, pBlock);
+	BlockEncoder::encodeBC4(pkTexels, 1u, pBlock + 8u);
+}
+
+
+
+// mode 6: 7 mode bits, 8 endpoint values of 7 bits (R0 R1 G0 G1 B0 B1 A0 A1), 2 p-bits, 16 indices of 4 bits (the
+// first one without its high bit, so the first texel must use the lower half of the palette)
+void BlockEncoder::encodeBC7(const GLubyte* pkTexels, GLubyte* pBlock) {
+	const GLint kpWeights[16u] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	std::memset(pBlock, 0, 16u);
+
+	float endpoints[2u][4u];
+	bool skipTransparent = false;
+	BlockEncoder::getEndpoints_(pkTexels, 4u, skipTransparent, endpoints[0u], endpoints[1u]);
+
+	// an opaque block keeps an alpha of 255, which needs both p-bits set
+	bool opaque = true;
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_ && opaque; i++)
+		if (pkTexels[i * 4u + 3u] < 255u) opaque = false;
+
+	// each endpoint: the p-bit (the low bit shared by its 4 channels) of the smaller error
+	GLint quantized[2u][4u], pBits[2u];
+	for (GLuint iEndpoint = 0u; iEndpoint < 2u; iEndpoint++) {
+		float minError = -1.0f;
+
+		for (GLint iPBit = opaque ? 1 : 0; iPBit < 2; iPBit++) {
+			GLint values[4u];
+			float error = 0.0f;
+
+			for (GLuint iChannel = 0u; iChannel < 4u; iChannel++) {
+				values[iChannel] = min(max(static_cast<GLint>(std::lround((endpoints[iEndpoint][iChannel] - iPBit) / 2.0f)),
+					                       0), 127);
+				float difference = static_cast<float>(values[iChannel] * 2 + iPBit) - endpoints[iEndpoint][iChannel];
+				error += difference * difference;
+			}
+
+			if (minError < 0.0f || error < minError) {
+				minError = error;
+				std::copy(values, values + 4u, quantized[iEndpoint]);
+				pBits[iEndpoint] = iPBit;
+			}
+		}
+	}
+
+	GLint palette[16u][4u];
+	for (GLuint i = 0u; i < 16u; i++)
+		for (GLuint iChannel = 0u; iChannel < 4u; iChannel++)
+			palette[i][iChannel] = ((64 - kpWeights[i]) * (quantized[0u][iChannel] * 2 + pBits[0u]) +
+				                    kpWeights[i] * (quantized[1u][iChannel] * 2 + pBits[1u]) + 32) >> 6;
+
+	GLuint indices[16u];
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		GLint minError = -1;
+
+		for (GLuint iEntry = 0u; iEntry < 16u; iEntry++) {
+			GLint error = 0;
+			for (GLuint iChannel = 0u; iChannel < 4u; iChannel++) {
+				GLint difference = palette[iEntry][iChannel] - static_cast<GLint>(pkTexels[i * 4u + iChannel]);
+				error += difference * difference;
+			}
+
+			if (minError < 0 || error < minError) {
+				minError = error;
+				indices[i] = iEntry;
+			}
+		}
+	}
+
+	if (indices[0u] >= 8u) {
+		std::swap(quantized[0u], quantized[1u]);
+		std::swap(pBits[0u], pBits[1u]);
+		for (GLuint& rIndex : indices) rIndex = 15u - rIndex;
+	}
+
+	GLuint position = 0u;
+	BlockEncoder::writeBits_(pBlock, position, 1u << 6u, 7u);
+
+	for (GLuint iChannel = 0u; iChannel < 4u; iChannel++) {
+		BlockEncoder::writeBits_(pBlock, position, static_cast<GLuint>(quantized[0u][iChannel]), 7u);
+		BlockEncoder::writeBits_(pBlock, position, static_cast<GLuint>(quantized[1u][iChannel]), 7u);
+	}
+
+	BlockEncoder::writeBits_(pBlock, position, static_cast<GLuint>(pBits[0u]), 1u);
+	BlockEncoder::writeBits_(pBlock, position, static_cast<GLuint>(pBits[1u]), 1u);
+
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++)
+		BlockEncoder::writeBits_(pBlock, position, indices[i], i == 0u ? 3u : 4u);
+}
+
+
+
+// principal axis by power iteration, from the diagonal of the bounding box
+void BlockEncoder::getEndpoints_(const GLubyte* pkTexels, GLuint nChannels, bool skipTransparent, float* pEndpoint0,
+	                             float* pEndpoint1) {
+	float mean[4u] = {}, minValues[4u] = { 255.0f, 255.0f, 255.0f, 255.0f }, maxValues[4u] = {};
+	GLuint nTexels = 0u;
+
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		if (skipTransparent && pkTexels[i * 4u + 3u] < 128u) continue;
+
+		for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) {
+			float value = static_cast<float>(pkTexels[i * 4u + iChannel]);
+			mean[iChannel] += value;
+			minValues[iChannel] = min(minValues[iChannel], value);
+			maxValues[iChannel] = max(maxValues[iChannel], value);
+		}
+		nTexels++;
+	}
+
+	if (nTexels == 0u) {
+		std::fill(pEndpoint0, pEndpoint0 + nChannels, 0.0f);
+		std::fill(pEndpoint1, pEndpoint1 + nChannels, 0.0f);
+		return;
+	}
+
+	for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) mean[iChannel] /= static_cast<float>(nTexels);
+
+	float covariance[4u][4u] = {};
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		if (skipTransparent && pkTexels[i * 4u + 3u] < 128u) continue;
+
+		for (GLuint iRow = 0u; iRow < nChannels; iRow++)
+			for (GLuint iColumn = 0u; iColumn < nChannels; iColumn++)
+				covariance[iRow][iColumn] += (pkTexels[i * 4u + iRow] - mean[iRow]) * (pkTexels[i * 4u + iColumn] - mean[iColumn]);
+	}
+
+	float axis[4u] = {};
+	for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) axis[iChannel] = maxValues[iChannel] - minValues[iChannel];
+
+	for (GLuint iIteration = 0u; iIteration < 8u; iIteration++) {
+		float product[4u] = {}, length = 0.0f;
+
+		for (GLuint iRow = 0u; iRow < nChannels; iRow++) {
+			for (GLuint iColumn = 0u; iColumn < nChannels; iColumn++) product[iRow] += covariance[iRow][iColumn] * axis[iColumn];
+			length += product[iRow] * product[iRow];
+		}
+
+		if (length <= 0.0f) break; // a single color, or a flat block: the axis of the bounding box
+		length = std::sqrt(length);
+		for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) axis[iChannel] = product[iChannel] / length;
+	}
+
+	float length = 0.0f;
+	for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) length += axis[iChannel] * axis[iChannel];
+	if (length > 0.0f) {
+		length = std::sqrt(length);
+		for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) axis[iChannel] /= length;
+	}
+
+	float minProjection = 0.0f, maxProjection = 0.0f;
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		if (skipTransparent && pkTexels[i * 4u + 3u] < 128u) continue;
+
+		float projection = 0.0f;
+		for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++)
+			projection += (pkTexels[i * 4u + iChannel] - mean[iChannel]) * axis[iChannel];
+
+		minProjection = min(minProjection, projection);
+		maxProjection = max(maxProjection, projection);
+	}
+
+	for (GLuint iChannel = 0u; iChannel < nChannels; iChannel++) {
+		pEndpoint0[iChannel] = min(max(mean[iChannel] + axis[iChannel] * maxProjection, 0.0f), 255.0f);
+		pEndpoint1[iChannel] = min(max(mean[iChannel] + axis[iChannel] * minProjection, 0.0f), 255.0f);
+	}
+}
+
+
+
+// 4 colors if the first endpoint is larger, 3 colors and transparent black otherwise
+void BlockEncoder::encodeColor_(const GLubyte* pkTexels, bool alpha, GLubyte* pBlock) {
+	std::memset(pBlock, 0, 8u);
+
+	bool transparent = false;
+	if (alpha)
+		for (GLuint i = 0u; i < BlockEncoder::kNumTexels_ && !transparent; i++)
+			if (pkTexels[i * 4u + 3u] < 128u) transparent = true;
+
+	float endpoint0[4u], endpoint1[4u];
+	BlockEncoder::getEndpoints_(pkTexels, 3u, transparent, endpoint0, endpoint1);
+
+	GLushort color0 = BlockEncoder::toRgb565_(endpoint0), color1 = BlockEncoder::toRgb565_(endpoint1);
+	if (transparent ? color0 > color1 : color0 < color1) std::swap(color0, color1);
+	bool fourColors = color0 > color1;
+
+	GLint palette[4u][3u] = {};
+	BlockEncoder::fromRgb565_(color0, palette[0u]);
+	BlockEncoder::fromRgb565_(color1, palette[1u]);
+	for (GLuint iChannel = 0u; iChannel < 3u; iChannel++) {
+		if (fourColors) {
+			palette[2u][iChannel] = (2 * palette[0u][iChannel] + palette[1u][iChannel]) / 3;
+			palette[3u][iChannel] = (palette[0u][iChannel] + 2 * palette[1u][iChannel]) / 3;
+		}
+		else palette[2u][iChannel] = (palette[0u][iChannel] + palette[1u][iChannel]) / 2;
+	}
+
+	GLuint position = 0u;
+	BlockEncoder::writeBits_(pBlock, position, color0, 16u);
+	BlockEncoder::writeBits_(pBlock, position, color1, 16u);
+
+	for (GLuint i = 0u; i < BlockEncoder::kNumTexels_; i++) {
+		GLuint index = 0u;
+
+		if (transparent && pkTexels[i * 4u + 3u] < 128u) index = 3u;
+		else {
+			GLint minError = -1;
+
+			for (GLuint iEntry = 0u; iEntry < (fourColors ? 4u : 3u); iEntry++) {
+				GLint error = 0;
+				for (GLuint iChannel = 0u; iChannel < 3u; iChannel++) {
+					GLint difference = palette[iEntry][iChannel] - static_cast<GLint>(pkTexels[i * 4u + iChannel]);
+					error += difference * difference;
+				}
+
+				if (minError < 0 || error < minError) {
+					minError = error;
+					index = iEntry;
+				}
+			}
+		}
+
+		BlockEncoder::writeBits_(pBlock, position, index, 2u);
+	}
+}
+
+
+
+GLushort BlockEncoder::toRgb565_(const float* pkColor) {
+	GLuint red = static_cast<GLuint>(std::lround(pkColor[0u] * 31.0f / 255.0f));
+	GLuint green = static_cast<GLuint>(std::lround(pkColor[1u] * 63.0f / 255.0f));
+	GLuint blue = static_cast<GLuint>(std::lround(pkColor[2u] * 31.0f / 255.0f));
+
+	return static_cast<GLushort>((red << 11u) | (green << 5u) | blue);
+}
+
+
+
+void BlockEncoder::fromRgb565_(GLushort color, GLint* pColor) {
+	GLint red = (color >> 11u) & 31, green = (color >> 5u) & 63, blue = color & 31;
+
+	pColor[0u] = (red << 3) | (red >> 2);
+	pColor[1u] = (green << 2) | (green >> 4);
+	pColor[2u] = (blue << 3) | (blue >> 2);
+}
+
+
+
+// least significant bit first, the block cleared before
+void BlockEncoder::writeBits_(GLubyte* pBlock, GLuint& rPosition, GLuint value, GLuint nBits) {
+	for (GLuint i = 0u; i < nBits; i++, rPosition++)
+		if ((value >> i) & 1u) pBlock[rPosition / 8u] |= static_cast<GLubyte>(1u << (rPosition % 8u));
+}
@@ -0,0 +1,55 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef BLOCK_ENCODER_H
+#define BLOCK_ENCODER_H
+
+#include <GL/gl3w.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+using std::max;
+using std::min;
+using std::size_t;
+
+
+
+// Block compression of one 4 x 4 block of RGBA8 texels (row after row), see 'TextureCooker'. The endpoints are the
+// extremes of the texels projected on their principal axis (range fit), the indices the nearest palette entries, as
+// the GPU decodes them. BC7 uses mode 6 only (one subset, RGBA endpoints of 7 bits and a p-bit, 16 weights).
+class BlockEncoder {
+public:
+	static const GLsizei kBlockSize; // texels per side
+
+	static void encodeBC1(const GLubyte* pkTexels, GLubyte* pBlock); // 8 bytes, 1-bit alpha (texels below 128)
+	static void encodeBC3(const GLubyte* pkTexels, GLubyte* pBlock); // 16 bytes
+	static void encodeBC4(const GLubyte* pkTexels, GLuint channel, GLubyte* pBlock); // 8 bytes, one channel
+	static void encodeBC5(const GLubyte* pkTexels, GLubyte* pBlock); // 16 bytes, red and green
+	static void encodeBC7(const GLubyte* pkTexels, GLubyte* pBlock); // 16 bytes
+
+private:
+	static const GLuint kNumTexels_;
+
+	BlockEncoder();
+	BlockEncoder(const BlockEncoder&);
+	const BlockEncoder& operator=(const BlockEncoder&) {}
+
+	// endpoints of the first 'nChannels' channels, float [0, 255]
+	static void getEndpoints_(const GLubyte* pkTexels, GLuint nChannels, bool skipTransparent, float* pEndpoint0,
+		                      float* pEndpoint1);
+
+	static void encodeColor_(const GLubyte* pkTexels, bool alpha, GLubyte* pBlock); // alpha -> 3 colors + transparent
+
+	static GLushort toRgb565_(const float* pkColor);
+	static void fromRgb565_(GLushort color, GLint* pColor);
+
+	static void writeBits_(GLubyte* pBlock, GLuint& rPosition, GLuint value, GLuint nBits);
+};
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "TextureCooker.h"
+
+
+
+const GLuint TextureCooker::kMagic_ = 0x43544D42; // 'BMTC'
+const GLuint TextureCooker::kVersion_ = 2u; // 2: transparency flag
+const GLuint TextureCooker::kTransparentFlag_ = 0x1;
+
+
+
+string TextureCooker::getCookedFileName(const string& kFileName) {
+	return kFileName + ".dds";
+}
+
+
+
+bool TextureCooker::isCooked(const string& kFilePath, const string& kFileName) {
+	const GLuint DDS_MAGIC = 0x20534444;
+	const GLsizei kHeaderLength = 124;
+
+	long long sourceSize = 0ll, sourceTime = 0ll;
+	if (!FileInfo::get(kFilePath + "/" + kFileName, sourceSize, sourceTime)) return false;
+
+	FILE* pFile;
+	fopen_s(&pFile, (kFilePath + "/" + TextureCooker::getCookedFileName(kFileName)).c_str(), "rb");
+	if (pFile == NULL) return false;
+
+	GLuint magic = 0u, header[kHeaderLength / 4u] = {};
+	bool read = std::fread(&magic, 4u, 1u, pFile) == 1u &&
+		        std::fread(header, 4u, kHeaderLength / 4u, pFile) == kHeaderLength / 4u;
+	std::fclose(pFile);
+
+	// reserved words: magic, version, source size, source time, flags
+	return read && magic == DDS_MAGIC && header[7u] == TextureCooker::kMagic_ && header[8u] <= TextureCooker::kVersion_ &&
+		   header[9u] == static_cast<GLuint>(sourceSize) && header[10u] == static_cast<GLuint>(sourceSize >> 32) &&
+		   header[11u] == static_cast<GLuint>(sourceTime) && header[12u] == static_cast<GLuint>(sourceTime >> 32);
+}
+
+
+
+void TextureCooker::cook(const string& kFilePath, const string& kFileName, TextureCooker::Format format) {
+	const GLuint DDS_MAGIC = 0x20534444;
+	const GLuint DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000,
+		         DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+	const GLuint DDPF_FOURCC = 0x4;
+	const GLuint FOURCC_DX10 = 0x30315844;
+	const GLuint DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+	const GLuint D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3u;
+	const GLsizei kHeaderLength = 124, kDx10HeaderLength = 20;
+
+	long long sourceSize = 0ll, sourceTime = 0ll;
+	if (!FileInfo::get(kFilePath + "/" + kFileName, sourceSize, sourceTime))
+		throw runtime_error("TextureCooker.cook|Cannot read '" + kFileName + "' file.");
+
+	// upper-left origin: top row first, as the other DDS images (flipped in the shaders)
+	ILuint imageName = 0u;
+	ilGenImages(1, &imageName);
+	if (imageName == 0u) throw runtime_error("TextureCooker.cook|Create DevIL image name failed.");
+
+	ilBindImage(imageName);
+	ilEnable(IL_ORIGIN_SET);
+	ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
+	ILboolean success = ilLoadImage((const wchar_t *)((kFilePath + "/" + kFileName).c_str()));
+
+	vector<GLubyte> level;
+	GLsizei width = 0, height = 0;
+	if (success) {
+		ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
+		width = static_cast<GLsizei>(ilGetInteger(IL_IMAGE_WIDTH));
+		height = static_cast<GLsizei>(ilGetInteger(IL_IMAGE_HEIGHT));
+
+		const ILubyte* pkBytes = ilGetData();
+		level.assign(pkBytes, pkBytes + static_cast<size_t>(width) * static_cast<size_t>(height) * 4u);
+	}
+
+	ilBindImage(0u);
+	ilDeleteImages(1, &imageName);
+	if (!success || width <= 0 || height <= 0) throw runtime_error("TextureCooker.cook|Cannot load image '" + kFileName + "'");
+
+	if (format == TextureCooker::Format::AUTO) format = TextureCooker::getAutoFormat_(level);
+	bool normalMap = format == TextureCooker::Format::BC5;
+
+	GLuint nLevels = 1u + static_cast<GLuint>(std::floor(std::log2(max(width, height))));
+	GLuint header[kHeaderLength / 4u] = {}, dx10Header[kDx10HeaderLength / 4u] = {};
+
+	header[0u] = kHeaderLength;
+	header[1u] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header[2u] = static_cast<GLuint>(height);
+	header[3u] = static_cast<GLuint>(width);
+	header[4u] = static_cast<GLuint>((width + 3) / 4) * static_cast<GLuint>((height + 3) / 4) *
+		         TextureCooker::getBlockLength_(format);
+	header[6u] = nLevels;
+	header[7u] = TextureCooker::kMagic_;
+	header[8u] = TextureCooker::kVersion_;
+	header[9u] = static_cast<GLuint>(sourceSize);
+	header[10u] = static_cast<GLuint>(sourceSize >> 32);
+	header[11u] = static_cast<GLuint>(sourceTime);
+	header[12u] = static_cast<GLuint>(sourceTime >> 32);
+	header[13u] = TextureCooker::isTransparent_(level, format) ? TextureCooker::kTransparentFlag_ : 0u;
+	header[18u] = 32u; // pixel format
+	header[19u] = DDPF_FOURCC;
+	header[20u] = FOURCC_DX10;
+	header[26u] = DDSCAPS_COMPLEX | DDSCAPS_TEXTURE | DDSCAPS_MIPMAP;
+
+	dx10Header[0u] = TextureCooker::getDxgiFormat_(format);
+	dx10Header[1u] = D3D10_RESOURCE_DIMENSION_TEXTURE2D;
+	dx10Header[3u] = 1u; // array size
+
+	string cookedFilePath = kFilePath + "/" + TextureCooker::getCookedFileName(kFileName);
+	FILE* pFile;
+	fopen_s(&pFile, cookedFilePath.c_str(), "wb");
+	if (pFile == NULL) throw runtime_error("TextureCooker.cook|Cannot write the '" + cookedFilePath + "' file.");
+
+	bool written = std::fwrite(&DDS_MAGIC, 4u, 1u, pFile) == 1u &&
+		           std::fwrite(header, 4u, kHeaderLength / 4u, pFile) == kHeaderLength / 4u &&
+		           std::fwrite(dx10Header, 4u, kDx10HeaderLength / 4u, pFile) == kDx10HeaderLength / 4u;
+
+	vector<GLubyte> blocks, nextLevel;
+	size_t length = 0u;
+	for (GLuint iLevel = 0u; iLevel < nLevels && written; iLevel++) {
+		if (iLevel > 0u) {
+			TextureCooker::downsample_(level, width, height, normalMap, nextLevel);
+			level.swap(nextLevel);
+			width = max(1, width / 2);
+			height = max(1, height / 2);
+		}
+
+		TextureCooker::encodeLevel_(level, width, height, format, blocks);
+		written = std::fwrite(blocks.data(), 1u, blocks.size(), pFile) == blocks.size();
+		length += blocks.size();
+	}
+
+	std::fclose(pFile);
+
+	// a partial file would only be rejected by the loader, remove it now
+	if (!written) {
+		std::remove(cookedFilePath.c_str());
+		throw runtime_error("TextureCooker.cook|Cannot write the '" + cookedFilePath + "' file.");
+	}
+
+	cout << "Texture '" << kFileName << "' cooked: " << TextureCooker::toString(format) << ", " << header[3u] << " x "
+		 << header[2u] << ", " << nLevels << " levels, " << (length + 1023u) / 1024u << " KB." << endl;
+}
+
+
+
+bool TextureCooker::readTransparency(const GLuint* pkHeader, bool& rTransparent) {
+	if (pkHeader[7u] != TextureCooker::kMagic_ || pkHeader[8u] < 2u || pkHeader[8u] > TextureCooker::kVersion_) return false;
+
+	rTransparent = (pkHeader[13u] & TextureCooker::kTransparentFlag_) != 0u;
+	return true;
+}
+
+
+
+string TextureCooker::toString(TextureCooker::Format format) {
+	switch (format) {
+	case TextureCooker::Format::AUTO:
+		return "AUTO";
+	case TextureCooker::Format::BC1:
+		return "BC1";
+	case TextureCooker::Format::BC3:
+		return "BC3";
+	case TextureCooker::Format::BC4:
+		return "BC4";
+	case TextureCooker::Format::BC5:
+		return "BC5";
+	case TextureCooker::Format::BC7:
+		return "BC7";
+	default:
+		throw runtime_error("TextureCooker.toString|Invalid format value.");
+	}
+}
+
+
+
+TextureCooker::Format TextureCooker::getAutoFormat_(const vector<GLubyte>& kImage) {
+	if (AlphaCoverage::isTransparentRgba8(kImage.data(), kImage.size() / 4u)) return TextureCooker::Format::BC7;
+
+	for (size_t i = 0u; i < kImage.size(); i += 4u)
+		if (kImage[i] != kImage[i + 1u] || kImage[i] != kImage[i + 2u]) return TextureCooker::Format::BC1;
+
+	return TextureCooker::Format::BC4;
+}
+
+
+
+// the mip levels of an opaque image are opaque; BC1 keeps the texels below half alpha only, BC4 and BC5 no alpha
+bool TextureCooker::isTransparent_(const vector<GLubyte>& kImage, TextureCooker::Format format) {
+	switch (format) {
+	case TextureCooker::Format::BC1:
+		for (size_t i = 3u; i < kImage.size(); i += 4u)
+			if (kImage[i] < 128u) return true;
+		return false;
+	case TextureCooker::Format::BC3:
+	case TextureCooker::Format::BC7:
+		return AlphaCoverage::isTransparentRgba8(kImage.data(), kImage.size() / 4u);
+	default:
+		return false;
+	}
+}
+
+
+
+// 2 x 2 box filter: sRGB colors averaged in linear space, normal maps averaged as vectors and renormalized
+void TextureCooker::downsample_(const vector<GLubyte>& kSource, GLsizei width, GLsizei height, bool normalMap,
+	                            vector<GLubyte>& rTarget) {
+	const size_t knLinearValues = 4096u;
+
+	float toLinear[256u];
+	for (unsigned int i = 0u; i < 256u; i++) {
+		float value = static_cast<float>(i) / 255.0f;
+		if (normalMap) toLinear[i] = value * 2.0f - 1.0f;
+		else toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	vector<GLubyte> toSrgb(knLinearValues);
+	for (size_t i = 0u; i < knLinearValues; i++) {
+		float value = static_cast<float>(i) / static_cast<float>(knLinearValues - 1u);
+		value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		toSrgb[i] = static_cast<GLubyte>(std::lround(min(max(value, 0.0f), 1.0f) * 255.0f));
+	}
+
+	GLsizei targetWidth = max(1, width / 2), targetHeight = max(1, height / 2);
+	rTarget.resize(static_cast<size_t>(targetWidth) * static_cast<size_t>(targetHeight) * 4u);
+
+	for (GLsizei y = 0; y < targetHeight; y++) {
+		const GLubyte* pkRow0 = kSource.data() + static_cast<size_t>(min(2 * y, height - 1)) * width * 4u;
+		const GLubyte* pkRow1 = kSource.data() + static_cast<size_t>(min(2 * y + 1, height - 1)) * width * 4u;
+		GLubyte* pTargetRow = rTarget.data() + static_cast<size_t>(y) * targetWidth * 4u;
+
+		for (GLsizei x = 0; x < targetWidth; x++) {
+			size_t x0 = static_cast<size_t>(min(2 * x, width - 1)) * 4u, x1 = static_cast<size_t>(min(2 * x + 1, width - 1)) * 4u;
+
+			float values[3u];
+			for (size_t iChannel = 0u; iChannel < 3u; iChannel++)
+				values[iChannel] = 0.25f * (toLinear[pkRow0[x0 + iChannel]] + toLinear[pkRow0[x1 + iChannel]] +
+					                        toLinear[pkRow1[x0 + iChannel]] + toLinear[pkRow1[x1 + iChannel]]);
+
+			if (normalMap) {
+				float length = std::sqrt(values[0u] * values[0u] + values[1u] * values[1u] + values[2u] * values[2u]);
+				for (size_t iChannel = 0u; iChannel < 3u; iChannel++) {
+					float value = length > 0.0f ? values[iChannel] / length : 0.0f;
+					pTargetRow[x * 4u + iChannel] = static_cast<GLubyte>(std::lround((value * 0.5f + 0.5f) * 255.0f));
+				}
+			}
+			else
+				for (size_t iChannel = 0u; iChannel < 3u; iChannel++)
+					pTargetRow[x * 4u + iChannel] = toSrgb[static_cast<size_t>(values[iChannel] * (knLinearValues - 1u) + 0.5f)];
+
+			pTargetRow[x * 4u + 3u] = static_cast<GLubyte>((pkRow0[x0 + 3u] + pkRow0[x1 + 3u] + pkRow1[x0 + 3u] +
+				                                            pkRow1[x1 + 3u] + 2u) / 4u);
+		}
+	}
+}
+
+
+
+// the block rows are shared by the threads; the texels past the edges of a level repeat its last row and column
+void TextureCooker::encodeLevel_(const vector<GLubyte>& kLevel, GLsizei width, GLsizei height,
+	                             TextureCooker::Format format, vector<GLubyte>& rBlocks) {
+	GLsizei nBlocksX = (width + 3) / 4, nBlocksY = (height + 3) / 4;
+	size_t blockLength = TextureCooker::getBlockLength_(format);
+	rBlocks.resize(static_cast<size_t>(nBlocksX) * static_cast<size_t>(nBlocksY) * blockLength);
+
+	unsigned int nThreads = min(max(thread::hardware_concurrency(), 1u), static_cast<unsigned int>(nBlocksY));
+	vector<thread> threads;
+
+	for (unsigned int iThread = 0u; iThread < nThreads; iThread++)
+		threads.emplace_back([&kLevel, width, height, format, &rBlocks, nBlocksX, nBlocksY, blockLength, nThreads, iThread]() {
+			GLubyte texels[64u];
+
+			for (GLsizei iBlockY = static_cast<GLsizei>(iThread); iBlockY < nBlocksY; iBlockY += nThreads)
+				for (GLsizei iBlockX = 0; iBlockX < nBlocksX; iBlockX++) {
+					for (GLsizei y = 0; y < BlockEncoder::kBlockSize; y++)
+						for (GLsizei x = 0; x < BlockEncoder::kBlockSize; x++) {
+							GLsizei levelX = min(iBlockX * BlockEncoder::kBlockSize + x, width - 1);
+							GLsizei levelY = min(iBlockY * BlockEncoder::kBlockSize + y, height - 1);
+							const GLubyte* pkTexel = kLevel.data() + (static_cast<size_t>(levelY) * width + levelX) * 4u;
+							std::copy(pkTexel, pkTexel + 4u, texels + (y * BlockEncoder::kBlockSize + x) * 4u);
+						}
+
+					GLubyte* pBlock = rBlocks.data() + (static_cast<size_t>(iBlockY) * nBlocksX + iBlockX) * blockLength;
+					switch (format) {
+					case TextureCooker::Format::BC1:
+						BlockEncoder::encodeBC1(texels, pBlock);
+						break;
+					case TextureCooker::Format::BC3:
+						BlockEncoder::encodeBC3(texels, pBlock);
+						break;
+					case TextureCooker::Format::BC4:
+						BlockEncoder::encodeBC4(texels, 0u, pBlock);
+						break;
+					case TextureCooker::Format::BC5:
+						BlockEncoder::encodeBC5(texels, pBlock);
+						break;
+					default:
+						BlockEncoder::encodeBC7(texels, pBlock);
+						break;
+					}
+				}
+		});
+
+	for (thread& rThread : threads) rThread.join();
+}
+
+
+
+GLuint TextureCooker::getDxgiFormat_(TextureCooker::Format format) {
+	const GLuint DXGI_FORMAT_BC1_UNORM = 71u, DXGI_FORMAT_BC3_UNORM = 77u, DXGI_FORMAT_BC4_UNORM = 80u,
+		         DXGI_FORMAT_BC5_UNORM = 83u, DXGI_FORMAT_BC7_UNORM = 98u;
+
+	switch (format) {
+	case TextureCooker::Format::BC1:
+		return DXGI_FORMAT_BC1_UNORM;
+	case TextureCooker::Format::BC3:
+		return DXGI_FORMAT_BC3_UNORM;
+	case TextureCooker::Format::BC4:
+		return DXGI_FORMAT_BC4_UNORM;
+	case TextureCooker::Format::BC5:
+		return DXGI_FORMAT_BC5_UNORM;
+	case TextureCooker::Format::BC7:
+		return DXGI_FORMAT_BC7_UNORM;
+	default:
+		throw runtime_error("TextureCooker.getDxgiFormat_|Invalid format value.");
+	}
+}
+
+
+
+GLuint TextureCooker::getBlockLength_(TextureCooker::Format format) {
+	return (format == TextureCooker::Format::BC1 || format == TextureCooker::Format::BC4) ? 8u : 16u;
+}
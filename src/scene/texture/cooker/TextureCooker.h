@@ -0,0 +1,86 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef TEXTURE_COOKER_H
+#define TEXTURE_COOKER_H
+
+#include <GL/gl3w.h>
+
+#include "info/FileInfo.h"
+#include "texture/cooker/BlockEncoder.h"
+#include "texture/texture/AlphaCoverage.h"
+
+#include <IL/il.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::FILE;
+using std::max;
+using std::min;
+using std::runtime_error;
+using std::size_t;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+
+
+
+// Offline texture cooker (library of the 'TextureCooker' tool, 'src/cooker/main.cpp'): converts an image into a
+// block-compressed DDS with a DX10 header and all its mip levels, '<image>.dds' next to the image, which 'ColorTexture'
+// then loads instead of the image. The rows are stored top row first as in any DDS file, the mip levels are filtered
+// in linear space (normal maps: renormalized), and the blocks are encoded by a thread per core. The header keeps the
+// size and time of the image (an edited image must be cooked again) and whether the texture is transparent, so it is
+// not scanned when loaded.
+// Formats: BC1 (opaque color, 1-bit alpha), BC3 / BC7 (color and alpha), BC4 (gray, read as RRR1, see 'BaseTexture'),
+// BC5 (normal maps, z from x and y, see 'shaders/main/shading.frag'); the images are stored as they are sampled, sRGB
+// values in UNORM formats, as the other DDS textures.
+class TextureCooker {
+public:
+	enum class Format { AUTO = 0u, BC1, BC3, BC4, BC5, BC7 }; // AUTO: BC4 gray, BC7 transparent, otherwise BC1
+
+	static string getCookedFileName(const string& kFileName);
+	static bool isCooked(const string& kFilePath, const string& kFileName); // cooked file up to date
+	// 'pkHeader': the 31 words after the magic number of a DDS file -> false if not cooked (or by the version 1)
+	static bool readTransparency(const GLuint* pkHeader, bool& rTransparent);
+
+	// DevIL must be initialized; not thread safe (DevIL)
+	static void cook(const string& kFilePath, const string& kFileName, TextureCooker::Format format);
+
+	static string toString(TextureCooker::Format format);
+
+private:
+	static const GLuint kMagic_; // in the reserved words of the DDS header
+	static const GLuint kVersion_;
+	static const GLuint kTransparentFlag_;
+
+	TextureCooker();
+	TextureCooker(const TextureCooker&);
+	const TextureCooker& operator=(const TextureCooker&) {}
+
+	static TextureCooker::Format getAutoFormat_(const vector<GLubyte>& kImage);
+	static bool isTransparent_(const vector<GLubyte>& kImage, TextureCooker::Format format); // once encoded
+
+	static void downsample_(const vector<GLubyte>& kSource, GLsizei width, GLsizei height, bool normalMap,
+		                    vector<GLubyte>& rTarget);
+	static void encodeLevel_(const vector<GLubyte>& kLevel, GLsizei width, GLsizei height, TextureCooker::Format format,
+		                     vector<GLubyte>& rBlocks);
+
+	static GLuint getDxgiFormat_(TextureCooker::Format format);
+	static GLuint getBlockLength_(TextureCooker::Format format);
+};
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "AlphaCoverage.h"
+
+
+
+bool AlphaCoverage::isTransparentRgba8(const GLubyte* pkTexels, size_t nTexels) {
+	size_t i = 0u;
+
+#ifdef ALPHA_COVERAGE_SSE2
+	// the texels of 4 registers are and-ed together: their alpha stays 255 only if it was 255 in all of them
+	const __m128i kAlphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+
+	for (; i + 16u <= nTexels; i += 16u) {
+		const __m128i* pkBlock = reinterpret_cast<const __m128i*>(pkTexels + i * 4u);
+		__m128i texels = _mm_and_si128(_mm_and_si128(_mm_loadu_si128(pkBlock), _mm_loadu_si128(pkBlock + 1)),
+			                           _mm_and_si128(_mm_loadu_si128(pkBlock + 2), _mm_loadu_si128(pkBlock + 3)));
+		__m128i opaque = _mm_cmpeq_epi32(_mm_and_si128(texels, kAlphaMask), kAlphaMask);
+		if (_mm_movemask_epi8(opaque) != 0xffff) return true;
+	}
+#else
+	const uint64_t kAlphaMask = 0xff000000ff000000ull;
+
+	for (; i + 8u <= nTexels; i += 8u) {
+		uint64_t texels[4u];
+		std::memcpy(texels, pkTexels + i * 4u, sizeof(texels));
+		if ((texels[0u] & texels[1u] & texels[2u] & texels[3u] & kAlphaMask) != kAlphaMask) return true;
+	}
+#endif
+
+	for (; i < nTexels; i++)
+		if (pkTexels[i * 4u + 3u] < 255u) return true;
+
+	return false;
+}
+
+
+
+// 3 colors and transparent black when the first color is not larger: transparent if a texel has index 3
+bool AlphaCoverage::isTransparentBc1(const GLubyte* pkBlocks, size_t nBlocks) {
+	for (size_t iBlock = 0u; iBlock < nBlocks; iBlock++) {
+		const GLubyte* pkBlock = pkBlocks + iBlock * 8u;
+		GLuint color0 = pkBlock[0u] | (pkBlock[1u] << 8u), color1 = pkBlock[2u] | (pkBlock[3u] << 8u);
+		if (color0 > color1) continue;
+
+		GLuint indices = pkBlock[4u] | (pkBlock[5u] << 8u) | (pkBlock[6u] << 16u) | (static_cast<GLuint>(pkBlock[7u]) << 24u);
+		if (indices & (indices >> 1u) & 0x55555555u) return true;
+	}
+
+	return false;
+}
+
+
+
+// 4 bits of alpha per texel
+bool AlphaCoverage::isTransparentBc2(const GLubyte* pkBlocks, size_t nBlocks) {
+	for (size_t iBlock = 0u; iBlock < nBlocks; iBlock++) {
+		uint64_t alpha;
+		std::memcpy(&alpha, pkBlocks + iBlock * 16u, sizeof(alpha));
+		if (alpha != ~0ull) return true;
+	}
+
+	return false;
+}
+
+
+
+// alpha palette of 8 entries (the endpoints and 6 interpolated) or of 6 entries, 0 and 255
+bool AlphaCoverage::isTransparentBc3(const GLubyte* pkBlocks, size_t nBlocks) {
+	for (size_t iBlock = 0u; iBlock < nBlocks; iBlock++) {
+		const GLubyte* pkBlock = pkBlocks + iBlock * 16u;
+		GLuint alpha0 = pkBlock[0u], alpha1 = pkBlock[1u];
+
+		GLuint palette[8u] = { alpha0, alpha1 };
+		if (alpha0 > alpha1)
+			for (GLuint i = 1u; i < 7u; i++) palette[i + 1u] = ((7u - i) * alpha0 + i * alpha1) / 7u;
+		else {
+			for (GLuint i = 1u; i < 5u; i++) palette[i + 1u] = ((5u - i) * alpha0 + i * alpha1) / 5u;
+			palette[6u] = 0u;
+			palette[7u] = 255u;
+		}
+
+		for (GLuint iTexel = 0u; iTexel < 16u; iTexel++)
+			if (palette[AlphaCoverage::getBits_(pkBlock, 16u + iTexel * 3u, 3u)] < 255u) return true;
+	}
+
+	return false;
+}
+
+
+
+// mode: the position of the first set bit; modes 0 - 3 have no alpha, modes 4 and 5 one alpha pair (opaque
+// without a channel rotation), modes 6 and 7 RGBA endpoints with p-bits
+bool AlphaCoverage::isTransparentBc7(const GLubyte* pkBlocks, size_t nBlocks) {
+	for (size_t iBlock = 0u; iBlock < nBlocks; iBlock++) {
+		const GLubyte* pkBlock = pkBlocks + iBlock * 16u;
+		GLuint mode = 0u;
+		while (mode < 8u && !(pkBlock[0u] & (1u << mode))) mode++;
+
+		switch (mode) {
+		case 0u:
+		case 1u:
+		case 2u:
+		case 3u:
+			break;
+		case 4u:
+			if (AlphaCoverage::getBits_(pkBlock, 5u, 2u) != 0u || AlphaCoverage::getBits_(pkBlock, 38u, 6u) != 63u ||
+				AlphaCoverage::getBits_(pkBlock, 44u, 6u) != 63u) return true;
+			break;
+		case 5u:
+			if (AlphaCoverage::getBits_(pkBlock, 6u, 2u) != 0u || AlphaCoverage::getBits_(pkBlock, 50u, 8u) != 255u ||
+				AlphaCoverage::getBits_(pkBlock, 58u, 8u) != 255u) return true;
+			break;
+		case 6u:
+			if (AlphaCoverage::getBits_(pkBlock, 49u, 7u) != 127u || AlphaCoverage::getBits_(pkBlock, 56u, 7u) != 127u ||
+				AlphaCoverage::getBits_(pkBlock, 63u, 2u) != 3u) return true;
+			break;
+		case 7u:
+			for (GLuint i = 0u; i < 4u; i++)
+				if (AlphaCoverage::getBits_(pkBlock, 74u + i * 5u, 5u) != 31u) return true;
+			if (AlphaCoverage::getBits_(pkBlock, 94u, 4u) != 15u) return true;
+			break;
+		default: // reserved mode, decoded as transparent black
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+GLuint AlphaCoverage::getBits_(const GLubyte* pkBlock, GLuint position, GLuint nBits) {
+	GLuint iByte = position / 8u;
+	GLuint bits = pkBlock[iByte];
+	if (iByte + 1u < 16u) bits |= pkBlock[iByte + 1u] << 8u;
+
+	return (bits >> (position % 8u)) & ((1u << nBits) - 1u);
+}
@@ -0,0 +1,45 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef ALPHA_COVERAGE_H
+#define ALPHA_COVERAGE_H
+
+#include <GL/gl3w.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ALPHA_COVERAGE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+using std::size_t;
+using std::uint64_t;
+
+
+
+// Transparency of texture data in memory, scanned on the CPU before the upload (the data is never read back): a
+// texture is transparent if any of its texels has an alpha below 255. The RGBA8 / BGRA8 texels are scanned 16 at a
+// time (SSE2, otherwise 64 bits at a time); the compressed blocks are decoded only as far as their alpha: BC1 (DXT1)
+// punch-through texels, BC2 (DXT3) explicit alpha, BC3 (DXT5) alpha palette, and BC7 endpoints (the modes without
+// alpha are opaque; a block whose alpha endpoints are not all 255 is counted as transparent).
+class AlphaCoverage {
+public:
+	static bool isTransparentRgba8(const GLubyte* pkTexels, size_t nTexels);
+	static bool isTransparentBc1(const GLubyte* pkBlocks, size_t nBlocks);
+	static bool isTransparentBc2(const GLubyte* pkBlocks, size_t nBlocks);
+	static bool isTransparentBc3(const GLubyte* pkBlocks, size_t nBlocks);
+	static bool isTransparentBc7(const GLubyte* pkBlocks, size_t nBlocks);
+
+private:
+	AlphaCoverage();
+	AlphaCoverage(const AlphaCoverage&);
+	const AlphaCoverage& operator=(const AlphaCoverage&) {}
+
+	static GLuint getBits_(const GLubyte* pkBlock, GLuint position, GLuint nBits); // LSB first, 'nBits' <= 8
+};
+
+#endif
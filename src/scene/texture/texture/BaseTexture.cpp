@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 3, 2025
+ * Last modified: Oct 17, 2026
  **/
 
 #include "BaseTexture.h"
@@ -9,10 +9,12 @@
 
 const unsigned int BaseTexture::knCubeFaces_ = 6u;
 
+mutex BaseTexture::ilMutex_;
+
 
 
 BaseTexture::~BaseTexture() {
-	glDeleteTextures(1, &id_);
+	GlState::deleteTexture(id_);
 
 	if (ppTextureData_) {
 		if (ppTextureData_[0u]) delete[] ppTextureData_[0u];
@@ -27,17 +29,15 @@ BaseTexture::~BaseTexture() {
 
 
 void BaseTexture::startReading(GLint textureUnit) const {
-	if (textureUnit >= 0 && textureUnit < maxCombinedTextureImageUnits_) {
-		glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(textureUnit));
-		glBindTexture(GL_TEXTURE_2D, id_);
-	}
+	if (textureUnit >= 0 && textureUnit < GlState::getMaxCombinedTextureImageUnits())
+		GlState::bindTexture(static_cast<GLuint>(textureUnit), id_);
 	else throw runtime_error("BaseTexture.startReading|Invalid texture unit value.");
 }
 
 
 
 void BaseTexture::stopReading() const {
-	glBindTexture(GL_TEXTURE_2D, 0u);
+	// the texture stays bound to its unit until the unit is reused, so rebinding it is skipped (see GlState)
 }
 
 
@@ -61,10 +61,9 @@ GLuint BaseTexture::getId() const {
 
 
 BaseTexture::BaseTexture() : ppTextureData_(nullptr), pOffsets_(nullptr), filePath_(), fileName_(), width_(0), height_(0),
-                             nMipmaps_(0), internalFormat_(0), maxCombinedTextureImageUnits_(0), format_(0u),  dataType_(0u),
-	                         dds_(false), compressed_(false), transparent_(false), id_(0u) {
+                             nMipmaps_(0), internalFormat_(0), format_(0u),  dataType_(0u),
+	                         dds_(false), compressed_(false), transparent_(false), knownTransparency_(false), id_(0u) {
 	glGenTextures(1, &id_);
-	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxCombinedTextureImageUnits_);
 
 	//cout << "[Base texture " << id_ << "] created." << endl;
 }
@@ -72,6 +71,8 @@ BaseTexture::BaseTexture() : ppTextureData_(nullptr), pOffsets_(nullptr), filePa
 
 
 void BaseTexture::loadIlImage_(const string& kFilePath, const string& kFileName, bool cubeMap, GLuint face) {
+	lock_guard<mutex> lock(BaseTexture::ilMutex_);
+
 	ILuint imageName = 0u;
 	ilGenImages(1, &imageName);
 	if (imageName == 0u)
@@ -97,8 +98,7 @@ void BaseTexture::loadIlImage_(const string& kFilePath, const string& kFileName,
 		GLint nMipmaps = 1;		
 
 		try {
-			setTextureParameters_(kFilePath, kFileName, cubeMap, cubeDDS, face, 
-				                  width, height, nMipmaps, kInternalFormat, kFormat, kDataType, compressed);
+			setTextureParameters_(cubeMap, cubeDDS, face, width, height, nMipmaps, kInternalFormat, kFormat, kDataType, compressed);
 		}
 		catch (const exception& kException) {
 			ilBindImage(0u);
@@ -110,8 +110,7 @@ void BaseTexture::loadIlImage_(const string& kFilePath, const string& kFileName,
 		ILint size = ilGetInteger(IL_IMAGE_SIZE_OF_DATA);		
 
 		ppTextureData_[face] = new GLubyte[static_cast<size_t>(size)];
-		for (ILint i = 0; i < size; i++)
-			ppTextureData_[face][i] = pBytes[i];
+		std::copy(pBytes, pBytes + size, ppTextureData_[face]);
 	}
 
 	ilBindImage(0u);
@@ -133,20 +132,23 @@ void BaseTexture::loadDDsImage_(const string& kFilePath, const string& kFileName
 	GLsizei width, height;
 	GLint nMipmaps, internalFormat;
 	GLenum format;
-	GLuint blockSize, caps2, nFaces;
-	bool compressed;
+	GLuint blockSize, caps2, dxgiFormat, nFaces;
+	bool compressed, knownTransparency, transparent;
 
 	GLuint* pPixelFormat = nullptr;
 
 	try {
-		readDDsHeader_(pFile, kFileName, fileLength, height, width, nMipmaps, pPixelFormat, caps2);
+		readDDsHeader_(pFile, kFileName, fileLength, height, width, nMipmaps, pPixelFormat, caps2, dxgiFormat,
+			           knownTransparency, transparent);
 		
-		getTextureFormat_(pPixelFormat, internalFormat, format, blockSize, compressed);
-		setTextureParameters_(kFilePath, kFileName, cubeMap, cubeDDS, face, 
-			                  width, height, nMipmaps, internalFormat, format, kDataType, compressed);
+		getTextureFormat_(pPixelFormat, dxgiFormat, internalFormat, format, blockSize, compressed);
+		setTextureParameters_(cubeMap, cubeDDS, face, width, height, nMipmaps, internalFormat, format, kDataType, compressed);
 
 		getNumFaces_(caps2, cubeDDS, nFaces);
 
+		knownTransparency_ = knownTransparency;
+		if (knownTransparency) transparent_ = transparent;
+
 		delete[] pPixelFormat;
 	}
 	catch (const exception& kException) {
@@ -209,7 +211,7 @@ void BaseTexture::initTexture_(bool) {
 
 
 void BaseTexture::setTexParameters_(bool repeat, bool linearFiltering, bool mipmapping, bool compareMode) const {
-	glBindTexture(GL_TEXTURE_2D, id_);
+	GlState::bindTexture(id_);
 
 	if (repeat) {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -237,13 +239,19 @@ void BaseTexture::setTexParameters_(bool repeat, bool linearFiltering, bool mipm
 	}
 	else glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
 
-	glBindTexture(GL_TEXTURE_2D, 0u);
+	// one channel images (BC4) are gray
+	if (format_ == GL_COMPRESSED_RED_RGTC1) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+	}
+
+	GlState::bindTexture(0u);
 }
 
 
 
 void BaseTexture::generateMipmaps_(bool mipmapping) {
-	glBindTexture(GL_TEXTURE_2D, id_);
+	GlState::bindTexture(id_);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
 
 	if (mipmapping && nMipmaps_ == 1) {
@@ -254,59 +262,68 @@ void BaseTexture::generateMipmaps_(bool mipmapping) {
 	else if (mipmapping && nMipmaps_ > 1) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, nMipmaps_ - 1);
 	else glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
-	glBindTexture(GL_TEXTURE_2D, 0u);
+	GlState::bindTexture(0u);
 }
 
 
 
-void BaseTexture::computeTexTransparency_() {
-	glBindTexture(GL_TEXTURE_2D, id_);
+// no GL call (worker threads, see 'ColorTexture'); the compressed formats without alpha (BC4, BC5) are opaque
+void BaseTexture::computeTexTransparency_(const GLubyte* pkTextureData) {
+	transparent_ = false;
+	if (!pkTextureData) return;
 
-	GLint textureWidth = 0, textureHeight = 0;
+	size_t size = pOffsets_ ? static_cast<size_t>(pOffsets_[nMipmaps_])
+		                    : static_cast<size_t>(width_) * static_cast<size_t>(height_) * 4u;
 
-	for (GLint iLevel = 0; iLevel < nMipmaps_; iLevel++) {
-		glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_WIDTH, &textureWidth);
-		glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_HEIGHT, &textureHeight);
+	if (!compressed_) {
+		if (format_ == GL_RGBA || format_ == GL_BGRA) transparent_ = AlphaCoverage::isTransparentRgba8(pkTextureData, size / 4u);
+		return;
+	}
 
-		GLubyte* pPixels = new GLubyte[static_cast<size_t>(textureWidth) * textureHeight * 4u];
-		glGetTexImage(GL_TEXTURE_2D, iLevel, GL_RGBA, GL_UNSIGNED_BYTE, pPixels);
+	switch (format_) {
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		transparent_ = AlphaCoverage::isTransparentBc1(pkTextureData, size / 8u);
+		break;
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		transparent_ = AlphaCoverage::isTransparentBc2(pkTextureData, size / 16u);
+		break;
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		transparent_ = AlphaCoverage::isTransparentBc3(pkTextureData, size / 16u);
+		break;
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		transparent_ = AlphaCoverage::isTransparentBc7(pkTextureData, size / 16u);
+		break;
+	default:
+		break;
+	}
+}
 
-		for (GLint row = 0; row < textureHeight; row++)
-			for (GLint col = 0; col < textureWidth; col++) {
-				GLubyte color = pPixels[((row * textureWidth) + col) * 4u + 3u];
 
-				if (color < 255u) {
-					delete[] pPixels;
-					glBindTexture(GL_TEXTURE_2D, 0u);
-					transparent_ = true;
-					return;
-				}
-			}
-
-		delete[] pPixels;
-	}
 
-	glBindTexture(GL_TEXTURE_2D, 0u);
+void BaseTexture::setTexStorage_(GLsizei nLevels) const {
+	glTexStorage2D(GL_TEXTURE_2D, nLevels, compressed_ ? format_ : static_cast<GLenum>(internalFormat_), width_, height_);
 }
 
 
 
-void BaseTexture::setTexImage_(GLint level, GLsizei width, GLsizei height, GLsizei compressedSize,
-	                           const GLubyte* pkTextureData) const {
+// with a pixel buffer bound, the data pointer is an offset into it
+void BaseTexture::setTexSubImage_(GLint level, GLint yOffset, GLsizei width, GLsizei height, GLsizei compressedSize,
+	                              const GLubyte* pkTextureData) const {
 	if (compressed_)
-		glCompressedTexImage2D(GL_TEXTURE_2D, level, format_, width, height, 0, compressedSize,
-		                       (pkTextureData) ? pkTextureData : NULL);
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, yOffset, width, height, format_, compressedSize, pkTextureData);
 
-	else glTexImage2D(GL_TEXTURE_2D, level, internalFormat_, width, height, 0, format_, dataType_, 
-		              (pkTextureData) ? pkTextureData : NULL);
+	else glTexSubImage2D(GL_TEXTURE_2D, level, 0, yOffset, width, height, format_, dataType_, pkTextureData);
 }
 
 
 
 void BaseTexture::readDDsHeader_(FILE* pFile, const string& kFileName, long int& rFileLength, GLsizei& rHeight, GLsizei& rWidth,
-	                             GLint& rnMipmaps, GLuint*& rpPixelFormat, GLuint& rCaps2) const {
+	                             GLint& rnMipmaps, GLuint*& rpPixelFormat, GLuint& rCaps2, GLuint& rDxgiFormat,
+	                             bool& rKnownTransparency, bool& rTransparent) const {
 	const GLuint DDS_MAGIC = 0x20534444;
-	const GLsizei kMagicLength = 4, kHeaderLength = 124, kPixelFormatLength = 32;
+	const GLuint DDPF_FOURCC = 0x4;
+	const GLuint FOURCC_DX10 = 0x30315844;
+	const GLsizei kMagicLength = 4, kHeaderLength = 124, kPixelFormatLength = 32, kDx10HeaderLength = 20;
 
 	int success = std::fseek(pFile, 0L, SEEK_END);
 	if (success != 0)
@@ -347,11 +364,25 @@ void BaseTexture::readDDsHeader_(FILE* pFile, const string& kFileName, long int&
 	}
 
 	rCaps2 = ddsHeader[27u];
+	rDxgiFormat = 0u;
+	rKnownTransparency = TextureCooker::readTransparency(ddsHeader, rTransparent);
+
+	if ((ddsHeader[19u] & DDPF_FOURCC) && ddsHeader[20u] == FOURCC_DX10) {
+		GLuint dx10Header[kDx10HeaderLength / 4u];
+		count = std::fread(&dx10Header, 4u, kDx10HeaderLength / 4u, pFile);
+		if (count != kDx10HeaderLength / 4u || rFileLength <= static_cast<long int>(kDx10HeaderLength))
+			throw runtime_error("BaseTexture.readDDsHeader_|Invalid DDS file: " + kFileName);
+		if (dx10Header[3u] != 1u)
+			throw runtime_error("BaseTexture.readDDsHeader_|DDS texture arrays not supported.");
+
+		rDxgiFormat = dx10Header[0u];
+		rFileLength -= kDx10HeaderLength;
+	}
 }
 
 
 
-void BaseTexture::getTextureFormat_(const GLuint* pkPixelFormat, 
+void BaseTexture::getTextureFormat_(const GLuint* pkPixelFormat, GLuint dxgiFormat,
 	                                GLint& rInternalFormat, GLenum& rFormat, GLuint& rBlockSize, bool& rCompressed) const {
 	const GLuint DDPF_ALPHAPIXELS = 0x1;
 	const GLuint DDPF_FOURCC = 0x4;
@@ -361,6 +392,14 @@ void BaseTexture::getTextureFormat_(const GLuint* pkPixelFormat,
 	const GLuint FOURCC_DXT3 = 0x33545844;
 	const GLuint FOURCC_DXT5 = 0x35545844;
 
+	// the sRGB formats are read as the UNORM ones, the DDS images are decoded in the shaders
+	const GLuint DXGI_FORMAT_BC1_UNORM = 71u, DXGI_FORMAT_BC1_UNORM_SRGB = 72u;
+	const GLuint DXGI_FORMAT_BC2_UNORM = 74u, DXGI_FORMAT_BC2_UNORM_SRGB = 75u;
+	const GLuint DXGI_FORMAT_BC3_UNORM = 77u, DXGI_FORMAT_BC3_UNORM_SRGB = 78u;
+	const GLuint DXGI_FORMAT_BC4_UNORM = 80u;
+	const GLuint DXGI_FORMAT_BC5_UNORM = 83u;
+	const GLuint DXGI_FORMAT_BC7_UNORM = 98u, DXGI_FORMAT_BC7_UNORM_SRGB = 99u;
+
 	const GLuint kRedBitMask = 0x00ff0000;
 	const GLuint kGreenBitMask = 0x0000ff00;
 	const GLuint kBlueBitMask = 0x000000ff;
@@ -374,7 +413,45 @@ void BaseTexture::getTextureFormat_(const GLuint* pkPixelFormat,
 	GLuint blueBitMask = pkPixelFormat[6u];
 	GLuint alfaBitMask = pkPixelFormat[7u];
 
-	if (flags & DDPF_FOURCC) {
+	if (dxgiFormat != 0u) {
+		switch (dxgiFormat) {
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+			rFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+			rBlockSize = 8u;
+			break;
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+			rFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+			rBlockSize = 16u;
+			break;
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+			rFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			rBlockSize = 16u;
+			break;
+		case DXGI_FORMAT_BC4_UNORM:
+			rFormat = GL_COMPRESSED_RED_RGTC1;
+			rBlockSize = 8u;
+			break;
+		case DXGI_FORMAT_BC5_UNORM:
+			rFormat = GL_COMPRESSED_RG_RGTC2;
+			rBlockSize = 16u;
+			break;
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			rFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+			rBlockSize = 16u;
+			break;
+		default:
+			throw runtime_error("BaseTexture.getTextureFormat_|DDS DX10 format not supported.");
+		}
+
+		rInternalFormat = GL_COMPRESSED_RGBA;
+		rCompressed = true;
+	}
+
+	else if (flags & DDPF_FOURCC) {
 		switch (fourCC) {
 		case FOURCC_DXT1:
 			rFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
@@ -452,12 +529,9 @@ void BaseTexture::getNumFaces_(GLuint caps2, bool cubeDDS, GLuint& rnFaces) cons
 
 
 
-void BaseTexture::setTextureParameters_(const string& kFilePath, const string& kFileName, bool cubeMap, bool cubeDDS, GLuint face,
-	                                    GLsizei width, GLsizei height, GLint nMipmaps, 
+void BaseTexture::setTextureParameters_(bool cubeMap, bool cubeDDS, GLuint face, GLsizei width, GLsizei height, GLint nMipmaps, 
 	                                    GLint internalFormat, GLenum format, GLenum dataType, bool compressed) {
 	if (!cubeMap || (cubeMap && !cubeDDS && face == 0u) || (cubeMap && cubeDDS)) {
-		filePath_ = kFilePath;
-		fileName_ = kFileName;
 		width_ = width;
 		height_ = height;
 		nMipmaps_ = nMipmaps;
@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 16, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef BASE_TEXTURE_H
@@ -8,6 +8,10 @@
 
 #include <GL/gl3w.h>
 
+#include "AlphaCoverage.h"
+#include "state/GlState.h"
+#include "texture/cooker/TextureCooker.h"
+
 #include <IL/il.h>
 
 #include <algorithm>
@@ -15,6 +19,7 @@
 #include <cstdio>
 #include <exception>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 
@@ -22,7 +27,9 @@ using std::cout;
 using std::endl;
 using std::exception;
 using std::FILE;
+using std::lock_guard;
 using std::max;
+using std::mutex;
 using std::runtime_error;
 using std::string;
 
@@ -52,32 +59,38 @@ protected:
 
 	virtual void setTexParameters_(bool repeat, bool linearFiltering, bool mipmapping, bool compareMode) const;
 	virtual void generateMipmaps_(bool mipmapping);
-	virtual void computeTexTransparency_();
+	virtual void computeTexTransparency_(const GLubyte* pkTextureData); // all the levels (DDS) or the image, on the CPU
 
-	void setTexImage_(GLint level, GLsizei width, GLsizei height, GLsizei compressedSize, const GLubyte* pkTextureData) const;
+	void setTexStorage_(GLsizei nLevels) const; // immutable
+	// rows ['yOffset', 'yOffset' + 'height') of a level; a multiple of 4 rows (compressed), or up to the last row
+	void setTexSubImage_(GLint level, GLint yOffset, GLsizei width, GLsizei height, GLsizei compressedSize,
+		                 const GLubyte* pkTextureData) const;
 
 	GLubyte** ppTextureData_;
 	GLsizei* pOffsets_;
 	string filePath_, fileName_;
 	GLsizei width_, height_;
-	GLint nMipmaps_, internalFormat_, maxCombinedTextureImageUnits_;
+	GLint nMipmaps_, internalFormat_;
 	GLenum format_, dataType_;	
-	bool dds_, compressed_, transparent_;
+	bool dds_, compressed_, transparent_, knownTransparency_; // known: read from the header of a cooked DDS
 	GLuint id_;
 
 private:
+	static mutex ilMutex_; // DevIL has one bound image per process, the images are decoded one at a time
+
 	BaseTexture(const BaseTexture&);
 	const BaseTexture& operator=(const BaseTexture&) {}
 
+	// 'rDxgiFormat': format of the DX10 header, 0 -> none; 'rKnownTransparency': cooked DDS, see 'TextureCooker'
 	void readDDsHeader_(FILE* pFile, const string& kFileName, long int& rFileLength, GLsizei& rHeight, GLsizei& rWidth,
-		                GLint& rnMipmaps, GLuint*& rpPixelFormat, GLuint& rCaps2) const;
+		                GLint& rnMipmaps, GLuint*& rpPixelFormat, GLuint& rCaps2, GLuint& rDxgiFormat,
+		                bool& rKnownTransparency, bool& rTransparent) const;
 
-	void getTextureFormat_(const GLuint* pkPixelFormat,
+	void getTextureFormat_(const GLuint* pkPixelFormat, GLuint dxgiFormat,
 		                   GLint& rInternalFormat, GLenum& rFormat, GLuint& rBlockSize, bool& rCompressed) const;
 	void getNumFaces_(GLuint caps2, bool cubeDDS, GLuint& rnFaces) const;
 
-	void setTextureParameters_(const string& kFilePath, const string& kFileName, bool cubeMap, bool cubeDDS, GLuint face,
-	                           GLsizei width, GLsizei height, GLint nMipmaps, 
+	void setTextureParameters_(bool cubeMap, bool cubeDDS, GLuint face, GLsizei width, GLsizei height, GLint nMipmaps, 
 		                       GLint internalFormat, GLenum format, GLenum dataType, bool compressed);
 };
 
@@ -1,13 +1,136 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 16, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #include "ColorTexture.h"
 
 
 
-ColorTexture::ColorTexture(GLsizei width, GLsizei height, bool repeat, bool linearFiltering): BaseTexture() {
+const GLsizeiptr ColorTexture::kStagingSize_ = 64 * 1024 * 1024;
+const GLsizeiptr ColorTexture::kMaxChunkSize_ = 16 * 1024 * 1024;
+const GLsizeiptr ColorTexture::kMaxStagedSize_ = 32 * 1024 * 1024;
+
+bool ColorTexture::asyncLoading_ = false;
+
+vector<thread> ColorTexture::workers_;
+mutex ColorTexture::mutex_;
+condition_variable ColorTexture::condition_;
+deque<ColorTexture*> ColorTexture::jobs_;
+list<ColorTexture*> ColorTexture::loading_;
+unsigned int ColorTexture::nTextures_ = 0u;
+bool ColorTexture::stopping_ = false;
+StagingBuffer* ColorTexture::pStagingBuffer_ = nullptr;
+
+
+
+void ColorTexture::setAsyncLoading(bool on) {
+	ColorTexture::asyncLoading_ = on;
+}
+
+
+
+bool ColorTexture::isAsyncLoading() {
+	return ColorTexture::asyncLoading_;
+}
+
+
+
+// decoded -> storage allocated -> per chunk: staged, copied by a worker, uploaded -> resident after its last chunk; the
+// staged bytes are bounded per update, so a frame never copies or uploads much of a large image, and the uploads never
+// wait on the GPU (the staging buffer reuses a region once the fence of its upload is signaled)
+unsigned int ColorTexture::updateLoading() {
+	unsigned int nResident = 0u;
+	GLsizeiptr nStagedSize = 0;
+	bool compareMode = false;
+
+	if (ColorTexture::loading_.empty()) return nResident;
+
+	try {
+		if (!ColorTexture::pStagingBuffer_) ColorTexture::pStagingBuffer_ = new StagingBuffer(ColorTexture::kStagingSize_);
+		ColorTexture::pStagingBuffer_->update();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("ColorTexture.updateLoading > " + string(kException.what()));
+	}
+
+	for (list<ColorTexture*>::iterator it = ColorTexture::loading_.begin(); it != ColorTexture::loading_.end();) {
+		ColorTexture* pTexture = *it;
+		bool resident = false;
+
+		LoadState loadState;
+		{
+			lock_guard<mutex> lock(ColorTexture::mutex_);
+			loadState = pTexture->loadState_;
+		}
+
+		try {
+			switch (loadState) {
+			case LoadState::DECODED:
+				if (pTexture->hasPageFile_) {
+					pTexture->createVirtualTexture_();
+					pTexture->setLoadState_(LoadState::RESIDENT);
+					resident = true;
+				}
+				else if (nStagedSize < ColorTexture::kMaxStagedSize_) {
+					if (!pTexture->hasStorage_) {
+						pTexture->initTexture_(pTexture->mipmapping_);
+						pTexture->setTexParameters_(pTexture->repeat_, pTexture->linearFiltering_, pTexture->mipmapping_,
+						                            compareMode);
+					}
+					if (pTexture->stageChunk_(nStagedSize)) pTexture->setLoadState_(LoadState::STAGED);
+				}
+				break;
+
+			case LoadState::COPIED:
+				pTexture->uploadChunk_();
+
+				if (pTexture->chunkEnd_ == pTexture->getDataSize_()) {
+					pTexture->completeTexture_();
+					pTexture->setLoadState_(LoadState::RESIDENT);
+					resident = true;
+				}
+				else if (nStagedSize < ColorTexture::kMaxStagedSize_ && pTexture->stageChunk_(nStagedSize))
+					pTexture->setLoadState_(LoadState::STAGED);
+				else pTexture->setLoadState_(LoadState::DECODED);
+				break;
+
+			case LoadState::FAILED:
+				ColorTexture::loading_.erase(it);
+				throw runtime_error(pTexture->loadError_);
+
+			default:
+				break;
+			}
+		}
+		catch (const exception& kException) {
+			throw runtime_error("ColorTexture.updateLoading > " + string(kException.what()));
+		}
+
+		if (resident) {
+			pTexture->resident_ = true;
+			it = ColorTexture::loading_.erase(it);
+			nResident++;
+		}
+		else it++;
+	}
+
+	return nResident;
+}
+
+
+
+unsigned int ColorTexture::getNumLoading() {
+	return static_cast<unsigned int>(ColorTexture::loading_.size());
+}
+
+
+
+ColorTexture::ColorTexture(GLsizei width, GLsizei height, bool repeat, bool linearFiltering):
+	                       BaseTexture(), pVirtualTexture_(nullptr), cooked_(false), repeat_(repeat), linearFiltering_(linearFiltering),
+	                       mipmapping_(false), hasPageFile_(false), resident_(false), loadState_(LoadState::NONE),
+	                       loadError_(), hasStorage_(false), chunkBegin_(0u), chunkEnd_(0u), chunkOffset_(0),
+	                       pChunkData_(nullptr) {
 	width_ = width; 
 	height_ = height;
 	internalFormat_ = GL_RGBA8;
@@ -27,13 +150,19 @@ ColorTexture::ColorTexture(GLsizei width, GLsizei height, bool repeat, bool line
 		throw runtime_error("ColorTexture > " + string(kException.what()));
 	}
 
+	resident_ = true;
+
 	//cout << "Color texture " << id_ << " created (1st constructor)." << endl;
 }
 
 
 
 ColorTexture::ColorTexture(const string& kFilePath, const string& kFileName, 
-	                       bool repeat, bool linearFiltering, bool mipmapping) : BaseTexture() {
+	                       bool repeat, bool linearFiltering, bool mipmapping) :
+	                       BaseTexture(), pVirtualTexture_(nullptr), cooked_(false), repeat_(repeat), linearFiltering_(linearFiltering),
+	                       mipmapping_(mipmapping), hasPageFile_(false), resident_(false), loadState_(LoadState::NONE),
+	                       loadError_(), hasStorage_(false), chunkBegin_(0u), chunkEnd_(0u), chunkOffset_(0),
+	                       pChunkData_(nullptr) {
 	ppTextureData_ = new GLubyte*[1u];
 	ppTextureData_[0u] = nullptr;
 	
@@ -42,28 +171,88 @@ ColorTexture::ColorTexture(const string& kFilePath, const string& kFileName,
 		throw runtime_error("ColorTexture|Image name too short.");
 	string extension = kFileName.substr(size - 4u, 4u);
 	dds_ = (extension == ".DDS" || extension == ".dds");
+
+	filePath_ = kFilePath;
+	fileName_ = kFileName;
+
+	if (!dds_ && TextureCooker::isCooked(filePath_, fileName_)) {
+		dds_ = true;
+		cooked_ = true;
+	}
+
+	if (ColorTexture::asyncLoading_) {
+		lock_guard<mutex> lock(ColorTexture::mutex_);
+		if (ColorTexture::workers_.empty()) {
+			unsigned int nWorkers = min(max(thread::hardware_concurrency(), 2u) - 1u, 4u);
+			for (unsigned int i = 0u; i < nWorkers; i++)
+				ColorTexture::workers_.emplace_back(&ColorTexture::work_);
+		}
+		ColorTexture::nTextures_++;
+
+		loadState_ = LoadState::QUEUED;
+		ColorTexture::jobs_.push_back(this);
+		ColorTexture::loading_.push_back(this);
+		ColorTexture::condition_.notify_one();
+
+		//cout << "Color texture " << id_ << " queued (2nd constructor)." << endl;
+		return;
+	}
 	
 	try {
-		if (dds_) loadDDsImage_(kFilePath, kFileName, false, false, 0u);
-		else loadIlImage_(kFilePath, kFileName, false, 0u);
+		loadImage_();
 
-		bool compareMode = false;
-
-		initTexture_(mipmapping);
-		setTexParameters_(repeat, linearFiltering, mipmapping, compareMode);
-		generateMipmaps_(mipmapping);
-		computeTexTransparency_();
+		if (hasPageFile_) createVirtualTexture_();
+		else uploadImage_();
 	}
 	catch (const exception& kException) {
 		throw runtime_error("ColorTexture > " + string(kException.what()));
 	}
 
+	resident_ = true;
+
 	//cout << "Color texture " << id_ << " created (2nd constructor)." << endl;
 }
 
 
 
 ColorTexture::~ColorTexture() {
+	unique_lock<mutex> lock(ColorTexture::mutex_);
+	bool async = loadState_ != LoadState::NONE, last = false;
+
+	if (async) {
+		// a queued job is dropped, a job being run is waited for
+		for (deque<ColorTexture*>::iterator it = ColorTexture::jobs_.begin(); it != ColorTexture::jobs_.end();)
+			if (*it == this) it = ColorTexture::jobs_.erase(it);
+			else it++;
+
+		ColorTexture::condition_.wait(lock, [this] {
+			return loadState_ != LoadState::DECODING && loadState_ != LoadState::COPYING;
+		});
+
+		ColorTexture::nTextures_--;
+		last = ColorTexture::nTextures_ == 0u;
+	}
+
+	if (last) {
+		ColorTexture::stopping_ = true;
+		lock.unlock();
+		ColorTexture::condition_.notify_all();
+
+		for (thread& rWorker : ColorTexture::workers_) rWorker.join();
+		ColorTexture::workers_.clear();
+		ColorTexture::stopping_ = false;
+	}
+	else lock.unlock();
+
+	if (async) ColorTexture::loading_.remove(this);
+
+	if (pChunkData_) ColorTexture::pStagingBuffer_->release(chunkOffset_); // not uploaded
+	if (last && ColorTexture::pStagingBuffer_) {
+		delete ColorTexture::pStagingBuffer_; ColorTexture::pStagingBuffer_ = nullptr;
+	}
+
+	if (pVirtualTexture_) delete pVirtualTexture_;
+
 	//cout << "Color texture " << id_ << " deleted." << endl;
 }
 
@@ -87,8 +276,67 @@ bool ColorTexture::isDDS() const {
 
 
 
+bool ColorTexture::isResident() const {
+	return resident_;
+}
+
+
+
 bool ColorTexture::isTransparent() const {
-	return transparent_;
+	return resident_ && transparent_;
+}
+
+
+
+bool ColorTexture::isVirtual() const {
+	return pVirtualTexture_ != nullptr;
+}
+
+
+
+VirtualTexture* ColorTexture::getVirtualTexture() const {
+	return pVirtualTexture_;
+}
+
+
+
+void ColorTexture::work_() {
+	while (true) {
+		ColorTexture* pTexture = nullptr;
+		bool decode = false;
+
+		{
+			unique_lock<mutex> lock(ColorTexture::mutex_);
+			ColorTexture::condition_.wait(lock, [] {
+				return ColorTexture::stopping_ || !ColorTexture::jobs_.empty();
+			});
+			if (ColorTexture::jobs_.empty()) return;
+
+			pTexture = ColorTexture::jobs_.front();
+			ColorTexture::jobs_.pop_front();
+
+			decode = pTexture->loadState_ == LoadState::QUEUED;
+			pTexture->loadState_ = decode ? LoadState::DECODING : LoadState::COPYING;
+		}
+
+		string error = "";
+		try {
+			if (decode) pTexture->loadImage_();
+			else pTexture->copyChunk_();
+		}
+		catch (const exception& kException) {
+			error = "ColorTexture.work_ > " + string(kException.what());
+		}
+
+		{
+			unique_lock<mutex> lock(ColorTexture::mutex_);
+			pTexture->loadError_ = error;
+			if (!error.empty()) pTexture->loadState_ = LoadState::FAILED;
+			else pTexture->loadState_ = decode ? LoadState::DECODED : LoadState::COPIED;
+		}
+
+		ColorTexture::condition_.notify_all(); // a texture being deleted waits for its job
+	}
 }
 
 
@@ -96,36 +344,244 @@ bool ColorTexture::isTransparent() const {
 void ColorTexture::initTexture_(bool mipmapping) {
 	BaseTexture::initTexture_(mipmapping);
 
-	glBindTexture(GL_TEXTURE_2D, id_);
+	GlState::bindTexture(id_);
+	setTexStorage_(getNumStorageLevels_(mipmapping));
+	GlState::bindTexture(0u);
+	GlDebug::countCalls(1u);
 
-	if (ppTextureData_ && ppTextureData_[0u]) {
-		if (dds_ && pOffsets_) {
-			GLint level = 0;
-			GLsizei tempWidth = width_, tempHeight = height_;
+	hasStorage_ = true;
+}
 
-			do {
-				if (level < nMipmaps_)
-					setTexImage_(level, max(1, tempWidth), max(1, tempHeight), pOffsets_[level + 1], 
-						         ppTextureData_[0u] + pOffsets_[level]);
-				else setTexImage_(level, max(1, tempWidth), max(1, tempHeight), 0, nullptr);
 
-				tempWidth /= 2; tempHeight /= 2; level++;
-			} while (mipmapping && nMipmaps_ > 1 && (tempWidth > 0 || tempHeight > 0));
 
-			delete[] pOffsets_; pOffsets_ = nullptr;
+void ColorTexture::setTexImages_() {
+	if (!ppTextureData_ || !ppTextureData_[0u]) return;
 
-			//cout << endl << "DDS texture '" << fileName_ << "' loaded." << endl;
-		}
-		else if (!dds_) {
-			setTexImage_(0, width_, height_, 0, ppTextureData_[0u]);
+	GlState::bindTexture(id_);
+	setTexRange_(0u, getDataSize_(), ppTextureData_[0u]);
+	GlState::bindTexture(0u);
+
+	delete[] ppTextureData_[0u]; ppTextureData_[0u] = nullptr;
+	delete[] ppTextureData_; ppTextureData_ = nullptr;
+
+	//cout << endl << "Texture '" << fileName_ << "' loaded." << endl;
+}
+
+
+
+// a level is cut at rows of texels, or of blocks (a compressed level: whole blocks, its last rows excepted)
+void ColorTexture::setTexRange_(size_t begin, size_t end, const GLubyte* pkData) const {
+	GLint nLevels = getNumDataLevels_();
+	GLsizei nRowTexels = compressed_ ? 4 : 1;
 
-			//cout << endl << "Texture '" << fileName_ << "' loaded." << endl;
+	for (GLint level = 0; level < nLevels; level++) {
+		size_t levelBegin = getLevelOffset_(level), levelEnd = getLevelOffset_(level + 1);
+		if (levelEnd <= begin || levelBegin >= end || levelEnd == levelBegin) continue;
+
+		size_t rowSize = (levelEnd - levelBegin) / static_cast<size_t>(getNumRows_(level));
+		size_t first = max(begin, levelBegin), last = min(end, levelEnd);
+
+		GLsizei levelWidth = max(1, width_ >> level), levelHeight = max(1, height_ >> level);
+		GLint y = static_cast<GLint>((first - levelBegin) / rowSize) * nRowTexels;
+		GLsizei height = min(levelHeight - y, static_cast<GLsizei>((last - first) / rowSize) * nRowTexels);
+
+		setTexSubImage_(level, y, levelWidth, height, static_cast<GLsizei>(last - first), pkData + (first - begin));
+		GlDebug::countCalls(1u);
+	}
+}
+
+
+
+void ColorTexture::loadImage_() {
+	try {
+		if (cooked_) loadDDsImage_(filePath_, TextureCooker::getCookedFileName(fileName_), false, false, 0u);
+		else if (dds_) loadDDsImage_(filePath_, fileName_, false, false, 0u);
+		else if (VirtualTexture::getMinSize() > 0 && buildPageFile_()) hasPageFile_ = true;
+		else if (!ppTextureData_[0u]) loadIlImage_(filePath_, fileName_, false, 0u); // not loaded for the page file
+
+		// scanned while decoded (the virtual textures: by their page file)
+		if (!hasPageFile_ && !knownTransparency_) computeTexTransparency_(ppTextureData_[0u]);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("ColorTexture.loadImage_ > " + string(kException.what()));
+	}
+}
+
+
+
+// the image is decoded only when its page file is missing or out of date (see 'PageFile'); if it is not virtual after
+// all, it stays in 'ppTextureData_' for the normal path
+bool ColorTexture::buildPageFile_() {
+	PageFile pageFile;
+
+	if (pageFile.open(filePath_, fileName_, repeat_))
+		return max(pageFile.getWidth(), pageFile.getHeight()) >= VirtualTexture::getMinSize();
+
+	try {
+		loadIlImage_(filePath_, fileName_, false, 0u);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("ColorTexture.buildPageFile_ > " + string(kException.what()));
+	}
+
+	if (max(width_, height_) < VirtualTexture::getMinSize() ||
+		!PageFile::build(filePath_, fileName_, ppTextureData_[0u], width_, height_, repeat_)) return false;
+
+	delete[] ppTextureData_[0u]; ppTextureData_[0u] = nullptr;
+	delete[] ppTextureData_; ppTextureData_ = nullptr;
+	return true;
+}
+
+
+
+void ColorTexture::createVirtualTexture_() {
+	try {
+		pVirtualTexture_ = new VirtualTexture(filePath_, fileName_, repeat_);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("ColorTexture.createVirtualTexture_ > " + string(kException.what()));
+	}
+
+	width_ = pVirtualTexture_->getWidth();
+	height_ = pVirtualTexture_->getHeight();
+	transparent_ = pVirtualTexture_->isTransparent();
+
+	//cout << endl << "Virtual texture '" << fileName_ << "' loaded." << endl;
+}
+
+
+
+// the next bytes of the data: whole levels while they fit in 'kMaxChunkSize_', then whole rows (at least one)
+bool ColorTexture::stageChunk_(GLsizeiptr& rnStagedSize) {
+	const size_t kMaxChunkSize = static_cast<size_t>(ColorTexture::kMaxChunkSize_);
+
+	size_t begin = chunkEnd_, end = begin, size = getDataSize_();
+	GLint level = 0;
+
+	while (end < size) {
+		while (getLevelOffset_(level + 1) <= end) level++;
+
+		size_t levelBegin = getLevelOffset_(level), levelEnd = getLevelOffset_(level + 1);
+		if (levelEnd - begin <= kMaxChunkSize) {
+			end = levelEnd;
+			continue;
 		}
 
+		size_t rowSize = (levelEnd - levelBegin) / static_cast<size_t>(getNumRows_(level));
+		size_t nRows = (kMaxChunkSize - (end - begin)) / rowSize;
+		if (nRows == 0u && end == begin) nRows = 1u;
+
+		end += nRows * rowSize;
+		break;
+	}
+
+	GLubyte* pChunkData = ColorTexture::pStagingBuffer_->allocate(static_cast<GLsizeiptr>(end - begin), chunkOffset_);
+	if (!pChunkData) return false;
+
+	pChunkData_ = pChunkData;
+	chunkBegin_ = begin;
+	chunkEnd_ = end;
+	rnStagedSize += static_cast<GLsizeiptr>(end - begin);
+	return true;
+}
+
+
+
+void ColorTexture::copyChunk_() {
+	const GLubyte* pkData = ppTextureData_[0u];
+	std::copy(pkData + chunkBegin_, pkData + chunkEnd_, pChunkData_);
+
+	if (chunkEnd_ == getDataSize_()) {
 		delete[] ppTextureData_[0u]; ppTextureData_[0u] = nullptr;
 		delete[] ppTextureData_; ppTextureData_ = nullptr;
 	}
-	else setTexImage_(0, width_, height_, 0, nullptr);
+}
+
+
+
+void ColorTexture::uploadChunk_() {
+	GlState::bindTexture(id_);
+	ColorTexture::pStagingBuffer_->startReading();
+
+	setTexRange_(chunkBegin_, chunkEnd_, reinterpret_cast<const GLubyte*>(chunkOffset_));
+
+	ColorTexture::pStagingBuffer_->stopReading();
+	GlState::bindTexture(0u);
+
+	ColorTexture::pStagingBuffer_->release(chunkOffset_);
+	pChunkData_ = nullptr;
+}
+
+
+
+void ColorTexture::uploadImage_() {
+	bool compareMode = false;
+
+	try {
+		initTexture_(mipmapping_);
+		setTexParameters_(repeat_, linearFiltering_, mipmapping_, compareMode);
+		setTexImages_();
+		completeTexture_();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("ColorTexture.uploadImage_ > " + string(kException.what()));
+	}
+}
+
+
+
+void ColorTexture::completeTexture_() {
+	generateMipmaps_(mipmapping_);
+
+	if (pOffsets_) {
+		delete[] pOffsets_; pOffsets_ = nullptr;
+	}
+}
+
+
+
+void ColorTexture::setLoadState_(LoadState loadState) {
+	lock_guard<mutex> lock(ColorTexture::mutex_);
+	loadState_ = loadState;
+
+	if (loadState == LoadState::STAGED) {
+		ColorTexture::jobs_.push_back(this);
+		ColorTexture::condition_.notify_one();
+	}
+}
+
+
+
+// the image has all its levels in storage (a missing chain is generated), the data has those of the DDS only
+GLsizei ColorTexture::getNumStorageLevels_(bool mipmapping) const {
+	if (!mipmapping) return 1;
+	if (nMipmaps_ > 1) return nMipmaps_;
+	return 1 + static_cast<GLsizei>(std::floor(std::log2(max(width_, height_))));
+}
+
+
+
+GLint ColorTexture::getNumDataLevels_() const {
+	return (dds_ && mipmapping_) ? nMipmaps_ : 1;
+}
+
+
+
+// 'level' up to the number of data levels (-> the data size)
+size_t ColorTexture::getLevelOffset_(GLint level) const {
+	if (dds_) return static_cast<size_t>(pOffsets_[level]);
+	return (level == 0) ? 0u : static_cast<size_t>(width_) * static_cast<size_t>(height_) * 4u;
+}
+
+
+
+GLsizei ColorTexture::getNumRows_(GLint level) const {
+	GLsizei height = max(1, height_ >> level);
+	return compressed_ ? (height + 3) / 4 : height;
+}
+
+
 
-	glBindTexture(GL_TEXTURE_2D, 0u);
+size_t ColorTexture::getDataSize_() const {
+	return getLevelOffset_(getNumDataLevels_());
 }
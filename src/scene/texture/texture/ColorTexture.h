@@ -1,6 +1,6 @@
 /**
  * Author: Oldrin Barbulescu
- * Last modified: Feb 16, 2021
+ * Last modified: Oct 17, 2026
  **/
 
 #ifndef COLOR_TEXTURE_H
@@ -9,21 +9,41 @@
 #include <GL/gl3w.h>
 
 #include "BaseTexture.h"
+#include "StagingBuffer.h"
+#include "info/GlDebug.h"
+#include "texture/cooker/TextureCooker.h"
+#include "texture/virtual/PageFile.h"
+#include "texture/virtual/VirtualTexture.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
 #include <exception>
 #include <iostream>
+#include <list>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
+using std::condition_variable;
 using std::cout;
+using std::deque;
 using std::endl;
 using std::exception;
+using std::list;
+using std::lock_guard;
 using std::max;
+using std::min;
+using std::mutex;
 using std::runtime_error;
 using std::size_t;
 using std::string;
+using std::thread;
+using std::unique_lock;
+using std::vector;
 
 
 
@@ -31,7 +51,19 @@ class ColorTexture : public BaseTexture {
 public:
 	enum class TextureType { NONE = 0u, DIFFUSE = 2u, SPECULAR = 3u, EMISSIVE = 4u, NORMAL_MAP = 5u };
 
+	// the file textures created while on are decoded by a pool of worker threads and streamed by 'updateLoading' into
+	// their immutable storage, a few rows or levels per frame, through a persistently mapped staging buffer; until then
+	// they are not resident, and their materials are drawn with their colors only
+	static void setAsyncLoading(bool on);
+	static bool isAsyncLoading();
+
+	static unsigned int updateLoading(); // once per frame -> number of textures made resident
+	static unsigned int getNumLoading(); // not resident yet
+
 	ColorTexture(GLsizei width, GLsizei height, bool repeat, bool linearFiltering);
+	// images (not DDS) with a side of at least 'VirtualTexture::getMinSize' texels are virtual textures, tiled into
+	// their page file on first load (power-of-two sides only, otherwise loaded whole); see 'setAsyncLoading'
+	// an image cooked and up to date (see 'TextureCooker') is loaded from its cooked DDS instead
 	ColorTexture(const string& kFilePath, const string& kFileName, bool repeat, bool linearFiltering, bool mipmapping);
 	virtual ~ColorTexture();
 
@@ -52,15 +84,73 @@ public:
 	string getFileName() const;
 
 	bool isDDS() const;
+	bool isResident() const; // the other getters of the image are valid once resident
 	bool isTransparent() const;
 
+	bool isVirtual() const;
+	VirtualTexture* getVirtualTexture() const; // nullptr if not virtual, read with 'VirtualTexture.startReading'
+
 	//-> GLuint getId() const;	
 
 private:
+	enum class LoadState { NONE = 0u, QUEUED, DECODING, DECODED, STAGED, COPYING, COPIED, RESIDENT, FAILED };
+
+	static const GLsizeiptr kStagingSize_;
+	static const GLsizeiptr kMaxChunkSize_; // one chunk in flight per texture
+	static const GLsizeiptr kMaxStagedSize_; // per update
+
+	static bool asyncLoading_;
+
+	static vector<thread> workers_;
+	static mutex mutex_;
+	static condition_variable condition_;
+	static deque<ColorTexture*> jobs_; // 'QUEUED' -> decode, 'STAGED' -> copy a chunk to the staging buffer
+	static list<ColorTexture*> loading_; // main thread
+	static unsigned int nTextures_; // asynchronous
+	static bool stopping_;
+	static StagingBuffer* pStagingBuffer_; // main thread, while there are asynchronous textures
+
+	static void work_();
+
 	ColorTexture(const ColorTexture&);
 	const ColorTexture& operator=(const ColorTexture&) {}
 
-	virtual void initTexture_(bool mipmapping);
+	virtual void initTexture_(bool mipmapping); // storage only
+	void setTexImages_(); // all the data, from client memory
+	// the levels overlapping the bytes ['begin', 'end') of the data, cut at rows; 'pkData': byte 'begin' (a pointer, or
+	// an offset into the bound pixel buffer)
+	void setTexRange_(size_t begin, size_t end, const GLubyte* pkData) const;
+
+	// steps of the loading: 'loadImage_' and 'copyChunk_' make no GL call (worker threads), the others run on the main
+	// thread; asynchronous: 'loadImage_', then 'createVirtualTexture_' or 'initTexture_' and, chunk by chunk,
+	// 'stageChunk_', 'copyChunk_' and 'uploadChunk_'; synchronous: 'loadImage_', then 'createVirtualTexture_' or
+	// 'uploadImage_'
+	void loadImage_();
+	bool buildPageFile_(); // false -> not virtual
+	void createVirtualTexture_();
+	bool stageChunk_(GLsizeiptr& rnStagedSize); // false -> the staging buffer is full
+	void copyChunk_(); // the last one frees the image
+	void uploadChunk_();
+	void uploadImage_();
+	void completeTexture_();
+
+	void setLoadState_(LoadState loadState);
+	GLsizei getNumStorageLevels_(bool mipmapping) const;
+	GLint getNumDataLevels_() const;
+	size_t getLevelOffset_(GLint level) const;
+	GLsizei getNumRows_(GLint level) const; // of blocks, if compressed
+	size_t getDataSize_() const;
+
+	VirtualTexture* pVirtualTexture_;
+
+	bool cooked_, repeat_, linearFiltering_, mipmapping_, hasPageFile_, resident_;
+	LoadState loadState_; // 'mutex_'
+	string loadError_;
+
+	bool hasStorage_;
+	size_t chunkBegin_, chunkEnd_; // in the data; 'chunkEnd_': staged so far
+	GLintptr chunkOffset_; // in the staging buffer
+	GLubyte* pChunkData_; // nullptr -> no chunk staged
 };
 
 #endif
@@ -0,0 +1,115 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "StagingBuffer.h"
+
+
+
+const GLsizeiptr StagingBuffer::kAlignment_ = 64;
+
+
+
+StagingBuffer::StagingBuffer(GLsizeiptr size) : id_(0u), pData_(nullptr), size_(size), head_(0), regions_() {
+	const GLbitfield kFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	if (size_ <= 0) throw runtime_error("StagingBuffer|Invalid size value.");
+
+	glGenBuffers(1, &id_);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, id_);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size_, nullptr, kFlags);
+	pData_ = static_cast<GLubyte*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size_, kFlags));
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0u);
+	GlDebug::countCalls(5u);
+
+	if (!pData_) {
+		glDeleteBuffers(1, &id_);
+		GlDebug::countCalls(1u);
+		throw runtime_error("StagingBuffer|Cannot map the staging buffer.");
+	}
+}
+
+
+
+StagingBuffer::~StagingBuffer() {
+	for (REGION& rRegion : regions_)
+		if (rRegion.fence) glDeleteSync(rRegion.fence);
+
+	glDeleteBuffers(1, &id_); // unmapped
+}
+
+
+
+// the regions in use are [offset of the first region, head_), wrapped at the end of the buffer
+GLubyte* StagingBuffer::allocate(GLsizeiptr size, GLintptr& rOffset) {
+	size = (size + StagingBuffer::kAlignment_ - 1) / StagingBuffer::kAlignment_ * StagingBuffer::kAlignment_;
+	if (size <= 0 || size > size_) return nullptr;
+
+	GLintptr offset = -1;
+	if (regions_.empty()) offset = 0;
+	else {
+		GLintptr tail = regions_.front().offset;
+
+		if (head_ > tail) {
+			if (head_ + size <= size_) offset = head_;
+			else if (size <= tail) offset = 0;
+		}
+		else if (head_ + size <= tail) offset = head_;
+	}
+
+	if (offset < 0) return nullptr;
+
+	head_ = offset + size;
+	regions_.push_back({ offset, nullptr });
+
+	rOffset = offset;
+	return pData_ + offset;
+}
+
+
+
+void StagingBuffer::release(GLintptr offset) {
+	for (REGION& rRegion : regions_)
+		if (rRegion.offset == offset && !rRegion.fence) {
+			rRegion.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
+			GlDebug::countCalls(1u);
+			return;
+		}
+}
+
+
+
+void StagingBuffer::update() {
+	while (!regions_.empty() && regions_.front().fence) {
+		GLenum status = glClientWaitSync(regions_.front().fence, 0u, 0u);
+		GlDebug::countQueries(1u);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+		glDeleteSync(regions_.front().fence);
+		GlDebug::countCalls(1u);
+		regions_.pop_front();
+	}
+
+	if (regions_.empty()) head_ = 0;
+}
+
+
+
+void StagingBuffer::startReading() const {
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, id_);
+	GlDebug::countCalls(1u);
+}
+
+
+
+void StagingBuffer::stopReading() const {
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0u);
+	GlDebug::countCalls(1u);
+}
+
+
+
+GLsizeiptr StagingBuffer::getSize() const {
+	return size_;
+}
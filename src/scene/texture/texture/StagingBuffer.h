@@ -0,0 +1,57 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef STAGING_BUFFER_H
+#define STAGING_BUFFER_H
+
+#include <GL/gl3w.h>
+
+#include "info/GlDebug.h"
+
+#include <deque>
+#include <stdexcept>
+
+using std::deque;
+using std::runtime_error;
+
+
+
+// Persistently mapped pixel unpack buffer, used as a ring by the uploads of the file textures (see 'ColorTexture'). A
+// region is allocated on the main thread, written through its pointer by any thread, uploaded from (offset into the
+// bound buffer), then released; it is reused once the fence of its upload is signaled. The regions are reused in
+// their allocation order, the ring never waits on the GPU. The GL calls are made on the main thread only.
+class StagingBuffer {
+public:
+	explicit StagingBuffer(GLsizeiptr size);
+	~StagingBuffer();
+
+	GLubyte* allocate(GLsizeiptr size, GLintptr& rOffset); // nullptr -> no space until earlier regions are reused
+	void release(GLintptr offset); // after its uploads (or unused)
+	void update(); // once per frame, reuses the regions of the completed uploads
+
+	void startReading() const; // binds the buffer to 'GL_PIXEL_UNPACK_BUFFER'
+	void stopReading() const;
+
+	GLsizeiptr getSize() const;
+
+private:
+	static const GLsizeiptr kAlignment_;
+
+	StagingBuffer(const StagingBuffer&);
+	const StagingBuffer& operator=(const StagingBuffer&) {}
+
+	struct REGION {
+		GLintptr offset;
+		GLsync fence; // nullptr -> not released yet
+	};
+
+	GLuint id_;
+	GLubyte* pData_;
+	GLsizeiptr size_;
+	GLintptr head_; // end of the last region
+	deque<REGION> regions_; // allocation order
+};
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "FeedbackBuffer.h"
+
+
+
+const unsigned int FeedbackBuffer::knPixelBuffers_ = 2u;
+
+
+
+GLsizei FeedbackBuffer::getScale() {
+	return 8;
+}
+
+
+
+FeedbackBuffer::FeedbackBuffer(const uvec2& kWindowSize) : windowSize_(kWindowSize), size_(0u), fbo_(0u),
+	                                                       colorTexture_(0u), depthRenderbuffer_(0u), pixelBuffers_(),
+	                                                       fences_(), nextPixelBuffer_(0u) {
+	try {
+		createBuffers_();
+	}
+	catch (const exception& kException) {
+		deleteBuffers_();
+		throw runtime_error("FeedbackBuffer > " + string(kException.what()));
+	}
+
+	//cout << "Feedback buffer " << size_.x << " x " << size_.y << " created." << endl;
+}
+
+
+
+FeedbackBuffer::~FeedbackBuffer() {
+	deleteBuffers_();
+
+	//cout << "Feedback buffer deleted." << endl;
+}
+
+
+
+void FeedbackBuffer::setWindowSize(const uvec2& kWindowSize) {
+	windowSize_ = kWindowSize;
+
+	// the pending readbacks have the old size, they are dropped
+	deleteBuffers_();
+
+	try {
+		createBuffers_();
+	}
+	catch (const exception& kException) {
+		throw runtime_error("FeedbackBuffer.setWindowSize > " + string(kException.what()));
+	}
+}
+
+
+
+void FeedbackBuffer::start() const {
+	const GLfloat kpClearColor[4u] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const GLfloat kClearDepth = 1.0f;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+	glViewport(0, 0, static_cast<GLsizei>(size_.x), static_cast<GLsizei>(size_.y));
+	glClearBufferfv(GL_COLOR, 0, kpClearColor);
+	glClearBufferfv(GL_DEPTH, 0, &kClearDepth);
+	GlDebug::countCalls(4u);
+}
+
+
+
+void FeedbackBuffer::stop() {
+	GLuint pixelBuffer = pixelBuffers_.at(nextPixelBuffer_);
+	GLsync& rFence = fences_.at(nextPixelBuffer_);
+
+	// a readback not read yet is overwritten, the newer pixels are as good
+	if (rFence) {
+		glDeleteSync(rFence);
+		GlDebug::countCalls(1u);
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+	glReadPixels(0, 0, static_cast<GLsizei>(size_.x), static_cast<GLsizei>(size_.y), GL_RGBA, GL_FLOAT, nullptr);
+	rFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0u);
+	glViewport(0, 0, static_cast<GLsizei>(windowSize_.x), static_cast<GLsizei>(windowSize_.y));
+	GlDebug::countCalls(7u);
+
+	nextPixelBuffer_ = (nextPixelBuffer_ + 1u) % FeedbackBuffer::knPixelBuffers_;
+}
+
+
+
+bool FeedbackBuffer::getPixels(vector<vec4>& rPixels) {
+	size_t nPixels = static_cast<size_t>(size_.x) * size_.y;
+
+	// oldest first: the next buffer to be written
+	for (unsigned int i = 0u; i < FeedbackBuffer::knPixelBuffers_; i++) {
+		unsigned int index = (nextPixelBuffer_ + i) % FeedbackBuffer::knPixelBuffers_;
+		GLsync& rFence = fences_.at(index);
+		if (!rFence) continue;
+
+		GLenum status = glClientWaitSync(rFence, 0u, 0u);
+		GlDebug::countQueries(1u);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+
+		glDeleteSync(rFence);
+		rFence = nullptr;
+
+		rPixels.resize(nPixels);
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers_.at(index));
+		const void* pkData = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(nPixels * sizeof(vec4)),
+			                                  GL_MAP_READ_BIT);
+		if (pkData) {
+			std::memcpy(rPixels.data(), pkData, nPixels * sizeof(vec4));
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+		GlDebug::countCalls(4u);
+
+		return pkData != nullptr;
+	}
+
+	return false;
+}
+
+
+
+uvec2 FeedbackBuffer::getSize() const {
+	return size_;
+}
+
+
+
+void FeedbackBuffer::createBuffers_() {
+	GLsizei scale = FeedbackBuffer::getScale();
+	size_ = uvec2(static_cast<unsigned int>(max(1, static_cast<GLsizei>(windowSize_.x) / scale)),
+		          static_cast<unsigned int>(max(1, static_cast<GLsizei>(windowSize_.y) / scale)));
+
+	// texture coordinates, footprint, material id: exact values, no blending
+	glGenTextures(1, &colorTexture_);
+	GlState::bindTexture(colorTexture_);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, static_cast<GLsizei>(size_.x), static_cast<GLsizei>(size_.y));
+
+	glGenRenderbuffers(1, &depthRenderbuffer_);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer_);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, static_cast<GLsizei>(size_.x),
+		                  static_cast<GLsizei>(size_.y));
+	glBindRenderbuffer(GL_RENDERBUFFER, 0u);
+
+	glGenFramebuffers(1, &fbo_);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture_, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer_);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0u);
+	GlDebug::countCalls(12u);
+
+	if (status != GL_FRAMEBUFFER_COMPLETE) throw runtime_error("FeedbackBuffer.createBuffers_|Incomplete framebuffer.");
+
+	pixelBuffers_.assign(FeedbackBuffer::knPixelBuffers_, 0u);
+	fences_.assign(FeedbackBuffer::knPixelBuffers_, nullptr);
+	nextPixelBuffer_ = 0u;
+
+	glGenBuffers(static_cast<GLsizei>(FeedbackBuffer::knPixelBuffers_), pixelBuffers_.data());
+	for (GLuint iPixelBuffer : pixelBuffers_) {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, iPixelBuffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(static_cast<size_t>(size_.x) * size_.y * sizeof(vec4)),
+			         nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0u);
+	GlDebug::countCalls(2u + 2u * FeedbackBuffer::knPixelBuffers_);
+}
+
+
+
+void FeedbackBuffer::deleteBuffers_() {
+	for (GLsync iFence : fences_)
+		if (iFence) glDeleteSync(iFence);
+	fences_.clear();
+
+	if (!pixelBuffers_.empty()) glDeleteBuffers(static_cast<GLsizei>(pixelBuffers_.size()), pixelBuffers_.data());
+	pixelBuffers_.clear();
+
+	glDeleteFramebuffers(1, &fbo_);
+	glDeleteRenderbuffers(1, &depthRenderbuffer_);
+	GlState::deleteTexture(colorTexture_);
+	fbo_ = depthRenderbuffer_ = colorTexture_ = 0u;
+}
@@ -0,0 +1,86 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef FEEDBACK_BUFFER_H
+#define FEEDBACK_BUFFER_H
+
+#include <GL/gl3w.h>
+
+#include "info/GlDebug.h"
+#include "state/GlState.h"
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using glm::uvec2;
+using glm::vec4;
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::max;
+using std::runtime_error;
+using std::size_t;
+using std::string;
+using std::vector;
+
+
+
+// Low-resolution render target of the virtual texture feedback pass (1/'getScale' of the window on each side), see
+// 'shaders/main/scene.frag' and 'Scene.updateVirtualTextures_'. The pixels are copied to a ring of pixel buffers and
+// read when their fence is signaled, one or two frames later, so the CPU never waits for the GPU.
+class FeedbackBuffer {
+public:
+	static GLsizei getScale();
+
+
+	FeedbackBuffer(const uvec2& kWindowSize);
+	~FeedbackBuffer();
+
+
+	// set
+	//############################################################################
+	void setWindowSize(const uvec2& kWindowSize);
+
+
+	// render: 1) start (binds and clears the buffer)
+	//         2) draw
+	//         3) stop (starts the readback, binds the window)
+	//############################################################################
+	void start() const;
+	void stop();
+
+
+	// get
+	//############################################################################
+	bool getPixels(vector<vec4>& rPixels); // false -> no readback finished since the last call
+	uvec2 getSize() const;
+
+private:
+	static const unsigned int knPixelBuffers_;
+
+	FeedbackBuffer(const FeedbackBuffer&);
+	const FeedbackBuffer& operator=(const FeedbackBuffer&) {}
+
+	void createBuffers_();
+	void deleteBuffers_();
+
+	uvec2 windowSize_, size_;
+	GLuint fbo_, colorTexture_, depthRenderbuffer_;
+
+	vector<GLuint> pixelBuffers_;
+	vector<GLsync> fences_; // nullptr -> no readback pending
+	unsigned int nextPixelBuffer_;
+};
+
+#endif
@@ -0,0 +1,274 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "PageFile.h"
+
+
+
+const GLsizei PageFile::kTileSize = 128;
+const GLsizei PageFile::kTileBorder = 4;
+
+const char PageFile::kMagic_[4u] = { 'B', 'M', 'V', 'T' };
+const GLuint PageFile::kVersion_ = 1u;
+
+
+
+GLsizei PageFile::getPaddedTileSize() {
+	return PageFile::kTileSize + 2 * PageFile::kTileBorder;
+}
+
+
+
+bool PageFile::canTile(GLsizei width, GLsizei height) {
+	return width >= PageFile::kTileSize && height >= PageFile::kTileSize &&
+		   (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+}
+
+
+
+bool PageFile::build(const string& kFilePath, const string& kFileName, const GLubyte* pkImage, GLsizei width,
+	                 GLsizei height, bool repeat) {
+	if (!pkImage || !PageFile::canTile(width, height)) return false;
+
+	FILE_HEADER header = {};
+	std::copy(PageFile::kMagic_, PageFile::kMagic_ + 4u, header.magic);
+	header.version = PageFile::kVersion_;
+	header.width = width;
+	header.height = height;
+	header.tileSize = PageFile::kTileSize;
+	header.tileBorder = PageFile::kTileBorder;
+	header.repeat = repeat ? 1u : 0u;
+	if (!FileInfo::get(kFilePath + "/" + kFileName, header.sourceSize, header.sourceTime)) return false;
+
+	// down to the level of a single page
+	header.nLevels = 1;
+	while ((width >> (header.nLevels - 1)) > PageFile::kTileSize || (height >> (header.nLevels - 1)) > PageFile::kTileSize)
+		header.nLevels++;
+
+	size_t nTexels = static_cast<size_t>(width) * static_cast<size_t>(height);
+	header.transparent = AlphaCoverage::isTransparentRgba8(pkImage, nTexels) ? 1u : 0u;
+
+	string pageFilePath = PageFile::getPageFilePath_(kFilePath, kFileName);
+	FILE* pFile;
+	fopen_s(&pFile, pageFilePath.c_str(), "wb");
+	if (pFile == NULL) {
+		cout << "Page file: cannot write the '" << pageFilePath << "' file." << endl;
+		return false;
+	}
+
+	GLsizei paddedTileSize = PageFile::getPaddedTileSize();
+	size_t tileLength = static_cast<size_t>(paddedTileSize) * paddedTileSize * 4u;
+	vector<GLubyte> tile(tileLength), level, nextLevel;
+
+	const GLubyte* pkLevel = pkImage;
+	GLsizei levelWidth = width, levelHeight = height;
+	bool written = std::fwrite(&header, sizeof(FILE_HEADER), 1u, pFile) == 1u;
+
+	for (GLint iLevel = 0; iLevel < header.nLevels && written; iLevel++) {
+		if (iLevel > 0) {
+			nextLevel.resize(static_cast<size_t>(max(1, levelWidth / 2)) * max(1, levelHeight / 2) * 4u);
+			PageFile::downsample_(pkLevel, levelWidth, levelHeight, nextLevel.data());
+			level.swap(nextLevel);
+
+			pkLevel = level.data();
+			levelWidth = max(1, levelWidth / 2);
+			levelHeight = max(1, levelHeight / 2);
+		}
+
+		GLsizei nPagesX = max(1, levelWidth / PageFile::kTileSize), nPagesY = max(1, levelHeight / PageFile::kTileSize);
+		for (GLint iPageY = 0; iPageY < nPagesY && written; iPageY++)
+			for (GLint iPageX = 0; iPageX < nPagesX && written; iPageX++) {
+				PageFile::cutTile_(pkLevel, levelWidth, levelHeight, iPageX, iPageY, repeat, tile.data());
+				written = std::fwrite(tile.data(), 1u, tileLength, pFile) == tileLength;
+			}
+	}
+
+	std::fclose(pFile);
+
+	// a partial file would only be rejected later, remove it now
+	if (!written) {
+		std::remove(pageFilePath.c_str());
+		cout << "Page file: cannot write the '" << pageFilePath << "' file." << endl;
+		return false;
+	}
+
+	cout << "Page file '" << kFileName << ".vtp' written (" << width << " x " << height << ", " << header.nLevels
+		 << " levels)." << endl;
+	return true;
+}
+
+
+
+PageFile::PageFile() : pFile_(nullptr), header_(), mutex_() {
+	//cout << "Page file created." << endl;
+}
+
+
+
+PageFile::~PageFile() {
+	if (pFile_) std::fclose(pFile_);
+
+	//cout << "Page file deleted." << endl;
+}
+
+
+
+bool PageFile::open(const string& kFilePath, const string& kFileName, bool repeat) {
+	if (pFile_) {
+		std::fclose(pFile_);
+		pFile_ = nullptr;
+	}
+
+	long long sourceSize = 0ll, sourceTime = 0ll;
+	if (!FileInfo::get(kFilePath + "/" + kFileName, sourceSize, sourceTime)) return false;
+
+	fopen_s(&pFile_, PageFile::getPageFilePath_(kFilePath, kFileName).c_str(), "rb");
+	if (pFile_ == NULL) return false;
+
+	size_t count = std::fread(&header_, sizeof(FILE_HEADER), 1u, pFile_);
+	if (count != 1u || string(header_.magic, 4u) != string(PageFile::kMagic_, 4u) ||
+		header_.version != PageFile::kVersion_ || header_.tileSize != PageFile::kTileSize ||
+		header_.tileBorder != PageFile::kTileBorder || !PageFile::canTile(header_.width, header_.height) ||
+		header_.nLevels <= 0 || (header_.repeat != 0u) != repeat ||
+		header_.sourceSize != sourceSize || header_.sourceTime != sourceTime) {
+		std::fclose(pFile_);
+		pFile_ = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void PageFile::readTile(GLint level, GLint pageX, GLint pageY, GLubyte* pTile) {
+	if (!pFile_) throw runtime_error("PageFile.readTile|Page file not opened.");
+	if (level < 0 || level >= header_.nLevels || pageX < 0 || pageX >= getNumPagesX(level) ||
+		pageY < 0 || pageY >= getNumPagesY(level))
+		throw runtime_error("PageFile.readTile|Invalid page value.");
+
+	size_t tileLength = static_cast<size_t>(PageFile::getPaddedTileSize()) * PageFile::getPaddedTileSize() * 4u;
+
+	lock_guard<mutex> lock(mutex_);
+
+	if (_fseeki64(pFile_, getTileOffset_(level, pageX, pageY), SEEK_SET) != 0 ||
+		std::fread(pTile, 1u, tileLength, pFile_) != tileLength)
+		throw runtime_error("PageFile.readTile|An error occured while reading the page file.");
+}
+
+
+
+GLsizei PageFile::getWidth() const {
+	return header_.width;
+}
+
+
+
+GLsizei PageFile::getHeight() const {
+	return header_.height;
+}
+
+
+
+GLint PageFile::getNumLevels() const {
+	return header_.nLevels;
+}
+
+
+
+GLsizei PageFile::getNumPagesX(GLint level) const {
+	return max(1, (header_.width >> level) / PageFile::kTileSize);
+}
+
+
+
+GLsizei PageFile::getNumPagesY(GLint level) const {
+	return max(1, (header_.height >> level) / PageFile::kTileSize);
+}
+
+
+
+bool PageFile::isTransparent() const {
+	return header_.transparent != 0u;
+}
+
+
+
+string PageFile::getPageFilePath_(const string& kFilePath, const string& kFileName) {
+	return kFilePath + "/" + kFileName + ".vtp";
+}
+
+
+
+// 2 x 2 box filter, the color channels averaged in linear space (as 'glGenerateMipmap' does for sRGB textures)
+void PageFile::downsample_(const GLubyte* pkSource, GLsizei width, GLsizei height, GLubyte* pTarget) {
+	const size_t knLinearValues = 4096u;
+
+	float toLinear[256u];
+	for (unsigned int i = 0u; i < 256u; i++) {
+		float value = static_cast<float>(i) / 255.0f;
+		toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	vector<GLubyte> toSrgb(knLinearValues);
+	for (size_t i = 0u; i < knLinearValues; i++) {
+		float value = static_cast<float>(i) / static_cast<float>(knLinearValues - 1u);
+		value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		toSrgb[i] = static_cast<GLubyte>(std::lround(min(max(value, 0.0f), 1.0f) * 255.0f));
+	}
+
+	GLsizei targetWidth = max(1, width / 2), targetHeight = max(1, height / 2);
+
+	for (GLsizei y = 0; y < targetHeight; y++) {
+		const GLubyte* pkRow0 = pkSource + static_cast<size_t>(min(2 * y, height - 1)) * width * 4u;
+		const GLubyte* pkRow1 = pkSource + static_cast<size_t>(min(2 * y + 1, height - 1)) * width * 4u;
+		GLubyte* pTargetRow = pTarget + static_cast<size_t>(y) * targetWidth * 4u;
+
+		for (GLsizei x = 0; x < targetWidth; x++) {
+			size_t x0 = static_cast<size_t>(min(2 * x, width - 1)) * 4u, x1 = static_cast<size_t>(min(2 * x + 1, width - 1)) * 4u;
+
+			for (size_t iChannel = 0u; iChannel < 3u; iChannel++) {
+				float value = 0.25f * (toLinear[pkRow0[x0 + iChannel]] + toLinear[pkRow0[x1 + iChannel]] +
+					                   toLinear[pkRow1[x0 + iChannel]] + toLinear[pkRow1[x1 + iChannel]]);
+				pTargetRow[x * 4u + iChannel] = toSrgb[static_cast<size_t>(value * (knLinearValues - 1u) + 0.5f)];
+			}
+
+			pTargetRow[x * 4u + 3u] = static_cast<GLubyte>((pkRow0[x0 + 3u] + pkRow0[x1 + 3u] + pkRow1[x0 + 3u] +
+				                                            pkRow1[x1 + 3u] + 2u) / 4u);
+		}
+	}
+}
+
+
+
+void PageFile::cutTile_(const GLubyte* pkImage, GLsizei width, GLsizei height, GLint pageX, GLint pageY, bool repeat,
+	                    GLubyte* pTile) {
+	GLsizei paddedTileSize = PageFile::getPaddedTileSize();
+
+	for (GLint y = 0; y < paddedTileSize; y++) {
+		GLint imageY = pageY * PageFile::kTileSize + y - PageFile::kTileBorder;
+		imageY = repeat ? ((imageY % height) + height) % height : min(max(imageY, 0), height - 1);
+
+		for (GLint x = 0; x < paddedTileSize; x++) {
+			GLint imageX = pageX * PageFile::kTileSize + x - PageFile::kTileBorder;
+			imageX = repeat ? ((imageX % width) + width) % width : min(max(imageX, 0), width - 1);
+
+			const GLubyte* pkTexel = pkImage + (static_cast<size_t>(imageY) * width + imageX) * 4u;
+			std::copy(pkTexel, pkTexel + 4u, pTile + (static_cast<size_t>(y) * paddedTileSize + x) * 4u);
+		}
+	}
+}
+
+
+
+long long PageFile::getTileOffset_(GLint level, GLint pageX, GLint pageY) const {
+	long long tileLength = static_cast<long long>(PageFile::getPaddedTileSize()) * PageFile::getPaddedTileSize() * 4ll;
+	long long offset = static_cast<long long>(sizeof(FILE_HEADER));
+
+	for (GLint iLevel = 0; iLevel < level; iLevel++)
+		offset += static_cast<long long>(getNumPagesX(iLevel)) * getNumPagesY(iLevel) * tileLength;
+
+	return offset + (static_cast<long long>(pageY) * getNumPagesX(level) + pageX) * tileLength;
+}
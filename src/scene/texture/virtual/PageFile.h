@@ -0,0 +1,107 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef PAGE_FILE_H
+#define PAGE_FILE_H
+
+#include <GL/gl3w.h>
+
+#include "info/FileInfo.h"
+#include "texture/texture/AlphaCoverage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::FILE;
+using std::lock_guard;
+using std::max;
+using std::min;
+using std::mutex;
+using std::runtime_error;
+using std::size_t;
+using std::string;
+using std::to_string;
+using std::vector;
+
+
+
+// Mip-tiled page file of a virtual texture, '<image>.vtp' next to the image. 'build' (the offline tiler) writes it
+// once from the decoded image, then the tiles are read one by one. Each level is cut into pages of 'kTileSize' texels,
+// padded with a border of 'kTileBorder' texels copied from the neighbouring pages (wrapped or clamped), so a tile is
+// filtered bilinearly in any atlas slot; the tiles are stored level after level, row after row (lower-left origin),
+// as sRGB RGBA8. The header keeps the size and time of the image, an edited image is tiled again.
+class PageFile {
+public:
+	static const GLsizei kTileSize, kTileBorder; // defined also in shaders/main/shading.frag
+
+	static GLsizei getPaddedTileSize();
+	static bool canTile(GLsizei width, GLsizei height); // power-of-two sides of at least 'kTileSize' texels
+
+	// RGBA8 image, lower-left origin; false -> the page file cannot be written
+	static bool build(const string& kFilePath, const string& kFileName, const GLubyte* pkImage, GLsizei width,
+		              GLsizei height, bool repeat);
+
+
+	PageFile();
+	~PageFile();
+
+
+	// init: open (false -> no page file, or out of date)
+	//############################################################################
+	bool open(const string& kFilePath, const string& kFileName, bool repeat);
+
+
+	// read (any thread, one read at a time)
+	//############################################################################
+	void readTile(GLint level, GLint pageX, GLint pageY, GLubyte* pTile); // 'getPaddedTileSize'^2 RGBA8 texels
+
+
+	// get
+	//############################################################################
+	GLsizei getWidth() const;
+	GLsizei getHeight() const;
+	GLint getNumLevels() const;
+	GLsizei getNumPagesX(GLint level) const;
+	GLsizei getNumPagesY(GLint level) const;
+	bool isTransparent() const;
+
+private:
+	static const char kMagic_[4u];
+	static const GLuint kVersion_;
+
+	static string getPageFilePath_(const string& kFilePath, const string& kFileName);
+
+	static void downsample_(const GLubyte* pkSource, GLsizei width, GLsizei height, GLubyte* pTarget);
+	static void cutTile_(const GLubyte* pkImage, GLsizei width, GLsizei height, GLint pageX, GLint pageY, bool repeat,
+		                 GLubyte* pTile);
+
+	PageFile(const PageFile&);
+	const PageFile& operator=(const PageFile&) {}
+
+	struct FILE_HEADER {
+		char magic[4u];
+		GLuint version;
+		GLsizei width, height, tileSize, tileBorder;
+		GLint nLevels;
+		GLuint repeat, transparent;
+		long long sourceSize, sourceTime;
+	};
+
+	long long getTileOffset_(GLint level, GLint pageX, GLint pageY) const;
+
+	FILE* pFile_;
+	FILE_HEADER header_;
+	mutex mutex_;
+};
+
+#endif
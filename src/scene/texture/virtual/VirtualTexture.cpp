@@ -0,0 +1,435 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#include "VirtualTexture.h"
+
+
+
+const unsigned int VirtualTexture::kMaxLoads_ = 32u;
+const unsigned int VirtualTexture::kMaxUploads_ = 8u;
+const GLuint VirtualTexture::kNoPage_ = 0xFFFFFFFFu;
+
+GLsizei VirtualTexture::minSize_ = 0;
+uvec2 VirtualTexture::screenSize_ = uvec2(0u);
+
+vector<thread> VirtualTexture::workers_;
+mutex VirtualTexture::mutex_;
+condition_variable VirtualTexture::condition_;
+deque<pair<VirtualTexture*, GLuint>> VirtualTexture::loads_;
+unsigned int VirtualTexture::nTextures_ = 0u;
+bool VirtualTexture::stopping_ = false;
+
+
+
+void VirtualTexture::setMinSize(GLsizei size) {
+	if (size < 0) throw runtime_error("VirtualTexture.setMinSize|Invalid size value.");
+	VirtualTexture::minSize_ = size;
+}
+
+
+
+GLsizei VirtualTexture::getMinSize() {
+	return VirtualTexture::minSize_;
+}
+
+
+
+void VirtualTexture::setScreenSize(const uvec2& kSize) {
+	VirtualTexture::screenSize_ = kSize;
+}
+
+
+
+VirtualTexture::VirtualTexture(const string& kFilePath, const string& kFileName, bool repeat) :
+	                           pageFile_(), fileName_(kFileName), atlas_(0u), pageTable_(0u),
+	                           nSlotsPerSide_(0), nSlots_(0), nPinnedSlots_(0), firstPages_(), pageSlots_(),
+	                           pageRequests_(), loadingPages_(), requestedPages_(), slotPages_(), slotFrames_(),
+	                           loadedTiles_(), nLoading_(0u), frame_(1u), pageTableChanged_(true),
+	                           nUploaded_(0u), nEvicted_(0u) {
+	if (!pageFile_.open(kFilePath, kFileName, repeat))
+		throw runtime_error("VirtualTexture.VirtualTexture|Cannot open the page file of '" + kFileName + "'.");
+
+	GLuint nPages = 0u;
+	for (GLint iLevel = 0; iLevel < pageFile_.getNumLevels(); iLevel++) {
+		firstPages_.push_back(nPages);
+		nPages += static_cast<GLuint>(pageFile_.getNumPagesX(iLevel) * pageFile_.getNumPagesY(iLevel));
+	}
+
+	GLint coarsestLevel = pageFile_.getNumLevels() - 1;
+	nPinnedSlots_ = pageFile_.getNumPagesX(coarsestLevel) * pageFile_.getNumPagesY(coarsestLevel);
+
+	pageSlots_.assign(nPages, -1);
+	pageRequests_.assign(nPages, 0u);
+	loadingPages_.assign(nPages, false);
+
+	try {
+		createTextures_();
+
+		// the coarsest level stays resident, every page table entry resolves to a loaded page
+		vector<GLubyte> tile(static_cast<size_t>(PageFile::getPaddedTileSize()) * PageFile::getPaddedTileSize() * 4u);
+		for (GLsizei i = 0; i < nPinnedSlots_; i++) {
+			GLuint page = firstPages_.back() + static_cast<GLuint>(i);
+			readPage_(page, tile.data());
+			uploadPage_(page, i, tile.data());
+		}
+
+		updatePageTable_();
+	}
+	catch (const exception& kException) {
+		GlState::deleteTexture(atlas_);
+		GlState::deleteTexture(pageTable_);
+		throw runtime_error("VirtualTexture.VirtualTexture > " + string(kException.what()));
+	}
+
+	unique_lock<mutex> lock(VirtualTexture::mutex_);
+	if (VirtualTexture::workers_.empty()) {
+		unsigned int nWorkers = min(max(thread::hardware_concurrency(), 2u) - 1u, 4u);
+		for (unsigned int i = 0u; i < nWorkers; i++)
+			VirtualTexture::workers_.emplace_back(&VirtualTexture::work_);
+	}
+	VirtualTexture::nTextures_++;
+
+	//cout << "[Virtual texture " << atlas_ << "] created." << endl;
+}
+
+
+
+VirtualTexture::~VirtualTexture() {
+	unique_lock<mutex> lock(VirtualTexture::mutex_);
+
+	// queued pages are dropped, pages being read are waited for
+	for (auto it = VirtualTexture::loads_.begin(); it != VirtualTexture::loads_.end();)
+		if (it->first == this) {
+			it = VirtualTexture::loads_.erase(it);
+			nLoading_--;
+		}
+		else it++;
+
+	VirtualTexture::condition_.wait(lock, [this] { return nLoading_ == 0u; });
+
+	VirtualTexture::nTextures_--;
+	if (VirtualTexture::nTextures_ == 0u) {
+		VirtualTexture::stopping_ = true;
+		lock.unlock();
+		VirtualTexture::condition_.notify_all();
+
+		for (thread& rWorker : VirtualTexture::workers_) rWorker.join();
+		VirtualTexture::workers_.clear();
+		VirtualTexture::stopping_ = false;
+	}
+	else lock.unlock();
+
+	GlState::deleteTexture(atlas_);
+	GlState::deleteTexture(pageTable_);
+
+	//cout << "[Virtual texture " << atlas_ << "] deleted." << endl;
+}
+
+
+
+void VirtualTexture::requestPages(float u, float v, float uFootprintLog2, float vFootprintLog2) {
+	float lod = max(std::log2(static_cast<float>(pageFile_.getWidth())) + uFootprintLog2,
+		            std::log2(static_cast<float>(pageFile_.getHeight())) + vFootprintLog2);
+	GLint level = static_cast<GLint>(std::floor(min(max(lod, 0.0f), static_cast<float>(pageFile_.getNumLevels() - 1))));
+
+	u = min(max(u, 0.0f), 1.0f);
+	v = min(max(v, 0.0f), 1.0f);
+
+	// the page and its ancestors (the next level is blended in, and they are the fallback while it loads)
+	for (GLint iLevel = level; iLevel < pageFile_.getNumLevels(); iLevel++) {
+		GLsizei levelWidth = pageFile_.getWidth() >> iLevel, levelHeight = pageFile_.getHeight() >> iLevel;
+		GLint pageX = min(static_cast<GLint>(u * levelWidth) / PageFile::kTileSize, pageFile_.getNumPagesX(iLevel) - 1);
+		GLint pageY = min(static_cast<GLint>(v * levelHeight) / PageFile::kTileSize, pageFile_.getNumPagesY(iLevel) - 1);
+
+		GLuint page = getPage_(iLevel, pageX, pageY);
+		if (pageRequests_.at(page) == frame_) break; // so are its ancestors
+		pageRequests_.at(page) = frame_;
+
+		GLint slot = pageSlots_.at(page);
+		if (slot >= 0) slotFrames_.at(static_cast<size_t>(slot)) = frame_;
+		else if (!loadingPages_.at(page)) requestedPages_.push_back(page);
+	}
+}
+
+
+
+void VirtualTexture::update() {
+	vector<TILE> tiles;
+
+	{
+		// coarse levels first (higher page indices), so that a missing page soon has a closer ancestor
+		std::sort(requestedPages_.begin(), requestedPages_.end(), [](GLuint a, GLuint b) { return a > b; });
+
+		unique_lock<mutex> lock(VirtualTexture::mutex_);
+
+		for (GLuint iPage : requestedPages_) {
+			if (nLoading_ + loadedTiles_.size() >= VirtualTexture::kMaxLoads_) break;
+
+			loadingPages_.at(iPage) = true;
+			VirtualTexture::loads_.emplace_back(this, iPage);
+			nLoading_++;
+		}
+
+		size_t nTiles = min(loadedTiles_.size(), static_cast<size_t>(VirtualTexture::kMaxUploads_));
+		tiles.reserve(nTiles);
+		for (size_t i = 0u; i < nTiles; i++) tiles.push_back(std::move(loadedTiles_.at(i)));
+		loadedTiles_.erase(loadedTiles_.begin(), loadedTiles_.begin() + nTiles);
+	}
+
+	// pages not queued are requested again by the next feedback
+	if (!requestedPages_.empty()) VirtualTexture::condition_.notify_all();
+	requestedPages_.clear();
+
+	for (const TILE& kTile : tiles) {
+		loadingPages_.at(kTile.page) = false;
+		if (kTile.data.empty() || pageSlots_.at(kTile.page) >= 0) continue;
+
+		// without a free slot the page is requested again by the next feedback
+		GLint slot = getFreeSlot_();
+		if (slot >= 0) uploadPage_(kTile.page, slot, kTile.data.data());
+	}
+
+	if (pageTableChanged_) updatePageTable_();
+	frame_++;
+}
+
+
+
+void VirtualTexture::startReading(GLint atlasUnit, GLint pageTableUnit) const {
+	GLint nUnits = GlState::getMaxCombinedTextureImageUnits();
+	if (atlasUnit < 0 || atlasUnit >= nUnits || pageTableUnit < 0 || pageTableUnit >= nUnits)
+		throw runtime_error("VirtualTexture.startReading|Invalid texture unit value.");
+
+	GlState::bindTexture(static_cast<GLuint>(atlasUnit), atlas_);
+	GlState::bindTexture(static_cast<GLuint>(pageTableUnit), pageTable_);
+}
+
+
+
+GLsizei VirtualTexture::getWidth() const {
+	return pageFile_.getWidth();
+}
+
+
+
+GLsizei VirtualTexture::getHeight() const {
+	return pageFile_.getHeight();
+}
+
+
+
+bool VirtualTexture::isTransparent() const {
+	return pageFile_.isTransparent();
+}
+
+
+
+string VirtualTexture::toString() const {
+	size_t nResident = 0u;
+	for (GLuint iPage : slotPages_)
+		if (iPage != VirtualTexture::kNoPage_) nResident++;
+
+	GLsizei atlasSize = nSlotsPerSide_ * PageFile::getPaddedTileSize();
+	double atlasMB = static_cast<double>(atlasSize) * atlasSize * 4.0 / (1024.0 * 1024.0);
+	double fullMB = static_cast<double>(pageFile_.getWidth()) * pageFile_.getHeight() * 4.0 * 4.0 / 3.0 / (1024.0 * 1024.0);
+
+	return fileName_ + ": " + to_string(nResident) + "/" + to_string(nSlots_) + " slots (" +
+		   to_string(pageSlots_.size()) + " pages), atlas " + to_string(atlasSize) + " x " + to_string(atlasSize) + " (" +
+		   to_string(static_cast<unsigned int>(atlasMB + 0.5)) + " MB, full texture " +
+		   to_string(static_cast<unsigned int>(fullMB + 0.5)) + " MB), " + to_string(nUploaded_) + " uploaded, " +
+		   to_string(nEvicted_) + " evicted";
+}
+
+
+
+void VirtualTexture::work_() {
+	size_t tileLength = static_cast<size_t>(PageFile::getPaddedTileSize()) * PageFile::getPaddedTileSize() * 4u;
+
+	while (true) {
+		pair<VirtualTexture*, GLuint> load;
+
+		{
+			unique_lock<mutex> lock(VirtualTexture::mutex_);
+			VirtualTexture::condition_.wait(lock, [] {
+				return VirtualTexture::stopping_ || !VirtualTexture::loads_.empty();
+			});
+			if (VirtualTexture::loads_.empty()) return;
+
+			load = VirtualTexture::loads_.front();
+			VirtualTexture::loads_.pop_front();
+		}
+
+		TILE tile = { load.second, vector<GLubyte>(tileLength) };
+		try {
+			load.first->readPage_(load.second, tile.data.data());
+		}
+		catch (const exception& kException) {
+			cout << "Virtual texture: " << kException.what() << endl;
+			tile.data.clear();
+		}
+
+		{
+			unique_lock<mutex> lock(VirtualTexture::mutex_);
+			load.first->loadedTiles_.push_back(std::move(tile));
+			load.first->nLoading_--;
+		}
+
+		VirtualTexture::condition_.notify_all(); // a texture being deleted waits for its pages
+	}
+}
+
+
+
+void VirtualTexture::createTextures_() {
+	// enough slots to cover the screen about twice (magnification, the blended level, the pages on both sides of a
+	// page edge), plus a third for the coarser levels; bounded by the 8-bit page table and the texture size
+	double screenPages = static_cast<double>(VirtualTexture::screenSize_.x) * VirtualTexture::screenSize_.y /
+		                 (static_cast<double>(PageFile::kTileSize) * PageFile::kTileSize);
+	GLsizei nSlots = max(static_cast<GLsizei>(std::ceil(2.0 * screenPages * 4.0 / 3.0)), 64);
+	nSlots = min(nSlots, static_cast<GLsizei>(pageSlots_.size()));
+
+	nSlotsPerSide_ = static_cast<GLsizei>(std::ceil(std::sqrt(static_cast<double>(nSlots))));
+	nSlotsPerSide_ = min(min(nSlotsPerSide_, 255), GlState::getMaxTextureSize() / PageFile::getPaddedTileSize());
+	nSlots_ = min(nSlotsPerSide_ * nSlotsPerSide_, static_cast<GLsizei>(pageSlots_.size()));
+
+	if (nSlots_ <= nPinnedSlots_) throw runtime_error("VirtualTexture.createTextures_|Atlas too small.");
+
+	slotPages_.assign(static_cast<size_t>(nSlots_), VirtualTexture::kNoPage_);
+	slotFrames_.assign(static_cast<size_t>(nSlots_), 0u);
+
+	GLsizei atlasSize = nSlotsPerSide_ * PageFile::getPaddedTileSize();
+
+	glGenTextures(1, &atlas_);
+	GlState::bindTexture(atlas_);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_SRGB8_ALPHA8, atlasSize, atlasSize);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// integer texture: read with 'texelFetch', one mipmap per level of the page file
+	glGenTextures(1, &pageTable_);
+	GlState::bindTexture(pageTable_);
+	glTexStorage2D(GL_TEXTURE_2D, pageFile_.getNumLevels(), GL_RGBA8UI, pageFile_.getNumPagesX(0),
+		           pageFile_.getNumPagesY(0));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	GlDebug::countCalls(12u);
+}
+
+
+
+void VirtualTexture::readPage_(GLuint page, GLubyte* pTile) {
+	GLint level, pageX, pageY;
+	getPageCoordinates_(page, level, pageX, pageY);
+
+	try {
+		pageFile_.readTile(level, pageX, pageY, pTile);
+	}
+	catch (const exception& kException) {
+		throw runtime_error("VirtualTexture.readPage_ > " + string(kException.what()));
+	}
+}
+
+
+
+void VirtualTexture::uploadPage_(GLuint page, GLint slot, const GLubyte* pkTile) {
+	GLuint evictedPage = slotPages_.at(static_cast<size_t>(slot));
+	if (evictedPage != VirtualTexture::kNoPage_) {
+		pageSlots_.at(evictedPage) = -1;
+		nEvicted_++;
+	}
+
+	slotPages_.at(static_cast<size_t>(slot)) = page;
+	slotFrames_.at(static_cast<size_t>(slot)) = pageRequests_.at(page);
+	pageSlots_.at(page) = slot;
+
+	GLsizei paddedTileSize = PageFile::getPaddedTileSize();
+
+	GlState::bindTexture(atlas_);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % nSlotsPerSide_) * paddedTileSize, (slot / nSlotsPerSide_) * paddedTileSize,
+		            paddedTileSize, paddedTileSize, GL_RGBA, GL_UNSIGNED_BYTE, pkTile);
+	GlDebug::countCalls(1u);
+
+	pageTableChanged_ = true;
+	nUploaded_++;
+}
+
+
+
+GLint VirtualTexture::getFreeSlot_() const {
+	GLint slot = -1;
+	unsigned int slotFrame = frame_;
+
+	// least recently requested page, never one requested by the current feedback; the pinned slots are skipped
+	for (GLsizei i = nPinnedSlots_; i < nSlots_; i++) {
+		if (slotPages_.at(static_cast<size_t>(i)) == VirtualTexture::kNoPage_) return i;
+
+		if (slotFrames_.at(static_cast<size_t>(i)) < slotFrame) {
+			slotFrame = slotFrames_.at(static_cast<size_t>(i));
+			slot = i;
+		}
+	}
+
+	return slot;
+}
+
+
+
+void VirtualTexture::updatePageTable_() {
+	vector<GLubyte> entries, parentEntries;
+	GLsizei parentPagesX = 0;
+
+	GlState::bindTexture(pageTable_);
+
+	// coarse to fine: a page that is not resident takes the entry of its parent
+	for (GLint iLevel = pageFile_.getNumLevels() - 1; iLevel >= 0; iLevel--) {
+		GLsizei nPagesX = pageFile_.getNumPagesX(iLevel), nPagesY = pageFile_.getNumPagesY(iLevel);
+		entries.resize(static_cast<size_t>(nPagesX) * nPagesY * 4u);
+
+		for (GLint iPageY = 0; iPageY < nPagesY; iPageY++)
+			for (GLint iPageX = 0; iPageX < nPagesX; iPageX++) {
+				GLubyte* pEntry = entries.data() + (static_cast<size_t>(iPageY) * nPagesX + iPageX) * 4u;
+				GLint slot = pageSlots_.at(getPage_(iLevel, iPageX, iPageY));
+
+				if (slot >= 0) {
+					pEntry[0u] = static_cast<GLubyte>(slot % nSlotsPerSide_);
+					pEntry[1u] = static_cast<GLubyte>(slot / nSlotsPerSide_);
+					pEntry[2u] = static_cast<GLubyte>(iLevel);
+					pEntry[3u] = 255u;
+				}
+				else {
+					const GLubyte* pkParent = parentEntries.data() +
+						                      (static_cast<size_t>(iPageY / 2) * parentPagesX + iPageX / 2) * 4u;
+					std::copy(pkParent, pkParent + 4u, pEntry);
+				}
+			}
+
+		glTexSubImage2D(GL_TEXTURE_2D, iLevel, 0, 0, nPagesX, nPagesY, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, entries.data());
+		GlDebug::countCalls(1u);
+
+		entries.swap(parentEntries);
+		parentPagesX = nPagesX;
+	}
+
+	pageTableChanged_ = false;
+}
+
+
+
+GLuint VirtualTexture::getPage_(GLint level, GLint pageX, GLint pageY) const {
+	return firstPages_.at(static_cast<size_t>(level)) + static_cast<GLuint>(pageY * pageFile_.getNumPagesX(level) + pageX);
+}
+
+
+
+void VirtualTexture::getPageCoordinates_(GLuint page, GLint& rLevel, GLint& rPageX, GLint& rPageY) const {
+	rLevel = pageFile_.getNumLevels() - 1;
+	while (rLevel > 0 && firstPages_.at(static_cast<size_t>(rLevel)) > page) rLevel--;
+
+	GLuint index = page - firstPages_.at(static_cast<size_t>(rLevel));
+	rPageX = static_cast<GLint>(index % static_cast<GLuint>(pageFile_.getNumPagesX(rLevel)));
+	rPageY = static_cast<GLint>(index / static_cast<GLuint>(pageFile_.getNumPagesX(rLevel)));
+}
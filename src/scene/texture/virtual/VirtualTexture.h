@@ -0,0 +1,145 @@
+/**
+ * Author: Oldrin Barbulescu
+ * Last modified: Oct 17, 2026
+ **/
+
+#ifndef VIRTUAL_TEXTURE_H
+#define VIRTUAL_TEXTURE_H
+
+#include <GL/gl3w.h>
+
+#include "info/GlDebug.h"
+#include "state/GlState.h"
+#include "texture/virtual/PageFile.h"
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using glm::uvec2;
+
+using std::condition_variable;
+using std::cout;
+using std::deque;
+using std::endl;
+using std::exception;
+using std::max;
+using std::min;
+using std::mutex;
+using std::pair;
+using std::runtime_error;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::unique_lock;
+using std::vector;
+
+
+
+// Streaming virtual texture: an image of any size (its page file, see 'PageFile') of which only the pages seen on
+// the screen are resident. The pages are tiles of an atlas sized from the screen, not from the image; the page table
+// has one RGBA8UI texel per page and level (atlas slot x, y and the level of the resident page), a missing page points
+// at its nearest resident ancestor, and the coarsest level is always resident. The pages are requested from the
+// feedback pass ('requestPages', see 'FeedbackBuffer'), read by a pool of worker threads shared by all the virtual
+// textures, and uploaded by 'update'; when the atlas is full, the least recently requested page is evicted.
+// Sampled in 'shaders/main/shading.frag'.
+class VirtualTexture {
+public:
+	// images with a side at least this large are virtual (see 'ColorTexture'), 0 -> off
+	static void setMinSize(GLsizei size);
+	static GLsizei getMinSize();
+
+	static void setScreenSize(const uvec2& kSize); // sizes the atlas of the next virtual textures
+
+
+	VirtualTexture(const string& kFilePath, const string& kFileName, bool repeat); // page file up to date
+	~VirtualTexture();
+
+
+	// render: 1) [requestPages] (feedback pixels)
+	//         2) update
+	//         3) startReading
+	//############################################################################
+	// texture coordinates in [0, 1); log2 of the largest texture coordinate derivatives of a screen pixel
+	void requestPages(float u, float v, float uFootprintLog2, float vFootprintLog2);
+	void update();
+	void startReading(GLint atlasUnit, GLint pageTableUnit) const;
+
+
+	// get
+	//############################################################################
+	GLsizei getWidth() const;
+	GLsizei getHeight() const;
+	bool isTransparent() const;
+
+	string toString() const;
+
+private:
+	static const unsigned int kMaxLoads_; // queued or being read, per texture
+	static const unsigned int kMaxUploads_; // per update
+	static const GLuint kNoPage_;
+
+	static GLsizei minSize_;
+	static uvec2 screenSize_;
+
+	static vector<thread> workers_;
+	static mutex mutex_;
+	static condition_variable condition_;
+	static deque<pair<VirtualTexture*, GLuint>> loads_; // texture, page
+	static unsigned int nTextures_;
+	static bool stopping_;
+
+	static void work_();
+
+	VirtualTexture(const VirtualTexture&);
+	const VirtualTexture& operator=(const VirtualTexture&) {}
+
+	struct TILE {
+		GLuint page;
+		vector<GLubyte> data; // empty -> the read failed
+	};
+
+	void createTextures_();
+	void readPage_(GLuint page, GLubyte* pTile);
+	void uploadPage_(GLuint page, GLint slot, const GLubyte* pkTile);
+	GLint getFreeSlot_() const; // -1 -> every slot is in use this frame
+	void updatePageTable_();
+
+	GLuint getPage_(GLint level, GLint pageX, GLint pageY) const;
+	void getPageCoordinates_(GLuint page, GLint& rLevel, GLint& rPageX, GLint& rPageY) const;
+
+	PageFile pageFile_;
+	string fileName_;
+
+	GLuint atlas_, pageTable_;
+	GLsizei nSlotsPerSide_, nSlots_, nPinnedSlots_; // pinned: the first slots, the coarsest level
+
+	vector<GLuint> firstPages_; // per level
+	vector<GLint> pageSlots_; // -1 -> not resident
+	vector<unsigned int> pageRequests_; // frame of the last request
+	vector<bool> loadingPages_;
+	vector<GLuint> requestedPages_; // since the last update
+
+	vector<GLuint> slotPages_;
+	vector<unsigned int> slotFrames_; // frame of the last request of the page in the slot
+
+	vector<TILE> loadedTiles_; // filled by the workers ('mutex_')
+	unsigned int nLoading_; // queued or being read ('mutex_')
+
+	unsigned int frame_;
+	bool pageTableChanged_;
+	unsigned int nUploaded_, nEvicted_;
+};
+
+#endif